@@ -309,6 +309,27 @@ pub fn get_connection_messages(pw_did: &str, pw_vk: &str, agent_did: &str, agent
     Ok(response)
 }
 
+/**
+Lists messages of a connection without downloading their (encrypted) payloads. Used to find out
+which messages are new before fetching payloads of just those messages.
+ */
+pub fn get_connection_messages_metadata(pw_did: &str, pw_vk: &str, agent_did: &str, agent_vk: &str, status_codes: Option<Vec<MessageStatusCode>>) -> AgencyClientResult<Vec<Message>> {
+    trace!("get_connection_messages_metadata >>> pw_did: {}, pw_vk: {}, agent_vk: {}", pw_did, pw_vk, agent_vk);
+
+    let response = get_messages()
+        .to(&pw_did)?
+        .to_vk(&pw_vk)?
+        .agent_did(&agent_did)?
+        .agent_vk(&agent_vk)?
+        .status_codes(status_codes)?
+        .include_edge_payload("Y")?
+        .send_secure()
+        .map_err(|err| err.map(AgencyClientErrorKind::PostMessageFailed, "Cannot get messages metadata"))?;
+
+    trace!("messages metadata returned: {:?}", response);
+    Ok(response)
+}
+
 pub fn parse_status_codes(status_codes: Option<Vec<String>>) -> AgencyClientResult<Option<Vec<MessageStatusCode>>> {
     match status_codes {
         Some(codes) => {
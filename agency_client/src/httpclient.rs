@@ -1,14 +1,31 @@
 use std::env;
 use std::io::Read;
+use std::sync::Arc;
 
 use reqwest;
 use reqwest::header::CONTENT_TYPE;
 
 use crate::error::{AgencyClientError, AgencyClientErrorKind, AgencyClientResult};
+use crate::metrics;
 use crate::mocking::{AgencyMock, AgencyMockDecrypted, HttpClientMockResponse};
 use crate::mocking;
 
+lazy_static! {
+    static ref AGENCY_POST_MESSAGE: Arc<metrics::Histogram> = metrics::histogram("agency_post_message");
+}
+
+lazy_static! {
+    // shared so consecutive posts to the same agency reuse kept-alive connections
+    static ref HTTP_CLIENT: reqwest::Result<reqwest::Client> = reqwest::ClientBuilder::new()
+        .timeout(crate::utils::timeout::TimeoutUtils::long_timeout())
+        .build();
+}
+
 pub fn post_message(body_content: &Vec<u8>, url: &str) -> AgencyClientResult<Vec<u8>> {
+    AGENCY_POST_MESSAGE.time(|| _post_message(body_content, url))
+}
+
+fn _post_message(body_content: &Vec<u8>, url: &str) -> AgencyClientResult<Vec<u8>> {
     // todo: this function should be general, not knowing that agency exists -> move agency mocks to agency module
     if mocking::agency_mocks_enabled() {
         if HttpClientMockResponse::has_response() {
@@ -30,7 +47,7 @@ pub fn post_message(body_content: &Vec<u8>, url: &str) -> AgencyClientResult<Vec
         set_ssl_cert_location();
     }
 
-    let client = reqwest::ClientBuilder::new().timeout(crate::utils::timeout::TimeoutUtils::long_timeout()).build().map_err(|err| {
+    let client = HTTP_CLIENT.as_ref().map_err(|err| {
         error!("error: {}", err);
         AgencyClientError::from_msg(AgencyClientErrorKind::PostMessageFailed, format!("Building reqwest client failed: {:?}", err))
     })?;
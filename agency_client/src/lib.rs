@@ -24,7 +24,10 @@ pub mod payload;
 #[macro_use]
 pub mod agency_settings;
 pub mod mocking;
+#[cfg(feature = "mock_agency")]
+pub mod mock_agency;
 pub mod httpclient;
+pub mod metrics;
 pub mod agency_client;
 pub mod agent_utils;
 pub mod error;
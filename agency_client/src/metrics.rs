@@ -0,0 +1,346 @@
+use std::collections::HashMap;
+use std::sync::{Arc, RwLock};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::time::{Duration, Instant};
+
+/*
+Latency histograms are log-linear like HDR histograms: each power of two microseconds is split into
+SUB_BUCKETS linear buckets, so recorded values keep ~3% relative precision from 1us up to hours while a
+histogram is a fixed array of atomic counters. Call sites resolve their histogram or counter from the
+registry once (see `histogram` and `counter`) and keep the handle, so recording only touches atomics.
+Reset zeroes registered metrics in place, which keeps such handles valid.
+ */
+const SUB_BUCKET_BITS: u32 = 5;
+const SUB_BUCKETS: usize = 1 << SUB_BUCKET_BITS;
+const MAGNITUDES: usize = 64 - SUB_BUCKET_BITS as usize + 1;
+const BUCKETS: usize = MAGNITUDES * SUB_BUCKETS;
+
+const QUANTILES: [f64; 4] = [0.5, 0.9, 0.99, 0.999];
+
+lazy_static! {
+    static ref METRICS: Metrics = Metrics::default();
+}
+
+pub struct Histogram {
+    buckets: Vec<AtomicU64>,
+    count: AtomicU64,
+    sum_us: AtomicU64,
+    max_us: AtomicU64,
+    errors: AtomicU64,
+}
+
+impl Histogram {
+    fn new() -> Histogram {
+        Histogram {
+            buckets: (0..BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            count: AtomicU64::new(0),
+            sum_us: AtomicU64::new(0),
+            max_us: AtomicU64::new(0),
+            errors: AtomicU64::new(0),
+        }
+    }
+
+    pub fn record_duration(&self, duration: Duration, failed: bool) {
+        self.record(_as_us(duration), failed)
+    }
+
+    ///
+    /// Runs `f` and records its duration; `Err` results are counted as errors.
+    ///
+    pub fn time<T, E, F: FnOnce() -> Result<T, E>>(&self, f: F) -> Result<T, E> {
+        let started = Instant::now();
+        let result = f();
+        self.record_duration(started.elapsed(), result.is_err());
+        result
+    }
+
+    fn record(&self, value_us: u64, failed: bool) {
+        self.buckets[_bucket_index(value_us)].fetch_add(1, Ordering::Relaxed);
+        self.count.fetch_add(1, Ordering::Relaxed);
+        self.sum_us.fetch_add(value_us, Ordering::Relaxed);
+        self.max_us.fetch_max(value_us, Ordering::Relaxed);
+        if failed {
+            self.errors.fetch_add(1, Ordering::Relaxed);
+        }
+    }
+
+    /// Upper bound of the bucket holding the value at quantile `q`, in microseconds.
+    fn quantile(&self, q: f64) -> u64 {
+        let count = self.count.load(Ordering::Relaxed);
+        if count == 0 {
+            return 0;
+        }
+        let rank = ((q * count as f64).ceil() as u64).max(1);
+        let mut seen = 0;
+        for (index, bucket) in self.buckets.iter().enumerate() {
+            seen += bucket.load(Ordering::Relaxed);
+            if seen >= rank {
+                return _bucket_upper_bound(index).min(self.max_us.load(Ordering::Relaxed));
+            }
+        }
+        self.max_us.load(Ordering::Relaxed)
+    }
+
+    fn reset(&self) {
+        self.buckets.iter().for_each(|bucket| bucket.store(0, Ordering::Relaxed));
+        self.count.store(0, Ordering::Relaxed);
+        self.sum_us.store(0, Ordering::Relaxed);
+        self.max_us.store(0, Ordering::Relaxed);
+        self.errors.store(0, Ordering::Relaxed);
+    }
+
+    fn snapshot(&self, operation: &str) -> HistogramSnapshot {
+        HistogramSnapshot {
+            operation: operation.to_string(),
+            count: self.count.load(Ordering::Relaxed),
+            errors: self.errors.load(Ordering::Relaxed),
+            sum_us: self.sum_us.load(Ordering::Relaxed),
+            max_us: self.max_us.load(Ordering::Relaxed),
+            quantiles_us: QUANTILES.iter().map(|q| (q.to_string(), self.quantile(*q))).collect(),
+        }
+    }
+}
+
+#[derive(Default)]
+pub struct Counter(AtomicU64);
+
+impl Counter {
+    pub fn increment(&self) {
+        self.0.fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn load(&self) -> u64 {
+        self.0.load(Ordering::Relaxed)
+    }
+}
+
+fn _bucket_index(value_us: u64) -> usize {
+    if value_us < SUB_BUCKETS as u64 {
+        return value_us as usize;
+    }
+    let magnitude = 63 - value_us.leading_zeros() - SUB_BUCKET_BITS + 1;
+    let sub_bucket = (value_us >> (magnitude - 1)) as usize - SUB_BUCKETS;
+    magnitude as usize * SUB_BUCKETS + sub_bucket
+}
+
+fn _bucket_upper_bound(index: usize) -> u64 {
+    let magnitude = (index / SUB_BUCKETS) as u32;
+    let sub_bucket = (index % SUB_BUCKETS) as u64;
+    if magnitude == 0 {
+        return sub_bucket;
+    }
+    // the last bucket ends at u64::MAX, which would overflow before subtracting
+    ((((SUB_BUCKETS as u64 + sub_bucket + 1) as u128) << (magnitude - 1)) - 1) as u64
+}
+
+#[derive(Default)]
+struct Metrics {
+    histograms: RwLock<HashMap<&'static str, Arc<Histogram>>>,
+    counters: RwLock<HashMap<&'static str, Arc<Counter>>>,
+}
+
+impl Metrics {
+    fn histogram(&self, operation: &'static str) -> Arc<Histogram> {
+        if let Some(histogram) = self.histograms.read().ok().and_then(|histograms| histograms.get(operation).cloned()) {
+            return histogram;
+        }
+        match self.histograms.write() {
+            Ok(mut histograms) => histograms.entry(operation).or_insert_with(|| Arc::new(Histogram::new())).clone(),
+            Err(_) => Arc::new(Histogram::new())
+        }
+    }
+
+    fn counter(&self, event: &'static str) -> Arc<Counter> {
+        if let Some(counter) = self.counters.read().ok().and_then(|counters| counters.get(event).cloned()) {
+            return counter;
+        }
+        match self.counters.write() {
+            Ok(mut counters) => counters.entry(event).or_insert_with(|| Arc::new(Counter::default())).clone(),
+            Err(_) => Arc::new(Counter::default())
+        }
+    }
+
+    fn snapshot(&self) -> MetricsSnapshot {
+        let mut operations: Vec<HistogramSnapshot> = self.histograms.read()
+            .map(|histograms| histograms.iter().map(|(operation, histogram)| histogram.snapshot(operation)).collect())
+            .unwrap_or_default();
+        operations.sort_by(|a, b| a.operation.cmp(&b.operation));
+        let mut events: Vec<CounterSnapshot> = self.counters.read()
+            .map(|counters| counters.iter().map(|(event, counter)| CounterSnapshot { event: event.to_string(), count: counter.load() }).collect())
+            .unwrap_or_default();
+        events.sort_by(|a, b| a.event.cmp(&b.event));
+        MetricsSnapshot { operations, events }
+    }
+
+    fn reset(&self) {
+        if let Ok(histograms) = self.histograms.read() {
+            histograms.values().for_each(|histogram| histogram.reset());
+        }
+        if let Ok(counters) = self.counters.read() {
+            counters.values().for_each(|counter| counter.0.store(0, Ordering::Relaxed));
+        }
+    }
+}
+
+#[derive(Debug)]
+pub struct HistogramSnapshot {
+    pub operation: String,
+    pub count: u64,
+    pub errors: u64,
+    pub sum_us: u64,
+    pub max_us: u64,
+    pub quantiles_us: Vec<(String, u64)>,
+}
+
+#[derive(Debug)]
+pub struct CounterSnapshot {
+    pub event: String,
+    pub count: u64,
+}
+
+#[derive(Debug)]
+pub struct MetricsSnapshot {
+    pub operations: Vec<HistogramSnapshot>,
+    pub events: Vec<CounterSnapshot>,
+}
+
+impl MetricsSnapshot {
+    pub fn to_json(&self) -> String {
+        let operations: serde_json::Map<String, serde_json::Value> = self.operations.iter()
+            .map(|op| (op.operation.clone(), json!({
+                "count": op.count,
+                "errors": op.errors,
+                "sum_us": op.sum_us,
+                "max_us": op.max_us,
+                "quantiles_us": op.quantiles_us.iter().cloned().collect::<HashMap<String, u64>>(),
+            })))
+            .collect();
+        let events: serde_json::Map<String, serde_json::Value> = self.events.iter()
+            .map(|event| (event.event.clone(), json!(event.count)))
+            .collect();
+        json!({"operations": operations, "events": events}).to_string()
+    }
+
+    pub fn to_prometheus(&self) -> String {
+        let mut out = String::new();
+        out.push_str("# TYPE vcx_operation_duration_seconds summary\n");
+        for op in &self.operations {
+            for (quantile, value_us) in &op.quantiles_us {
+                out.push_str(&format!("vcx_operation_duration_seconds{{operation=\"{}\",quantile=\"{}\"}} {}\n", op.operation, quantile, _seconds(*value_us)));
+            }
+            out.push_str(&format!("vcx_operation_duration_seconds_sum{{operation=\"{}\"}} {}\n", op.operation, _seconds(op.sum_us)));
+            out.push_str(&format!("vcx_operation_duration_seconds_count{{operation=\"{}\"}} {}\n", op.operation, op.count));
+        }
+        out.push_str("# TYPE vcx_operation_errors_total counter\n");
+        for op in &self.operations {
+            out.push_str(&format!("vcx_operation_errors_total{{operation=\"{}\"}} {}\n", op.operation, op.errors));
+        }
+        out.push_str("# TYPE vcx_events_total counter\n");
+        for event in &self.events {
+            out.push_str(&format!("vcx_events_total{{event=\"{}\"}} {}\n", event.event, event.count));
+        }
+        out
+    }
+}
+
+fn _seconds(value_us: u64) -> f64 {
+    value_us as f64 / 1_000_000.0
+}
+
+fn _as_us(duration: Duration) -> u64 {
+    duration.as_secs() * 1_000_000 + duration.subsec_micros() as u64
+}
+
+///
+/// Returns histogram of `operation`, registering it on first use. Resolve it once per call site,
+/// e.g. in lazy_static, rather than on every record.
+///
+pub fn histogram(operation: &'static str) -> Arc<Histogram> {
+    METRICS.histogram(operation)
+}
+
+///
+/// Returns counter of `event`, registering it on first use. Resolve it once per call site.
+///
+pub fn counter(event: &'static str) -> Arc<Counter> {
+    METRICS.counter(event)
+}
+
+pub fn snapshot() -> MetricsSnapshot {
+    METRICS.snapshot()
+}
+
+pub fn reset() {
+    METRICS.reset()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_bucket_bounds_cover_values() {
+        for value in (0..100_000).chain(vec![u64::MAX / 2, u64::MAX]) {
+            let index = _bucket_index(value);
+            assert!(index < BUCKETS);
+            assert!(value <= _bucket_upper_bound(index), "value {} above bound of bucket {}", value, index);
+            if index > 0 {
+                assert!(value > _bucket_upper_bound(index - 1), "value {} within bound of bucket {}", value, index - 1);
+            }
+        }
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_quantiles_are_precise() {
+        let histogram = Histogram::new();
+        for value in 1..=10_000 {
+            histogram.record(value, value % 100 == 0);
+        }
+        assert_eq!(histogram.count.load(Ordering::Relaxed), 10_000);
+        assert_eq!(histogram.errors.load(Ordering::Relaxed), 100);
+        let p50 = histogram.quantile(0.5);
+        assert!(p50 >= 5_000 && p50 <= 5_200, "p50 = {}", p50);
+        assert_eq!(histogram.quantile(1.0), 10_000);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_export_formats() {
+        let metrics = Metrics::default();
+        metrics.histogram("test_op").record(1500, false);
+        metrics.counter("test_event").increment();
+        metrics.counter("test_event").increment();
+        let snapshot = metrics.snapshot();
+
+        let json: serde_json::Value = serde_json::from_str(&snapshot.to_json()).unwrap();
+        assert_eq!(json["operations"]["test_op"]["count"], json!(1));
+        assert_eq!(json["events"]["test_event"], json!(2));
+
+        let prometheus = snapshot.to_prometheus();
+        assert!(prometheus.contains("vcx_operation_duration_seconds_count{operation=\"test_op\"} 1\n"));
+        assert!(prometheus.contains("vcx_events_total{event=\"test_event\"} 2\n"));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_reset_keeps_resolved_handles() {
+        let metrics = Metrics::default();
+        let histogram = metrics.histogram("test_op");
+        let counter = metrics.counter("test_event");
+        histogram.record(1500, true);
+        counter.increment();
+
+        metrics.reset();
+        assert_eq!(metrics.snapshot().operations[0].count, 0);
+        assert_eq!(metrics.snapshot().events[0].count, 0);
+
+        histogram.record(1500, false);
+        counter.increment();
+        let snapshot = metrics.snapshot();
+        assert_eq!(snapshot.operations[0].count, 1);
+        assert_eq!(snapshot.operations[0].errors, 0);
+        assert_eq!(snapshot.events[0].count, 1);
+    }
+}
@@ -0,0 +1,308 @@
+use std::collections::HashMap;
+use std::io::{BufRead, BufReader, ErrorKind, Read, Write};
+use std::net::{Shutdown, SocketAddr, TcpListener, TcpStream};
+use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::mpsc::{channel, Receiver, RecvTimeoutError, Sender};
+use std::thread;
+use std::time::Duration;
+
+use crate::error::{AgencyClientError, AgencyClientErrorKind, AgencyClientResult};
+
+const POLL_INTERVAL: Duration = Duration::from_millis(500);
+const KEEP_ALIVE_TIMEOUT: Duration = Duration::from_secs(30);
+const REQUEST_TIMEOUT: Duration = Duration::from_secs(30);
+const MAX_HEADER_LINES: usize = 100;
+const MAX_BODY_SIZE: usize = 16 * 1024 * 1024;
+
+pub type Handler = Arc<dyn Fn(Vec<u8>) -> AgencyClientResult<Vec<u8>> + Send + Sync>;
+
+struct Request {
+    body: Vec<u8>,
+    keep_alive: bool,
+}
+
+struct Job {
+    body: Vec<u8>,
+    reply: Sender<AgencyClientResult<Vec<u8>>>,
+}
+
+type Connections = Arc<Mutex<HashMap<u64, TcpStream>>>;
+
+/*
+Just enough HTTP/1.1 for the agency wire protocol: every request is a POST with a Content-Length body,
+answered with the packed response. Connections are kept alive, so the client can reuse them like it
+would with a real agency. Every accepted connection gets its own thread blocked reading the next request
+until keep-alive timeout, so a request is picked up as soon as it arrives however many connections sit
+idle. Requests read are handed to a fixed set of workers running the handler through a shared queue,
+which bounds how many requests are handled at once. Stopping the server shuts down all connections,
+waking up their threads.
+ */
+pub struct HttpServer {
+    address: SocketAddr,
+    stop: Arc<AtomicBool>,
+    connections: Connections,
+    threads: Vec<thread::JoinHandle<()>>,
+}
+
+impl HttpServer {
+    pub fn start(address: &str, workers: usize, handler: Handler) -> AgencyClientResult<HttpServer> {
+        let listener = TcpListener::bind(address)
+            .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::IOError, format!("Cannot bind mock agency to {}: {}", address, err)))?;
+        let address = listener.local_addr()
+            .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::IOError, format!("Cannot get mock agency address: {}", err)))?;
+        let stop = Arc::new(AtomicBool::new(false));
+        let connections: Connections = Arc::new(Mutex::new(HashMap::new()));
+
+        let (sender, receiver) = channel::<Job>();
+        let receiver = Arc::new(Mutex::new(receiver));
+        let mut threads = Vec::new();
+        for i in 0..workers.max(1) {
+            let receiver = receiver.clone();
+            let handler = handler.clone();
+            let stop = stop.clone();
+            threads.push(_spawn(format!("vcx-mock-agency-{}", i), move || _work(receiver, handler, stop))?);
+        }
+
+        let acceptor_stop = stop.clone();
+        let acceptor_connections = connections.clone();
+        threads.push(_spawn("vcx-mock-agency-acceptor".to_string(), move || {
+            let mut next_id = 0u64;
+            for stream in listener.incoming() {
+                let stream = match stream {
+                    Ok(stream) => stream,
+                    Err(err) => {
+                        warn!("HttpServer >>> failed to accept connection: {}", err);
+                        continue;
+                    }
+                };
+                next_id += 1;
+                let id = next_id;
+                {
+                    // checked under the lock, so a connection is either shut down by `stop` or never served
+                    let mut connections = acceptor_connections.lock().unwrap();
+                    if acceptor_stop.load(Ordering::Relaxed) {
+                        break;
+                    }
+                    match stream.try_clone() {
+                        Ok(clone) => { connections.insert(id, clone); }
+                        Err(err) => {
+                            warn!("HttpServer >>> failed to register connection: {}", err);
+                            continue;
+                        }
+                    }
+                }
+                let jobs = sender.clone();
+                let connections = acceptor_connections.clone();
+                let spawned = _spawn(format!("vcx-mock-agency-connection-{}", id), move || {
+                    if let Err(err) = _serve(stream, &jobs) {
+                        debug!("HttpServer >>> connection closed: {}", err);
+                    }
+                    connections.lock().unwrap().remove(&id);
+                });
+                if let Err(err) = spawned {
+                    warn!("HttpServer >>> {}", err);
+                    if let Some(stream) = acceptor_connections.lock().unwrap().remove(&id) {
+                        stream.shutdown(Shutdown::Both).ok();
+                    }
+                }
+            }
+        })?);
+
+        Ok(HttpServer { address, stop, connections, threads })
+    }
+
+    pub fn address(&self) -> SocketAddr {
+        self.address
+    }
+
+    pub fn stop(&mut self) {
+        if self.stop.swap(true, Ordering::Relaxed) {
+            return;
+        }
+        // wakes up the acceptor blocked in accept
+        TcpStream::connect(self.address).ok();
+        for (_, stream) in self.connections.lock().unwrap().drain() {
+            stream.shutdown(Shutdown::Both).ok();
+        }
+        for thread in self.threads.drain(..) {
+            thread.join().ok();
+        }
+    }
+}
+
+impl Drop for HttpServer {
+    fn drop(&mut self) {
+        self.stop();
+    }
+}
+
+fn _spawn<F: FnOnce() + Send + 'static>(name: String, f: F) -> AgencyClientResult<thread::JoinHandle<()>> {
+    thread::Builder::new()
+        .name(name)
+        .spawn(f)
+        .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::IOError, format!("Cannot spawn mock agency thread: {}", err)))
+}
+
+fn _work(receiver: Arc<Mutex<Receiver<Job>>>, handler: Handler, stop: Arc<AtomicBool>) {
+    while !stop.load(Ordering::Relaxed) {
+        let job = match receiver.lock() {
+            Ok(receiver) => match receiver.recv_timeout(POLL_INTERVAL) {
+                Ok(job) => job,
+                Err(RecvTimeoutError::Timeout) => continue,
+                Err(RecvTimeoutError::Disconnected) => return
+            },
+            Err(_) => return
+        };
+        job.reply.send(handler(job.body)).ok();
+    }
+}
+
+///
+/// Serves requests of the connection one by one until the peer closes it, asks for it to be closed,
+/// or keeps it idle longer than keep-alive timeout.
+///
+fn _serve(stream: TcpStream, jobs: &Sender<Job>) -> std::io::Result<()> {
+    let mut reader = BufReader::new(stream);
+    let served = loop {
+        if let Err(err) = reader.get_ref().set_read_timeout(Some(KEEP_ALIVE_TIMEOUT)) {
+            break Err(err);
+        }
+        let request = match _read_request(&mut reader) {
+            Ok(Some(request)) => request,
+            Ok(None) => break Ok(()),
+            Err(err) => break Err(err)
+        };
+        let (reply, response) = channel();
+        if jobs.send(Job { body: request.body, reply }).is_err() {
+            break Ok(());
+        }
+        // reply is dropped without answer only when the server is stopping
+        let written = match response.recv() {
+            Ok(Ok(body)) => _write_response(reader.get_ref(), "200 OK", &body, request.keep_alive),
+            Ok(Err(err)) => {
+                warn!("HttpServer >>> failed to handle request: {}", err);
+                _write_response(reader.get_ref(), "400 Bad Request", err.to_string().as_bytes(), request.keep_alive)
+            }
+            Err(_) => break Ok(())
+        };
+        if written.is_err() || !request.keep_alive {
+            break written;
+        }
+    };
+    reader.get_ref().shutdown(Shutdown::Both).ok();
+    served
+}
+
+fn _read_request(reader: &mut BufReader<TcpStream>) -> std::io::Result<Option<Request>> {
+    let mut line = String::new();
+    if reader.read_line(&mut line)? == 0 {
+        return Ok(None);
+    }
+    // keep-alive timeout applies to waiting for a request, the request itself must arrive in time
+    reader.get_ref().set_read_timeout(Some(REQUEST_TIMEOUT))?;
+    let mut request_line = line.split_whitespace();
+    let method = request_line.next().unwrap_or_default().to_string();
+    let version = request_line.nth(1).unwrap_or_default().to_string();
+    let mut keep_alive = version == "HTTP/1.1";
+    let mut content_length = None;
+
+    for _ in 0..MAX_HEADER_LINES {
+        line.clear();
+        if reader.read_line(&mut line)? == 0 {
+            return Ok(None);
+        }
+        let header = line.trim_end();
+        if header.is_empty() {
+            break;
+        }
+        let mut parts = header.splitn(2, ':');
+        let name = parts.next().unwrap_or_default().trim().to_lowercase();
+        let value = parts.next().unwrap_or_default().trim();
+        match name.as_str() {
+            "content-length" => content_length = value.parse::<usize>().ok(),
+            "connection" => keep_alive = !value.eq_ignore_ascii_case("close"),
+            _ => {}
+        }
+    }
+
+    if method != "POST" {
+        return Err(std::io::Error::new(ErrorKind::InvalidData, format!("Unsupported method {}", method)));
+    }
+    let content_length = content_length
+        .filter(|length| *length <= MAX_BODY_SIZE)
+        .ok_or_else(|| std::io::Error::new(ErrorKind::InvalidData, "Missing or too large Content-Length"))?;
+
+    let mut body = vec![0u8; content_length];
+    reader.read_exact(&mut body)?;
+    Ok(Some(Request { body, keep_alive }))
+}
+
+fn _write_response(mut stream: &TcpStream, status: &str, body: &[u8], keep_alive: bool) -> std::io::Result<()> {
+    let head = format!("HTTP/1.1 {}\r\nContent-Type: application/ssi-agent-wire\r\nContent-Length: {}\r\nConnection: {}\r\n\r\n",
+                       status, body.len(), if keep_alive { "keep-alive" } else { "close" });
+    stream.write_all(head.as_bytes())?;
+    stream.write_all(body)?;
+    stream.flush()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn _post(stream: &mut TcpStream, body: &[u8]) -> Vec<u8> {
+        let head = format!("POST /agency/msg HTTP/1.1\r\nContent-Length: {}\r\n\r\n", body.len());
+        stream.write_all(head.as_bytes()).unwrap();
+        stream.write_all(body).unwrap();
+        let mut reader = BufReader::new(stream);
+        let mut content_length = 0;
+        let mut line = String::new();
+        while reader.read_line(&mut line).unwrap() > 2 {
+            if let Some(value) = line.to_lowercase().strip_prefix("content-length:") {
+                content_length = value.trim().parse().unwrap();
+            }
+            line.clear();
+        }
+        let mut response = vec![0u8; content_length];
+        reader.read_exact(&mut response).unwrap();
+        response
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_idle_keep_alive_connection_does_not_hold_worker() {
+        let server = HttpServer::start("127.0.0.1:0", 1, Arc::new(|request: Vec<u8>| Ok(request))).unwrap();
+
+        let mut idle = TcpStream::connect(server.address()).unwrap();
+        assert_eq!(_post(&mut idle, b"first"), b"first");
+
+        let mut other = TcpStream::connect(server.address()).unwrap();
+        other.set_read_timeout(Some(Duration::from_secs(5))).unwrap();
+        assert_eq!(_post(&mut other, b"second"), b"second");
+        assert_eq!(_post(&mut idle, b"third"), b"third");
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_idle_connections_do_not_delay_requests() {
+        let server = HttpServer::start("127.0.0.1:0", 1, Arc::new(|request: Vec<u8>| Ok(request))).unwrap();
+
+        let idle: Vec<TcpStream> = (0..50)
+            .map(|_| {
+                let mut stream = TcpStream::connect(server.address()).unwrap();
+                assert_eq!(_post(&mut stream, b"idle"), b"idle");
+                stream
+            })
+            .collect();
+
+        let mut active = TcpStream::connect(server.address()).unwrap();
+        active.set_read_timeout(Some(Duration::from_secs(5))).unwrap();
+        let started = std::time::Instant::now();
+        for _ in 0..20 {
+            assert_eq!(_post(&mut active, b"active"), b"active");
+        }
+        // polling idle connections in turn used to add milliseconds per idle connection to every request
+        assert!(started.elapsed() < Duration::from_secs(2), "requests took {:?}", started.elapsed());
+        drop(idle);
+    }
+}
@@ -0,0 +1,418 @@
+use std::collections::{BTreeMap, HashMap};
+use std::process;
+use std::sync::{Arc, RwLock, RwLockReadGuard, RwLockWriteGuard};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+use futures::Future;
+use indy::{crypto, did, wallet, WalletHandle};
+use serde_json::Value;
+
+use crate::{A2AMessageKinds, MessageStatusCode};
+use crate::error::{AgencyClientError, AgencyClientErrorKind, AgencyClientResult};
+use crate::message_type::MessageTypes;
+
+use self::http::HttpServer;
+
+mod http;
+
+pub const DEFAULT_MOCK_AGENCY_ADDRESS: &str = "127.0.0.1:0";
+pub const DEFAULT_MOCK_AGENCY_WORKERS: usize = 16;
+
+static WALLET_COUNTER: AtomicUsize = AtomicUsize::new(0);
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct MockAgencyConfig {
+    pub address: String,
+    pub seed: Option<String>,
+    pub workers: usize,
+}
+
+impl Default for MockAgencyConfig {
+    fn default() -> MockAgencyConfig {
+        MockAgencyConfig {
+            address: DEFAULT_MOCK_AGENCY_ADDRESS.to_string(),
+            seed: None,
+            workers: DEFAULT_MOCK_AGENCY_WORKERS,
+        }
+    }
+}
+
+#[derive(Debug, Clone)]
+enum RouteOwner {
+    Agency,
+    AgencyPairwise,
+    Agent,
+    PairwiseAgent { agent_did: String, pw_did: String, pw_vk: String },
+}
+
+#[derive(Debug, Clone)]
+struct Route {
+    vk: String,
+    owner: RouteOwner,
+}
+
+#[derive(Debug, Clone)]
+struct StoredMessage {
+    uid: String,
+    status_code: String,
+    payload: Value,
+}
+
+impl StoredMessage {
+    fn to_json(&self, exclude_payload: bool) -> Value {
+        let mut message = json!({
+            "statusCode": self.status_code,
+            "uid": self.uid,
+            "refMsgId": null,
+        });
+        if !exclude_payload {
+            message["payload"] = self.payload.clone();
+        }
+        message
+    }
+}
+
+#[derive(Debug, Default)]
+struct AgencyState {
+    routes: HashMap<String, Route>,
+    dids_by_vk: HashMap<String, String>,
+    pairwise_agents_by_pw_vk: HashMap<String, String>,
+    connections_by_agent: HashMap<String, BTreeMap<String, String>>,
+    messages: HashMap<String, Vec<StoredMessage>>,
+    com_methods: HashMap<String, Value>,
+    next_uid: u64,
+}
+
+impl AgencyState {
+    fn add_route(&mut self, did: &str, vk: &str, owner: RouteOwner) {
+        if let RouteOwner::PairwiseAgent { ref agent_did, ref pw_did, ref pw_vk } = owner {
+            self.connections_by_agent.entry(agent_did.to_string()).or_default().insert(pw_did.to_string(), did.to_string());
+            self.pairwise_agents_by_pw_vk.insert(pw_vk.to_string(), did.to_string());
+        }
+        self.dids_by_vk.insert(vk.to_string(), did.to_string());
+        self.routes.insert(did.to_string(), Route { vk: vk.to_string(), owner });
+    }
+
+    fn route_by_vk(&self, vk: &str) -> Option<(String, Route)> {
+        let did = self.dids_by_vk.get(vk)?;
+        self.routes.get(did).map(|route| (did.clone(), route.clone()))
+    }
+
+    fn store_message(&mut self, pairwise_agent_did: &str, payload: Value) -> String {
+        self.next_uid += 1;
+        let uid = format!("mock-{}", self.next_uid);
+        self.messages.entry(pairwise_agent_did.to_string()).or_default().push(StoredMessage {
+            uid: uid.clone(),
+            status_code: MessageStatusCode::Received.to_string(),
+            payload,
+        });
+        uid
+    }
+
+    fn messages(&self, pairwise_agent_did: &str, query: &Value) -> Vec<Value> {
+        let uids = _string_list(&query["uids"]);
+        let status_codes = _string_list(&query["statusCodes"]);
+        let exclude_payload = query["excludePayload"].as_str() == Some("Y");
+        self.messages.get(pairwise_agent_did)
+            .map(|messages| messages.iter()
+                .filter(|message| uids.as_ref().map_or(true, |uids| uids.contains(&message.uid)))
+                .filter(|message| status_codes.as_ref().map_or(true, |codes| codes.contains(&message.status_code)))
+                .map(|message| message.to_json(exclude_payload))
+                .collect())
+            .unwrap_or_default()
+    }
+
+    fn update_status(&mut self, pairwise_agent_did: &str, uids: &[String], status_code: &str) -> Vec<String> {
+        let mut updated = Vec::new();
+        if let Some(messages) = self.messages.get_mut(pairwise_agent_did) {
+            for message in messages.iter_mut().filter(|message| uids.contains(&message.uid)) {
+                message.status_code = status_code.to_string();
+                updated.push(message.uid.clone());
+            }
+        }
+        updated
+    }
+}
+
+struct AgencyWallet {
+    handle: WalletHandle,
+    config: String,
+    credentials: String,
+}
+
+impl AgencyWallet {
+    fn create() -> AgencyClientResult<AgencyWallet> {
+        let nanos = SystemTime::now().duration_since(UNIX_EPOCH).map(|time| time.as_nanos()).unwrap_or_default();
+        let name = format!("mock_agency_{}_{}_{}", process::id(), nanos, WALLET_COUNTER.fetch_add(1, Ordering::SeqCst));
+        let config = json!({"id": name}).to_string();
+        let credentials = json!({"key": name, "key_derivation_method": "ARGON2I_INT"}).to_string();
+        wallet::create_wallet(&config, &credentials).wait()?;
+        let handle = wallet::open_wallet(&config, &credentials).wait()?;
+        Ok(AgencyWallet { handle, config, credentials })
+    }
+
+    fn create_did(&self, seed: Option<&str>) -> AgencyClientResult<(String, String)> {
+        did::create_and_store_my_did(self.handle, &json!({"seed": seed}).to_string())
+            .wait()
+            .map_err(AgencyClientError::from)
+    }
+}
+
+impl Drop for AgencyWallet {
+    fn drop(&mut self) {
+        if let Err(err) = wallet::close_wallet(self.handle).wait() {
+            warn!("MockAgency >>> failed to close wallet: {}", err);
+        }
+        if let Err(err) = wallet::delete_wallet(&self.config, &self.credentials).wait() {
+            warn!("MockAgency >>> failed to delete wallet: {}", err);
+        }
+    }
+}
+
+struct Agency {
+    wallet: AgencyWallet,
+    state: RwLock<AgencyState>,
+}
+
+/*
+Local stand-in for the cloud agency, serving the agency wire protocol over HTTP with real packing, so
+end-to-end flows and load tests can run without a deployed agency. It keeps its keys in its own wallet
+and everything else in memory. Besides the endpoints used by connections (CreateKey, GetMessages,
+UpdateMessageStatusByConnections, UpdateComMethod and forwarding of messages between parties), it
+supports the onboarding messages, so agents can be provisioned against it as usual.
+ */
+pub struct MockAgency {
+    did: String,
+    verkey: String,
+    endpoint: String,
+    server: HttpServer,
+    _agency: Arc<Agency>,
+}
+
+impl MockAgency {
+    pub fn start(config: &MockAgencyConfig) -> AgencyClientResult<MockAgency> {
+        trace!("MockAgency::start >>> config: {:?}", config);
+        let wallet = AgencyWallet::create()?;
+        let (did, verkey) = wallet.create_did(config.seed.as_ref().map(String::as_str))?;
+        let mut state = AgencyState::default();
+        state.add_route(&did, &verkey, RouteOwner::Agency);
+        let agency = Arc::new(Agency { wallet, state: RwLock::new(state) });
+
+        let handler_agency = agency.clone();
+        let server = HttpServer::start(&config.address, config.workers, Arc::new(move |request: Vec<u8>| handler_agency.handle_packed(&request)))?;
+        let endpoint = format!("http://{}", server.address());
+        info!("MockAgency::start <<< did: {}, verkey: {}, endpoint: {}", did, verkey, endpoint);
+        Ok(MockAgency { did, verkey, endpoint, server, _agency: agency })
+    }
+
+    pub fn did(&self) -> &str {
+        &self.did
+    }
+
+    pub fn verkey(&self) -> &str {
+        &self.verkey
+    }
+
+    pub fn endpoint(&self) -> &str {
+        &self.endpoint
+    }
+
+    pub fn stop(mut self) {
+        self.server.stop();
+    }
+}
+
+impl Agency {
+    fn handle_packed(&self, packed: &[u8]) -> AgencyClientResult<Vec<u8>> {
+        let unpacked = crypto::unpack_message(self.wallet.handle, packed).wait()?;
+        let unpacked: Value = serde_json::from_slice(&unpacked)
+            .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::InvalidJson, format!("Cannot deserialize unpacked message: {}", err)))?;
+        let recipient_vk = _str_field(&unpacked, "recipient_verkey")?;
+        let message: Value = serde_json::from_str(_str_field(&unpacked, "message")?)
+            .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::InvalidJson, format!("Cannot deserialize message: {}", err)))?;
+        let (did, route) = self.read_state()?.route_by_vk(recipient_vk)
+            .ok_or(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, format!("No route for key {}", recipient_vk)))?;
+
+        let message_type = message["@type"].as_str().unwrap_or_default();
+        if message_type.ends_with("/FWD") {
+            return self.handle_packed(&_packed_bytes(&message["@msg"])?);
+        }
+        if message_type.ends_with("/forward") {
+            return self.handle_forward(&message);
+        }
+
+        let sender_vk = unpacked["sender_verkey"].as_str()
+            .ok_or(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, "Agency commands must be authcrypted"))?;
+        let response = self.handle_command(&did, &route, &message)?;
+        let response = json!(response).to_string();
+        crypto::pack_message(self.wallet.handle, response.as_bytes(), &json!([sender_vk]).to_string(), Some(&route.vk))
+            .wait()
+            .map_err(AgencyClientError::from)
+    }
+
+    // Forward messages between parties are routed through the agency key and then the pairwise agent key
+    // of the recipient, where the message is stored until downloaded.
+    fn handle_forward(&self, message: &Value) -> AgencyClientResult<Vec<u8>> {
+        let to = _str_field(message, "to")?;
+        if self.read_state()?.dids_by_vk.contains_key(to) {
+            return self.handle_packed(&_packed_bytes(&message["msg"])?);
+        }
+        let mut state = self.write_state()?;
+        let pairwise_agent_did = state.pairwise_agents_by_pw_vk.get(to).cloned()
+            .ok_or(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, format!("Unknown forward recipient {}", to)))?;
+        let uid = state.store_message(&pairwise_agent_did, message["msg"].clone());
+        trace!("MockAgency >>> stored message {} for {}", uid, pairwise_agent_did);
+        Ok(Vec::new())
+    }
+
+    fn handle_command(&self, did: &str, route: &Route, message: &Value) -> AgencyClientResult<Value> {
+        let name = message["@type"].as_str().and_then(|message_type| message_type.rsplit('/').next()).unwrap_or_default();
+        trace!("MockAgency >>> {} for route {} ({:?})", name, did, route.owner);
+        match (&route.owner, name) {
+            (RouteOwner::Agency, "CONNECT") => {
+                let (pw_did, pw_vk) = self.create_route(RouteOwner::AgencyPairwise)?;
+                Ok(_response(A2AMessageKinds::Connected, json!({"withPairwiseDID": pw_did, "withPairwiseDIDVerKey": pw_vk})))
+            }
+            (RouteOwner::AgencyPairwise, "SIGNUP") => Ok(_response(A2AMessageKinds::SignedUp, json!({}))),
+            (RouteOwner::AgencyPairwise, "CREATE_AGENT") => {
+                let (agent_did, agent_vk) = self.create_route(RouteOwner::Agent)?;
+                Ok(_response(A2AMessageKinds::AgentCreated, json!({"withPairwiseDID": agent_did, "withPairwiseDIDVerKey": agent_vk})))
+            }
+            (RouteOwner::Agent, "CREATE_KEY") => {
+                let pw_did = _str_field(message, "forDID")?.to_string();
+                let pw_vk = _str_field(message, "forDIDVerKey")?.to_string();
+                let (pairwise_agent_did, pairwise_agent_vk) = self.create_route(RouteOwner::PairwiseAgent { agent_did: did.to_string(), pw_did, pw_vk })?;
+                Ok(_response(A2AMessageKinds::KeyCreated, json!({"withPairwiseDID": pairwise_agent_did, "withPairwiseDIDVerKey": pairwise_agent_vk})))
+            }
+            (RouteOwner::Agent, "GET_MSGS_BY_CONNS") => {
+                let pairwise_dids = _string_list(&message["pairwiseDIDs"]);
+                let state = self.read_state()?;
+                let msgs_by_conns: Vec<Value> = state.connections_by_agent.get(did)
+                    .map(|connections| connections.iter()
+                        .filter(|(pw_did, _)| pairwise_dids.as_ref().map_or(true, |dids| dids.contains(pw_did)))
+                        .map(|(pw_did, pairwise_agent_did)| json!({"pairwiseDID": pw_did, "msgs": state.messages(pairwise_agent_did, message)}))
+                        .collect())
+                    .unwrap_or_default();
+                Ok(_response_named(A2AMessageKinds::GetMessagesByConnections, "MSGS_BY_CONNS", json!({"msgsByConns": msgs_by_conns})))
+            }
+            (RouteOwner::Agent, "UPDATE_MSG_STATUS_BY_CONNS") => {
+                let status_code = _str_field(message, "statusCode")?;
+                let mut state = self.write_state()?;
+                let mut updated_uids_by_conns = Vec::new();
+                for uids_by_conn in message["uidsByConns"].as_array().cloned().unwrap_or_default() {
+                    let pw_did = _str_field(&uids_by_conn, "pairwiseDID")?;
+                    let uids = _string_list(&uids_by_conn["uids"]).unwrap_or_default();
+                    let pairwise_agent_did = state.connections_by_agent.get(did).and_then(|connections| connections.get(pw_did)).cloned()
+                        .ok_or(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, format!("Unknown pairwise DID {}", pw_did)))?;
+                    let updated = state.update_status(&pairwise_agent_did, &uids, status_code);
+                    updated_uids_by_conns.push(json!({"pairwiseDID": pw_did, "uids": updated}));
+                }
+                Ok(_response(A2AMessageKinds::MessageStatusUpdatedByConnections, json!({"statusCode": status_code, "updatedUidsByConns": updated_uids_by_conns})))
+            }
+            (RouteOwner::Agent, "UPDATE_COM_METHOD") => {
+                let com_method = message["comMethod"].clone();
+                let id = _str_field(&com_method, "id")?.to_string();
+                self.write_state()?.com_methods.insert(did.to_string(), com_method);
+                Ok(_response(A2AMessageKinds::ComMethodUpdated, json!({"id": id})))
+            }
+            (RouteOwner::PairwiseAgent { .. }, "GET_MSGS") => {
+                let msgs = self.read_state()?.messages(did, message);
+                Ok(_response(A2AMessageKinds::Messages, json!({"msgs": msgs})))
+            }
+            (RouteOwner::PairwiseAgent { .. }, "UPDATE_CONN_STATUS") => {
+                let status_code = _str_field(message, "statusCode")?;
+                Ok(_response_named(A2AMessageKinds::UpdateConnectionStatus, "CONN_STATUS_UPDATED", json!({"statusCode": status_code})))
+            }
+            _ => Err(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, format!("Message {} is not supported for {:?}", name, route.owner)))
+        }
+    }
+
+    fn read_state(&self) -> AgencyClientResult<RwLockReadGuard<AgencyState>> {
+        self.state.read()
+            .map_err(|_| AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, "Mock agency state is poisoned"))
+    }
+
+    fn write_state(&self) -> AgencyClientResult<RwLockWriteGuard<AgencyState>> {
+        self.state.write()
+            .map_err(|_| AgencyClientError::from_msg(AgencyClientErrorKind::InvalidState, "Mock agency state is poisoned"))
+    }
+
+    fn create_route(&self, owner: RouteOwner) -> AgencyClientResult<(String, String)> {
+        let (did, vk) = self.wallet.create_did(None)?;
+        self.write_state()?.add_route(&did, &vk, owner);
+        Ok((did, vk))
+    }
+}
+
+fn _response(kind: A2AMessageKinds, mut fields: Value) -> Value {
+    fields["@type"] = json!(MessageTypes::build(kind));
+    fields
+}
+
+// Some responses have no kind of their own, they share the family of the request
+fn _response_named(kind: A2AMessageKinds, name: &str, mut fields: Value) -> Value {
+    let mut message_type = MessageTypes::build_v2(kind);
+    message_type.type_ = name.to_string();
+    fields["@type"] = json!(message_type);
+    fields
+}
+
+fn _str_field<'a>(value: &'a Value, field: &str) -> AgencyClientResult<&'a str> {
+    value[field].as_str()
+        .ok_or(AgencyClientError::from_msg(AgencyClientErrorKind::InvalidJson, format!("Missing field {}", field)))
+}
+
+fn _string_list(value: &Value) -> Option<Vec<String>> {
+    value.as_array().map(|values| values.iter().filter_map(|value| value.as_str().map(String::from)).collect())
+}
+
+fn _packed_bytes(value: &Value) -> AgencyClientResult<Vec<u8>> {
+    serde_json::to_vec(value)
+        .map_err(|err| AgencyClientError::from_msg(AgencyClientErrorKind::SerializationError, format!("Cannot serialize packed message: {}", err)))
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn _state() -> AgencyState {
+        let mut state = AgencyState::default();
+        state.add_route("agent_did", "agent_vk", RouteOwner::Agent);
+        state.add_route("pw_agent_did", "pw_agent_vk", RouteOwner::PairwiseAgent {
+            agent_did: "agent_did".to_string(),
+            pw_did: "pw_did".to_string(),
+            pw_vk: "pw_vk".to_string(),
+        });
+        state
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_pairwise_agent_routes_are_indexed() {
+        let state = _state();
+        assert_eq!(state.route_by_vk("pw_agent_vk").unwrap().0, "pw_agent_did");
+        assert_eq!(state.pairwise_agents_by_pw_vk.get("pw_vk").unwrap(), "pw_agent_did");
+        assert_eq!(state.connections_by_agent.get("agent_did").unwrap().get("pw_did").unwrap(), "pw_agent_did");
+        assert!(state.route_by_vk("unknown_vk").is_none());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_stored_messages_are_filtered_and_updated() {
+        let mut state = _state();
+        let uid_1 = state.store_message("pw_agent_did", json!({"protected": "1"}));
+        let uid_2 = state.store_message("pw_agent_did", json!({"protected": "2"}));
+
+        assert_eq!(state.messages("pw_agent_did", &json!({})).len(), 2);
+        let messages = state.messages("pw_agent_did", &json!({"uids": [uid_1], "excludePayload": "Y"}));
+        assert_eq!(messages.len(), 1);
+        assert!(messages[0].get("payload").is_none());
+
+        assert_eq!(state.update_status("pw_agent_did", &[uid_2.clone()], "MS-106"), vec![uid_2.clone()]);
+        let messages = state.messages("pw_agent_did", &json!({"statusCodes": ["MS-103"]}));
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0]["uid"], json!(uid_1));
+        assert_eq!(messages[0]["payload"], json!({"protected": "1"}));
+    }
+}
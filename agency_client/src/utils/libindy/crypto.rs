@@ -1,9 +1,17 @@
+use std::sync::Arc;
+
 use futures::Future;
 use indy::crypto;
 
 use crate::error::AgencyClientResult;
+use crate::metrics;
 use crate::mocking::agency_mocks_enabled;
 
+lazy_static! {
+    static ref AGENCY_PACK_MESSAGE: Arc<metrics::Histogram> = metrics::histogram("agency_pack_message");
+    static ref AGENCY_UNPACK_MESSAGE: Arc<metrics::Histogram> = metrics::histogram("agency_unpack_message");
+}
+
 pub fn pack_message(sender_vk: Option<&str>, receiver_keys: &str, msg: &[u8]) -> AgencyClientResult<Vec<u8>> {
     trace!("pack_message >>> sender_vk: {:?}, receiver_keys: {}, msg: ...", sender_vk, receiver_keys);
     if agency_mocks_enabled() {
@@ -11,8 +19,7 @@ pub fn pack_message(sender_vk: Option<&str>, receiver_keys: &str, msg: &[u8]) ->
         return Ok(msg.to_vec());
     }
 
-    crypto::pack_message(crate::utils::wallet::get_wallet_handle(), msg, receiver_keys, sender_vk)
-        .wait()
+    AGENCY_PACK_MESSAGE.time(|| crypto::pack_message(crate::utils::wallet::get_wallet_handle(), msg, receiver_keys, sender_vk).wait())
         .map_err(|err| err.into())
 }
 
@@ -22,7 +29,6 @@ pub fn unpack_message(msg: &[u8]) -> AgencyClientResult<Vec<u8>> {
         return Ok(msg.to_vec());
     }
 
-    crypto::unpack_message(crate::utils::wallet::get_wallet_handle(), msg)
-        .wait()
+    AGENCY_UNPACK_MESSAGE.time(|| crypto::unpack_message(crate::utils::wallet::get_wallet_handle(), msg).wait())
         .map_err(|err| err.into())
 }
@@ -0,0 +1,89 @@
+use criterion::{BatchSize, black_box, Criterion, criterion_group, criterion_main};
+
+use aries_vcx::agency_client::mocking::AgencyMockDecrypted;
+use aries_vcx::libindy::utils::crypto::create_key;
+use aries_vcx::messages::a2a::A2AMessage;
+use aries_vcx::messages::connection::did_doc::DidDoc;
+use aries_vcx::messages::connection::did_doc::test_utils::_service_endpoint;
+use aries_vcx::utils::devsetup::{SetupLibraryWallet, SetupMocks};
+use aries_vcx::utils::encryption_envelope::EncryptionEnvelope;
+use aries_vcx::utils::mockdata::mockdata_connection::{ARIES_CONNECTION_ACK, ARIES_CONNECTION_INVITATION, ARIES_CONNECTION_REQUEST, ARIES_CONNECTION_RESPONSE};
+use aries_vcx::utils::mockdata::mockdata_credex::{ARIES_CREDENTIAL_OFFER, ARIES_CREDENTIAL_REQUEST, ARIES_CREDENTIAL_RESPONSE};
+use aries_vcx::utils::mockdata::mockdata_oob::ARIES_OOB_MESSAGE;
+use aries_vcx::utils::mockdata::mockdata_proof::{ARIES_PROOF_PRESENTATION, ARIES_PROOF_REQUEST_PRESENTATION};
+
+fn _messages() -> Vec<(&'static str, &'static str)> {
+    vec![
+        ("connection_invitation", ARIES_CONNECTION_INVITATION),
+        ("connection_request", ARIES_CONNECTION_REQUEST),
+        ("connection_response", ARIES_CONNECTION_RESPONSE),
+        ("connection_ack", ARIES_CONNECTION_ACK),
+        ("credential_offer", ARIES_CREDENTIAL_OFFER),
+        ("credential_request", ARIES_CREDENTIAL_REQUEST),
+        ("credential", ARIES_CREDENTIAL_RESPONSE),
+        ("presentation_request", ARIES_PROOF_REQUEST_PRESENTATION),
+        ("presentation", ARIES_PROOF_PRESENTATION),
+        ("out_of_band", ARIES_OOB_MESSAGE),
+    ]
+}
+
+fn bench_a2a_message(c: &mut Criterion) {
+    let mut group = c.benchmark_group("a2a_message");
+    for (name, json) in _messages() {
+        let message: A2AMessage = serde_json::from_str(json).unwrap();
+        group.bench_function(format!("deserialize/{}", name), |b| {
+            b.iter(|| serde_json::from_str::<A2AMessage>(black_box(json)).unwrap())
+        });
+        group.bench_function(format!("serialize/{}", name), |b| {
+            b.iter(|| serde_json::to_string(black_box(&message)).unwrap())
+        });
+    }
+    group.finish();
+}
+
+fn _did_doc(recipient_key: String, routing_keys: Vec<String>) -> DidDoc {
+    let mut did_doc = DidDoc::default();
+    did_doc.set_service_endpoint(_service_endpoint());
+    did_doc.set_keys(vec![recipient_key], routing_keys);
+    did_doc
+}
+
+fn bench_encryption_envelope(c: &mut Criterion) {
+    let mut group = c.benchmark_group("encryption_envelope");
+    let message: A2AMessage = serde_json::from_str(ARIES_CREDENTIAL_OFFER).unwrap();
+
+    {
+        let _setup = SetupMocks::init();
+        group.bench_function("unpack/decrypted_mock", |b| {
+            b.iter_batched(|| AgencyMockDecrypted::set_next_decrypted_message(ARIES_CREDENTIAL_OFFER),
+                           |_| EncryptionEnvelope::anon_unpack(vec![]).unwrap(),
+                           BatchSize::SmallInput)
+        });
+    }
+
+    // Packing is done by libindy with keys of a local wallet, so it needs no ledger nor agency
+    let _setup = SetupLibraryWallet::init();
+    let sender_vk = create_key(None).unwrap();
+    let recipient_vk = create_key(None).unwrap();
+    let routing_keys = vec![create_key(None).unwrap(), create_key(None).unwrap()];
+
+    let did_doc = _did_doc(recipient_vk.clone(), vec![]);
+    group.bench_function("pack/direct", |b| {
+        b.iter(|| EncryptionEnvelope::create(black_box(&message), Some(&sender_vk), &did_doc).unwrap())
+    });
+    let envelope = EncryptionEnvelope::create(&message, Some(&sender_vk), &did_doc).unwrap();
+    group.bench_function("unpack/direct", |b| {
+        b.iter_batched(|| envelope.0.clone(),
+                       |payload| EncryptionEnvelope::auth_unpack(payload, &sender_vk).unwrap(),
+                       BatchSize::SmallInput)
+    });
+
+    let routed_did_doc = _did_doc(recipient_vk.clone(), routing_keys);
+    group.bench_function("pack/routed", |b| {
+        b.iter(|| EncryptionEnvelope::create(black_box(&message), Some(&sender_vk), &routed_did_doc).unwrap())
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_a2a_message, bench_encryption_envelope);
+criterion_main!(benches);
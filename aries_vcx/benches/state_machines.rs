@@ -0,0 +1,124 @@
+#[macro_use]
+extern crate serde_json;
+
+use criterion::{BatchSize, Criterion, criterion_group, criterion_main};
+
+use aries_vcx::error::VcxResult;
+use aries_vcx::handlers::connection::connection::Connection;
+use aries_vcx::handlers::issuance::holder::holder::Holder;
+use aries_vcx::handlers::issuance::issuer::issuer::{Issuer, IssuerConfig};
+use aries_vcx::handlers::proof_presentation::prover::prover::Prover;
+use aries_vcx::handlers::proof_presentation::verifier::verifier::Verifier;
+use aries_vcx::messages::a2a::A2AMessage;
+use aries_vcx::messages::ack::test_utils::_ack;
+use aries_vcx::messages::issuance::credential::test_utils::_credential;
+use aries_vcx::messages::issuance::credential_offer::test_utils::_credential_offer;
+use aries_vcx::messages::issuance::credential_request::test_utils::{_credential_request, _my_pw_did};
+use aries_vcx::messages::proof_presentation::presentation::test_utils::_presentation;
+use aries_vcx::messages::proof_presentation::presentation_request::test_utils::_presentation_request;
+use aries_vcx::utils::constants::{REQUESTED_ATTRS, REQUESTED_PREDICATES};
+use aries_vcx::utils::devsetup::SetupMocks;
+use aries_vcx::utils::mockdata::mockdata_connection::{ARIES_CONNECTION_ACK, ARIES_CONNECTION_REQUEST};
+
+fn _send_message(_message: &A2AMessage) -> VcxResult<()> {
+    Ok(())
+}
+
+fn _credentials() -> String {
+    json!({
+        "attrs": {
+            "attribute_0": {
+                "credential": {
+                    "cred_info": {
+                        "attrs": {"name": "alice"},
+                        "cred_def_id": "V4SGRU86Z58d6TV7PBUe6f:3:CL:419:tag",
+                        "referent": "a1991de8-8317-43fd-98b3-63bac40b9e8b",
+                        "schema_id": "V4SGRU86Z58d6TV7PBUe6f:2:QcimrRShWQniqlHUtIDddYP0n:1.0"
+                    }
+                }
+            }
+        }
+    }).to_string()
+}
+
+fn bench_connection(c: &mut Criterion) {
+    let request: A2AMessage = serde_json::from_str(ARIES_CONNECTION_REQUEST).unwrap();
+    let ack: A2AMessage = serde_json::from_str(ARIES_CONNECTION_ACK).unwrap();
+
+    c.bench_function("state_machine/connection_inviter", |b| {
+        b.iter(|| {
+            let mut connection = Connection::create("bench", true).unwrap();
+            connection.connect().unwrap();
+            connection.update_state_with_message(&request).unwrap();
+            connection.update_state_with_message(&ack).unwrap();
+            connection
+        })
+    });
+}
+
+fn bench_issuance(c: &mut Criterion) {
+    let issuer_config = IssuerConfig {
+        cred_def_id: "cred_def_id".to_string(),
+        rev_reg_id: Some("TEST_REV_REG_ID".to_string()),
+        tails_file: Some("TEST_TAILS_FILE".to_string()),
+    };
+    let credential_data = json!({"name": "alice"}).to_string();
+
+    c.bench_function("state_machine/issuer", |b| {
+        b.iter_batched(|| Issuer::create(&issuer_config, &credential_data, "bench").unwrap(),
+                       |mut issuer| {
+                           issuer.send_credential_offer(_send_message, None).unwrap();
+                           issuer.step(A2AMessage::CredentialRequest(_credential_request()).into(), Some(&_send_message)).unwrap();
+                           issuer.send_credential(_send_message).unwrap();
+                           issuer
+                       },
+                       BatchSize::SmallInput)
+    });
+
+    c.bench_function("state_machine/holder", |b| {
+        b.iter_batched(|| Holder::create(_credential_offer(), "bench").unwrap(),
+                       |mut holder| {
+                           holder.send_request(_my_pw_did(), _send_message).unwrap();
+                           holder.step(A2AMessage::Credential(_credential()).into(), Some(&_send_message)).unwrap();
+                           holder
+                       },
+                       BatchSize::SmallInput)
+    });
+}
+
+fn bench_presentation(c: &mut Criterion) {
+    c.bench_function("state_machine/prover", |b| {
+        b.iter_batched(|| Prover::create("bench", _presentation_request()).unwrap(),
+                       |mut prover| {
+                           prover.generate_presentation(_credentials(), json!({}).to_string()).unwrap();
+                           prover.send_presentation(&_send_message).unwrap();
+                           prover.handle_message(A2AMessage::PresentationAck(_ack()).into(), Some(&_send_message)).unwrap();
+                           prover
+                       },
+                       BatchSize::SmallInput)
+    });
+
+    c.bench_function("state_machine/verifier", |b| {
+        b.iter_batched(|| Verifier::create("bench".to_string(),
+                                           REQUESTED_ATTRS.to_string(),
+                                           REQUESTED_PREDICATES.to_string(),
+                                           json!({}).to_string(),
+                                           "name".to_string()).unwrap(),
+                       |mut verifier| {
+                           verifier.send_presentation_request(_send_message, None).unwrap();
+                           verifier.step(A2AMessage::Presentation(_presentation()).into(), Some(&_send_message)).unwrap();
+                           verifier
+                       },
+                       BatchSize::SmallInput)
+    });
+}
+
+fn bench_state_machines(c: &mut Criterion) {
+    let _setup = SetupMocks::init();
+    bench_connection(c);
+    bench_issuance(c);
+    bench_presentation(c);
+}
+
+criterion_group!(benches, bench_state_machines);
+criterion_main!(benches);
@@ -1,12 +1,15 @@
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 
-use crate::agency_client::get_message::{get_connection_messages, Message};
+use crate::agency_client::get_message::{get_connection_messages, get_connection_messages_metadata, Message};
+use crate::agency_client::mocking::agency_mocks_enabled;
 use crate::agency_client::MessageStatusCode;
 use crate::agency_client::update_connection::send_delete_connection_message;
 use crate::agency_client::update_message::{UIDsByConn, update_messages as update_messages_status};
 use crate::error::prelude::*;
+use crate::handlers::connection::decrypted_messages::{self, DecryptedMessage};
+use crate::handlers::connection::message_sync;
 use crate::handlers::connection::pairwise_info::PairwiseInfo;
-use crate::messages::a2a::A2AMessage;
+use crate::messages::a2a::{A2AMessage, A2AMessageKind};
 use crate::settings;
 use crate::utils::encryption_envelope::EncryptionEnvelope;
 
@@ -39,6 +42,24 @@ pub fn create_agent_keys(source_id: &str, pw_did: &str, pw_verkey: &str) -> VcxR
     Ok((agent_did, agent_verkey))
 }
 
+fn _is_of_kinds(message: &str, kinds: Option<&[A2AMessageKind]>) -> bool {
+    match kinds {
+        Some(kinds) => A2AMessage::peek_type(message)
+            .map(|message_type| kinds.iter().any(|kind| kind.matches(&message_type)))
+            .unwrap_or(false),
+        None => true
+    }
+}
+
+fn _retain_kinds(a2a_messages: HashMap<String, A2AMessage>, kinds: Option<&[A2AMessageKind]>) -> HashMap<String, A2AMessage> {
+    match kinds {
+        Some(kinds) => a2a_messages.into_iter()
+            .filter(|(_, message)| kinds.iter().any(|kind| kind.matches_message(message)))
+            .collect(),
+        None => a2a_messages
+    }
+}
+
 fn _log_messages_optionally(_a2a_messages: &HashMap<String, A2AMessage>) {
     #[cfg(feature = "warnlog_fetched_messages")]
         {
@@ -49,6 +70,13 @@ fn _log_messages_optionally(_a2a_messages: &HashMap<String, A2AMessage>) {
         }
 }
 
+// agency will report the message again, so it must not be forgotten if the process exits before next download
+fn _record_processed(pw_did: &str, uid: &str) {
+    if let Err(err) = message_sync::mark_processed(pw_did, uid) {
+        warn!("Failed to record message {} of pw_did {} as processed: {}", uid, pw_did, err);
+    }
+}
+
 impl CloudAgentInfo {
     pub fn create(pairwise_info: &PairwiseInfo) -> VcxResult<CloudAgentInfo> {
         trace!("CloudAgentInfo::create >>> pairwise_info: {:?}", pairwise_info);
@@ -58,6 +86,8 @@ impl CloudAgentInfo {
 
     pub fn destroy(&self, pairwise_info: &PairwiseInfo) -> VcxResult<()> {
         trace!("CloudAgentInfo::delete >>>");
+        message_sync::clear_cursor(&pairwise_info.pw_did)?;
+        decrypted_messages::clear_messages(&pairwise_info.pw_did)?;
         send_delete_connection_message(&pairwise_info.pw_did, &pairwise_info.pw_vk, &self.agent_did, &self.agent_vk)
             .map_err(|err| err.into())
     }
@@ -74,26 +104,34 @@ impl CloudAgentInfo {
 
     pub fn update_message_status(&self, pairwise_info: &PairwiseInfo, uid: String) -> VcxResult<()> {
         trace!("CloudAgentInfo::update_message_status >>> uid: {:?}", uid);
+        decrypted_messages::remove_message(&pairwise_info.pw_did, &uid)?;
 
         let messages_to_update = vec![UIDsByConn {
             pairwise_did: pairwise_info.pw_did.clone(),
-            uids: vec![uid],
+            uids: vec![uid.clone()],
         }];
 
         update_messages_status(MessageStatusCode::Reviewed, messages_to_update)
-            .map_err(|err| err.into())
+            .map_err(|err| {
+                _record_processed(&pairwise_info.pw_did, &uid);
+                err.into()
+            })
     }
 
     pub fn reject_message(&self, pairwise_info: &PairwiseInfo, uid: String) -> VcxResult<()> {
         trace!("CloudAgentInfo::reject_message >>> uid: {:?}", uid);
+        decrypted_messages::remove_message(&pairwise_info.pw_did, &uid)?;
 
         let messages_to_reject = vec![UIDsByConn {
             pairwise_did: pairwise_info.pw_did.clone(),
-            uids: vec![uid],
+            uids: vec![uid.clone()],
         }];
 
         update_messages_status(MessageStatusCode::Rejected, messages_to_reject)
-            .map_err(|err| err.into())
+            .map_err(|err| {
+                _record_processed(&pairwise_info.pw_did, &uid);
+                err.into()
+            })
     }
 
     pub fn download_encrypted_messages(&self, msg_uid: Option<Vec<String>>, status_codes: Option<Vec<MessageStatusCode>>, pairwise_info: &PairwiseInfo) -> VcxResult<Vec<Message>> {
@@ -102,20 +140,124 @@ impl CloudAgentInfo {
             .map_err(|err| err.into())
     }
 
+    /**
+    Downloads received messages which were not processed yet. If updating status of some messages of
+    the connection failed after they were processed locally, only metadata of pending messages is
+    downloaded first and payloads are then fetched just for the new ones. Status update of the already
+    processed messages is retried.
+     */
+    pub fn download_new_encrypted_messages(&self, pairwise_info: &PairwiseInfo) -> VcxResult<Vec<Message>> {
+        self.download_new_encrypted_messages_skipping(pairwise_info, &HashSet::new())
+    }
+
+    /**
+    Same as download_new_encrypted_messages, but payloads of messages with `known_uids` are not
+    downloaded, these messages are returned just with their metadata.
+     */
+    pub fn download_new_encrypted_messages_skipping(&self, pairwise_info: &PairwiseInfo, known_uids: &HashSet<String>) -> VcxResult<Vec<Message>> {
+        trace!("CloudAgentInfo::download_new_encrypted_messages >>> known uids: {}", known_uids.len());
+        let cursor = message_sync::get_cursor(&pairwise_info.pw_did)?;
+        if (cursor.is_empty() && known_uids.is_empty()) || agency_mocks_enabled() {
+            return self.download_encrypted_messages(None, Some(vec![MessageStatusCode::Received]), pairwise_info);
+        }
+
+        let pending = get_connection_messages_metadata(&pairwise_info.pw_did, &pairwise_info.pw_vk, &self.agent_did, &self.agent_vk, Some(vec![MessageStatusCode::Received]))?;
+        let pending_uids: HashSet<&str> = pending.iter().map(|message| message.uid.as_str()).collect();
+        let (processed_uids, new_uids): (Vec<String>, Vec<String>) = pending.iter()
+            .map(|message| message.uid.clone())
+            .partition(|uid| cursor.is_processed(uid));
+        debug!("CloudAgentInfo::download_new_encrypted_messages >>> {} pending messages, {} already processed", pending.len(), processed_uids.len());
+
+        message_sync::retain_pending(&pairwise_info.pw_did, &pending_uids)?;
+        if !processed_uids.is_empty() {
+            let messages_to_update = vec![UIDsByConn { pairwise_did: pairwise_info.pw_did.clone(), uids: processed_uids }];
+            if let Err(err) = update_messages_status(MessageStatusCode::Reviewed, messages_to_update) {
+                warn!("CloudAgentInfo::download_new_encrypted_messages >>> failed to update status of processed messages: {}", err);
+            }
+        }
+        if new_uids.is_empty() {
+            return Ok(Vec::new());
+        }
+        let (known_new_uids, unknown_new_uids): (HashSet<String>, Vec<String>) = new_uids.into_iter()
+            .partition(|uid| known_uids.contains(uid));
+        let mut messages = if unknown_new_uids.is_empty() {
+            Vec::new()
+        } else {
+            self.download_encrypted_messages(Some(unknown_new_uids), Some(vec![MessageStatusCode::Received]), pairwise_info)?
+        };
+        messages.extend(pending.into_iter().filter(|message| known_new_uids.contains(&message.uid)));
+        Ok(messages)
+    }
+
+    /**
+    Downloads new messages and decrypts them. Messages decrypted by previous calls are taken from
+    cache and their payloads are not downloaded again.
+     */
+    fn get_decrypted_messages(&self, pairwise_info: &PairwiseInfo) -> VcxResult<Vec<(String, DecryptedMessage)>> {
+        let cached_uids = decrypted_messages::cached_uids(&pairwise_info.pw_did)?;
+        let messages = self.download_new_encrypted_messages_skipping(pairwise_info, &cached_uids)?;
+        debug!("CloudAgentInfo::get_decrypted_messages >>> obtained {} messages, {} decrypted before", messages.len(), cached_uids.len());
+
+        let pending_uids: HashSet<&str> = messages.iter().map(|message| message.uid.as_str()).collect();
+        decrypted_messages::retain_pending(&pairwise_info.pw_did, &pending_uids)?;
+
+        let mut decrypted = Vec::with_capacity(messages.len());
+        for message in messages.iter() {
+            let decrypted_message = match decrypted_messages::get_message(&pairwise_info.pw_did, &message.uid)? {
+                Some(decrypted_message) => decrypted_message,
+                None => {
+                    let (message_content, sender_vk) = EncryptionEnvelope::decrypt(message.payload()?)?;
+                    let decrypted_message = DecryptedMessage { message: message_content, sender_vk };
+                    decrypted_messages::store_message(&pairwise_info.pw_did, &message.uid, decrypted_message.clone())?;
+                    decrypted_message
+                }
+            };
+            decrypted.push((message.uid.clone(), decrypted_message));
+        }
+        Ok(decrypted)
+    }
+
     pub fn get_messages(&self, expect_sender_vk: &str, pairwise_info: &PairwiseInfo) -> VcxResult<HashMap<String, A2AMessage>> {
-        trace!("CloudAgentInfo::get_messages >>> expect_sender_vk: {}", expect_sender_vk);
-        let messages = self.download_encrypted_messages(None, Some(vec![MessageStatusCode::Received]), pairwise_info)?;
-        debug!("CloudAgentInfo::get_messages >>> obtained {} messages", messages.len());
-        let a2a_messages = self.decrypt_decode_messages(&messages, expect_sender_vk)?;
+        self.get_messages_of_kinds(expect_sender_vk, pairwise_info, None)
+    }
+
+    /**
+    Returns new messages of given kinds, or all new messages if no kinds are given. Messages of other
+    kinds are skipped right after reading their `@type`, they are neither authenticated nor deserialized.
+     */
+    pub fn get_messages_of_kinds(&self, expect_sender_vk: &str, pairwise_info: &PairwiseInfo, kinds: Option<&[A2AMessageKind]>) -> VcxResult<HashMap<String, A2AMessage>> {
+        trace!("CloudAgentInfo::get_messages_of_kinds >>> expect_sender_vk: {}, kinds: {:?}", expect_sender_vk, kinds);
+        if agency_mocks_enabled() {
+            let messages = self.download_new_encrypted_messages(pairwise_info)?;
+            let a2a_messages = _retain_kinds(self.decrypt_decode_messages(&messages, expect_sender_vk)?, kinds);
+            _log_messages_optionally(&a2a_messages);
+            return Ok(a2a_messages);
+        }
+        let mut a2a_messages: HashMap<String, A2AMessage> = HashMap::new();
+        for (uid, decrypted_message) in self.get_decrypted_messages(pairwise_info)? {
+            if !_is_of_kinds(&decrypted_message.message, kinds) {
+                continue;
+            }
+            EncryptionEnvelope::authenticate(decrypted_message.sender_vk.as_deref(), expect_sender_vk)?;
+            a2a_messages.insert(uid, EncryptionEnvelope::decode(&decrypted_message.message)?);
+        }
         _log_messages_optionally(&a2a_messages);
         Ok(a2a_messages)
     }
 
     pub fn get_messages_noauth(&self, pairwise_info: &PairwiseInfo) -> VcxResult<HashMap<String, A2AMessage>> {
         trace!("CloudAgentInfo::get_messages_noauth >>>");
-        let messages = self.download_encrypted_messages(None, Some(vec![MessageStatusCode::Received]), pairwise_info)?;
-        debug!("CloudAgentInfo::get_messages_noauth >>> obtained {} messages", messages.len());
-        let a2a_messages = self.decrypt_decode_messages_noauth(&messages)?;
+        if agency_mocks_enabled() {
+            let messages = self.download_new_encrypted_messages(pairwise_info)?;
+            debug!("CloudAgentInfo::get_messages_noauth >>> obtained {} messages", messages.len());
+            let a2a_messages = self.decrypt_decode_messages_noauth(&messages)?;
+            _log_messages_optionally(&a2a_messages);
+            return Ok(a2a_messages);
+        }
+        let mut a2a_messages: HashMap<String, A2AMessage> = HashMap::new();
+        for (uid, decrypted_message) in self.get_decrypted_messages(pairwise_info)? {
+            a2a_messages.insert(uid, EncryptionEnvelope::decode(&decrypted_message.message)?);
+        }
         _log_messages_optionally(&a2a_messages);
         Ok(a2a_messages)
     }
@@ -154,3 +296,49 @@ impl CloudAgentInfo {
         EncryptionEnvelope::anon_unpack(message.payload()?)
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use crate::agency_client::mocking::AgencyMockDecrypted;
+    use crate::utils::constants::GET_MESSAGES_DECRYPTED_RESPONSE;
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_download_new_encrypted_messages_keeps_processed_uids() {
+        let _setup = SetupMocks::init();
+        let pairwise_info = PairwiseInfo { pw_did: "download_new_messages_did".to_string(), pw_vk: String::new() };
+        let agent_info = CloudAgentInfo::default();
+
+        message_sync::mark_processed(&pairwise_info.pw_did, "uid1").unwrap();
+        message_sync::mark_processed(&pairwise_info.pw_did, "uid2").unwrap();
+
+        AgencyMockDecrypted::set_next_decrypted_response(GET_MESSAGES_DECRYPTED_RESPONSE);
+        let messages = agent_info.download_new_encrypted_messages(&pairwise_info).unwrap();
+        assert_eq!(messages.len(), 1);
+        assert_eq!(messages[0].uid, "0c6bd83f-1fd2-441d-a0b9-3293536afdb3");
+
+        let cursor = message_sync::get_cursor(&pairwise_info.pw_did).unwrap();
+        assert!(!cursor.has_unsaved_changes());
+        assert!(cursor.is_processed("uid1"));
+        assert!(cursor.is_processed("uid2"));
+
+        message_sync::clear_cursor(&pairwise_info.pw_did).unwrap();
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_updated_message_is_not_recorded_as_processed() {
+        let _setup = SetupMocks::init();
+        let pairwise_info = PairwiseInfo { pw_did: "updated_message_did".to_string(), pw_vk: String::new() };
+        let agent_info = CloudAgentInfo::default();
+
+        agent_info.update_message_status(&pairwise_info, "uid1".to_string()).unwrap();
+        agent_info.reject_message(&pairwise_info, "uid2".to_string()).unwrap();
+        assert!(message_sync::get_cursor(&pairwise_info.pw_did).unwrap().is_empty());
+
+        message_sync::clear_cursor(&pairwise_info.pw_did).unwrap();
+    }
+}
@@ -1,11 +1,13 @@
 use core::fmt;
 use std::collections::HashMap;
+use std::sync::Arc;
 
 use serde::{Deserialize, Deserializer, Serialize, Serializer};
 use serde::de::{Error, MapAccess, Visitor};
 use serde_json::Value;
 
 use agency_client::get_message::Message;
+use agency_client::metrics;
 use agency_client::MessageStatusCode;
 
 use crate::error::prelude::*;
@@ -15,8 +17,10 @@ use crate::handlers::connection::inviter::state_machine::{InviterFullState, Invi
 use crate::handlers::connection::public_agent::PublicAgent;
 use crate::handlers::connection::legacy_agent_info::LegacyAgentInfo;
 use crate::handlers::connection::pairwise_info::PairwiseInfo;
+use crate::handlers::connection::provisioned_pool::take_provisioned_pairwise;
+use crate::handlers::connection::send_queue::{enqueue_message, send_queue_enabled};
 use crate::handlers::connection::util::verify_thread_id;
-use crate::messages::a2a::A2AMessage;
+use crate::messages::a2a::{A2AMessage, A2AMessageKind};
 use crate::messages::basic_message::message::BasicMessage;
 use crate::messages::connection::did_doc::DidDoc;
 use crate::messages::connection::invite::Invitation;
@@ -25,6 +29,11 @@ use crate::messages::connection::request::Request;
 use crate::utils::send_message;
 use crate::utils::serialization::SerializableObjectWithState;
 
+lazy_static! {
+    static ref CONNECTION_INVITER_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("connection_inviter_transition");
+    static ref CONNECTION_INVITEE_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("connection_invitee_transition");
+}
+
 #[derive(Clone, PartialEq)]
 pub struct Connection {
     connection_sm: SmConnection,
@@ -79,8 +88,7 @@ impl Connection {
      */
     pub fn create(source_id: &str, autohop: bool) -> VcxResult<Connection> {
         trace!("Connection::create >>> source_id: {}", source_id);
-        let pairwise_info = PairwiseInfo::create()?;
-        let cloud_agent_info = CloudAgentInfo::create(&pairwise_info)?;
+        let (pairwise_info, cloud_agent_info) = take_provisioned_pairwise()?;
         Ok(Connection {
             cloud_agent_info,
             connection_sm: SmConnection::Inviter(SmConnectionInviter::new(source_id, pairwise_info, send_message)),
@@ -93,8 +101,7 @@ impl Connection {
      */
     pub fn create_with_invite(source_id: &str, invitation: Invitation, autohop_enabled: bool) -> VcxResult<Connection> {
         trace!("Connection::create_with_invite >>> source_id: {}", source_id);
-        let pairwise_info = PairwiseInfo::create()?;
-        let cloud_agent_info = CloudAgentInfo::create(&pairwise_info)?;
+        let (pairwise_info, cloud_agent_info) = take_provisioned_pairwise()?;
         let mut connection = Connection {
             cloud_agent_info,
             connection_sm: SmConnection::Invitee(SmConnectionInvitee::new(source_id, pairwise_info, send_message)),
@@ -306,8 +313,7 @@ impl Connection {
         trace!("Connection::process_request >>> request: {:?}", request);
         let (connection_sm, new_cloud_agent_info) = match &self.connection_sm {
             SmConnection::Inviter(sm_inviter) => {
-                let new_pairwise_info = PairwiseInfo::create()?;
-                let new_cloud_agent = CloudAgentInfo::create(&new_pairwise_info)?;
+                let (new_pairwise_info, new_cloud_agent) = take_provisioned_pairwise()?;
                 let new_routing_keys = new_cloud_agent.routing_keys()?;
                 let new_service_endpoint = new_cloud_agent.service_endpoint()?;
                 (SmConnection::Inviter(sm_inviter.clone().handle_connection_request(request, &new_pairwise_info, new_routing_keys, new_service_endpoint)?), new_cloud_agent)
@@ -381,10 +387,10 @@ impl Connection {
         };
         let (new_connection_sm, can_autohop) = match &self.connection_sm {
             SmConnection::Inviter(_) => {
-                self._step_inviter(message)?
+                CONNECTION_INVITER_TRANSITION.time(|| self._step_inviter(message))?
             }
             SmConnection::Invitee(_) => {
-                self._step_invitee(message)?
+                CONNECTION_INVITEE_TRANSITION.time(|| self._step_invitee(message))?
             }
         };
         *self = new_connection_sm;
@@ -447,8 +453,7 @@ impl Connection {
                 let (sm_inviter, new_cloud_agent_info, can_autohop) = match message {
                     Some(message) => match message {
                         A2AMessage::ConnectionRequest(request) => {
-                            let new_pairwise_info = PairwiseInfo::create()?;
-                            let new_cloud_agent = CloudAgentInfo::create(&new_pairwise_info)?;
+                            let (new_pairwise_info, new_cloud_agent) = take_provisioned_pairwise()?;
                             let new_routing_keys = new_cloud_agent.routing_keys()?;
                             let new_service_endpoint = new_cloud_agent.service_endpoint()?;
                             let sm_connection = sm_inviter.handle_connection_request(request, &new_pairwise_info, new_routing_keys, new_service_endpoint)?;
@@ -613,6 +618,15 @@ impl Connection {
         }
     }
 
+    /**
+    Get messages of given kinds received from connection counterparty. Messages of other kinds are not
+    deserialized.
+     */
+    pub fn get_messages_of_kinds(&self, kinds: &[A2AMessageKind]) -> VcxResult<HashMap<String, A2AMessage>> {
+        let expected_sender_vk = self.get_expected_sender_vk()?;
+        self.cloud_agent_info().get_messages_of_kinds(&expected_sender_vk, self.pairwise_info(), Some(kinds))
+    }
+
     fn get_expected_sender_vk(&self) -> VcxResult<String> {
         self.remote_vk()
             .map_err(|_err|
@@ -635,8 +649,13 @@ impl Connection {
         let did_doc = self.their_did_doc()
             .ok_or(VcxError::from_msg(VcxErrorKind::NotReady, "Cannot send message: Remote Connection information is not set"))?;
         let sender_vk = self.pairwise_info().pw_vk.clone();
+        let pw_did = self.pairwise_info().pw_did.clone();
         return Ok(move |a2a_message: &A2AMessage| {
-            send_message(&sender_vk, &did_doc, a2a_message)
+            if send_queue_enabled() {
+                enqueue_message(&pw_did, &sender_vk, &did_doc, a2a_message).map(|_| ())
+            } else {
+                send_message(&sender_vk, &did_doc, a2a_message)
+            }
         });
     }
 
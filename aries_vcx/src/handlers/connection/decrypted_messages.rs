@@ -0,0 +1,115 @@
+use std::collections::{HashMap, HashSet};
+use std::sync::RwLock;
+
+use crate::error::prelude::*;
+
+// Bound on cached messages per connection; messages are also dropped as soon as they are processed or
+// agency stops reporting them as pending, so this is only reached if a connection piles up messages
+// nobody handles.
+const MAX_CACHED_MESSAGES: usize = 200;
+
+lazy_static! {
+    static ref DECRYPTED_MESSAGES: RwLock<HashMap<String, HashMap<String, DecryptedMessage>>> = RwLock::new(HashMap::new());
+}
+
+/**
+Payload of a downloaded message after it was decrypted, but before it was deserialized into A2AMessage.
+Pending messages are downloaded again by every update of connection state, so they are cached
+per connection to decrypt each of them only once.
+ */
+#[derive(Debug, Clone, PartialEq)]
+pub struct DecryptedMessage {
+    pub message: String,
+    pub sender_vk: Option<String>,
+}
+
+pub fn get_message(pw_did: &str, uid: &str) -> VcxResult<Option<DecryptedMessage>> {
+    Ok(DECRYPTED_MESSAGES.read()?
+        .get(pw_did)
+        .and_then(|messages| messages.get(uid))
+        .cloned())
+}
+
+pub fn cached_uids(pw_did: &str) -> VcxResult<HashSet<String>> {
+    Ok(DECRYPTED_MESSAGES.read()?
+        .get(pw_did)
+        .map(|messages| messages.keys().cloned().collect())
+        .unwrap_or_default())
+}
+
+pub fn store_message(pw_did: &str, uid: &str, message: DecryptedMessage) -> VcxResult<()> {
+    let mut cache = DECRYPTED_MESSAGES.write()?;
+    let messages = cache.entry(pw_did.to_string()).or_default();
+    if messages.len() < MAX_CACHED_MESSAGES || messages.contains_key(uid) {
+        messages.insert(uid.to_string(), message);
+    }
+    Ok(())
+}
+
+/**
+Drops cached messages which agency no longer reports as pending.
+ */
+pub fn retain_pending(pw_did: &str, pending_uids: &HashSet<&str>) -> VcxResult<()> {
+    let mut cache = DECRYPTED_MESSAGES.write()?;
+    if let Some(messages) = cache.get_mut(pw_did) {
+        messages.retain(|uid, _| pending_uids.contains(uid.as_str()));
+        if messages.is_empty() {
+            cache.remove(pw_did);
+        }
+    }
+    Ok(())
+}
+
+pub fn remove_message(pw_did: &str, uid: &str) -> VcxResult<()> {
+    let mut cache = DECRYPTED_MESSAGES.write()?;
+    if let Some(messages) = cache.get_mut(pw_did) {
+        messages.remove(uid);
+        if messages.is_empty() {
+            cache.remove(pw_did);
+        }
+    }
+    Ok(())
+}
+
+pub fn clear_messages(pw_did: &str) -> VcxResult<()> {
+    DECRYPTED_MESSAGES.write()?.remove(pw_did);
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn _message(content: &str) -> DecryptedMessage {
+        DecryptedMessage { message: content.to_string(), sender_vk: Some("sender_vk".to_string()) }
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cache_stores_and_prunes_messages() {
+        let pw_did = "test_cache_stores_and_prunes_messages";
+        store_message(pw_did, "uid1", _message("msg1")).unwrap();
+        store_message(pw_did, "uid2", _message("msg2")).unwrap();
+        assert_eq!(get_message(pw_did, "uid1").unwrap(), Some(_message("msg1")));
+        assert_eq!(cached_uids(pw_did).unwrap().len(), 2);
+
+        remove_message(pw_did, "uid1").unwrap();
+        assert_eq!(get_message(pw_did, "uid1").unwrap(), None);
+
+        let pending: HashSet<&str> = vec!["uid3"].into_iter().collect();
+        retain_pending(pw_did, &pending).unwrap();
+        assert!(cached_uids(pw_did).unwrap().is_empty());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cache_is_bounded() {
+        let pw_did = "test_cache_is_bounded";
+        for i in 0..MAX_CACHED_MESSAGES + 10 {
+            store_message(pw_did, &format!("uid{}", i), _message("msg")).unwrap();
+        }
+        assert_eq!(cached_uids(pw_did).unwrap().len(), MAX_CACHED_MESSAGES);
+        clear_messages(pw_did).unwrap();
+        assert!(cached_uids(pw_did).unwrap().is_empty());
+    }
+}
@@ -0,0 +1,211 @@
+use std::collections::{HashMap, HashSet, VecDeque};
+use std::sync::RwLock;
+
+use crate::error::prelude::*;
+use crate::libindy::utils::cache;
+
+// Upper bound on remembered uids per connection; uids are also pruned as soon as the agency stops
+// reporting them, so this is only reached if status updates keep failing for many messages.
+const MAX_PROCESSED_UIDS: usize = 1000;
+
+lazy_static! {
+    static ref MESSAGE_SYNC_CURSORS: RwLock<HashMap<String, MessageSyncCursor>> = RwLock::new(HashMap::new());
+}
+
+/**
+Per-connection record of messages which were already handled locally, but which agency still reports
+as pending because updating their status failed.
+
+A message is only recorded when its status update fails, and the cursor is written to wallet right
+away, as agency will keep reporting the message after it was handled. Cursors are read and updated
+under the lock of the cursor map, so concurrent updates of one connection are not lost.
+ */
+#[derive(Debug, Clone, Default, Serialize, Deserialize, PartialEq)]
+#[serde(from = "StoredCursor")]
+pub struct MessageSyncCursor {
+    processed_uids: VecDeque<String>,
+    #[serde(skip)]
+    index: HashSet<String>,
+    #[serde(skip)]
+    unsaved: bool,
+}
+
+#[derive(Deserialize)]
+struct StoredCursor {
+    #[serde(default)]
+    processed_uids: VecDeque<String>,
+}
+
+impl From<StoredCursor> for MessageSyncCursor {
+    fn from(stored: StoredCursor) -> MessageSyncCursor {
+        let index = stored.processed_uids.iter().cloned().collect();
+        MessageSyncCursor { processed_uids: stored.processed_uids, index, unsaved: false }
+    }
+}
+
+impl MessageSyncCursor {
+    pub fn is_empty(&self) -> bool {
+        self.processed_uids.is_empty()
+    }
+
+    pub fn is_processed(&self, uid: &str) -> bool {
+        self.index.contains(uid)
+    }
+
+    pub fn has_unsaved_changes(&self) -> bool {
+        self.unsaved
+    }
+
+    pub fn mark_processed(&mut self, uid: &str) {
+        if self.index.insert(uid.to_string()) {
+            self.processed_uids.push_back(uid.to_string());
+            if self.processed_uids.len() > MAX_PROCESSED_UIDS {
+                if let Some(oldest) = self.processed_uids.pop_front() {
+                    self.index.remove(&oldest);
+                }
+            }
+            self.unsaved = true;
+        }
+    }
+
+    /**
+    Forgets processed uids which agency no longer reports as pending. Returns true if anything was removed.
+     */
+    pub fn retain_pending(&mut self, pending_uids: &HashSet<&str>) -> bool {
+        let count = self.processed_uids.len();
+        self.processed_uids.retain(|uid| pending_uids.contains(uid.as_str()));
+        if count == self.processed_uids.len() {
+            return false;
+        }
+        self.index.retain(|uid| pending_uids.contains(uid.as_str()));
+        self.unsaved = true;
+        true
+    }
+}
+
+fn _load_cursor(pw_did: &str) -> MessageSyncCursor {
+    cache::get_message_sync_cache(pw_did)
+        .and_then(|json| serde_json::from_str(&json).ok())
+        .unwrap_or_default()
+}
+
+fn _store_cursor(pw_did: &str, cursor: &mut MessageSyncCursor) -> VcxResult<()> {
+    let json = serde_json::to_string(&cursor)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::SerializationError, format!("Cannot serialize MessageSyncCursor: {:?}", err)))?;
+    cache::set_message_sync_cache(pw_did, &json)?;
+    cursor.unsaved = false;
+    Ok(())
+}
+
+// Runs `f` on the cursor of the connection while holding the lock of the cursor map
+fn _update_cursor<R, F: FnOnce(&mut MessageSyncCursor) -> VcxResult<R>>(pw_did: &str, f: F) -> VcxResult<R> {
+    let mut cursors = MESSAGE_SYNC_CURSORS.write()?;
+    let cursor = cursors.entry(pw_did.to_string()).or_insert_with(|| _load_cursor(pw_did));
+    f(cursor)
+}
+
+pub fn get_cursor(pw_did: &str) -> VcxResult<MessageSyncCursor> {
+    if let Some(cursor) = MESSAGE_SYNC_CURSORS.read()?.get(pw_did) {
+        return Ok(cursor.clone());
+    }
+    _update_cursor(pw_did, |cursor| Ok(cursor.clone()))
+}
+
+/**
+Records the message as processed and writes the cursor to wallet, for message whose status update failed.
+ */
+pub fn mark_processed(pw_did: &str, uid: &str) -> VcxResult<()> {
+    _update_cursor(pw_did, |cursor| {
+        cursor.mark_processed(uid);
+        if cursor.has_unsaved_changes() {
+            _store_cursor(pw_did, cursor)?;
+        }
+        Ok(())
+    })
+}
+
+/**
+Forgets processed uids which agency no longer reports as pending, writing the cursor to wallet if it changed.
+ */
+pub fn retain_pending(pw_did: &str, pending_uids: &HashSet<&str>) -> VcxResult<()> {
+    _update_cursor(pw_did, |cursor| {
+        if cursor.retain_pending(pending_uids) || cursor.has_unsaved_changes() {
+            _store_cursor(pw_did, cursor)?;
+        }
+        Ok(())
+    })
+}
+
+pub fn clear_cursor(pw_did: &str) -> VcxResult<()> {
+    MESSAGE_SYNC_CURSORS.write()?.remove(pw_did);
+    if let Err(err) = cache::clear_message_sync_cache(pw_did) {
+        debug!("No persisted message sync cursor removed for pw_did {}: {}", pw_did, err);
+    }
+    Ok(())
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cursor_marks_and_prunes_processed_uids() {
+        let mut cursor = MessageSyncCursor::default();
+        assert!(cursor.is_empty());
+
+        cursor.mark_processed("uid1");
+        cursor.mark_processed("uid2");
+        cursor.mark_processed("uid2");
+        assert_eq!(cursor.processed_uids, vec!["uid1".to_string(), "uid2".to_string()]);
+        assert!(cursor.has_unsaved_changes());
+        assert!(cursor.is_processed("uid1"));
+        assert!(!cursor.is_processed("uid3"));
+
+        let restored: MessageSyncCursor = serde_json::from_str(&serde_json::to_string(&cursor).unwrap()).unwrap();
+        assert!(restored.is_processed("uid1"));
+        assert!(!restored.has_unsaved_changes());
+
+        let pending: HashSet<&str> = vec!["uid2", "uid3"].into_iter().collect();
+        assert!(cursor.retain_pending(&pending));
+        assert_eq!(cursor.processed_uids, vec!["uid2".to_string()]);
+        assert!(!cursor.retain_pending(&pending));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_processed_uids_are_stored_right_away() {
+        let _setup = SetupMocks::init();
+        let pw_did = "message_sync_store_did";
+
+        mark_processed(pw_did, "uid1").unwrap();
+        mark_processed(pw_did, "uid2").unwrap();
+        let cursor = get_cursor(pw_did).unwrap();
+        assert!(!cursor.has_unsaved_changes());
+        assert_eq!(cursor.processed_uids, vec!["uid1".to_string(), "uid2".to_string()]);
+
+        let pending: HashSet<&str> = vec!["uid2"].into_iter().collect();
+        retain_pending(pw_did, &pending).unwrap();
+        let cursor = get_cursor(pw_did).unwrap();
+        assert!(!cursor.has_unsaved_changes());
+        assert!(!cursor.is_processed("uid1"));
+        assert!(cursor.is_processed("uid2"));
+
+        clear_cursor(pw_did).unwrap();
+        assert!(get_cursor(pw_did).unwrap().is_empty());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cursor_is_bounded() {
+        let mut cursor = MessageSyncCursor::default();
+        for i in 0..MAX_PROCESSED_UIDS + 10 {
+            cursor.mark_processed(&format!("uid{}", i));
+        }
+        assert_eq!(cursor.processed_uids.len(), MAX_PROCESSED_UIDS);
+        assert!(!cursor.is_processed("uid0"));
+        assert!(cursor.is_processed(&format!("uid{}", MAX_PROCESSED_UIDS + 9)));
+    }
+}
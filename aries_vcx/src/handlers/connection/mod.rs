@@ -1,8 +1,12 @@
 pub mod pairwise_info;
 pub mod cloud_agent;
+pub mod message_sync;
+pub mod decrypted_messages;
 pub mod legacy_agent_info;
 pub mod connection;
 pub mod invitee;
 pub mod inviter;
 pub mod public_agent;
+pub mod provisioned_pool;
+pub mod send_queue;
 mod util;
@@ -0,0 +1,168 @@
+use crate::agency_client::mocking::agency_mocks_enabled;
+use crate::error::prelude::*;
+use crate::handlers::connection::cloud_agent::CloudAgentInfo;
+use crate::handlers::connection::pairwise_info::PairwiseInfo;
+use crate::libindy::utils::wallet::{add_record, delete_record};
+use crate::libindy::utils::wallet_search::{SearchProjection, WalletSearch, DEFAULT_SEARCH_PAGE_SIZE};
+use crate::settings;
+use crate::utils::refill_pool::{RefillPool, RefillPoolConfig, RefillSource};
+
+const PROVISIONED_PAIRWISE_RECORD_TYPE: &str = "VcxProvisionedPairwise";
+
+lazy_static! {
+    static ref PAIRWISE_POOL: RefillPool<ProvisionedPairwiseSource> = RefillPool::new(ProvisionedPairwiseSource);
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize, PartialEq)]
+pub struct ProvisionedPairwise {
+    pub pairwise_info: PairwiseInfo,
+    pub cloud_agent_info: CloudAgentInfo,
+}
+
+pub type PairwisePoolConfig = RefillPoolConfig;
+
+/*
+Pairwise DIDs with cloud agent keys provisioned ahead of time, so creating a connection does not wait
+for the wallet and a CreateKey round trip to the agency. Entries are also stored in the wallet, so ones
+not used before the wallet is closed are picked up again next time instead of leaking agent keys.
+ */
+struct ProvisionedPairwiseSource;
+
+impl RefillSource for ProvisionedPairwiseSource {
+    type Item = ProvisionedPairwise;
+
+    fn name(&self) -> &'static str {
+        "pairwise"
+    }
+
+    fn enabled(&self) -> bool {
+        !settings::indy_mocks_enabled() && !agency_mocks_enabled()
+    }
+
+    fn provision(&self) -> VcxResult<ProvisionedPairwise> {
+        _provision()
+    }
+
+    fn store(&self, entry: &ProvisionedPairwise) -> VcxResult<()> {
+        _store(entry)
+    }
+
+    fn load_stored(&self) -> VcxResult<Vec<ProvisionedPairwise>> {
+        _load_stored()
+    }
+}
+
+fn _provision() -> VcxResult<ProvisionedPairwise> {
+    let pairwise_info = PairwiseInfo::create()?;
+    let cloud_agent_info = CloudAgentInfo::create(&pairwise_info)?;
+    Ok(ProvisionedPairwise { pairwise_info, cloud_agent_info })
+}
+
+fn _load_stored() -> VcxResult<Vec<ProvisionedPairwise>> {
+    let projection = SearchProjection { retrieve_type: false, retrieve_value: true, retrieve_tags: false, tag_names: None };
+    WalletSearch::open(PROVISIONED_PAIRWISE_RECORD_TYPE, "{}", projection, DEFAULT_SEARCH_PAGE_SIZE)?
+        .map(|record| {
+            let record = record?;
+            serde_json::from_str(&record.value.unwrap_or_default())
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize provisioned pairwise: {}", err)))
+        })
+        .collect()
+}
+
+fn _store(entry: &ProvisionedPairwise) -> VcxResult<()> {
+    let value = serde_json::to_string(entry)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::SerializationError, format!("Cannot serialize provisioned pairwise: {}", err)))?;
+    add_record(PROVISIONED_PAIRWISE_RECORD_TYPE, &entry.pairwise_info.pw_did, &value, None)
+}
+
+fn _delete_stored(pw_did: &str) -> VcxResult<()> {
+    delete_record(PROVISIONED_PAIRWISE_RECORD_TYPE, pw_did)
+}
+
+/*
+Entry is handed out only once its wallet record is gone. Otherwise it would be loaded again after the
+wallet is reopened and the same pairwise DID used for a second connection, so it is dropped instead.
+ */
+fn _claim(entry: ProvisionedPairwise, delete_stored: fn(&str) -> VcxResult<()>) -> Option<ProvisionedPairwise> {
+    match delete_stored(&entry.pairwise_info.pw_did) {
+        Ok(()) => Some(entry),
+        Err(err) => {
+            warn!("take_provisioned_pairwise >>> dropping pre-provisioned pw_did: {}, failed to delete stored entry: {}", entry.pairwise_info.pw_did, err);
+            None
+        }
+    }
+}
+
+///
+/// Enables pool of pre-provisioned pairwise DIDs with cloud agent keys and starts filling it.
+///
+pub fn init_pairwise_pool(config: PairwisePoolConfig) -> VcxResult<()> {
+    trace!("init_pairwise_pool >>> config: {:?}", config);
+    PAIRWISE_POOL.enable(config)
+}
+
+///
+/// Returns pre-provisioned pairwise info with its cloud agent, or provisions a new one if the pool is
+/// disabled or empty.
+///
+pub fn take_provisioned_pairwise() -> VcxResult<(PairwiseInfo, CloudAgentInfo)> {
+    if let Some(entry) = PAIRWISE_POOL.take()?.and_then(|entry| _claim(entry, _delete_stored)) {
+        trace!("take_provisioned_pairwise >>> using pre-provisioned pw_did: {}", entry.pairwise_info.pw_did);
+        return Ok((entry.pairwise_info, entry.cloud_agent_info));
+    }
+    let entry = _provision()?;
+    Ok((entry.pairwise_info, entry.cloud_agent_info))
+}
+
+///
+/// Disables the pool. Entries already stored in the wallet are loaded again once the pool is re-enabled.
+///
+pub fn reset_pairwise_pool() {
+    PAIRWISE_POOL.disable()
+}
+
+pub fn pairwise_pool_size() -> usize {
+    PAIRWISE_POOL.len()
+}
+
+#[cfg(test)]
+pub mod tests {
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    fn _entry(pw_did: &str) -> ProvisionedPairwise {
+        ProvisionedPairwise {
+            pairwise_info: PairwiseInfo { pw_did: pw_did.to_string(), pw_vk: format!("{}_vk", pw_did) },
+            cloud_agent_info: CloudAgentInfo { agent_did: format!("{}_agent", pw_did), agent_vk: format!("{}_agent_vk", pw_did) },
+        }
+    }
+
+    fn _delete_failing(_pw_did: &str) -> VcxResult<()> {
+        Err(VcxError::from_msg(VcxErrorKind::WalletRecordNotFound, "record not found"))
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_entry_is_dropped_when_stored_record_cannot_be_deleted() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(_claim(_entry("did1"), _delete_stored), Some(_entry("did1")));
+        assert_eq!(_claim(_entry("did2"), _delete_failing), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_take_provisioned_pairwise_falls_back_under_mocks() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(init_pairwise_pool(PairwisePoolConfig { capacity: 1, low_water_mark: 1 }).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+        init_pairwise_pool(PairwisePoolConfig { capacity: 5, low_water_mark: 2 }).unwrap();
+
+        let (pairwise_info, _cloud_agent_info) = take_provisioned_pairwise().unwrap();
+        assert!(!pairwise_info.pw_did.is_empty());
+        assert_eq!(pairwise_pool_size(), 0);
+
+        reset_pairwise_pool();
+    }
+}
@@ -0,0 +1,510 @@
+use std::cmp::{self, Reverse};
+use std::collections::{BinaryHeap, HashMap, HashSet, VecDeque};
+use std::sync::{Arc, Condvar, mpsc, Mutex, MutexGuard};
+use std::sync::mpsc::RecvTimeoutError;
+use std::thread;
+use std::time::{Duration, Instant};
+
+use crate::error::prelude::*;
+use crate::messages::a2a::A2AMessage;
+use crate::messages::connection::did_doc::DidDoc;
+use crate::utils::encryption_envelope::EncryptionEnvelope;
+
+const MAX_KEPT_OUTCOMES: usize = 10_000;
+
+lazy_static! {
+    static ref SEND_QUEUE: Mutex<SendQueue> = Mutex::new(SendQueue::default());
+}
+
+#[derive(Debug, Clone, Copy, Serialize, Deserialize, PartialEq)]
+#[serde(default)]
+pub struct SendQueueConfig {
+    pub workers: usize,
+    pub max_retries: u32,
+    pub initial_backoff_ms: u64,
+    pub max_backoff_ms: u64,
+}
+
+impl Default for SendQueueConfig {
+    fn default() -> SendQueueConfig {
+        SendQueueConfig {
+            workers: 4,
+            max_retries: 3,
+            initial_backoff_ms: 200,
+            max_backoff_ms: 5000,
+        }
+    }
+}
+
+#[derive(Debug, Clone, Serialize, Deserialize, PartialEq)]
+pub struct DeliveryOutcome {
+    pub id: u64,
+    pub pw_did: String,
+    pub message_id: Option<String>,
+    pub delivered: bool,
+    pub attempts: u32,
+    pub error: Option<String>,
+}
+
+enum Packing {
+    Pending,
+    Packing,
+    Packed(Result<Vec<u8>, String>),
+}
+
+#[derive(Default)]
+struct Attempts {
+    count: u32,
+    // backoff before the next retry, initial backoff if not retried yet
+    backoff: Option<Duration>,
+}
+
+struct Outbound {
+    id: u64,
+    pw_did: String,
+    sender_vk: String,
+    did_doc: DidDoc,
+    message: A2AMessage,
+    packing: Mutex<Packing>,
+    packed: Condvar,
+    attempts: Mutex<Attempts>,
+}
+
+impl Outbound {
+    // Packs the message, unless another worker is already packing it, in which case its result is awaited
+    fn pack(&self) -> Result<Vec<u8>, String> {
+        let mut packing = _lock(&self.packing);
+        loop {
+            match *packing {
+                Packing::Packed(ref result) => return result.clone(),
+                Packing::Pending => break,
+                Packing::Packing => {}
+            }
+            packing = self.packed.wait(packing).unwrap_or_else(|poisoned| poisoned.into_inner());
+        }
+        *packing = Packing::Packing;
+        drop(packing);
+
+        let result = EncryptionEnvelope::create(&self.message, Some(&self.sender_vk), &self.did_doc)
+            .map(|envelope| envelope.0)
+            .map_err(|err| err.to_string());
+        *_lock(&self.packing) = Packing::Packed(result.clone());
+        self.packed.notify_all();
+        result
+    }
+
+    fn message_id(&self) -> Option<String> {
+        serde_json::to_value(&self.message).ok()
+            .and_then(|message| message["@id"].as_str().map(String::from))
+    }
+}
+
+enum Job {
+    Pack(Arc<Outbound>),
+    Deliver(String, u64),
+}
+
+// Delivery to a connection postponed until its backoff passes, ordered by when it is due
+#[derive(Debug, PartialEq, Eq, PartialOrd, Ord)]
+struct Retry {
+    due: Instant,
+    pw_did: String,
+    generation: u64,
+}
+
+enum Attempt {
+    Finished(DeliveryOutcome),
+    RetryAfter(Duration),
+}
+
+/*
+Outbound messages of every connection are queued in the order they were sent. Workers pack queued
+messages as soon as they arrive, while at most one delivery job per connection is queued at a time, so
+its messages are posted in order and packing of later messages overlaps delivery of earlier ones.
+Messages are not coalesced into fewer requests, as the receiving agent or mediator accepts a single
+packed envelope per request; posting them in order is what lets them share the kept-alive connection
+instead. A delivery job posts a single message and requeues the connection at the end of the job queue,
+so busy connections take turns with the others. Failed posts are retried with exponential backoff: the
+connection is handed to a retry thread which requeues it once the backoff passes, so no worker sleeps
+while an unreachable endpoint backs off. A message which still fails is reported and the following
+messages of the connection are delivered anyway. Outcomes are collected until taken by the caller.
+Workers of a previous configuration finish their current job and discard its result, as the generation
+no longer matches.
+ */
+#[derive(Default)]
+struct SendQueue {
+    jobs: Option<mpsc::Sender<Job>>,
+    retries: Option<mpsc::Sender<Retry>>,
+    pending: HashMap<String, VecDeque<Arc<Outbound>>>,
+    delivering: HashSet<String>,
+    outcomes: VecDeque<DeliveryOutcome>,
+    next_id: u64,
+    generation: u64,
+}
+
+impl SendQueue {
+    fn push_outcome(&mut self, outcome: DeliveryOutcome) {
+        if self.outcomes.len() >= MAX_KEPT_OUTCOMES {
+            warn!("SendQueue >>> dropping oldest undelivered outcome report, outcomes are not being taken");
+            self.outcomes.pop_front();
+        }
+        self.outcomes.push_back(outcome);
+    }
+
+    // Returns next message of the connection, or stops delivering to it if none is left
+    fn next_to_deliver(&mut self, pw_did: &str, generation: u64) -> Option<Arc<Outbound>> {
+        if self.generation != generation {
+            return None;
+        }
+        let next = self.pending.get(pw_did).and_then(|queue| queue.front().cloned());
+        if next.is_none() {
+            self.pending.remove(pw_did);
+            self.delivering.remove(pw_did);
+        }
+        next
+    }
+
+    fn delivered(&mut self, generation: u64, outcome: DeliveryOutcome) {
+        if self.generation != generation {
+            return;
+        }
+        if let Some(queue) = self.pending.get_mut(&outcome.pw_did) {
+            queue.pop_front();
+        }
+        self.push_outcome(outcome);
+    }
+
+    // Queues next delivery job of the connection, right away or once `delay` passes; stops delivering to it if no message is left
+    fn schedule_delivery(&mut self, pw_did: String, generation: u64, delay: Option<Duration>) {
+        if self.generation != generation {
+            return;
+        }
+        if self.pending.get(&pw_did).map_or(true, VecDeque::is_empty) {
+            self.pending.remove(&pw_did);
+            self.delivering.remove(&pw_did);
+            return;
+        }
+        let scheduled = match delay {
+            None => self.jobs.as_ref()
+                .map_or(false, |jobs| jobs.send(Job::Deliver(pw_did.clone(), generation)).is_ok()),
+            Some(delay) => self.retries.as_ref()
+                .map_or(false, |retries| retries.send(Retry { due: Instant::now() + delay, pw_did: pw_did.clone(), generation }).is_ok())
+        };
+        if !scheduled {
+            warn!("SendQueue >>> delivery to {} stopped, send queue workers are stopped", pw_did);
+            self.delivering.remove(&pw_did);
+        }
+    }
+}
+
+fn _lock<T>(mutex: &Mutex<T>) -> MutexGuard<T> {
+    mutex.lock().unwrap_or_else(|poisoned| poisoned.into_inner())
+}
+
+// Makes one attempt to post the message, returns when to retry if it failed and retries are left
+fn _post(outbound: &Outbound, config: &SendQueueConfig) -> Attempt {
+    let mut attempts = _lock(&outbound.attempts);
+    let mut outcome = DeliveryOutcome {
+        id: outbound.id,
+        pw_did: outbound.pw_did.clone(),
+        message_id: outbound.message_id(),
+        delivered: false,
+        attempts: attempts.count,
+        error: None,
+    };
+    let packed = match outbound.pack() {
+        Ok(packed) => packed,
+        Err(err) => {
+            outcome.error = Some(err);
+            return Attempt::Finished(outcome);
+        }
+    };
+    let endpoint = outbound.did_doc.get_endpoint();
+    attempts.count += 1;
+    outcome.attempts = attempts.count;
+    match agency_client::httpclient::post_message(&packed, &endpoint) {
+        Ok(_) => {
+            outcome.delivered = true;
+            Attempt::Finished(outcome)
+        }
+        Err(err) => {
+            warn!("SendQueue >>> attempt {} to deliver message {} to {} failed: {}", outcome.attempts, outbound.id, endpoint, err);
+            if outcome.attempts > config.max_retries {
+                outcome.error = Some(err.to_string());
+                return Attempt::Finished(outcome);
+            }
+            let backoff = attempts.backoff.unwrap_or(Duration::from_millis(config.initial_backoff_ms));
+            attempts.backoff = Some(_next_backoff(backoff, config));
+            Attempt::RetryAfter(backoff)
+        }
+    }
+}
+
+fn _next_backoff(backoff: Duration, config: &SendQueueConfig) -> Duration {
+    cmp::min(backoff * 2, Duration::from_millis(config.max_backoff_ms))
+}
+
+fn _deliver(pw_did: String, generation: u64, config: SendQueueConfig) {
+    let next = _lock(&SEND_QUEUE).next_to_deliver(&pw_did, generation);
+    let outbound = match next {
+        Some(outbound) => outbound,
+        None => return
+    };
+    let attempt = _post(&outbound, &config);
+    let mut queue = _lock(&SEND_QUEUE);
+    let delay = match attempt {
+        Attempt::Finished(outcome) => {
+            trace!("SendQueue >>> message {} for {} delivered: {}", outcome.id, pw_did, outcome.delivered);
+            queue.delivered(generation, outcome);
+            None
+        }
+        Attempt::RetryAfter(backoff) => Some(backoff)
+    };
+    queue.schedule_delivery(pw_did, generation, delay);
+}
+
+// Requeues delivery jobs of connections once their backoff passes, until the send queue is reset
+fn _schedule_retries(retries: mpsc::Receiver<Retry>, jobs: mpsc::Sender<Job>) {
+    let mut scheduled: BinaryHeap<Reverse<Retry>> = BinaryHeap::new();
+    loop {
+        let now = Instant::now();
+        while scheduled.peek().map_or(false, |next| next.0.due <= now) {
+            let Reverse(retry) = scheduled.pop().unwrap();
+            if jobs.send(Job::Deliver(retry.pw_did, retry.generation)).is_err() {
+                return;
+            }
+        }
+        let received = match scheduled.peek() {
+            Some(Reverse(next)) => retries.recv_timeout(next.due.saturating_duration_since(now)),
+            None => retries.recv().map_err(|_| RecvTimeoutError::Disconnected)
+        };
+        match received {
+            Ok(retry) => scheduled.push(Reverse(retry)),
+            Err(RecvTimeoutError::Timeout) => {}
+            Err(RecvTimeoutError::Disconnected) => return
+        }
+    }
+}
+
+fn _work(jobs: Arc<Mutex<mpsc::Receiver<Job>>>, config: SendQueueConfig) {
+    loop {
+        let job = match _lock(&jobs).recv() {
+            Ok(job) => job,
+            Err(_) => return
+        };
+        match job {
+            Job::Pack(outbound) => { outbound.pack().ok(); }
+            Job::Deliver(pw_did, generation) => _deliver(pw_did, generation, config)
+        }
+    }
+}
+
+///
+/// Starts workers delivering messages sent over connections in background. Messages queued under
+/// a previous configuration are dropped.
+///
+pub fn init_send_queue(config: SendQueueConfig) -> VcxResult<()> {
+    trace!("init_send_queue >>> config: {:?}", config);
+    if config.workers == 0 || config.initial_backoff_ms > config.max_backoff_ms {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration,
+                                      format!("Send queue needs workers and initial backoff not above max backoff: {:?}", config)));
+    }
+    let (sender, receiver) = mpsc::channel();
+    let receiver = Arc::new(Mutex::new(receiver));
+    for i in 0..config.workers {
+        let receiver = receiver.clone();
+        thread::Builder::new()
+            .name(format!("vcx-send-queue-{}", i))
+            .spawn(move || _work(receiver, config))
+            .map_err(|err| VcxError::from_msg(VcxErrorKind::IOError, format!("Cannot spawn send queue worker: {}", err)))?;
+    }
+    let (retries, scheduled) = mpsc::channel();
+    let jobs = sender.clone();
+    thread::Builder::new()
+        .name("vcx-send-queue-retries".to_string())
+        .spawn(move || _schedule_retries(scheduled, jobs))
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::IOError, format!("Cannot spawn send queue retry thread: {}", err)))?;
+
+    let mut queue = SEND_QUEUE.lock()?;
+    let generation = queue.generation + 1;
+    *queue = SendQueue { jobs: Some(sender), retries: Some(retries), generation, ..SendQueue::default() };
+    Ok(())
+}
+
+///
+/// Stops background delivery, messages not delivered yet are dropped.
+///
+pub fn reset_send_queue() {
+    let mut queue = _lock(&SEND_QUEUE);
+    let generation = queue.generation + 1;
+    *queue = SendQueue { generation, ..SendQueue::default() };
+}
+
+pub fn send_queue_enabled() -> bool {
+    _lock(&SEND_QUEUE).jobs.is_some()
+}
+
+///
+/// Queues message for delivery to the connection's counterparty, returns id its outcome is reported with.
+///
+pub fn enqueue_message(pw_did: &str, sender_vk: &str, did_doc: &DidDoc, message: &A2AMessage) -> VcxResult<u64> {
+    let mut queue = SEND_QUEUE.lock()?;
+    let jobs = queue.jobs.clone()
+        .ok_or(VcxError::from_msg(VcxErrorKind::NotReady, "Send queue is not initialized"))?;
+    queue.next_id += 1;
+    let outbound = Arc::new(Outbound {
+        id: queue.next_id,
+        pw_did: pw_did.to_string(),
+        sender_vk: sender_vk.to_string(),
+        did_doc: did_doc.clone(),
+        message: message.clone(),
+        packing: Mutex::new(Packing::Pending),
+        packed: Condvar::new(),
+        attempts: Mutex::new(Attempts::default()),
+    });
+    trace!("enqueue_message >>> queued message {} for {}", outbound.id, pw_did);
+    queue.pending.entry(pw_did.to_string()).or_default().push_back(outbound.clone());
+
+    let id = outbound.id;
+    let mut sent = jobs.send(Job::Pack(outbound)).is_ok();
+    if sent && queue.delivering.insert(pw_did.to_string()) {
+        sent = jobs.send(Job::Deliver(pw_did.to_string(), queue.generation)).is_ok();
+    }
+    if !sent {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidState, "Send queue workers are stopped"));
+    }
+    Ok(id)
+}
+
+///
+/// Returns outcomes of messages delivered or given up on since the previous call.
+///
+pub fn take_delivery_outcomes() -> Vec<DeliveryOutcome> {
+    _lock(&SEND_QUEUE).outcomes.drain(..).collect()
+}
+
+pub fn pending_messages(pw_did: &str) -> usize {
+    _lock(&SEND_QUEUE).pending.get(pw_did).map(VecDeque::len).unwrap_or(0)
+}
+
+#[cfg(test)]
+pub mod tests {
+    use std::time::Instant;
+
+    use agency_client::error::{AgencyClientError, AgencyClientErrorKind};
+    use agency_client::mocking::HttpClientMockResponse;
+
+    use crate::messages::ack::test_utils::_ack;
+    use crate::messages::connection::did_doc::test_utils::_did_doc_4;
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    fn _wait_for_outcomes(count: usize) -> Vec<DeliveryOutcome> {
+        let started = Instant::now();
+        let mut outcomes = Vec::new();
+        while outcomes.len() < count && started.elapsed() < Duration::from_secs(10) {
+            outcomes.extend(take_delivery_outcomes());
+            thread::sleep(Duration::from_millis(10));
+        }
+        outcomes
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_send_queue_rejects_invalid_config() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(init_send_queue(SendQueueConfig { workers: 0, ..SendQueueConfig::default() }).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+        assert_eq!(init_send_queue(SendQueueConfig { initial_backoff_ms: 10, max_backoff_ms: 1, ..SendQueueConfig::default() }).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+        assert!(!send_queue_enabled());
+        assert_eq!(enqueue_message("pw_did", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap_err().kind(), VcxErrorKind::NotReady);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_send_queue_delivers_messages_in_order() {
+        let _setup = SetupMocks::init();
+        init_send_queue(SendQueueConfig { workers: 3, ..SendQueueConfig::default() }).unwrap();
+        assert!(send_queue_enabled());
+
+        let ids: Vec<u64> = (0..5)
+            .map(|_| enqueue_message("pw_did_1", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap())
+            .collect();
+        let other_id = enqueue_message("pw_did_2", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap();
+
+        let outcomes = _wait_for_outcomes(6);
+        assert_eq!(outcomes.len(), 6);
+        assert!(outcomes.iter().all(|outcome| outcome.delivered && outcome.attempts == 1));
+        let delivered_ids: Vec<u64> = outcomes.iter().filter(|outcome| outcome.pw_did == "pw_did_1").map(|outcome| outcome.id).collect();
+        assert_eq!(delivered_ids, ids);
+        assert!(outcomes.iter().any(|outcome| outcome.id == other_id && outcome.pw_did == "pw_did_2"));
+        assert_eq!(pending_messages("pw_did_1"), 0);
+
+        reset_send_queue();
+        assert!(!send_queue_enabled());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_send_queue_gives_up_after_retries() {
+        let _setup = SetupMocks::init();
+        let config = SendQueueConfig { workers: 1, max_retries: 2, initial_backoff_ms: 1, max_backoff_ms: 2 };
+        let backoffs: Vec<u64> = (0..3)
+            .scan(Duration::from_millis(config.initial_backoff_ms), |backoff, _| {
+                let current = *backoff;
+                *backoff = _next_backoff(current, &config);
+                Some(current.as_millis() as u64)
+            })
+            .collect();
+        assert_eq!(backoffs, vec![1, 2, 2]);
+
+        init_send_queue(config).unwrap();
+        for _ in 0..3 {
+            HttpClientMockResponse::set_next_response(Err(AgencyClientError::from_msg(AgencyClientErrorKind::IOError, "Sending message timeout.")));
+        }
+        let failed_id = enqueue_message("pw_did_failing", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap();
+        let next_id = enqueue_message("pw_did_failing", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap();
+
+        let outcomes = _wait_for_outcomes(2);
+        assert_eq!(outcomes.len(), 2);
+        assert_eq!(outcomes[0].id, failed_id);
+        assert!(!outcomes[0].delivered);
+        assert_eq!(outcomes[0].attempts, 3);
+        assert!(outcomes[0].error.is_some());
+        assert_eq!(outcomes[1].id, next_id);
+        assert!(outcomes[1].delivered);
+        assert_eq!(outcomes[1].attempts, 1);
+
+        reset_send_queue();
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_backing_off_connections_do_not_hold_workers() {
+        let _setup = SetupMocks::init();
+        init_send_queue(SendQueueConfig { workers: 1, max_retries: 1, initial_backoff_ms: 5000, max_backoff_ms: 5000 }).unwrap();
+
+        let failing = vec!["pw_did_failing_1", "pw_did_failing_2", "pw_did_failing_3"];
+        for _ in &failing {
+            HttpClientMockResponse::set_next_response(Err(AgencyClientError::from_msg(AgencyClientErrorKind::IOError, "Sending message timeout.")));
+        }
+        let started = Instant::now();
+        for pw_did in &failing {
+            enqueue_message(pw_did, "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap();
+        }
+        let healthy_id = enqueue_message("pw_did_healthy", "pw_vk", &_did_doc_4(), &A2AMessage::Ack(_ack())).unwrap();
+
+        let outcomes = _wait_for_outcomes(1);
+        assert_eq!(outcomes.len(), 1);
+        assert_eq!(outcomes[0].id, healthy_id);
+        assert!(outcomes[0].delivered);
+        assert!(started.elapsed() < Duration::from_secs(2), "healthy connection waited {:?}", started.elapsed());
+
+        let retried = _wait_for_outcomes(failing.len());
+        assert_eq!(retried.len(), failing.len());
+        assert!(retried.iter().all(|outcome| outcome.delivered && outcome.attempts == 2));
+
+        reset_send_queue();
+    }
+}
@@ -1,12 +1,20 @@
 use std::collections::HashMap;
+use std::sync::Arc;
+
+use agency_client::metrics;
 
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
+use crate::handlers::issuance::holder::ledger_artefacts::{HolderLedgerArtefactId, HolderLedgerArtefacts};
 use crate::handlers::issuance::holder::state_machine::HolderSM;
 use crate::handlers::issuance::messages::CredentialIssuanceMessage;
 use crate::messages::a2a::A2AMessage;
 use crate::messages::issuance::credential_offer::CredentialOffer;
 
+lazy_static! {
+    static ref HOLDER_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("holder_transition");
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone, Default)]
 pub struct Holder {
     holder_sm: HolderSM,
@@ -90,7 +98,23 @@ impl Holder {
     }
 
     pub fn step(&mut self, message: CredentialIssuanceMessage, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>) -> VcxResult<()> {
-        self.holder_sm = self.holder_sm.clone().handle_message(message, send_message)?;
+        self.holder_sm = HOLDER_TRANSITION.time(|| self.holder_sm.clone().handle_message(message, send_message))?;
+        Ok(())
+    }
+
+    pub fn referenced_ledger_artefacts(&self, message: &CredentialIssuanceMessage) -> VcxResult<Vec<HolderLedgerArtefactId>> {
+        self.holder_sm.referenced_ledger_artefacts(message)
+    }
+
+    /**
+    Same as step, but ledger data is taken from artefacts resolved for a whole batch of holders
+    rather than fetched for this holder alone.
+     */
+    pub fn step_with_artefacts(&mut self,
+                               message: CredentialIssuanceMessage,
+                               send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>,
+                               artefacts: &HolderLedgerArtefacts) -> VcxResult<()> {
+        self.holder_sm = HOLDER_TRANSITION.time(|| self.holder_sm.clone().handle_message_with_artefacts(message, send_message, artefacts))?;
         Ok(())
     }
 
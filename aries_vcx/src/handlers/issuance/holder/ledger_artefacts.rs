@@ -0,0 +1,84 @@
+use std::collections::{HashMap, HashSet};
+
+use crate::error::prelude::*;
+use crate::libindy::utils::anoncreds;
+use crate::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
+
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub enum HolderLedgerArtefactId {
+    CredDef(String),
+    RevRegDef(String),
+}
+
+fn _fetch_ledger_artefact(id: HolderLedgerArtefactId) -> VcxResult<String> {
+    match id {
+        HolderLedgerArtefactId::CredDef(cred_def_id) => anoncreds::get_cred_def_json(&cred_def_id).map(|(_, json)| json),
+        HolderLedgerArtefactId::RevRegDef(rev_reg_id) => anoncreds::get_rev_reg_def_json(&rev_reg_id).map(|(_, json)| json)
+    }
+}
+
+/*
+Ledger data holders need to create credential requests and to store received credentials. When
+processing several credentials at once, artefacts referenced by any of them are resolved once up front,
+so offers of the same cred def or credentials of the same revocation registry share a single lookup.
+Artefacts which failed to resolve are left out and fetched again by the holder which needs them, so
+the failure is reported for that credential only. Empty set fetches everything on demand.
+ */
+#[derive(Debug, Clone, Default)]
+pub struct HolderLedgerArtefacts {
+    artefacts: HashMap<HolderLedgerArtefactId, String>,
+}
+
+impl HolderLedgerArtefacts {
+    pub fn resolve(ids: Vec<HolderLedgerArtefactId>) -> VcxResult<HolderLedgerArtefacts> {
+        let mut seen: HashSet<HolderLedgerArtefactId> = HashSet::new();
+        let ids: Vec<HolderLedgerArtefactId> = ids.into_iter().filter(|id| seen.insert(id.clone())).collect();
+        debug!("resolving {} ledger artefacts for holders", ids.len());
+
+        let fetched = map_concurrently(ids.clone(), DEFAULT_MAX_WORKERS, _fetch_ledger_artefact)?;
+
+        let mut artefacts = HashMap::new();
+        for (id, artefact) in ids.into_iter().zip(fetched.into_iter()) {
+            match artefact {
+                Ok(artefact) => { artefacts.insert(id, artefact); }
+                Err(err) => warn!("Failed to resolve ledger artefact {:?}: {}", id, err)
+            }
+        }
+        Ok(HolderLedgerArtefacts { artefacts })
+    }
+
+    pub fn get(&self, id: &HolderLedgerArtefactId) -> VcxResult<String> {
+        match self.artefacts.get(id) {
+            Some(artefact) => Ok(artefact.clone()),
+            None => _fetch_ledger_artefact(id.clone())
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.artefacts.len()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::utils::constants::{CRED_DEF_ID, CRED_DEF_JSON, REV_REG_ID};
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_resolve_deduplicates_artefacts() {
+        let _setup = SetupMocks::init();
+
+        let artefacts = HolderLedgerArtefacts::resolve(vec![
+            HolderLedgerArtefactId::CredDef(CRED_DEF_ID.to_string()),
+            HolderLedgerArtefactId::RevRegDef(REV_REG_ID.to_string()),
+            HolderLedgerArtefactId::CredDef(CRED_DEF_ID.to_string()),
+        ]).unwrap();
+
+        assert_eq!(artefacts.len(), 2);
+        assert_eq!(artefacts.get(&HolderLedgerArtefactId::CredDef(CRED_DEF_ID.to_string())).unwrap(), CRED_DEF_JSON);
+        assert_eq!(HolderLedgerArtefacts::default().get(&HolderLedgerArtefactId::CredDef(CRED_DEF_ID.to_string())).unwrap(), CRED_DEF_JSON);
+    }
+}
@@ -1,13 +1,14 @@
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
-use crate::messages::a2a::A2AMessage;
+use crate::messages::a2a::{A2AMessage, A2AMessageKind};
 
 pub mod holder;
+pub mod ledger_artefacts;
 mod state_machine;
 mod states;
 
 pub fn get_credential_offer_messages(connection: &Connection) -> VcxResult<String> {
-    let credential_offers: Vec<A2AMessage> = connection.get_messages()?
+    let credential_offers: Vec<A2AMessage> = connection.get_messages_of_kinds(&[A2AMessageKind::CredentialOffer])?
         .into_iter()
         .filter_map(|(_, a2a_message)| {
             match a2a_message {
@@ -2,12 +2,13 @@ use std::collections::HashMap;
 
 use crate::error::prelude::*;
 use crate::handlers::issuance::holder::holder::HolderState;
+use crate::handlers::issuance::holder::ledger_artefacts::{HolderLedgerArtefactId, HolderLedgerArtefacts};
 use crate::handlers::issuance::holder::states::finished::FinishedHolderState;
 use crate::handlers::issuance::holder::states::offer_received::OfferReceivedState;
 use crate::handlers::issuance::holder::states::request_sent::RequestSentState;
 use crate::handlers::issuance::messages::CredentialIssuanceMessage;
 use crate::handlers::issuance::verify_thread_id;
-use crate::libindy::utils::anoncreds::{self, get_cred_def_json, libindy_prover_create_credential_req, libindy_prover_delete_credential, libindy_prover_store_credential};
+use crate::libindy::utils::anoncreds::{get_cred_def_json, libindy_prover_create_credential_req, libindy_prover_delete_credential, libindy_prover_store_credential};
 use crate::messages::a2a::A2AMessage;
 use crate::messages::error::ProblemReport;
 use crate::messages::issuance::credential::Credential;
@@ -98,14 +99,39 @@ impl HolderSM {
         HolderSM { state, source_id, thread_id }
     }
 
+    /**
+    Ledger artefacts the state machine needs to handle the message, so they can be resolved for several
+    holders at once and passed to handle_message_with_artefacts.
+     */
+    pub fn referenced_ledger_artefacts(&self, cim: &CredentialIssuanceMessage) -> VcxResult<Vec<HolderLedgerArtefactId>> {
+        match (&self.state, cim) {
+            (HolderFullState::OfferReceived(state_data), CredentialIssuanceMessage::CredentialRequestSend(_)) => {
+                let cred_offer = state_data.offer.offers_attach.content()?;
+                Ok(vec![HolderLedgerArtefactId::CredDef(parse_cred_def_id_from_cred_offer(&cred_offer)?)])
+            }
+            (HolderFullState::RequestSent(_), CredentialIssuanceMessage::Credential(credential)) => {
+                let credential_json = credential.credentials_attach.content()?;
+                Ok(_parse_rev_reg_id_from_credential(&credential_json)?.map(HolderLedgerArtefactId::RevRegDef).into_iter().collect())
+            }
+            _ => Ok(vec![])
+        }
+    }
+
     pub fn handle_message(self, cim: CredentialIssuanceMessage, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>) -> VcxResult<HolderSM> {
+        self.handle_message_with_artefacts(cim, send_message, &HolderLedgerArtefacts::default())
+    }
+
+    pub fn handle_message_with_artefacts(self,
+                                         cim: CredentialIssuanceMessage,
+                                         send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>,
+                                         artefacts: &HolderLedgerArtefacts) -> VcxResult<HolderSM> {
         trace!("Holder::handle_message >>> cim: {:?}, state: {:?}", cim, self.state);
         let HolderSM { state, source_id, thread_id } = self;
         verify_thread_id(&thread_id, &cim)?;
         let state = match state {
             HolderFullState::OfferReceived(state_data) => match cim {
                 CredentialIssuanceMessage::CredentialRequestSend(my_pw_did) => {
-                    let request = _make_credential_request(my_pw_did, &state_data.offer);
+                    let request = _make_credential_request(my_pw_did, &state_data.offer, artefacts);
                     match request {
                         Ok((cred_request, req_meta, cred_def_json)) => {
                             let cred_request = cred_request
@@ -133,7 +159,7 @@ impl HolderSM {
             },
             HolderFullState::RequestSent(state_data) => match cim {
                 CredentialIssuanceMessage::Credential(credential) => {
-                    let result = _store_credential(&credential, &state_data.req_meta, &state_data.cred_def_json);
+                    let result = _store_credential(&credential, &state_data.req_meta, &state_data.cred_def_json, artefacts);
                     match result {
                         Ok((cred_id, rev_reg_def_json)) => {
                             if credential.please_ack.is_some() {
@@ -283,16 +309,15 @@ fn _parse_rev_reg_id_from_credential(credential: &str) -> VcxResult<Option<Strin
 }
 
 fn _store_credential(credential: &Credential,
-                     req_meta: &str, cred_def_json: &str) -> VcxResult<(String, Option<String>)> {
+                     req_meta: &str, cred_def_json: &str,
+                     artefacts: &HolderLedgerArtefacts) -> VcxResult<(String, Option<String>)> {
     trace!("Holder::_store_credential >>> credential: {:?}, req_meta: {}, cred_def_json: {}", credential, req_meta, cred_def_json);
 
     let credential_json = credential.credentials_attach.content()?;
     let rev_reg_id = _parse_rev_reg_id_from_credential(&credential_json)?;
-    let rev_reg_def_json = if let Some(rev_reg_id) = rev_reg_id {
-        let (_, json) = anoncreds::get_rev_reg_def_json(&rev_reg_id)?;
-        Some(json)
-    } else {
-        None
+    let rev_reg_def_json = match rev_reg_id {
+        Some(rev_reg_id) => Some(artefacts.get(&HolderLedgerArtefactId::RevRegDef(rev_reg_id))?),
+        None => None
     };
 
     let cred_id = libindy_prover_store_credential(None,
@@ -318,13 +343,15 @@ pub fn create_credential_request(cred_def_id: &str, prover_did: &str, cred_offer
         .map_err(|err| err.extend("Cannot create credential request")).map(|(s1, s2)| (s1, s2, cred_def_id, cred_def_json))
 }
 
-fn _make_credential_request(my_pw_did: String, offer: &CredentialOffer) -> VcxResult<(CredentialRequest, String, String)> {
+fn _make_credential_request(my_pw_did: String, offer: &CredentialOffer, artefacts: &HolderLedgerArtefacts) -> VcxResult<(CredentialRequest, String, String)> {
     trace!("Holder::_make_credential_request >>> my_pw_did: {:?}, offer: {:?}", my_pw_did, offer);
 
     let cred_offer = offer.offers_attach.content()?;
     trace!("Parsed cred offer attachment: {}", cred_offer);
     let cred_def_id = parse_cred_def_id_from_cred_offer(&cred_offer)?;
-    let (req, req_meta, _cred_def_id, cred_def_json) = create_credential_request(&cred_def_id, &my_pw_did, &cred_offer)?;
+    let cred_def_json = artefacts.get(&HolderLedgerArtefactId::CredDef(cred_def_id))?;
+    let (req, req_meta) = libindy_prover_create_credential_req(&my_pw_did, &cred_offer, &cred_def_json)
+        .map_err(|err| err.extend("Cannot create credential request"))?;
     trace!("Created cred def json: {}", cred_def_json);
     Ok((CredentialRequest::create().set_requests_attach(req)?, req_meta, cred_def_json))
 }
@@ -683,4 +710,43 @@ mod test {
             assert_eq!(true, _holder_sm().to_finished_state().is_revokable().unwrap());
         }
     }
+
+    mod referenced_ledger_artefacts {
+        use super::*;
+
+        #[test]
+        #[cfg(feature = "general_test")]
+        fn test_referenced_ledger_artefacts() {
+            let _setup = SetupMocks::init();
+
+            let cred_offer = _credential_offer().offers_attach.content().unwrap();
+            let cred_def_id = parse_cred_def_id_from_cred_offer(&cred_offer).unwrap();
+            assert_eq!(vec![HolderLedgerArtefactId::CredDef(cred_def_id)],
+                       _holder_sm().referenced_ledger_artefacts(&CredentialIssuanceMessage::CredentialRequestSend(_my_pw_did())).unwrap());
+
+            let credential_json = _credential().credentials_attach.content().unwrap();
+            let rev_reg_id = _parse_rev_reg_id_from_credential(&credential_json).unwrap().unwrap();
+            assert_eq!(vec![HolderLedgerArtefactId::RevRegDef(rev_reg_id)],
+                       _holder_sm().to_request_sent_state().referenced_ledger_artefacts(&CredentialIssuanceMessage::Credential(_credential())).unwrap());
+
+            assert!(_holder_sm().to_finished_state().referenced_ledger_artefacts(&CredentialIssuanceMessage::Credential(_credential())).unwrap().is_empty());
+        }
+
+        #[test]
+        #[cfg(feature = "general_test")]
+        fn test_handle_message_with_resolved_artefacts() {
+            let _setup = SetupMocks::init();
+
+            let holder_sm = _holder_sm();
+            let cim = CredentialIssuanceMessage::CredentialRequestSend(_my_pw_did());
+            let artefacts = HolderLedgerArtefacts::resolve(holder_sm.referenced_ledger_artefacts(&cim).unwrap()).unwrap();
+            let holder_sm = holder_sm.handle_message_with_artefacts(cim, _send_message(), &artefacts).unwrap();
+            assert_match!(HolderFullState::RequestSent(_), holder_sm.state);
+
+            let cim = CredentialIssuanceMessage::Credential(_credential());
+            let artefacts = HolderLedgerArtefacts::resolve(holder_sm.referenced_ledger_artefacts(&cim).unwrap()).unwrap();
+            let holder_sm = holder_sm.handle_message_with_artefacts(cim, _send_message(), &artefacts).unwrap();
+            assert_eq!(HolderState::Finished, holder_sm.get_state());
+        }
+    }
 }
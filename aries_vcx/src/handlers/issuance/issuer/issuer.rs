@@ -1,4 +1,7 @@
 use std::collections::HashMap;
+use std::sync::Arc;
+
+use agency_client::metrics;
 
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
@@ -6,6 +9,10 @@ use crate::handlers::issuance::issuer::state_machine::IssuerSM;
 use crate::handlers::issuance::messages::CredentialIssuanceMessage;
 use crate::messages::a2a::A2AMessage;
 
+lazy_static! {
+    static ref ISSUER_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("issuer_transition");
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone, Default)]
 pub struct Issuer {
     issuer_sm: IssuerSM,
@@ -81,7 +88,7 @@ impl Issuer {
     }
 
     pub fn step(&mut self, message: CredentialIssuanceMessage, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>) -> VcxResult<()> {
-        self.issuer_sm = self.issuer_sm.clone().handle_message(message, send_message)?;
+        self.issuer_sm = ISSUER_TRANSITION.time(|| self.issuer_sm.clone().handle_message(message, send_message))?;
         Ok(())
     }
 
@@ -1,4 +1,5 @@
 pub mod issuer;
+pub mod offer_pool;
 pub mod utils;
 mod state_machine;
 mod states;
@@ -0,0 +1,119 @@
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+
+use crate::error::prelude::*;
+use crate::libindy::utils::anoncreds::libindy_issuer_create_credential_offer;
+use crate::utils::refill_pool::{RefillPool, RefillPoolConfig, RefillSource};
+
+lazy_static! {
+    static ref OFFER_POOLS: Mutex<HashMap<String, Arc<RefillPool<CredentialOfferSource>>>> = Default::default();
+}
+
+pub type OfferPoolConfig = RefillPoolConfig;
+
+/*
+Credential offers created ahead of time for credential definitions with enabled pool, so sending an
+offer does not wait for libindy to load key correctness proof from the wallet. Every offer carries its
+own nonce, so an offer is removed from the pool once taken and is never handed out twice. Offers are
+only kept in memory.
+ */
+struct CredentialOfferSource {
+    cred_def_id: String,
+}
+
+impl RefillSource for CredentialOfferSource {
+    type Item = String;
+
+    fn name(&self) -> &'static str {
+        "offer"
+    }
+
+    fn provision(&self) -> VcxResult<String> {
+        libindy_issuer_create_credential_offer(&self.cred_def_id)
+    }
+}
+
+fn _get_pool(cred_def_id: &str) -> VcxResult<Option<Arc<RefillPool<CredentialOfferSource>>>> {
+    Ok(OFFER_POOLS.lock()?.get(cred_def_id).cloned())
+}
+
+///
+/// Keeps up to `capacity` credential offers for the credential definition created in background.
+///
+pub fn enable_offer_pool(cred_def_id: &str, config: OfferPoolConfig) -> VcxResult<()> {
+    trace!("enable_offer_pool >>> cred_def_id: {}, config: {:?}", cred_def_id, config);
+    let pool = OFFER_POOLS.lock()?
+        .entry(cred_def_id.to_string())
+        .or_insert_with(|| Arc::new(RefillPool::new(CredentialOfferSource { cred_def_id: cred_def_id.to_string() })))
+        .clone();
+    pool.enable(config)
+}
+
+///
+/// Drops offers kept for the credential definition and stops creating new ones.
+///
+pub fn disable_offer_pool(cred_def_id: &str) -> VcxResult<()> {
+    trace!("disable_offer_pool >>> cred_def_id: {}", cred_def_id);
+    if let Some(pool) = _get_pool(cred_def_id)? {
+        pool.disable();
+    }
+    Ok(())
+}
+
+pub fn reset_offer_pools() {
+    if let Ok(mut pools) = OFFER_POOLS.lock() {
+        pools.drain().for_each(|(_, pool)| pool.disable());
+    }
+}
+
+///
+/// Returns credential offer for the credential definition. Each offer is returned just once, a new
+/// one is created if the pool is disabled or empty.
+///
+pub fn take_credential_offer(cred_def_id: &str) -> VcxResult<String> {
+    let offer = match _get_pool(cred_def_id)? {
+        Some(pool) => pool.take()?,
+        None => None
+    };
+    match offer {
+        Some(offer) => Ok(offer),
+        None => libindy_issuer_create_credential_offer(cred_def_id)
+    }
+}
+
+pub fn offer_pool_size(cred_def_id: &str) -> usize {
+    _get_pool(cred_def_id).ok().flatten().map(|pool| pool.len()).unwrap_or(0)
+}
+
+#[cfg(test)]
+pub mod tests {
+    use crate::utils::constants::LIBINDY_CRED_OFFER;
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_take_credential_offer_without_pool() {
+        let _setup = SetupMocks::init();
+
+        let config = OfferPoolConfig { capacity: 1, low_water_mark: 1 };
+        assert_eq!(enable_offer_pool("cred_def_id", config).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+
+        assert_eq!(take_credential_offer("cred_def_id").unwrap(), LIBINDY_CRED_OFFER);
+        assert_eq!(offer_pool_size("cred_def_id"), 0);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_disable_offer_pool() {
+        let _setup = SetupMocks::init();
+
+        enable_offer_pool("disabled_cred_def_id", OfferPoolConfig { capacity: 2, low_water_mark: 0 }).unwrap();
+        disable_offer_pool("disabled_cred_def_id").unwrap();
+        disable_offer_pool("unknown_cred_def_id").unwrap();
+
+        assert_eq!(take_credential_offer("disabled_cred_def_id").unwrap(), LIBINDY_CRED_OFFER);
+        assert_eq!(offer_pool_size("disabled_cred_def_id"), 0);
+    }
+}
@@ -2,6 +2,7 @@ use std::collections::HashMap;
 
 use crate::error::{VcxError, VcxErrorKind, VcxResult};
 use crate::handlers::issuance::issuer::issuer::IssuerState;
+use crate::handlers::issuance::issuer::offer_pool::take_credential_offer;
 use crate::handlers::issuance::issuer::states::credential_sent::CredentialSentState;
 use crate::handlers::issuance::issuer::states::finished::FinishedState;
 use crate::handlers::issuance::issuer::states::initial::InitialState;
@@ -10,7 +11,7 @@ use crate::handlers::issuance::issuer::states::requested_received::RequestReceiv
 use crate::handlers::issuance::issuer::utils::encode_attributes;
 use crate::handlers::issuance::messages::CredentialIssuanceMessage;
 use crate::handlers::issuance::verify_thread_id;
-use crate::libindy::utils::anoncreds::{self, libindy_issuer_create_credential_offer};
+use crate::libindy::utils::anoncreds;
 use crate::messages::a2a::A2AMessage;
 use crate::messages::error::ProblemReport;
 use crate::messages::issuance::credential::Credential;
@@ -207,7 +208,7 @@ impl IssuerSM {
         let state = match state {
             IssuerFullState::Initial(state_data) => match cim {
                 CredentialIssuanceMessage::CredentialInit(comment) => {
-                    let cred_offer = libindy_issuer_create_credential_offer(&state_data.cred_def_id)?;
+                    let cred_offer = take_credential_offer(&state_data.cred_def_id)?;
                     let cred_offer_msg = CredentialOffer::create()
                         .set_offers_attach(&cred_offer)?
                         .set_comment(comment);
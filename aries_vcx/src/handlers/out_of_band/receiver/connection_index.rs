@@ -0,0 +1,180 @@
+use std::collections::{BTreeSet, HashMap};
+use std::hash::Hash;
+
+use crate::error::prelude::*;
+use crate::handlers::connection::connection::Connection;
+use crate::messages::connection::did_doc::DidDoc;
+use crate::messages::connection::service::{FullService, ServiceResolvable};
+
+/*
+Connections keyed by what an out-of-band invitation can be matched against: the DID of the bootstrap
+DidDoc the connection was created from, and the fingerprint of its service. The fingerprint holds the
+keys compared by FullService equality, so a lookup gives the same answer as comparing the resolved
+service with every connection, while services are resolved once per connection when it is indexed
+and once per invitation when it is looked up.
+ */
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+struct ServiceFingerprint {
+    recipient_keys: Vec<String>,
+    routing_keys: Vec<String>,
+}
+
+impl From<&FullService> for ServiceFingerprint {
+    fn from(service: &FullService) -> Self {
+        ServiceFingerprint {
+            recipient_keys: service.recipient_keys.clone(),
+            routing_keys: service.routing_keys.clone(),
+        }
+    }
+}
+
+#[derive(Debug)]
+struct IndexEntry {
+    did: String,
+    fingerprint: Option<ServiceFingerprint>,
+}
+
+#[derive(Debug)]
+pub struct ConnectionIndex<K> {
+    entries: HashMap<K, IndexEntry>,
+    by_did: HashMap<String, BTreeSet<K>>,
+    by_service: HashMap<ServiceFingerprint, BTreeSet<K>>,
+}
+
+impl<K: Copy + Ord + Hash> Default for ConnectionIndex<K> {
+    fn default() -> Self {
+        ConnectionIndex {
+            entries: HashMap::new(),
+            by_did: HashMap::new(),
+            by_service: HashMap::new(),
+        }
+    }
+}
+
+impl<K: Copy + Ord + Hash> ConnectionIndex<K> {
+    pub fn new() -> Self {
+        Self::default()
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    ///
+    /// Indexes connection under `key`, replacing what was indexed under it before. Connections
+    /// without bootstrap DidDoc, like inviter ones, cannot be reused and are not indexed.
+    ///
+    pub fn insert(&mut self, key: K, connection: &Connection) {
+        self.remove(key);
+        if let Some(did_doc) = connection.bootstrap_did_doc() {
+            self.insert_did_doc(key, &did_doc);
+        }
+    }
+
+    fn insert_did_doc(&mut self, key: K, did_doc: &DidDoc) {
+        let fingerprint = did_doc.resolve_service().ok().map(|service| ServiceFingerprint::from(&service));
+        self.by_did.entry(did_doc.id.clone()).or_default().insert(key);
+        if let Some(fingerprint) = &fingerprint {
+            self.by_service.entry(fingerprint.clone()).or_default().insert(key);
+        }
+        self.entries.insert(key, IndexEntry { did: did_doc.id.clone(), fingerprint });
+    }
+
+    pub fn remove(&mut self, key: K) {
+        if let Some(entry) = self.entries.remove(&key) {
+            _remove_key(&mut self.by_did, &entry.did, key);
+            if let Some(fingerprint) = entry.fingerprint {
+                _remove_key(&mut self.by_service, &fingerprint, key);
+            }
+        }
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.clear();
+        self.by_did.clear();
+        self.by_service.clear();
+    }
+
+    ///
+    /// Returns first connection accepted by `accept` which was bootstrapped from any of the services.
+    /// Services are tried in order, each one matching by DID first and by resolved service second.
+    ///
+    pub fn find<F: Fn(&K) -> bool>(&self, services: &[ServiceResolvable], accept: F) -> VcxResult<Option<K>> {
+        if self.entries.is_empty() {
+            return Ok(None);
+        }
+        for service in services {
+            if let ServiceResolvable::Did(did) = service {
+                if let Some(key) = _first_accepted(self.by_did.get(did), &accept) {
+                    return Ok(Some(key));
+                }
+            }
+            let fingerprint = ServiceFingerprint::from(&service.resolve()?);
+            if let Some(key) = _first_accepted(self.by_service.get(&fingerprint), &accept) {
+                return Ok(Some(key));
+            }
+        }
+        Ok(None)
+    }
+}
+
+fn _remove_key<I: Eq + Hash, K: Ord>(index: &mut HashMap<I, BTreeSet<K>>, id: &I, key: K) {
+    if let Some(keys) = index.get_mut(id) {
+        keys.remove(&key);
+        if keys.is_empty() {
+            index.remove(id);
+        }
+    }
+}
+
+fn _first_accepted<K: Copy, F: Fn(&K) -> bool>(keys: Option<&BTreeSet<K>>, accept: &F) -> Option<K> {
+    keys.and_then(|keys| keys.iter().find(|key| accept(key)).copied())
+}
+
+#[cfg(test)]
+pub mod tests {
+    use crate::messages::connection::did_doc::test_utils::{_did_doc, _recipient_keys, _routing_keys, _service_endpoint};
+
+    use super::*;
+
+    fn _service() -> FullService {
+        FullService::create()
+            .set_service_endpoint(_service_endpoint())
+            .set_recipient_keys(_recipient_keys())
+            .set_routing_keys(_routing_keys())
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_index_finds_connection_by_did_and_service() {
+        let did_doc = _did_doc();
+        let mut index = ConnectionIndex::new();
+        index.insert_did_doc(3u32, &did_doc);
+        index.insert_did_doc(7u32, &did_doc);
+        assert_eq!(index.len(), 2);
+
+        let by_did = vec![ServiceResolvable::Did(did_doc.id.clone())];
+        assert_eq!(index.find(&by_did, |_| true).unwrap(), Some(3));
+        assert_eq!(index.find(&by_did, |key| *key != 3).unwrap(), Some(7));
+
+        let by_service = vec![ServiceResolvable::FullService(_service())];
+        assert_eq!(index.find(&by_service, |_| true).unwrap(), Some(3));
+
+        let other_service = vec![ServiceResolvable::FullService(_service().set_recipient_keys(vec!["other".to_string()]))];
+        assert_eq!(index.find(&other_service, |_| true).unwrap(), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_index_forgets_removed_connections() {
+        let did_doc = _did_doc();
+        let mut index = ConnectionIndex::new();
+        index.insert_did_doc(1u32, &did_doc);
+        index.remove(1);
+
+        assert_eq!(index.len(), 0);
+        assert!(index.by_did.is_empty());
+        assert!(index.by_service.is_empty());
+        assert_eq!(index.find(&vec![ServiceResolvable::FullService(_service())], |_| true).unwrap(), None);
+    }
+}
@@ -1 +1,2 @@
 pub mod receiver;
+pub mod connection_index;
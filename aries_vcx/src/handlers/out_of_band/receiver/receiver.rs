@@ -1,4 +1,5 @@
 use crate::handlers::out_of_band::OutOfBand;
+use crate::handlers::out_of_band::receiver::connection_index::ConnectionIndex;
 use crate::handlers::connection::connection::Connection;
 use crate::error::prelude::*;
 use crate::messages::a2a::A2AMessage;
@@ -9,8 +10,8 @@ use crate::messages::issuance::credential::Credential;
 use crate::messages::proof_presentation::presentation_request::PresentationRequest;
 use crate::messages::proof_presentation::presentation::Presentation;
 use crate::messages::connection::invite::{Invitation, PairwiseInvitation};
-use crate::messages::connection::service::ServiceResolvable;
 use std::convert::TryFrom;
+use std::hash::Hash;
 
 #[derive(Default, Debug, PartialEq)]
 pub struct OutOfBandReceiver {
@@ -28,24 +29,20 @@ impl OutOfBandReceiver {
 
     pub fn connection_exists<'a>(&self, connections: &'a Vec<&'a Connection>) -> VcxResult<Option<&'a Connection>> {
         trace!("OutOfBand::connection_exists >>>");
-        for service in &self.oob.services {
-            for connection in connections {
-                match connection.bootstrap_did_doc() {
-                    Some(did_doc) => {
-                        if let ServiceResolvable::Did(did) = service {
-                            if did.to_string() == did_doc.id {
-                                return Ok(Some(connection))
-                            }
-                        };
-                        if did_doc.resolve_service()? == service.resolve()? {
-                            return Ok(Some(connection))
-                        };
-                    }
-                    None => break
-                }
-            }
-        };
-        Ok(None)
+        let mut index = ConnectionIndex::new();
+        for (position, connection) in connections.iter().enumerate() {
+            index.insert(position, connection);
+        }
+        Ok(self.connection_exists_in_index(&index, |_| true)?.map(|position| connections[position]))
+    }
+
+    ///
+    /// Looks up connection which can be reused for this invitation among indexed connections
+    /// accepted by `accept`.
+    ///
+    pub fn connection_exists_in_index<K: Copy + Ord + Hash, F: Fn(&K) -> bool>(&self, index: &ConnectionIndex<K>, accept: F) -> VcxResult<Option<K>> {
+        trace!("OutOfBand::connection_exists_in_index >>> indexed connections: {}", index.len());
+        index.find(&self.oob.services, accept)
     }
 
     // TODO: There may be multiple A2AMessages in a single OoB msg
@@ -1,6 +1,6 @@
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
-use crate::messages::a2a::A2AMessage;
+use crate::messages::a2a::{A2AMessage, A2AMessageKind};
 use crate::handlers::proof_presentation::prover::messages::ProverMessages;
 use crate::settings;
 
@@ -10,7 +10,7 @@ mod messages;
 mod states;
 
 pub fn get_proof_request_messages(connection: &Connection) -> VcxResult<String> {
-    let presentation_requests: Vec<A2AMessage> = connection.get_messages()?
+    let presentation_requests: Vec<A2AMessage> = connection.get_messages_of_kinds(&[A2AMessageKind::PresentationRequest])?
         .into_iter()
         .filter_map(|(_, message)| {
             match message {
@@ -1,4 +1,7 @@
 use std::collections::HashMap;
+use std::sync::Arc;
+
+use agency_client::metrics;
 
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
@@ -10,6 +13,10 @@ use crate::messages::proof_presentation::presentation::Presentation;
 use crate::messages::proof_presentation::presentation_proposal::PresentationPreview;
 use crate::messages::proof_presentation::presentation_request::PresentationRequest;
 
+lazy_static! {
+    static ref PROVER_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("prover_transition");
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone, Default)]
 pub struct Prover {
     prover_sm: ProverSM,
@@ -100,7 +107,7 @@ impl Prover {
                 send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>)
                 -> VcxResult<()>
     {
-        self.prover_sm = self.prover_sm.clone().step(message, send_message)?;
+        self.prover_sm = PROVER_TRANSITION.time(|| self.prover_sm.clone().step(message, send_message))?;
         Ok(())
     }
 
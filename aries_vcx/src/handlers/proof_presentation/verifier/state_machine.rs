@@ -82,7 +82,27 @@ impl VerifierSM {
         None
     }
 
+    /**
+    Proof and proof request which need to be validated to handle the message, so presentations received
+    by several verifiers can be validated at once and the results passed to step_with_validation.
+     */
+    pub fn presentation_to_validate(&self, message: &VerifierMessages) -> VcxResult<Option<(String, String)>> {
+        match (&self.state, message) {
+            (VerifierFullState::PresentationRequestSent(state), VerifierMessages::VerifyPresentation(presentation)) => {
+                Ok(Some((presentation.presentations_attach.content()?, state.presentation_request.request_presentations_attach.content()?)))
+            }
+            _ => Ok(None)
+        }
+    }
+
     pub fn step(self, message: VerifierMessages, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>) -> VcxResult<VerifierSM> {
+        self.step_with_validation(message, send_message, None)
+    }
+
+    pub fn step_with_validation(self,
+                                message: VerifierMessages,
+                                send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>,
+                                validation: Option<VcxResult<bool>>) -> VcxResult<VerifierSM> {
         trace!("VerifierSM::step >>> message: {:?}", message);
         let VerifierSM { source_id, state } = self.clone();
         verify_thread_id(&self.thread_id(), &message)?;
@@ -107,7 +127,7 @@ impl VerifierSM {
             VerifierFullState::PresentationRequestSent(state) => {
                 match message {
                     VerifierMessages::VerifyPresentation(presentation) => {
-                        match state.verify_presentation(&presentation, &self.thread_id(), send_message) {
+                        match state.verify_presentation_with(&presentation, &self.thread_id(), send_message, validation) {
                             Ok(()) => {
                                 VerifierFullState::Finished((state, presentation, RevocationStatus::NonRevoked).into())
                             }
@@ -339,6 +359,27 @@ pub mod test {
             assert_eq!(Status::Failed(ProblemReport::create()).code(), verifier_sm.presentation_status());
         }
 
+        #[test]
+        #[cfg(feature = "general_test")]
+        fn test_prover_handle_presentation_validated_in_batch() {
+            let _setup = SetupMocks::init();
+
+            let send_message = Some(&|_: &A2AMessage| VcxResult::Ok(()));
+            let mut verifier_sm = _verifier_sm();
+            let message = VerifierMessages::VerifyPresentation(_presentation());
+            assert!(verifier_sm.presentation_to_validate(&message).unwrap().is_none());
+
+            verifier_sm = verifier_sm.step(VerifierMessages::SendPresentationRequest(_comment()), send_message).unwrap();
+            assert!(verifier_sm.presentation_to_validate(&message).unwrap().is_some());
+
+            let finished_sm = verifier_sm.clone().step_with_validation(message.clone(), send_message, Some(Ok(true))).unwrap();
+            assert_eq!(Status::Success.code(), finished_sm.presentation_status());
+
+            let validation = Err(VcxError::from_msg(VcxErrorKind::PoolLedgerConnect, "Cannot get schema"));
+            let failed_sm = verifier_sm.step_with_validation(message, send_message, Some(validation)).unwrap();
+            assert_eq!(VerifierState::Failed, failed_sm.get_state());
+        }
+
         #[test]
         #[cfg(feature = "general_test")]
         fn test_prover_presentation_verification_fails_with_incorrect_thread_id() {
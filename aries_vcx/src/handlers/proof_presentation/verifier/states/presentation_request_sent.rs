@@ -17,12 +17,27 @@ pub struct PresentationRequestSentState {
 
 impl PresentationRequestSentState {
     pub fn verify_presentation(&self, presentation: &Presentation, thread_id: &str, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>) -> VcxResult<()> {
+        self.verify_presentation_with(presentation, thread_id, send_message, None)
+    }
+
+    /**
+    Same as verify_presentation, but uses `validation` as the result of proof validation if given,
+    e.g. when the presentation was validated as part of a batch.
+     */
+    pub fn verify_presentation_with(&self,
+                                    presentation: &Presentation,
+                                    thread_id: &str,
+                                    send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>,
+                                    validation: Option<VcxResult<bool>>) -> VcxResult<()> {
         if !settings::indy_mocks_enabled() && !presentation.from_thread(&thread_id) {
             return Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot handle proof presentation: thread id does not match: {:?}", presentation.thread)));
         };
 
-        let valid = validate_indy_proof(&presentation.presentations_attach.content()?,
-                                        &self.presentation_request.request_presentations_attach.content()?)?;
+        let valid = match validation {
+            Some(validation) => validation?,
+            None => validate_indy_proof(&presentation.presentations_attach.content()?,
+                                        &self.presentation_request.request_presentations_attach.content()?)?
+        };
 
         if !valid {
             return Err(VcxError::from_msg(VcxErrorKind::InvalidProof, "Presentation verification failed"));
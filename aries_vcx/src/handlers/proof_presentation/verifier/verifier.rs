@@ -1,12 +1,20 @@
 use std::collections::HashMap;
+use std::sync::Arc;
+
+use agency_client::metrics;
 
 use crate::error::prelude::*;
 use crate::handlers::connection::connection::Connection;
 use crate::handlers::proof_presentation::verifier::messages::VerifierMessages;
 use crate::handlers::proof_presentation::verifier::state_machine::VerifierSM;
+use crate::libindy::proofs::proof_request::ProofRequestTemplate;
 use crate::messages::a2a::A2AMessage;
 use crate::messages::proof_presentation::presentation_request::*;
 
+lazy_static! {
+    static ref VERIFIER_TRANSITION: Arc<metrics::Histogram> = metrics::histogram("verifier_transition");
+}
+
 #[derive(Serialize, Deserialize, Debug, Clone, PartialEq, Default)]
 pub struct Verifier {
     verifier_sm: VerifierSM,
@@ -29,13 +37,14 @@ impl Verifier {
         trace!("Verifier::create >>> source_id: {:?}, requested_attrs: {:?}, requested_predicates: {:?}, revocation_details: {:?}, name: {:?}",
                source_id, requested_attrs, requested_predicates, revocation_details, name);
 
-        let presentation_request =
-            PresentationRequestData::create()
-                .set_name(name)
-                .set_requested_attributes(requested_attrs)?
-                .set_requested_predicates(requested_predicates)?
-                .set_not_revoked_interval(revocation_details)?
-                .set_nonce()?;
+        let template = ProofRequestTemplate::compile(name, requested_attrs, requested_predicates, revocation_details)?;
+        Verifier::create_from_template(source_id, &template)
+    }
+
+    pub fn create_from_template(source_id: String, template: &ProofRequestTemplate) -> VcxResult<Verifier> {
+        trace!("Verifier::create_from_template >>> source_id: {:?}, template: {:?}", source_id, template.name());
+
+        let presentation_request = template.instantiate()?;
 
         Ok(Verifier {
             verifier_sm: VerifierSM::new(presentation_request, source_id),
@@ -94,7 +103,23 @@ impl Verifier {
     pub fn step(&mut self, message: VerifierMessages, send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>)
                 -> VcxResult<()>
     {
-        self.verifier_sm = self.verifier_sm.clone().step(message, send_message)?;
+        self.verifier_sm = VERIFIER_TRANSITION.time(|| self.verifier_sm.clone().step(message, send_message))?;
+        Ok(())
+    }
+
+    pub fn presentation_to_validate(&self, message: &VerifierMessages) -> VcxResult<Option<(String, String)>> {
+        self.verifier_sm.presentation_to_validate(message)
+    }
+
+    /**
+    Same as step, but the received presentation is not validated again if `validation` holds the result
+    of validating it together with presentations of other verifiers.
+     */
+    pub fn step_with_validation(&mut self,
+                                message: VerifierMessages,
+                                send_message: Option<&impl Fn(&A2AMessage) -> VcxResult<()>>,
+                                validation: Option<VcxResult<bool>>) -> VcxResult<()> {
+        self.verifier_sm = VERIFIER_TRANSITION.time(|| self.verifier_sm.clone().step_with_validation(message, send_message, validation))?;
         Ok(())
     }
 
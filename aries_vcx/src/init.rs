@@ -1,10 +1,12 @@
+use std::time::Duration;
+
 use indy;
 use indy::ErrorCode;
 use indy::future::Future;
 use indy_sys::WalletHandle;
 
 use crate::error::{VcxErrorExt, VcxErrorKind, VcxResult};
-use crate::libindy::utils::pool::{create_pool_ledger_config, open_pool_ledger};
+use crate::libindy::utils::pool::{create_pool_ledger_config, open_pool_ledger, open_pool_ledger_in_background, start_pool_refresh};
 use crate::libindy::utils::wallet::{build_wallet_config, build_wallet_credentials, IssuerConfig, set_wallet_handle, WalletConfig};
 use crate::settings;
 use crate::utils::provision::AgencyClientConfig;
@@ -14,6 +16,8 @@ pub struct PoolConfig {
     pub genesis_path: String,
     pub pool_name: Option<String>,
     pub pool_config: Option<String>,
+    pub open_in_background: Option<bool>,
+    pub refresh_interval_secs: Option<u64>,
 }
 
 pub fn enable_vcx_mocks() -> VcxResult<()> {
@@ -51,10 +55,19 @@ pub fn open_main_pool(config: &PoolConfig) -> VcxResult<()> {
 
     debug!("open_pool ::: Pool Config Created Successfully");
 
-    open_pool_ledger(&pool_name, config.pool_config.as_deref())
-        .map_err(|err| err.extend("Can not open Pool Ledger"))?;
-
-    info!("open_pool ::: Pool Opened Successfully");
+    if config.open_in_background.unwrap_or(false) {
+        open_pool_ledger_in_background(&pool_name, config.pool_config.as_deref())
+            .map_err(|err| err.extend("Can not open Pool Ledger"))?;
+        info!("open_pool ::: Pool Opening Started");
+    } else {
+        open_pool_ledger(&pool_name, config.pool_config.as_deref())
+            .map_err(|err| err.extend("Can not open Pool Ledger"))?;
+        info!("open_pool ::: Pool Opened Successfully");
+    }
+
+    if let Some(refresh_interval_secs) = config.refresh_interval_secs.filter(|secs| *secs > 0) {
+        start_pool_refresh(Duration::from_secs(refresh_interval_secs))?;
+    }
 
     Ok(())
 }
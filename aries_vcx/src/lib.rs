@@ -6,6 +6,7 @@ pub extern crate agency_client;
 extern crate base64;
 extern crate chrono;
 extern crate failure;
+extern crate flate2;
 extern crate futures;
 pub extern crate indy_sys;
 pub extern crate indyrs as indy;
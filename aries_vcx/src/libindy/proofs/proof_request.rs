@@ -84,6 +84,38 @@ impl ProofRequestData {
     }
 }
 
+/*
+Proof request whose attributes, predicates and revocation interval were parsed and validated once.
+Verifiers sending the same request over and over instantiate it with a fresh nonce instead of building
+it from the json strings every time.
+ */
+#[derive(Debug, PartialEq, Clone)]
+pub struct ProofRequestTemplate {
+    data: ProofRequestData,
+}
+
+impl ProofRequestTemplate {
+    pub fn compile(name: String,
+                   requested_attrs: String,
+                   requested_predicates: String,
+                   revocation_details: String) -> VcxResult<ProofRequestTemplate> {
+        let data = ProofRequestData::create()
+            .set_name(name)
+            .set_requested_attributes(requested_attrs)?
+            .set_requested_predicates(requested_predicates)?
+            .set_not_revoked_interval(revocation_details)?;
+        Ok(ProofRequestTemplate { data })
+    }
+
+    pub fn instantiate(&self) -> VcxResult<ProofRequestData> {
+        self.data.clone().set_nonce()
+    }
+
+    pub fn name(&self) -> &str {
+        &self.data.name
+    }
+}
+
 impl Default for ProofRequestData {
     fn default() -> ProofRequestData {
         ProofRequestData {
@@ -143,6 +175,31 @@ mod tests {
         assert_eq!(msg_as_value["requested_predicates"]["predicate_0"]["name"], "age");
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_proof_request_template() {
+        let _setup = SetupDefaults::init();
+
+        let template = ProofRequestTemplate::compile("Test".into(),
+                                                     REQUESTED_ATTRS.into(),
+                                                     REQUESTED_PREDICATES.into(),
+                                                     r#"{"from":1100000000, "to": 1600000000}"#.into()).unwrap();
+        let first = template.instantiate().unwrap();
+        let second = template.instantiate().unwrap();
+
+        let expected = ProofRequestData::create()
+            .set_name("Test".into())
+            .set_not_revoked_interval(r#"{"from":1100000000, "to": 1600000000}"#.into()).unwrap()
+            .set_requested_attributes(REQUESTED_ATTRS.into()).unwrap()
+            .set_requested_predicates(REQUESTED_PREDICATES.into()).unwrap();
+        assert_eq!(ProofRequestData { nonce: String::new(), ..first.clone() }, expected);
+        assert!(!first.nonce.is_empty());
+        assert_ne!(first.nonce, second.nonce);
+
+        let err = ProofRequestTemplate::compile("Test".into(), "invalid".into(), REQUESTED_PREDICATES.into(), "{}".into()).unwrap_err();
+        assert_eq!(err.kind(), VcxErrorKind::InvalidJson);
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_requested_attrs_constructed_correctly() {
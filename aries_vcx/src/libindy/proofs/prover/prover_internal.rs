@@ -6,7 +6,7 @@ use crate::error::prelude::*;
 use crate::libindy::proofs::proof_request::ProofRequestData;
 use crate::libindy::proofs::proof_request_internal::NonRevokedInterval;
 use crate::libindy::utils::anoncreds;
-use crate::libindy::utils::anoncreds::{get_rev_reg_def_json, get_rev_reg_delta_json};
+use crate::libindy::utils::anoncreds::get_rev_reg_def_and_delta_json;
 
 #[derive(Debug, Deserialize, Serialize, PartialEq)]
 pub struct CredInfoProver {
@@ -125,9 +125,7 @@ pub fn build_rev_states_json(credentials_identifiers: &mut Vec<CredInfoProver>)
                 let (from, to) = if let Some(ref interval) = cred_info.revocation_interval
                 { (interval.from, interval.to) } else { (None, None) };
 
-                let (_, rev_reg_def_json) = get_rev_reg_def_json(&rev_reg_id)?;
-
-                let (rev_reg_id, rev_reg_delta_json, timestamp) = get_rev_reg_delta_json(
+                let (rev_reg_id, rev_reg_def_json, rev_reg_delta_json, timestamp) = get_rev_reg_def_and_delta_json(
                     &rev_reg_id,
                     from,
                     to,
@@ -1,6 +1,9 @@
 use crate::error::prelude::*;
-use crate::libindy::proofs::verifier::verifier_internal::{build_cred_defs_json_verifier, build_rev_reg_defs_json, build_rev_reg_json, build_schemas_json_verifier, get_credential_info, validate_proof_revealed_attributes};
+use std::sync::Arc;
+
+use crate::libindy::proofs::verifier::verifier_internal::{build_cred_defs_json_verifier, build_rev_reg_defs_json, build_rev_reg_json, build_schemas_json_verifier, CredInfoVerifier, fetch_ledger_artefact, get_credential_info, LedgerArtefact, LedgerArtefactKey, validate_proof_revealed_attributes, VerifierLedgerArtefacts};
 use crate::libindy::utils::anoncreds;
+use crate::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use crate::utils::mockdata::mock_settings::get_mock_result_for_validate_indy_proof;
 
 pub fn validate_indy_proof(proof_json: &str, proof_req_json: &str) -> VcxResult<bool> {
@@ -35,15 +38,96 @@ pub fn validate_indy_proof(proof_json: &str, proof_req_json: &str) -> VcxResult<
                                              &rev_regs_json)
 }
 
+/**
+Validates a batch of proofs, given as pairs of (proof_json, proof_req_json). Ledger data referenced by
+the proofs is deduplicated across the whole batch and fetched once, proofs are then verified in parallel.
+Results are returned in the order of input proofs. Proofs referencing ledger data which could not be
+fetched fail with the original fetch error.
+ */
+pub fn validate_indy_proofs(proofs: Vec<(String, String)>) -> VcxResult<Vec<VcxResult<bool>>> {
+    validate_indy_proofs_with(proofs, fetch_ledger_artefact)
+}
+
+pub fn validate_indy_proofs_with(proofs: Vec<(String, String)>, fetch: fn(LedgerArtefactKey) -> VcxResult<LedgerArtefact>) -> VcxResult<Vec<VcxResult<bool>>> {
+    let credential_data: Vec<VcxResult<Vec<CredInfoVerifier>>> = proofs.iter()
+        .map(|(proof_json, _)| {
+            validate_proof_revealed_attributes(proof_json)?;
+            get_credential_info(proof_json)
+        })
+        .collect();
+
+    let all_credential_data: Vec<&CredInfoVerifier> = credential_data.iter()
+        .filter_map(|data| data.as_ref().ok())
+        .flatten()
+        .collect();
+    let artefacts = Arc::new(VerifierLedgerArtefacts::resolve_with(&all_credential_data, fetch)?);
+
+    let tasks: Vec<(String, String, VcxResult<Vec<CredInfoVerifier>>)> = proofs.into_iter()
+        .zip(credential_data.into_iter())
+        .map(|((proof_json, proof_req_json), data)| (proof_json, proof_req_json, data))
+        .collect();
+
+    map_concurrently(tasks, DEFAULT_MAX_WORKERS, move |(proof_json, proof_req_json, data)| {
+        let data = data?;
+        let (schemas_json, credential_defs_json, rev_reg_defs_json, rev_regs_json) = artefacts.build_verifier_jsons(&data)?;
+        if let Some(mock_result) = get_mock_result_for_validate_indy_proof() {
+            return mock_result;
+        }
+        anoncreds::libindy_verifier_verify_proof(&proof_req_json,
+                                                 &proof_json,
+                                                 &schemas_json,
+                                                 &credential_defs_json,
+                                                 &rev_reg_defs_json,
+                                                 &rev_regs_json)
+    })
+}
+
 #[cfg(test)]
 pub mod tests {
     use crate::{libindy, settings, utils};
     use crate::libindy::proofs::proof_request::ProofRequestData;
     use crate::libindy::utils::anoncreds::test_utils::create_and_store_credential;
-    use crate::utils::devsetup::SetupLibraryWalletPoolZeroFees;
+    use crate::utils::constants::{CRED_DEF_ID, SCHEMA_ID};
+    use crate::utils::devsetup::{SetupLibraryWalletPoolZeroFees, SetupMocks};
+    use crate::utils::mockdata::mock_settings::MockBuilder;
 
     use super::*;
 
+    fn _proof_json(schema_id: &str) -> String {
+        json!({"identifiers": [{"schema_id": schema_id, "cred_def_id": CRED_DEF_ID, "rev_reg_id": null, "timestamp": null}]}).to_string()
+    }
+
+    fn _fetch_failing_unknown_schema(key: LedgerArtefactKey) -> VcxResult<LedgerArtefact> {
+        match key {
+            LedgerArtefactKey::Schema(ref schema_id) if schema_id == "unknown_schema_id" => Err(VcxError::from_msg(VcxErrorKind::PoolLedgerConnect, "Ledger request timed out")),
+            key => fetch_ledger_artefact(key)
+        }
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_validate_indy_proofs_reports_fetch_errors_per_proof() {
+        let _setup = SetupMocks::init();
+        let _mock_builder = MockBuilder::init().set_mock_result_for_validate_indy_proof(Ok(true));
+        let proof_req_json = json!({}).to_string();
+
+        let results = validate_indy_proofs_with(vec![
+            (_proof_json(SCHEMA_ID), proof_req_json.clone()),
+            (_proof_json(SCHEMA_ID), proof_req_json.clone()),
+        ], _fetch_failing_unknown_schema).unwrap();
+        assert_eq!(results.len(), 2);
+        assert!(results.iter().all(|result| *result.as_ref().unwrap()));
+
+        let results = validate_indy_proofs_with(vec![
+            (_proof_json(SCHEMA_ID), proof_req_json.clone()),
+            (_proof_json("unknown_schema_id"), proof_req_json.clone()),
+            ("not a proof".to_string(), proof_req_json),
+        ], _fetch_failing_unknown_schema).unwrap();
+        assert_eq!(results[0].as_ref().unwrap(), &true);
+        assert_eq!(results[1].as_ref().unwrap_err().kind(), VcxErrorKind::PoolLedgerConnect);
+        assert_eq!(results[2].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidJson);
+    }
+
     #[test]
     #[cfg(feature = "pool_tests")]
     fn test_proof_self_attested_proof_validation() {
@@ -1,9 +1,12 @@
+use std::collections::{HashMap, HashSet};
+
 use serde_json;
 use serde_json::Value;
 
 use crate::error::prelude::*;
 use crate::libindy::utils::anoncreds;
 use crate::settings;
+use crate::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use crate::utils::openssl::encode;
 
 #[derive(Debug, Deserialize, Serialize, PartialEq)]
@@ -163,6 +166,162 @@ pub fn build_rev_reg_json(credential_data: &Vec<CredInfoVerifier>) -> VcxResult<
     Ok(rev_regs_json.to_string())
 }
 
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+pub enum LedgerArtefactKey {
+    Schema(String),
+    CredDef(String),
+    RevRegDef(String),
+    RevReg(String, u64),
+}
+
+pub enum LedgerArtefact {
+    Schema(String, Value),
+    CredDef(String, Value),
+    RevRegDef(String, Value),
+    RevReg(String, u64, Value),
+}
+
+/**
+Ledger data needed to verify a batch of proofs. Every distinct schema, credential definition,
+revocation registry definition and (revocation registry, timestamp) pair referenced by the batch is
+fetched just once, concurrently. Fetch failures are kept with their original kind and reported for
+each proof referencing the failed artefact, rather than surfacing later as a verification error.
+ */
+#[derive(Debug, Default)]
+pub struct VerifierLedgerArtefacts {
+    schemas: HashMap<String, (String, Value)>,
+    cred_defs: HashMap<String, (String, Value)>,
+    rev_reg_defs: HashMap<String, (String, Value)>,
+    rev_regs: HashMap<(String, u64), (String, u64, Value)>,
+    failures: HashMap<LedgerArtefactKey, (VcxErrorKind, String)>,
+}
+
+pub fn fetch_ledger_artefact(key: LedgerArtefactKey) -> VcxResult<LedgerArtefact> {
+    match key {
+        LedgerArtefactKey::Schema(schema_id) => {
+            let (id, json) = anoncreds::get_schema_json(&schema_id)
+                .map_err(|err| err.extend(format!("Cannot get schema {}", schema_id)))?;
+            let value = serde_json::from_str(&json)
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidSchema, format!("Cannot deserialize schema: {}", err)))?;
+            Ok(LedgerArtefact::Schema(id, value))
+        }
+        LedgerArtefactKey::CredDef(cred_def_id) => {
+            let (id, json) = anoncreds::get_cred_def_json(&cred_def_id)
+                .map_err(|err| err.extend(format!("Cannot get credential definition {}", cred_def_id)))?;
+            let value = serde_json::from_str(&json)
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidProofCredentialData, format!("Cannot deserialize credential definition: {}", err)))?;
+            Ok(LedgerArtefact::CredDef(id, value))
+        }
+        LedgerArtefactKey::RevRegDef(rev_reg_id) => {
+            let (id, json) = anoncreds::get_rev_reg_def_json(&rev_reg_id)
+                .map_err(|err| err.extend(format!("Cannot get revocation registry definition {}", rev_reg_id)))?;
+            let value = serde_json::from_str(&json)
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidRevocationDetails, format!("Cannot deserialize revocation registry definition: {}", err)))?;
+            Ok(LedgerArtefact::RevRegDef(id, value))
+        }
+        LedgerArtefactKey::RevReg(rev_reg_id, timestamp) => {
+            let (id, json, ledger_timestamp) = anoncreds::get_rev_reg(&rev_reg_id, timestamp)
+                .map_err(|err| err.extend(format!("Cannot get revocation registry {} at {}", rev_reg_id, timestamp)))?;
+            let value = serde_json::from_str(&json)
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize revocation registry: {}", err)))?;
+            Ok(LedgerArtefact::RevReg(id, ledger_timestamp, value))
+        }
+    }
+}
+
+fn _ledger_artefact_keys(cred_info: &CredInfoVerifier) -> Vec<LedgerArtefactKey> {
+    let mut keys = vec![
+        LedgerArtefactKey::Schema(cred_info.schema_id.clone()),
+        LedgerArtefactKey::CredDef(cred_info.cred_def_id.clone())
+    ];
+    if let Some(rev_reg_id) = cred_info.rev_reg_id.as_ref() {
+        keys.push(LedgerArtefactKey::RevRegDef(rev_reg_id.clone()));
+        if let Some(timestamp) = cred_info.timestamp {
+            keys.push(LedgerArtefactKey::RevReg(rev_reg_id.clone(), timestamp));
+        }
+    }
+    keys
+}
+
+impl VerifierLedgerArtefacts {
+    pub fn resolve(credential_data: &Vec<&CredInfoVerifier>) -> VcxResult<VerifierLedgerArtefacts> {
+        VerifierLedgerArtefacts::resolve_with(credential_data, fetch_ledger_artefact)
+    }
+
+    pub fn resolve_with(credential_data: &Vec<&CredInfoVerifier>, fetch: fn(LedgerArtefactKey) -> VcxResult<LedgerArtefact>) -> VcxResult<VerifierLedgerArtefacts> {
+        debug!("resolving ledger artefacts for validation of {} credentials", credential_data.len());
+        let mut keys: Vec<LedgerArtefactKey> = Vec::new();
+        let mut seen: HashSet<LedgerArtefactKey> = HashSet::new();
+        for cred_info in credential_data.iter() {
+            for key in _ledger_artefact_keys(cred_info) {
+                if seen.insert(key.clone()) {
+                    keys.push(key);
+                }
+            }
+        }
+
+        let fetched = map_concurrently(keys.clone(), DEFAULT_MAX_WORKERS, fetch)?;
+
+        let mut artefacts = VerifierLedgerArtefacts::default();
+        for (key, artefact) in keys.into_iter().zip(fetched.into_iter()) {
+            match (key, artefact) {
+                (LedgerArtefactKey::Schema(key), Ok(LedgerArtefact::Schema(id, value))) => { artefacts.schemas.insert(key, (id, value)); }
+                (LedgerArtefactKey::CredDef(key), Ok(LedgerArtefact::CredDef(id, value))) => { artefacts.cred_defs.insert(key, (id, value)); }
+                (LedgerArtefactKey::RevRegDef(key), Ok(LedgerArtefact::RevRegDef(id, value))) => { artefacts.rev_reg_defs.insert(key, (id, value)); }
+                (LedgerArtefactKey::RevReg(key, timestamp), Ok(LedgerArtefact::RevReg(id, ledger_timestamp, value))) => { artefacts.rev_regs.insert((key, timestamp), (id, ledger_timestamp, value)); }
+                (key, Err(err)) => {
+                    warn!("Failed to resolve ledger artefact {:?}: {}", key, err);
+                    artefacts.failures.insert(key, (err.kind(), err.to_string()));
+                }
+                (key, Ok(_)) => { warn!("Resolved unexpected ledger artefact for {:?}", key); }
+            }
+        }
+        Ok(artefacts)
+    }
+
+    /**
+    Builds schemas, credential definitions, revocation registry definitions and revocation registries
+    jsons for verification of a single proof. Fails with the fetch error of the first artefact of the
+    proof which could not be resolved.
+     */
+    pub fn build_verifier_jsons(&self, credential_data: &Vec<CredInfoVerifier>) -> VcxResult<(String, String, String, String)> {
+        for key in credential_data.iter().flat_map(_ledger_artefact_keys) {
+            if let Some((kind, msg)) = self.failures.get(&key) {
+                return Err(VcxError::from_msg(*kind, msg.clone()));
+            }
+        }
+
+        let mut schemas_json = json!({});
+        let mut cred_defs_json = json!({});
+        let mut rev_reg_defs_json = json!({});
+        let mut rev_regs_json = json!({});
+
+        for cred_info in credential_data.iter() {
+            if let Some((id, value)) = self.schemas.get(&cred_info.schema_id) {
+                schemas_json[id] = value.clone();
+            }
+            if let Some((id, value)) = self.cred_defs.get(&cred_info.cred_def_id) {
+                cred_defs_json[id] = value.clone();
+            }
+            if let Some(rev_reg_id) = cred_info.rev_reg_id.as_ref() {
+                if let Some((id, value)) = self.rev_reg_defs.get(rev_reg_id) {
+                    rev_reg_defs_json[id] = value.clone();
+                }
+                if let Some(timestamp) = cred_info.timestamp {
+                    if let Some((id, ledger_timestamp, value)) = self.rev_regs.get(&(rev_reg_id.clone(), timestamp)) {
+                        if rev_regs_json.get(id).is_none() {
+                            rev_regs_json[id] = json!({});
+                        }
+                        rev_regs_json[id][ledger_timestamp.to_string()] = value.clone();
+                    }
+                }
+            }
+        }
+
+        Ok((schemas_json.to_string(), cred_defs_json.to_string(), rev_reg_defs_json.to_string(), rev_regs_json.to_string()))
+    }
+}
+
 #[cfg(test)]
 pub mod tests {
     use crate::utils::constants::*;
@@ -269,4 +428,34 @@ pub mod tests {
         let expected = json!({REV_REG_ID:{"1":json}}).to_string();
         assert_eq!(rev_reg_json, expected);
     }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_resolve_ledger_artefacts_for_batch() {
+        let _setup = SetupMocks::init();
+
+        let cred1 = CredInfoVerifier {
+            schema_id: "schema_key1".to_string(),
+            cred_def_id: "cred_def_key1".to_string(),
+            rev_reg_id: Some("id1".to_string()),
+            timestamp: Some(1),
+        };
+        let cred2 = CredInfoVerifier {
+            schema_id: "schema_key1".to_string(),
+            cred_def_id: "cred_def_key1".to_string(),
+            rev_reg_id: None,
+            timestamp: None,
+        };
+        let artefacts = VerifierLedgerArtefacts::resolve(&vec![&cred1, &cred2]).unwrap();
+        let (schemas_json, cred_defs_json, rev_reg_defs_json, rev_regs_json) = artefacts.build_verifier_jsons(&vec![cred1]).unwrap();
+
+        let schema: Value = serde_json::from_str(SCHEMA_JSON).unwrap();
+        let cred_def: Value = serde_json::from_str(CRED_DEF_JSON).unwrap();
+        let rev_reg_def: Value = serde_json::from_str(&rev_def_json()).unwrap();
+        let rev_reg: Value = serde_json::from_str(REV_REG_JSON).unwrap();
+        assert_eq!(schemas_json, json!({SCHEMA_ID: schema}).to_string());
+        assert_eq!(cred_defs_json, json!({CRED_DEF_ID: cred_def}).to_string());
+        assert_eq!(rev_reg_defs_json, json!({REV_REG_ID: rev_reg_def}).to_string());
+        assert_eq!(rev_regs_json, json!({REV_REG_ID: {"1": rev_reg}}).to_string());
+    }
 }
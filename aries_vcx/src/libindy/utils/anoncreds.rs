@@ -1,19 +1,35 @@
+use std::sync::Arc;
+
 use indy::{anoncreds, blob_storage, ledger};
 use indy::future::Future;
 use serde_json;
 use serde_json::{map::Map, Value};
 use time;
 
+use agency_client::metrics;
+
 use crate::{libindy, settings, utils};
 use crate::error::prelude::*;
-use crate::libindy::utils::{LibindyMock, wallet::get_wallet_handle};
+use crate::libindy::utils::{LibindyMock, TimedWait, wallet::get_wallet_handle};
 use crate::libindy::utils::cache::{clear_rev_reg_delta_cache, get_rev_reg_delta_cache, set_rev_reg_delta_cache};
+use crate::libindy::utils::rev_reg_cache;
 use crate::libindy::utils::ledger::*;
 use crate::libindy::utils::payments::{pay_for_txn, PaymentTxn};
 use crate::utils::constants::{ATTRS, LIBINDY_CRED_OFFER, PROOF_REQUESTED_PREDICATES, REQUESTED_ATTRIBUTES, REV_STATE_JSON};
 use crate::utils::constants::{CREATE_CRED_DEF_ACTION, CREATE_REV_REG_DEF_ACTION, CREATE_REV_REG_DELTA_ACTION, CREATE_SCHEMA_ACTION, CRED_DEF_ID, CRED_DEF_JSON, CRED_DEF_REQ, rev_def_json, REV_REG_DELTA_JSON, REV_REG_ID, REV_REG_JSON, REVOC_REG_TYPE, SCHEMA_ID, SCHEMA_JSON, SCHEMA_TXN};
 use crate::utils::mockdata::mock_settings::get_mock_creds_retrieved_for_proof_request;
 
+lazy_static! {
+    static ref INDY_ANONCREDS_VERIFIER_VERIFY_PROOF: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_verifier_verify_proof");
+    static ref INDY_ANONCREDS_ISSUER_CREATE_CREDENTIAL_OFFER: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_issuer_create_credential_offer");
+    static ref INDY_ANONCREDS_ISSUER_CREATE_CREDENTIAL: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_issuer_create_credential");
+    static ref INDY_ANONCREDS_PROVER_CREATE_PROOF: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_prover_create_proof");
+    static ref INDY_ANONCREDS_PROVER_CREATE_CREDENTIAL_REQ: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_prover_create_credential_req");
+    static ref INDY_ANONCREDS_CREATE_REVOCATION_STATE: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_create_revocation_state");
+    static ref INDY_ANONCREDS_UPDATE_REVOCATION_STATE: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_update_revocation_state");
+    static ref INDY_ANONCREDS_PROVER_STORE_CREDENTIAL: Arc<metrics::Histogram> = metrics::histogram("indy_anoncreds_prover_store_credential");
+}
+
 const BLOB_STORAGE_TYPE: &str = "default";
 const REVOCATION_REGISTRY_TYPE: &str = "ISSUANCE_BY_DEFAULT";
 
@@ -29,7 +45,7 @@ pub fn libindy_verifier_verify_proof(proof_req_json: &str,
                                      credential_defs_json,
                                      rev_reg_defs_json,
                                      rev_regs_json)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_VERIFIER_VERIFY_PROOF)
         .map_err(VcxError::from)
 }
 
@@ -71,7 +87,7 @@ pub fn libindy_issuer_create_credential_offer(cred_def_id: &str) -> VcxResult<St
     }
     anoncreds::issuer_create_credential_offer(get_wallet_handle(),
                                               cred_def_id)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_ISSUER_CREATE_CREDENTIAL_OFFER)
         .map_err(VcxError::from)
 }
 
@@ -101,7 +117,7 @@ pub fn libindy_issuer_create_credential(cred_offer_json: &str,
                                         cred_values_json,
                                         revocation,
                                         blob_handle)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_ISSUER_CREATE_CREDENTIAL)
         .map_err(VcxError::from)
 }
 
@@ -121,7 +137,7 @@ pub fn libindy_prover_create_proof(proof_req_json: &str,
                                    schemas_json,
                                    credential_defs_json,
                                    revoc_states_json)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_PROVER_CREATE_PROOF)
         .map_err(VcxError::from)
 }
 
@@ -218,7 +234,7 @@ pub fn libindy_prover_create_credential_req(prover_did: &str,
                                             credential_offer_json,
                                             credential_def_json,
                                             master_secret_name)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_PROVER_CREATE_CREDENTIAL_REQ)
         .map_err(VcxError::from)
 }
 
@@ -228,7 +244,7 @@ pub fn libindy_prover_create_revocation_state(rev_reg_def_json: &str, rev_reg_de
     let blob_handle = blob_storage_open_reader(tails_file)?;
 
     anoncreds::create_revocation_state(blob_handle, rev_reg_def_json, rev_reg_delta_json, 100, cred_rev_id)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_CREATE_REVOCATION_STATE)
         .map_err(VcxError::from)
 }
 
@@ -238,7 +254,7 @@ pub fn libindy_prover_update_revocation_state(rev_reg_def_json: &str, rev_state_
     let blob_handle = blob_storage_open_reader(tails_file)?;
 
     anoncreds::update_revocation_state(blob_handle, rev_state_json, rev_reg_def_json, rev_reg_delta_json, 100, cred_rev_id)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_UPDATE_REVOCATION_STATE)
         .map_err(VcxError::from)
 }
 
@@ -256,7 +272,7 @@ pub fn libindy_prover_store_credential(cred_id: Option<&str>,
                                        cred_json,
                                        cred_def_json,
                                        rev_reg_def_json)
-        .wait()
+        .timed_wait(&INDY_ANONCREDS_PROVER_STORE_CREDENTIAL)
         .map_err(VcxError::from)
 }
 
@@ -542,6 +558,13 @@ pub fn publish_rev_reg_delta(issuer_did: &str, rev_reg_id: &str, rev_reg_entry_j
     pay_for_txn(&request, CREATE_REV_REG_DELTA_ACTION)
 }
 
+// Delta is requested from the beginning of the registry and up to now unless bounds are given
+fn _rev_reg_delta_interval(from: Option<u64>, to: Option<u64>) -> (i64, i64) {
+    let from = from.map(|from| from as i64).unwrap_or(-1);
+    let to = to.map(|to| to as i64).unwrap_or_else(|| time::get_time().sec);
+    (from, to)
+}
+
 pub fn get_rev_reg_delta_json(rev_reg_id: &str, from: Option<u64>, to: Option<u64>)
                               -> VcxResult<(String, String, u64)> {
     trace!("get_rev_reg_delta_json >>> rev_reg_id: {}, from: {:?}, to: {:?}", rev_reg_id, from, to);
@@ -549,22 +572,56 @@ pub fn get_rev_reg_delta_json(rev_reg_id: &str, from: Option<u64>, to: Option<u6
 
     let submitter_did = crate::utils::random::generate_random_did();
 
-    let from: i64 = if let Some(_from) = from { _from as i64 } else { -1 };
-    let to = if let Some(_to) = to { _to as i64 } else { time::get_time().sec };
+    let (from, to) = _rev_reg_delta_interval(from, to);
 
     libindy_build_get_revoc_reg_delta_request(&submitter_did, rev_reg_id, from, to)
         .and_then(|req| libindy_submit_request(&req))
         .and_then(|response| libindy_parse_get_revoc_reg_delta_response(&response))
 }
 
+/**
+Fetches revocation registry definition and revocation registry delta with a single pipelined ledger round trip.
+ */
+pub fn get_rev_reg_def_and_delta_json(rev_reg_id: &str, from: Option<u64>, to: Option<u64>)
+                                      -> VcxResult<(String, String, String, u64)> {
+    trace!("get_rev_reg_def_and_delta_json >>> rev_reg_id: {}, from: {:?}, to: {:?}", rev_reg_id, from, to);
+    if settings::indy_mocks_enabled() { return Ok((REV_REG_ID.to_string(), rev_def_json(), REV_REG_DELTA_JSON.to_string(), 1)); }
+
+    let submitter_did = crate::utils::random::generate_random_did();
+
+    let (from, to) = _rev_reg_delta_interval(from, to);
+
+    let requests = vec![
+        libindy_build_get_revoc_reg_def_request(&submitter_did, rev_reg_id)?,
+        libindy_build_get_revoc_reg_delta_request(&submitter_did, rev_reg_id, from, to)?
+    ];
+    let mut responses = libindy_submit_requests(&requests)?.into_iter();
+    let rev_reg_def_response = responses.next()
+        .ok_or(VcxError::from_msg(VcxErrorKind::InvalidLedgerResponse, "Missing GET_REVOC_REG_DEF response"))??;
+    let rev_reg_delta_response = responses.next()
+        .ok_or(VcxError::from_msg(VcxErrorKind::InvalidLedgerResponse, "Missing GET_REVOC_REG_DELTA response"))??;
+
+    let (_, rev_reg_def_json) = libindy_parse_get_revoc_reg_def_response(&rev_reg_def_response)?;
+    let (rev_reg_id, rev_reg_delta_json, timestamp) = libindy_parse_get_revoc_reg_delta_response(&rev_reg_delta_response)?;
+    Ok((rev_reg_id, rev_reg_def_json, rev_reg_delta_json, timestamp))
+}
+
 pub fn get_rev_reg(rev_reg_id: &str, timestamp: u64) -> VcxResult<(String, String, u64)> {
     if settings::indy_mocks_enabled() { return Ok((REV_REG_ID.to_string(), REV_REG_JSON.to_string(), 1)); }
 
+    if let Some((rev_reg_json, ledger_timestamp)) = rev_reg_cache::get_rev_reg_snapshot(rev_reg_id, timestamp) {
+        trace!("get_rev_reg >>> serving rev_reg_id: {}, timestamp: {} from cache", rev_reg_id, timestamp);
+        return Ok((rev_reg_id.to_string(), rev_reg_json, ledger_timestamp));
+    }
+
     let submitter_did = crate::utils::random::generate_random_did();
 
-    libindy_build_get_revoc_reg_request(&submitter_did, rev_reg_id, timestamp)
+    let (id, rev_reg_json, ledger_timestamp) = libindy_build_get_revoc_reg_request(&submitter_did, rev_reg_id, timestamp)
         .and_then(|req| libindy_submit_request(&req))
-        .and_then(|response| libindy_parse_get_revoc_reg_response(&response))
+        .and_then(|response| libindy_parse_get_revoc_reg_response(&response))?;
+
+    rev_reg_cache::set_rev_reg_snapshot(rev_reg_id, timestamp, ledger_timestamp, &rev_reg_json);
+    Ok((id, rev_reg_json, ledger_timestamp))
 }
 
 pub fn get_cred_def(issuer_did: Option<&str>, cred_def_id: &str) -> VcxResult<(String, String)> {
@@ -6,6 +6,7 @@ use crate::libindy::utils::wallet::{add_record, delete_record, get_record, updat
 static CACHE_TYPE: &str = "cache";
 static REV_REG_DELTA_CACHE_PREFIX: &str = "rev_reg_delta:";
 static REV_REG_IDS_CACHE_PREFIX: &str = "rev_reg_ids:";
+static MESSAGE_SYNC_CACHE_PREFIX: &str = "msg_sync:";
 
 // TODO: Maybe we need to persist more info
 #[derive(Serialize, Deserialize, Debug, Default, PartialEq)]
@@ -151,3 +152,58 @@ pub fn clear_rev_reg_delta_cache(rev_reg_id: &str) -> VcxResult<String> {
         Err(VcxError::from(VcxErrorKind::IOError))
     }
 }
+
+///
+/// Returns the persisted message sync cursor of a connection.
+///
+/// # Arguments
+/// `pw_did`: pairwise DID of the connection
+///
+/// # Returns
+/// Message sync cursor json as a string
+pub fn get_message_sync_cache(pw_did: &str) -> Option<String> {
+    debug!("Getting message_sync_cache for pw_did {}", pw_did);
+    let wallet_id = format!("{}{}", MESSAGE_SYNC_CACHE_PREFIX, pw_did);
+
+    match get_record(CACHE_TYPE, &wallet_id, &json!({"retrieveType": false, "retrieveValue": true, "retrieveTags": false}).to_string()) {
+        Ok(json) => {
+            match serde_json::from_str::<serde_json::Value>(&json) {
+                Ok(record) => record.get("value").and_then(|value| value.as_str()).map(String::from),
+                Err(err) => {
+                    warn!("Unable to convert message_sync cache for pw_did: {}, json: {}, error: {}", pw_did, json, err);
+                    None
+                }
+            }
+        }
+        Err(err) => {
+            debug!("Unable to get message_sync cache for pw_did: {}, error: {}", pw_did, err);
+            None
+        }
+    }
+}
+
+///
+/// Saves message sync cursor of a connection.
+///
+/// # Arguments
+/// `pw_did`: pairwise DID of the connection
+/// `cache`: Message sync cursor json.
+///
+pub fn set_message_sync_cache(pw_did: &str, cache: &str) -> VcxResult<()> {
+    debug!("Setting message_sync_cache for pw_did {}", pw_did);
+    let wallet_id = format!("{}{}", MESSAGE_SYNC_CACHE_PREFIX, pw_did);
+    update_record_value(CACHE_TYPE, &wallet_id, cache)
+        .or_else(|_| add_record(CACHE_TYPE, &wallet_id, cache, None))
+}
+
+///
+/// Removes message sync cursor of a connection.
+///
+/// # Arguments
+/// `pw_did`: pairwise DID of the connection
+///
+pub fn clear_message_sync_cache(pw_did: &str) -> VcxResult<()> {
+    debug!("Clearing message_sync_cache for pw_did {}", pw_did);
+    let wallet_id = format!("{}{}", MESSAGE_SYNC_CACHE_PREFIX, pw_did);
+    delete_record(CACHE_TYPE, &wallet_id)
+}
@@ -1,15 +1,27 @@
 /* test isn't ready until > libindy 1.0.1 */
+use std::sync::Arc;
+
 use indy::crypto;
 use indy::future::Future;
 
+use agency_client::metrics;
+
 use crate::{libindy, settings};
 use crate::error::prelude::*;
+use crate::libindy::utils::TimedWait;
+
+lazy_static! {
+    static ref INDY_CRYPTO_SIGN: Arc<metrics::Histogram> = metrics::histogram("indy_crypto_sign");
+    static ref INDY_CRYPTO_VERIFY: Arc<metrics::Histogram> = metrics::histogram("indy_crypto_verify");
+    static ref INDY_CRYPTO_PACK_MESSAGE: Arc<metrics::Histogram> = metrics::histogram("indy_crypto_pack_message");
+    static ref INDY_CRYPTO_UNPACK_MESSAGE: Arc<metrics::Histogram> = metrics::histogram("indy_crypto_unpack_message");
+}
 
 pub fn sign(my_vk: &str, msg: &[u8]) -> VcxResult<Vec<u8>> {
     if settings::indy_mocks_enabled() { return Ok(Vec::from(msg).to_owned()); }
 
     crypto::sign(libindy::utils::wallet::get_wallet_handle(), my_vk, msg)
-        .wait()
+        .timed_wait(&INDY_CRYPTO_SIGN)
         .map_err(VcxError::from)
 }
 
@@ -17,7 +29,7 @@ pub fn verify(vk: &str, msg: &[u8], signature: &[u8]) -> VcxResult<bool> {
     if settings::indy_mocks_enabled() { return Ok(true); }
 
     crypto::verify(vk, msg, signature)
-        .wait()
+        .timed_wait(&INDY_CRYPTO_VERIFY)
         .map_err(VcxError::from)
 }
 
@@ -25,7 +37,7 @@ pub fn pack_message(sender_vk: Option<&str>, receiver_keys: &str, msg: &[u8]) ->
     if settings::indy_mocks_enabled() { return Ok(msg.to_vec()); }
 
     crypto::pack_message(libindy::utils::wallet::get_wallet_handle(), msg, receiver_keys, sender_vk)
-        .wait()
+        .timed_wait(&INDY_CRYPTO_PACK_MESSAGE)
         .map_err(VcxError::from)
 }
 
@@ -33,7 +45,7 @@ pub fn unpack_message(msg: &[u8]) -> VcxResult<Vec<u8>> {
     if settings::indy_mocks_enabled() { return Ok(Vec::from(msg).to_owned()); }
 
     crypto::unpack_message(libindy::utils::wallet::get_wallet_handle(), msg)
-        .wait()
+        .timed_wait(&INDY_CRYPTO_UNPACK_MESSAGE)
         .map_err(VcxError::from)
 }
 
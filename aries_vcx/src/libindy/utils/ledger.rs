@@ -1,18 +1,27 @@
 use std::collections::HashMap;
+use std::sync::Arc;
 
 use indy::cache;
 use indy::future::Future;
 use indy::ledger;
 use serde_json;
 
+use agency_client::metrics;
+
 use crate::{settings, utils};
 use crate::error::prelude::*;
+use crate::libindy::utils::{ledger_cache, TimedWait};
 use crate::libindy::utils::pool::get_pool_handle;
 use crate::libindy::utils::wallet::get_wallet_handle;
 use crate::utils::random::generate_random_did;
 use crate::messages::connection::service::FullService;
 use crate::messages::connection::did_doc::Did;
 
+lazy_static! {
+    static ref LEDGER_SIGN_AND_SUBMIT_REQUEST: Arc<metrics::Histogram> = metrics::histogram("ledger_sign_and_submit_request");
+    static ref LEDGER_SUBMIT_REQUEST: Arc<metrics::Histogram> = metrics::histogram("ledger_submit_request");
+}
+
 pub fn multisign_request(did: &str, request: &str) -> VcxResult<String> {
     ledger::multi_sign_request(get_wallet_handle(), did, request)
         .wait()
@@ -33,7 +42,7 @@ pub fn libindy_sign_and_submit_request(issuer_did: &str, request_json: &str) ->
     let wallet_handle = get_wallet_handle();
 
     ledger::sign_and_submit_request(pool_handle, wallet_handle, issuer_did, request_json)
-        .wait()
+        .timed_wait(&LEDGER_SIGN_AND_SUBMIT_REQUEST)
         .map_err(VcxError::from)
 }
 
@@ -41,10 +50,30 @@ pub fn libindy_submit_request(request_json: &str) -> VcxResult<String> {
     let pool_handle = get_pool_handle()?;
 
     ledger::submit_request(pool_handle, request_json)
-        .wait()
+        .timed_wait(&LEDGER_SUBMIT_REQUEST)
         .map_err(VcxError::from)
 }
 
+/**
+Submits independent requests to the pool at once and waits for all of them. Libindy processes
+submitted requests concurrently, so total latency is that of the slowest request rather than the sum.
+Responses are returned in the order of requests.
+ */
+pub fn libindy_submit_requests(requests: &[String]) -> VcxResult<Vec<VcxResult<String>>> {
+    trace!("libindy_submit_requests >>> submitting {} requests", requests.len());
+    if settings::indy_mocks_enabled() { return Ok(requests.iter().map(|_| Ok(r#"{"rc":"success"}"#.to_string())).collect()); }
+
+    let pool_handle = get_pool_handle()?;
+
+    let pending: Vec<_> = requests.iter()
+        .map(|request_json| ledger::submit_request(pool_handle, request_json))
+        .collect();
+
+    Ok(pending.into_iter()
+        .map(|response| response.timed_wait(&LEDGER_SUBMIT_REQUEST).map_err(VcxError::from))
+        .collect())
+}
+
 pub fn libindy_build_schema_request(submitter_did: &str, data: &str) -> VcxResult<String> {
     trace!("libindy_build_schema_request >>> submitter_did: {}, data: {}", submitter_did, data);
     ledger::build_schema_request(submitter_did, data)
@@ -353,10 +382,19 @@ pub mod auth_rule {
 }
 
 pub fn get_nym(did: &str) -> VcxResult<String> {
+    if !settings::indy_mocks_enabled() {
+        if let Some(response) = ledger_cache::get_nym_response(did) {
+            return Ok(response);
+        }
+    }
     let submitter_did = generate_random_did();
 
     let get_nym_req = libindy_build_get_nym_request(Some(&submitter_did), &did)?;
-    libindy_submit_request(&get_nym_req)
+    let response = libindy_submit_request(&get_nym_req)?;
+    if !settings::indy_mocks_enabled() {
+        ledger_cache::set_nym_response(did, &response);
+    }
+    Ok(response)
 }
 
 pub fn get_role(did: &str) -> VcxResult<String> {
@@ -455,12 +493,23 @@ fn _verify_transaction_can_be_endorsed(transaction_json: &str, _did: &str) -> Vc
 pub fn add_attr(did: &str, key: &str, value: &str) -> VcxResult<String> {
     let attrib_json = json!({ key: value }).to_string();
     let attrib_req = ledger::build_attrib_request(&did, &did, None, Some(&attrib_json), None).wait()?;
-    libindy_sign_and_submit_request(&did, &attrib_req)
+    let response = libindy_sign_and_submit_request(&did, &attrib_req);
+    ledger_cache::invalidate_ledger_cache(did);
+    response
 }
 
 pub fn get_attr(did: &str, attr_name: &str) -> VcxResult<String> {
+    if !settings::indy_mocks_enabled() {
+        if let Some(response) = ledger_cache::get_attr_response(did, attr_name) {
+            return Ok(response);
+        }
+    }
     let get_attrib_req = ledger::build_get_attrib_request(None, &did, Some(attr_name), None, None).wait()?;
-    libindy_submit_request(&get_attrib_req)
+    let response = libindy_submit_request(&get_attrib_req)?;
+    if !settings::indy_mocks_enabled() {
+        ledger_cache::set_attr_response(did, attr_name, &response);
+    }
+    Ok(response)
 }
 
 // TODO: This should be responsibility of the service struct?
@@ -0,0 +1,207 @@
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+
+use agency_client::metrics;
+
+const MAX_CACHED_RESPONSES: usize = 1024;
+const POSITIVE_TTL_SECS: u64 = 300;
+// DIDs and attributes missing now are likely to be written soon (e.g. during onboarding), so keep them shorter
+const NEGATIVE_TTL_SECS: u64 = 30;
+
+lazy_static! {
+    static ref LEDGER_READ_CACHE: Mutex<LedgerReadCache> = Mutex::new(LedgerReadCache::default());
+    static ref LEDGER_CACHE_HIT: Arc<metrics::Counter> = metrics::counter("ledger_cache_hit");
+    static ref LEDGER_CACHE_MISS: Arc<metrics::Counter> = metrics::counter("ledger_cache_miss");
+}
+
+#[derive(Debug, Clone, PartialEq)]
+struct CachedResponse {
+    did: String,
+    response: String,
+    expires_at: u64,
+    inserted: u64,
+}
+
+#[derive(Debug, Default)]
+struct LedgerReadCache {
+    responses: HashMap<String, CachedResponse>,
+    tick: u64,
+}
+
+impl LedgerReadCache {
+    fn get(&mut self, key: &str, now: u64) -> Option<String> {
+        match self.responses.get(key) {
+            Some(cached) if now < cached.expires_at => Some(cached.response.clone()),
+            Some(_) => {
+                self.responses.remove(key);
+                None
+            }
+            None => None
+        }
+    }
+
+    fn insert(&mut self, key: &str, did: &str, response: &str, now: u64) {
+        let ttl = match _response_ttl(response) {
+            Some(ttl) => ttl,
+            None => return
+        };
+        if !self.responses.contains_key(key) && self.responses.len() >= MAX_CACHED_RESPONSES {
+            self._evict(now);
+        }
+        self.tick += 1;
+        self.responses.insert(key.to_string(), CachedResponse {
+            did: did.to_string(),
+            response: response.to_string(),
+            expires_at: now + ttl,
+            inserted: self.tick,
+        });
+    }
+
+    fn invalidate_did(&mut self, did: &str) {
+        self.responses.retain(|_, cached| cached.did != did);
+    }
+
+    fn _evict(&mut self, now: u64) {
+        self.responses.retain(|_, cached| now < cached.expires_at);
+        if self.responses.len() < MAX_CACHED_RESPONSES {
+            return;
+        }
+        let oldest = self.responses.iter()
+            .min_by_key(|(_, cached)| cached.inserted)
+            .map(|(key, _)| key.clone());
+        if let Some(key) = oldest {
+            self.responses.remove(&key);
+        }
+    }
+}
+
+// Only replies are cached; REQNACK, REJECT and unparsable responses are transient and must be retried
+fn _response_ttl(response: &str) -> Option<u64> {
+    let response = serde_json::from_str::<serde_json::Value>(response).ok()?;
+    if response["op"] != "REPLY" {
+        return None;
+    }
+    if response["result"]["data"].is_null() { Some(NEGATIVE_TTL_SECS) } else { Some(POSITIVE_TTL_SECS) }
+}
+
+fn _now() -> u64 {
+    time::get_time().sec as u64
+}
+
+fn _nym_key(did: &str) -> String {
+    format!("nym:{}", did)
+}
+
+fn _attr_key(did: &str, attr_name: &str) -> String {
+    format!("attr:{}:{}", did, attr_name)
+}
+
+fn _get(key: &str) -> Option<String> {
+    let response = match LEDGER_READ_CACHE.lock() {
+        Ok(mut cache) => cache.get(key, _now()),
+        Err(_) => None
+    };
+    if response.is_some() { LEDGER_CACHE_HIT.increment() } else { LEDGER_CACHE_MISS.increment() }
+    response
+}
+
+fn _set(key: &str, did: &str, response: &str) {
+    if let Ok(mut cache) = LEDGER_READ_CACHE.lock() {
+        cache.insert(key, did, response, _now());
+    }
+}
+
+pub fn get_nym_response(did: &str) -> Option<String> {
+    _get(&_nym_key(did))
+}
+
+pub fn set_nym_response(did: &str, response: &str) {
+    _set(&_nym_key(did), did, response)
+}
+
+pub fn get_attr_response(did: &str, attr_name: &str) -> Option<String> {
+    _get(&_attr_key(did, attr_name))
+}
+
+pub fn set_attr_response(did: &str, attr_name: &str, response: &str) {
+    _set(&_attr_key(did, attr_name), did, response)
+}
+
+///
+/// Drops all cached ledger reads (NYM and attributes) of the DID.
+///
+pub fn invalidate_ledger_cache(did: &str) {
+    if let Ok(mut cache) = LEDGER_READ_CACHE.lock() {
+        cache.invalidate_did(did);
+    }
+}
+
+pub fn clear_ledger_cache() {
+    if let Ok(mut cache) = LEDGER_READ_CACHE.lock() {
+        *cache = LedgerReadCache::default();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    const NYM_RESPONSE: &str = r#"{"op":"REPLY","result":{"data":"{\"dest\":\"did1\",\"role\":null}"}}"#;
+    const MISSING_RESPONSE: &str = r#"{"op":"REPLY","result":{"data":null}}"#;
+    const REQNACK_RESPONSE: &str = r#"{"op":"REQNACK","reason":"client request invalid"}"#;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cached_response_expires() {
+        let mut cache = LedgerReadCache::default();
+        cache.insert("nym:did1", "did1", NYM_RESPONSE, 1000);
+        cache.insert("nym:did2", "did2", MISSING_RESPONSE, 1000);
+
+        assert_eq!(cache.get("nym:did1", 1000 + NEGATIVE_TTL_SECS), Some(NYM_RESPONSE.to_string()));
+        assert_eq!(cache.get("nym:did2", 1000 + NEGATIVE_TTL_SECS - 1), Some(MISSING_RESPONSE.to_string()));
+        assert_eq!(cache.get("nym:did2", 1000 + NEGATIVE_TTL_SECS), None);
+        assert_eq!(cache.get("nym:did1", 1000 + POSITIVE_TTL_SECS), None);
+        assert!(cache.responses.is_empty());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_rejected_response_is_not_cached() {
+        let mut cache = LedgerReadCache::default();
+        cache.insert("nym:did1", "did1", REQNACK_RESPONSE, 1000);
+        cache.insert("nym:did2", "did2", r#"{"op":"REJECT","reason":"unauthorized"}"#, 1000);
+        cache.insert("nym:did3", "did3", "not a json", 1000);
+
+        assert_eq!(cache.get("nym:did1", 1000), None);
+        assert_eq!(cache.get("nym:did2", 1000), None);
+        assert_eq!(cache.get("nym:did3", 1000), None);
+        assert!(cache.responses.is_empty());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_invalidate_did() {
+        let mut cache = LedgerReadCache::default();
+        cache.insert("nym:did1", "did1", NYM_RESPONSE, 1000);
+        cache.insert("attr:did1:service", "did1", MISSING_RESPONSE, 1000);
+        cache.insert("nym:did2", "did2", NYM_RESPONSE, 1000);
+
+        cache.invalidate_did("did1");
+
+        assert_eq!(cache.get("nym:did1", 1000), None);
+        assert_eq!(cache.get("attr:did1:service", 1000), None);
+        assert_eq!(cache.get("nym:did2", 1000), Some(NYM_RESPONSE.to_string()));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cache_is_bounded() {
+        let mut cache = LedgerReadCache::default();
+        for i in 0..MAX_CACHED_RESPONSES + 1 {
+            cache.insert(&format!("nym:did{}", i), &format!("did{}", i), NYM_RESPONSE, 1000);
+        }
+        assert_eq!(cache.responses.len(), MAX_CACHED_RESPONSES);
+        assert_eq!(cache.get("nym:did0", 1000), None);
+        assert!(cache.get(&format!("nym:did{}", MAX_CACHED_RESPONSES), 1000).is_some());
+    }
+}
@@ -1,18 +1,25 @@
 use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::Mutex;
 
+use agency_client::metrics;
+use indy::future::Future;
 use indy_sys::CommandHandle;
 
 use crate::settings;
 
 pub mod ledger;
+pub mod ledger_cache;
 pub mod anoncreds;
 pub mod signus;
 pub mod wallet;
+pub mod wallet_search;
+pub mod wallet_backup;
 pub mod pool;
 pub mod crypto;
 pub mod payments;
 pub mod cache;
+pub mod rev_reg_cache;
+pub mod utxo_cache;
 pub mod logger;
 
 pub mod error_codes;
@@ -23,6 +30,17 @@ pub fn next_command_handle() -> CommandHandle {
     (COMMAND_HANDLE_COUNTER.fetch_add(1, Ordering::SeqCst) + 1) as CommandHandle
 }
 
+///
+/// Waits for libindy future like `Future::wait`, recording its latency in `histogram`.
+///
+pub trait TimedWait: Future + Sized {
+    fn timed_wait(self, histogram: &metrics::Histogram) -> Result<Self::Item, Self::Error> {
+        histogram.time(|| self.wait())
+    }
+}
+
+impl<F: Future> TimedWait for F {}
+
 lazy_static! {
     static ref LIBINDY_MOCK: Mutex<LibindyMock> = Mutex::new(LibindyMock::default());
 }
@@ -8,6 +8,8 @@ use serde_json::Value;
 use crate::{libindy, settings, utils};
 use crate::error::prelude::*;
 use crate::libindy::utils::ledger::{append_txn_author_agreement_to_request, auth_rule, libindy_sign_and_submit_request, libindy_sign_request, libindy_submit_request};
+use crate::libindy::utils::utxo_cache;
+use crate::libindy::utils::utxo_cache::CachedUtxo;
 use crate::libindy::utils::wallet::get_wallet_handle;
 use crate::utils::constants::{CREATE_TRANSFER_ACTION, SUBMIT_SCHEMA_RESPONSE};
 
@@ -54,6 +56,13 @@ pub struct Output {
     extra: Option<String>,
 }
 
+#[derive(Deserialize, Debug, PartialEq, Clone)]
+struct Receipt {
+    receipt: String,
+    recipient: String,
+    amount: u64,
+}
+
 impl fmt::Display for WalletInfo {
     fn fmt(&self, f: &mut fmt::Formatter) -> Result<(), fmt::Error> {
         match serde_json::to_string(&self) {
@@ -98,9 +107,12 @@ pub fn create_address(seed: Option<String>) -> VcxResult<String> {
         None => "{}".to_string(),
     };
 
-    payments::create_payment_address(get_wallet_handle(), settings::get_payment_method().as_str(), &config)
-        .wait()
-        .map_err(VcxError::from)
+    let address = payments::create_payment_address(get_wallet_handle(), settings::get_payment_method().as_str(), &config)
+        .wait()?;
+
+    // cached set of wallet addresses is stale now
+    utxo_cache::clear_utxo_cache();
+    Ok(address)
 }
 
 pub fn sign_with_address(address: &str, message: &[u8]) -> VcxResult<Vec<u8>> {
@@ -258,8 +270,19 @@ pub fn pay_for_txn(req: &str, txn_action: (&str, &str, &str, Option<&str>, Optio
         Ok((None, txn_response))
     } else {
         let (refund, inputs, refund_address) = inputs(txn_price)?;
-        let output = outputs(refund, &refund_address, None, None)?;
-        let (_fee_response, txn_response) = _submit_fees_request(req, &inputs, &output)?;
+        let result = outputs(refund, &refund_address, None, None)
+            .and_then(|output| {
+                let (fee_response, txn_response) = _submit_fees_request(req, &inputs, &output)?;
+                Ok((output, fee_response, txn_response))
+            });
+        let (output, fee_response, txn_response) = match result {
+            Ok(result) => result,
+            Err(err) => {
+                _release_inputs(&inputs);
+                return Err(err);
+            }
+        };
+        _spend_inputs(&inputs, &fee_response);
         let payment = PaymentTxn::from_parts(inputs, output, txn_price, false);
         Ok((Some(payment), txn_response))
     }
@@ -304,9 +327,6 @@ pub fn pay_a_payee(price: u64, address: &str) -> VcxResult<(PaymentTxn, String)>
 
     let ledger_cost = get_action_price(CREATE_TRANSFER_ACTION, None)?;
     let (remainder, input, refund_address) = inputs(price + ledger_cost)?;
-    let outputs = outputs(remainder, &refund_address, Some(address.to_string()), Some(price))?;
-
-    let my_did = settings::get_config_value(settings::CONFIG_INSTITUTION_DID)?;
 
     if settings::indy_mocks_enabled() {
         let inputs = vec![build_test_address("9UFgyjuJxi1i1HD")];
@@ -315,7 +335,25 @@ pub fn pay_a_payee(price: u64, address: &str) -> VcxResult<(PaymentTxn, String)>
         return Ok((PaymentTxn::from_parts(inputs, outputs, 1, false), SUBMIT_SCHEMA_RESPONSE.to_string()));
     }
 
-    let (inputs_json, outputs_json) = _serialize_inputs_and_outputs(&input, &outputs)?;
+    match _submit_payment(&input, remainder, &refund_address, price, address) {
+        Ok((outputs, receipts, result)) => {
+            _spend_inputs(&input, &receipts);
+            let payment = PaymentTxn::from_parts(input, outputs, price, false);
+            Ok((payment, result))
+        }
+        Err(err) => {
+            _release_inputs(&input);
+            Err(err)
+        }
+    }
+}
+
+fn _submit_payment(input: &Vec<String>, remainder: u64, refund_address: &str, price: u64, address: &str) -> VcxResult<(Vec<Output>, String, String)> {
+    let outputs = outputs(remainder, refund_address, Some(address.to_string()), Some(price))?;
+
+    let my_did = settings::get_config_value(settings::CONFIG_INSTITUTION_DID)?;
+
+    let (inputs_json, outputs_json) = _serialize_inputs_and_outputs(input, &outputs)?;
 
     let extra = match utils::author_agreement::get_txn_author_agreement()? {
         Some(meta) => {
@@ -330,13 +368,17 @@ pub fn pay_a_payee(price: u64, address: &str) -> VcxResult<(PaymentTxn, String)>
         None => None
     };
 
-    let (request, _payment_method) =
+    let (request, payment_method) =
         payments::build_payment_req(get_wallet_handle(), Some(&my_did), &inputs_json, &outputs_json, extra.as_ref().map(String::as_str))
             .wait()?;
 
     let result = libindy_submit_request(&request)?;
-    let payment = PaymentTxn::from_parts(input, outputs, price, false);
-    Ok((payment, result))
+
+    let receipts = payments::parse_payment_response(&payment_method, &result)
+        .wait()
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidLedgerResponse, format!("Cannot parse response: {}", err)))?;
+
+    Ok((outputs, receipts, result))
 }
 
 #[derive(Serialize, Deserialize, Debug, PartialEq, Clone)]
@@ -410,7 +452,17 @@ fn _address_balance(address: &Vec<UTXO>) -> u64 {
     address.iter().fold(0, |balance, utxo| balance + utxo.amount)
 }
 
+///
+/// Selects UTXOs paying `cost`. Outside of mocks, selected UTXOs stay reserved until the payment is completed
+/// by `_spend_inputs` or `_release_inputs`.
+///
+/// # Returns
+/// Remainder to be refunded, selected inputs and refund address
 pub fn inputs(cost: u64) -> VcxResult<(u64, Vec<String>, String)> {
+    if !settings::indy_mocks_enabled() {
+        return _reserve_inputs(cost);
+    }
+
     let mut inputs: Vec<String> = Vec::new();
     let mut balance = 0;
     let mut refund_address = String::new();
@@ -422,7 +474,6 @@ pub fn inputs(cost: u64) -> VcxResult<(u64, Vec<String>, String)> {
         return Err(VcxError::from_msg(VcxErrorKind::InsufficientTokenAmount, format!("Not enough tokens in wallet to pay: balance: {}, cost: {}", wallet_info.balance, cost)));
     }
 
-    // Todo: explore 'smarter' ways of selecting utxos ie bitcoin algorithms etc
     'outer: for address in wallet_info.addresses.iter() {
         refund_address = address.address.clone();
         for utxo in address.utxo.iter() {
@@ -438,6 +489,70 @@ pub fn inputs(cost: u64) -> VcxResult<(u64, Vec<String>, String)> {
     Ok((remainder, inputs, refund_address))
 }
 
+fn _reserve_inputs(cost: u64) -> VcxResult<(u64, Vec<String>, String)> {
+    let selection = if utxo_cache::is_utxo_cache_loaded() {
+        match utxo_cache::reserve_utxos(cost) {
+            // tokens might have been received since the cache was loaded
+            Err(ref err) if err.kind() == VcxErrorKind::InsufficientTokenAmount => {
+                _load_utxo_cache()?;
+                utxo_cache::reserve_utxos(cost)
+            }
+            result => result
+        }
+    } else {
+        _load_utxo_cache()?;
+        utxo_cache::reserve_utxos(cost)
+    };
+
+    let selection = selection
+        .map_err(|err| {
+            warn!("not enough tokens in wallet to pay: {}", err);
+            err
+        })?;
+    debug!("reserved utxos {:?} for cost {}", selection.inputs, cost);
+
+    Ok((selection.remainder, selection.inputs, selection.refund_address))
+}
+
+fn _load_utxo_cache() -> VcxResult<()> {
+    let wallet_info = get_wallet_token_info()?;
+
+    let addresses = wallet_info.addresses.iter().map(|address| address.address.clone()).collect();
+    let utxos = wallet_info.addresses.iter()
+        .flat_map(|address| address.utxo.iter())
+        .filter_map(|utxo| utxo.source.clone().map(|source| CachedUtxo { source, recipient: utxo.recipient.clone(), amount: utxo.amount }))
+        .collect();
+
+    utxo_cache::load_utxo_cache(addresses, utxos)
+}
+
+fn _spend_inputs(inputs: &Vec<String>, receipts_json: &str) {
+    if settings::indy_mocks_enabled() { return; }
+
+    let receipts = match serde_json::from_str::<Vec<Receipt>>(receipts_json) {
+        Ok(receipts) => receipts.into_iter()
+            .map(|receipt| CachedUtxo { source: receipt.receipt, recipient: receipt.recipient, amount: receipt.amount })
+            .collect(),
+        Err(err) => {
+            warn!("Cannot parse payment receipts, utxo cache will be reloaded: {}", err);
+            _release_inputs(inputs);
+            return;
+        }
+    };
+
+    if let Err(err) = utxo_cache::spend_utxos(inputs, receipts) {
+        warn!("Cannot update utxo cache: {}", err);
+    }
+}
+
+fn _release_inputs(inputs: &Vec<String>) {
+    if settings::indy_mocks_enabled() { return; }
+
+    if let Err(err) = utxo_cache::release_utxos(inputs) {
+        warn!("Cannot release reserved utxos: {}", err);
+    }
+}
+
 pub fn outputs(remainder: u64, refund_address: &str, payee_address: Option<String>, payee_amount: Option<u64>) -> VcxResult<Vec<Output>> {
     // In the future we might provide a way for users to specify multiple output address for their remainder tokens
     // As of now, we only handle one output address which we create
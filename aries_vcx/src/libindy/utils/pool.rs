@@ -1,28 +1,187 @@
-use std::sync::RwLock;
+use std::sync::{Condvar, Mutex};
+use std::thread;
+use std::time::{Duration, Instant};
 
 use indy::{ErrorCode, pool};
 use indy::future::Future;
 
 use crate::error::prelude::*;
+use crate::libindy::utils::{ledger_cache, rev_reg_cache};
 use crate::settings;
 
+// Seconds ledger requests wait for pool which is being opened in background before failing with NoPoolOpen
+const POOL_OPEN_WAIT_SECS: u64 = 60;
+
 lazy_static! {
-    static ref POOL_HANDLE: RwLock<Option<i32>> = RwLock::new(None);
+    static ref POOL_LIFECYCLE: PoolLifecycle = PoolLifecycle::new();
+}
+
+#[derive(Debug, Clone, PartialEq)]
+enum PoolState {
+    Closed,
+    Opening,
+    Open(i32),
+    Failed(VcxErrorKind, String),
+}
+
+#[derive(Debug)]
+struct PoolStatus {
+    state: PoolState,
+    open_generation: u64,
+    refresh_generation: u64,
+}
+
+/*
+Pool handle together with progress of pool being opened in background. Callers asking for the handle
+while the pool is still opening are parked on condvar until the opening finishes, so the pool can be
+opened off the startup path and requests are served as soon as it is ready. Each opening gets its own
+generation, closing the pool while it is opening cancels it without waiting, and the handle the cancelled
+opening ends up with is closed instead of published. Refresh threads run until refresh generation
+changes, which happens when refresh is restarted or pool is closed.
+ */
+struct PoolLifecycle {
+    status: Mutex<PoolStatus>,
+    changed: Condvar,
+}
+
+impl PoolLifecycle {
+    fn new() -> PoolLifecycle {
+        PoolLifecycle {
+            status: Mutex::new(PoolStatus { state: PoolState::Closed, open_generation: 0, refresh_generation: 0 }),
+            changed: Condvar::new(),
+        }
+    }
+
+    fn set_state(&self, state: PoolState) {
+        self.status.lock().unwrap().state = state;
+        self.changed.notify_all();
+    }
+
+    fn handle(&self) -> Option<i32> {
+        match self.status.lock().unwrap().state {
+            PoolState::Open(handle) => Some(handle),
+            _ => None
+        }
+    }
+
+    fn is_opening(&self) -> bool {
+        self.status.lock().unwrap().state == PoolState::Opening
+    }
+
+    /// Returns generation of the started opening, to be passed to `finish_opening`.
+    fn begin_opening(&self) -> VcxResult<u64> {
+        let mut status = self.status.lock()?;
+        match status.state {
+            PoolState::Opening | PoolState::Open(_) => Err(VcxError::from_msg(VcxErrorKind::AlreadyInitialized, "Pool connection is already open.")),
+            _ => {
+                status.open_generation += 1;
+                status.state = PoolState::Opening;
+                Ok(status.open_generation)
+            }
+        }
+    }
+
+    /// Publishes result of the opening of given generation. If the opening was cancelled meanwhile,
+    /// the state is left alone and the opened handle is returned, so the caller can close it.
+    fn finish_opening(&self, generation: u64, result: VcxResult<i32>) -> Option<i32> {
+        let mut status = self.status.lock().unwrap();
+        if status.open_generation != generation || status.state != PoolState::Opening {
+            return result.ok();
+        }
+        status.state = match result {
+            Ok(handle) => PoolState::Open(handle),
+            Err(err) => PoolState::Failed(err.kind(), err.to_string()),
+        };
+        self.changed.notify_all();
+        None
+    }
+
+    /// Cancels opening in progress, returns false if the pool was not being opened.
+    fn cancel_opening(&self) -> bool {
+        let mut status = self.status.lock().unwrap();
+        if status.state != PoolState::Opening {
+            return false;
+        }
+        status.open_generation += 1;
+        status.state = PoolState::Closed;
+        self.changed.notify_all();
+        true
+    }
+
+    fn wait_for_handle(&self, timeout: Duration) -> VcxResult<i32> {
+        let deadline = Instant::now() + timeout;
+        let mut status = self.status.lock()?;
+        loop {
+            match &status.state {
+                PoolState::Open(handle) => return Ok(*handle),
+                PoolState::Failed(kind, msg) => return Err(VcxError::from_msg(*kind, format!("Pool could not be opened: {}", msg))),
+                PoolState::Closed => return Err(VcxError::from_msg(VcxErrorKind::NoPoolOpen, "There is no pool opened")),
+                PoolState::Opening => {
+                    let now = Instant::now();
+                    if now >= deadline {
+                        return Err(VcxError::from_msg(VcxErrorKind::NoPoolOpen, "Pool is still being opened"));
+                    }
+                    status = self.changed.wait_timeout(status, deadline - now)?.0;
+                }
+            }
+        }
+    }
+
+    fn next_refresh_generation(&self) -> u64 {
+        let mut status = self.status.lock().unwrap();
+        status.refresh_generation += 1;
+        self.changed.notify_all();
+        status.refresh_generation
+    }
+
+    /// Sleeps for `interval`, returns false as soon as refresh of given generation is stopped.
+    fn wait_for_refresh(&self, generation: u64, interval: Duration) -> bool {
+        let deadline = Instant::now() + interval;
+        let mut status = self.status.lock().unwrap();
+        loop {
+            if status.refresh_generation != generation {
+                return false;
+            }
+            let now = Instant::now();
+            if now >= deadline {
+                return true;
+            }
+            status = self.changed.wait_timeout(status, deadline - now).unwrap().0;
+        }
+    }
+
+    fn stop_refresh(&self) {
+        self.next_refresh_generation();
+        let mut status = self.status.lock().unwrap();
+        if let PoolState::Failed(_, _) = status.state {
+            status.state = PoolState::Closed;
+        }
+    }
 }
 
 pub fn set_pool_handle(handle: Option<i32>) {
-    let mut h = POOL_HANDLE.write().unwrap();
-    *h = handle;
+    POOL_LIFECYCLE.set_state(match handle {
+        Some(handle) => PoolState::Open(handle),
+        None => PoolState::Closed,
+    });
 }
 
+///
+/// Returns handle of the main pool. If the pool is being opened in background, waits until it is ready.
+///
 pub fn get_pool_handle() -> VcxResult<i32> {
-    POOL_HANDLE.read()
-        .or(Err(VcxError::from_msg(VcxErrorKind::NoPoolOpen, "There is no pool opened")))?
-        .ok_or(VcxError::from_msg(VcxErrorKind::NoPoolOpen, "There is no pool opened"))
+    match POOL_LIFECYCLE.handle() {
+        Some(handle) => Ok(handle),
+        None => POOL_LIFECYCLE.wait_for_handle(Duration::from_secs(POOL_OPEN_WAIT_SECS))
+    }
 }
 
 pub fn is_pool_open() -> bool {
-    get_pool_handle().is_ok()
+    POOL_LIFECYCLE.handle().is_some()
+}
+
+pub fn is_pool_opening() -> bool {
+    POOL_LIFECYCLE.is_opening()
 }
 
 pub fn reset_pool_handle() { set_pool_handle(None); }
@@ -55,9 +214,15 @@ pub fn create_pool_ledger_config(pool_name: &str, path: &str) -> VcxResult<()> {
 }
 
 pub fn open_pool_ledger(pool_name: &str, config: Option<&str>) -> VcxResult<u32> {
+    let handle = _open_pool_ledger(pool_name, config)?;
+    set_pool_handle(Some(handle));
+    Ok(handle as u32)
+}
+
+fn _open_pool_ledger(pool_name: &str, config: Option<&str>) -> VcxResult<i32> {
     set_protocol_version()?;
 
-    let handle = pool::open_pool_ledger(pool_name, config)
+    pool::open_pool_ledger(pool_name, config)
         .wait()
         .map_err(|err|
             match err.error_code.clone() {
@@ -81,14 +246,74 @@ pub fn open_pool_ledger(pool_name: &str, config: Option<&str>) -> VcxResult<u32>
                 error_code => {
                     err.to_vcx(VcxErrorKind::LibndyError(error_code as u32), "Indy error occurred")
                 }
-            })?;
+            })
+}
+
+///
+/// Opens pool ledger on a background thread and returns immediately. Ledger requests issued meanwhile
+/// wait in `get_pool_handle` until the pool is ready, or fail with the error the opening ended with.
+///
+pub fn open_pool_ledger_in_background(pool_name: &str, config: Option<&str>) -> VcxResult<()> {
+    let generation = POOL_LIFECYCLE.begin_opening()?;
+
+    let pool_name = pool_name.to_string();
+    let config = config.map(String::from);
+    thread::Builder::new()
+        .name("vcx-pool-open".to_string())
+        .spawn(move || {
+            let result = _open_pool_ledger(&pool_name, config.as_deref());
+            if let Err(err) = &result {
+                error!("open_pool_ledger_in_background >>> pool \"{}\" could not be opened: {}", pool_name, err);
+            }
+            if let Some(handle) = POOL_LIFECYCLE.finish_opening(generation, result) {
+                debug!("open_pool_ledger_in_background >>> pool \"{}\" was closed while opening, closing it", pool_name);
+                if let Err(err) = pool::close_pool_ledger(handle).wait() {
+                    warn!("open_pool_ledger_in_background >>> pool \"{}\" could not be closed: {}", pool_name, err);
+                }
+            }
+        })
+        .map(|_| ())
+        .map_err(|err| {
+            POOL_LIFECYCLE.cancel_opening();
+            VcxError::from_msg(VcxErrorKind::IOError, format!("Could not spawn thread opening pool: {}", err))
+        })
+}
 
-    set_pool_handle(Some(handle));
-    Ok(handle as u32)
+///
+/// Periodically refreshes node list of the main pool until the pool is closed. Libindy persists
+/// transactions obtained by the refresh in its pool ledger storage, so reopening the pool under the same
+/// name only catches up with transactions written since the last refresh.
+///
+pub fn start_pool_refresh(interval: Duration) -> VcxResult<()> {
+    let generation = POOL_LIFECYCLE.next_refresh_generation();
+    thread::Builder::new()
+        .name("vcx-pool-refresh".to_string())
+        .spawn(move || {
+            while POOL_LIFECYCLE.wait_for_refresh(generation, interval) {
+                // pool might still be opening, try again next round
+                if let Some(handle) = POOL_LIFECYCLE.handle() {
+                    match pool::refresh_pool_ledger(handle).wait() {
+                        Ok(()) => debug!("start_pool_refresh >>> pool ledger refreshed"),
+                        Err(err) => warn!("start_pool_refresh >>> pool ledger refresh failed: {}", err)
+                    }
+                }
+            }
+        })
+        .map(|_| ())
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::IOError, format!("Could not spawn thread refreshing pool: {}", err)))
 }
 
 pub fn close() -> VcxResult<()> {
-    let handle = get_pool_handle()?;
+    POOL_LIFECYCLE.stop_refresh();
+    // cached ledger data belongs to the pool being closed, drop it even if the pool is not open
+    ledger_cache::clear_ledger_cache();
+    rev_reg_cache::clear_rev_reg_snapshots();
+    // pool being opened is not waited for, the opening thread closes the handle once it gets it
+    if POOL_LIFECYCLE.cancel_opening() {
+        return Ok(());
+    }
+    let handle = POOL_LIFECYCLE.handle()
+        .ok_or(VcxError::from_msg(VcxErrorKind::NoPoolOpen, "There is no pool opened"))?;
 
     //TODO there was timeout here (before future-based Rust wrapper)
     pool::close_pool_ledger(handle).wait()?;
@@ -164,10 +389,108 @@ pub mod test_utils {
     }
 }
 
-#[cfg(feature = "pool_tests")]
+#[cfg(test)]
 pub mod tests {
-    use crate::libindy::utils::pool::get_pool_handle;
+    use std::sync::Arc;
+
+    #[cfg(feature = "pool_tests")]
     use crate::utils::devsetup::SetupLibraryWalletPoolZeroFees;
+    #[cfg(feature = "general_test")]
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_pool_handle_waits_for_background_opening() {
+        let lifecycle = Arc::new(PoolLifecycle::new());
+        assert_eq!(lifecycle.wait_for_handle(Duration::from_millis(10)).unwrap_err().kind(), VcxErrorKind::NoPoolOpen);
+
+        let generation = lifecycle.begin_opening().unwrap();
+        assert_eq!(lifecycle.begin_opening().unwrap_err().kind(), VcxErrorKind::AlreadyInitialized);
+        assert_eq!(lifecycle.wait_for_handle(Duration::from_millis(10)).unwrap_err().kind(), VcxErrorKind::NoPoolOpen);
+
+        let opener = {
+            let lifecycle = lifecycle.clone();
+            thread::spawn(move || {
+                thread::sleep(Duration::from_millis(50));
+                assert_eq!(lifecycle.finish_opening(generation, Ok(7)), None);
+            })
+        };
+        assert_eq!(lifecycle.wait_for_handle(Duration::from_secs(10)).unwrap(), 7);
+        opener.join().unwrap();
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_failed_background_opening_is_reported() {
+        let lifecycle = PoolLifecycle::new();
+        let generation = lifecycle.begin_opening().unwrap();
+        lifecycle.finish_opening(generation, Err(VcxError::from_msg(VcxErrorKind::PoolLedgerConnect, "Can not connect to Pool")));
+        assert_eq!(lifecycle.wait_for_handle(Duration::from_secs(10)).unwrap_err().kind(), VcxErrorKind::PoolLedgerConnect);
+
+        // closing pool forgets the failure, so the pool can be opened again
+        lifecycle.stop_refresh();
+        assert_eq!(lifecycle.wait_for_handle(Duration::from_secs(10)).unwrap_err().kind(), VcxErrorKind::NoPoolOpen);
+        lifecycle.begin_opening().unwrap();
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cancelled_opening_does_not_publish_handle() {
+        let lifecycle = Arc::new(PoolLifecycle::new());
+        let cancelled = lifecycle.begin_opening().unwrap();
+
+        let waiter = {
+            let lifecycle = lifecycle.clone();
+            thread::spawn(move || lifecycle.wait_for_handle(Duration::from_secs(600)))
+        };
+        thread::sleep(Duration::from_millis(50));
+        assert!(lifecycle.cancel_opening());
+        assert!(!lifecycle.cancel_opening());
+        assert_eq!(waiter.join().unwrap().unwrap_err().kind(), VcxErrorKind::NoPoolOpen);
+
+        // handle of the cancelled opening is handed back to be closed, even if the pool is opened again meanwhile
+        assert_eq!(lifecycle.finish_opening(cancelled, Ok(7)), Some(7));
+        assert_eq!(lifecycle.handle(), None);
+        let reopened = lifecycle.begin_opening().unwrap();
+        assert_eq!(lifecycle.finish_opening(cancelled, Ok(7)), Some(7));
+        assert!(lifecycle.is_opening());
+        assert_eq!(lifecycle.finish_opening(reopened, Ok(8)), None);
+        assert_eq!(lifecycle.handle(), Some(8));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_close_does_not_wait_for_opening_pool() {
+        let _setup = SetupMocks::init();
+
+        let generation = POOL_LIFECYCLE.begin_opening().unwrap();
+        let started = Instant::now();
+        close().unwrap();
+        assert!(started.elapsed() < Duration::from_secs(POOL_OPEN_WAIT_SECS));
+        assert!(!is_pool_opening());
+        assert!(!is_pool_open());
+
+        assert_eq!(POOL_LIFECYCLE.finish_opening(generation, Ok(7)), Some(7));
+        assert!(!is_pool_open());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_stopped_refresh_wakes_up() {
+        let lifecycle = Arc::new(PoolLifecycle::new());
+        let generation = lifecycle.next_refresh_generation();
+        assert!(lifecycle.wait_for_refresh(generation, Duration::from_millis(10)));
+
+        let refresher = {
+            let lifecycle = lifecycle.clone();
+            thread::spawn(move || lifecycle.wait_for_refresh(generation, Duration::from_secs(600)))
+        };
+        thread::sleep(Duration::from_millis(50));
+        lifecycle.stop_refresh();
+        assert!(!refresher.join().unwrap());
+    }
 
     #[cfg(feature = "pool_tests")]
     #[test]
@@ -0,0 +1,169 @@
+use std::collections::HashMap;
+use std::sync::Mutex;
+
+const MAX_CACHED_REV_REGS: usize = 256;
+const MAX_SNAPSHOTS_PER_REV_REG: usize = 32;
+
+lazy_static! {
+    static ref REV_REG_SNAPSHOTS: Mutex<RevRegSnapshotCache> = Mutex::new(RevRegSnapshotCache::default());
+}
+
+/*
+GET_REVOC_REG for timestamp `t` returns accumulator of the last registry entry written at or before `t`,
+together with the time of that entry. Hence the same accumulator is valid for every timestamp between
+the entry time and `t` and requests falling into such interval can be served locally.
+ */
+#[derive(Debug, Clone, PartialEq)]
+struct RevRegSnapshot {
+    ledger_timestamp: u64,
+    valid_until: u64,
+    rev_reg_json: String,
+}
+
+#[derive(Debug, Default)]
+struct RevRegSnapshots {
+    last_used: u64,
+    snapshots: Vec<RevRegSnapshot>,
+}
+
+#[derive(Debug, Default)]
+struct RevRegSnapshotCache {
+    rev_regs: HashMap<String, RevRegSnapshots>,
+    tick: u64,
+}
+
+impl RevRegSnapshotCache {
+    fn get(&mut self, rev_reg_id: &str, timestamp: u64) -> Option<(String, u64)> {
+        self.tick += 1;
+        let tick = self.tick;
+        let rev_reg = self.rev_regs.get_mut(rev_reg_id)?;
+        let snapshot = rev_reg.snapshots.iter()
+            .find(|snapshot| snapshot.ledger_timestamp <= timestamp && timestamp <= snapshot.valid_until)?;
+        rev_reg.last_used = tick;
+        Some((snapshot.rev_reg_json.clone(), snapshot.ledger_timestamp))
+    }
+
+    fn insert(&mut self, rev_reg_id: &str, requested_timestamp: u64, ledger_timestamp: u64, rev_reg_json: &str, now: u64) {
+        // entries may still be written between now and a future requested timestamp
+        let valid_until = requested_timestamp.min(now);
+        if valid_until < ledger_timestamp {
+            return;
+        }
+        self.tick += 1;
+        let tick = self.tick;
+
+        if !self.rev_regs.contains_key(rev_reg_id) && self.rev_regs.len() >= MAX_CACHED_REV_REGS {
+            self._evict_least_recently_used();
+        }
+        let rev_reg = self.rev_regs.entry(rev_reg_id.to_string()).or_insert_with(RevRegSnapshots::default);
+        rev_reg.last_used = tick;
+
+        match rev_reg.snapshots.iter_mut().find(|snapshot| snapshot.ledger_timestamp == ledger_timestamp) {
+            Some(snapshot) => {
+                snapshot.valid_until = snapshot.valid_until.max(valid_until);
+            }
+            None => {
+                rev_reg.snapshots.push(RevRegSnapshot { ledger_timestamp, valid_until, rev_reg_json: rev_reg_json.to_string() });
+                rev_reg.snapshots.sort_by_key(|snapshot| snapshot.ledger_timestamp);
+                if rev_reg.snapshots.len() > MAX_SNAPSHOTS_PER_REV_REG {
+                    rev_reg.snapshots.remove(0);
+                }
+            }
+        }
+    }
+
+    fn _evict_least_recently_used(&mut self) {
+        let lru = self.rev_regs.iter()
+            .min_by_key(|(_, rev_reg)| rev_reg.last_used)
+            .map(|(rev_reg_id, _)| rev_reg_id.clone());
+        if let Some(rev_reg_id) = lru {
+            self.rev_regs.remove(&rev_reg_id);
+        }
+    }
+}
+
+///
+/// Returns cached revocation registry valid at given timestamp.
+///
+/// # Returns
+/// Revocation registry json and timestamp of its ledger entry
+pub fn get_rev_reg_snapshot(rev_reg_id: &str, timestamp: u64) -> Option<(String, u64)> {
+    match REV_REG_SNAPSHOTS.lock() {
+        Ok(mut cache) => cache.get(rev_reg_id, timestamp),
+        Err(_) => None
+    }
+}
+
+///
+/// Caches revocation registry as returned by ledger for the requested timestamp.
+///
+pub fn set_rev_reg_snapshot(rev_reg_id: &str, requested_timestamp: u64, ledger_timestamp: u64, rev_reg_json: &str) {
+    let now = time::get_time().sec as u64;
+    if let Ok(mut cache) = REV_REG_SNAPSHOTS.lock() {
+        cache.insert(rev_reg_id, requested_timestamp, ledger_timestamp, rev_reg_json, now);
+    }
+}
+
+pub fn clear_rev_reg_snapshots() {
+    if let Ok(mut cache) = REV_REG_SNAPSHOTS.lock() {
+        *cache = RevRegSnapshotCache::default();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_snapshot_served_within_interval() {
+        let mut cache = RevRegSnapshotCache::default();
+        cache.insert("rev_reg_1", 200, 100, "accum_100", 1000);
+
+        assert_eq!(cache.get("rev_reg_1", 100), Some(("accum_100".to_string(), 100)));
+        assert_eq!(cache.get("rev_reg_1", 150), Some(("accum_100".to_string(), 100)));
+        assert_eq!(cache.get("rev_reg_1", 200), Some(("accum_100".to_string(), 100)));
+        assert_eq!(cache.get("rev_reg_1", 201), None);
+        assert_eq!(cache.get("rev_reg_1", 99), None);
+        assert_eq!(cache.get("rev_reg_2", 150), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_snapshot_interval_is_extended() {
+        let mut cache = RevRegSnapshotCache::default();
+        cache.insert("rev_reg_1", 200, 100, "accum_100", 1000);
+        cache.insert("rev_reg_1", 300, 100, "accum_100", 1000);
+        cache.insert("rev_reg_1", 500, 400, "accum_400", 1000);
+
+        assert_eq!(cache.get("rev_reg_1", 250), Some(("accum_100".to_string(), 100)));
+        assert_eq!(cache.get("rev_reg_1", 350), None);
+        assert_eq!(cache.get("rev_reg_1", 450), Some(("accum_400".to_string(), 400)));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_snapshot_not_valid_past_now() {
+        let mut cache = RevRegSnapshotCache::default();
+        cache.insert("rev_reg_1", 5000, 100, "accum_100", 1000);
+
+        assert_eq!(cache.get("rev_reg_1", 1000), Some(("accum_100".to_string(), 100)));
+        assert_eq!(cache.get("rev_reg_1", 1001), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cache_is_bounded() {
+        let mut cache = RevRegSnapshotCache::default();
+        for i in 0..MAX_CACHED_REV_REGS + 1 {
+            cache.insert(&format!("rev_reg_{}", i), 200, 100, "accum", 1000);
+        }
+        assert_eq!(cache.rev_regs.len(), MAX_CACHED_REV_REGS);
+        assert_eq!(cache.get("rev_reg_0", 150), None);
+
+        for i in 0..MAX_SNAPSHOTS_PER_REV_REG as u64 + 1 {
+            cache.insert("rev_reg_1", i * 10 + 5, i * 10, "accum", 1000);
+        }
+        assert_eq!(cache.rev_regs.get("rev_reg_1").unwrap().snapshots.len(), MAX_SNAPSHOTS_PER_REV_REG);
+    }
+}
@@ -0,0 +1,264 @@
+use std::collections::{HashMap, HashSet};
+use std::sync::Mutex;
+
+use crate::error::prelude::*;
+
+// Upper bound on visited nodes when searching for exact match, keeps selection fast for large wallets
+const MAX_BRANCH_AND_BOUND_TRIES: usize = 100_000;
+
+lazy_static! {
+    static ref UTXO_SET: Mutex<UtxoSet> = Mutex::new(UtxoSet::default());
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub struct CachedUtxo {
+    pub source: String,
+    pub recipient: String,
+    pub amount: u64,
+}
+
+#[derive(Debug, Clone, PartialEq)]
+pub struct UtxoSelection {
+    pub inputs: Vec<String>,
+    pub remainder: u64,
+    pub refund_address: String,
+}
+
+/*
+Local view of unspent outputs of wallet payment addresses. UTXOs selected for a payment are reserved until
+the payment completes, so concurrent payments never pick the same UTXO. Completed payments replace spent
+UTXOs by receipts paid to wallet addresses, hence the ledger only needs to be swept on first use or after
+the view was invalidated.
+ */
+#[derive(Debug, Default)]
+struct UtxoSet {
+    loaded: bool,
+    addresses: HashSet<String>,
+    utxos: HashMap<String, CachedUtxo>,
+    reserved: HashSet<String>,
+}
+
+impl UtxoSet {
+    fn load(&mut self, addresses: Vec<String>, utxos: Vec<CachedUtxo>) {
+        self.addresses = addresses.into_iter().collect();
+        self.utxos = utxos.into_iter().map(|utxo| (utxo.source.clone(), utxo)).collect();
+        self.loaded = true;
+    }
+
+    fn reserve(&mut self, cost: u64) -> VcxResult<UtxoSelection> {
+        let mut available: Vec<&CachedUtxo> = self.utxos.values()
+            .filter(|utxo| !self.reserved.contains(&utxo.source))
+            .collect();
+        // deterministic order regardless of hash map iteration
+        available.sort_by(|a, b| b.amount.cmp(&a.amount).then_with(|| a.source.cmp(&b.source)));
+
+        let balance = available.iter().fold(0, |balance, utxo| balance + utxo.amount);
+        let amounts: Vec<u64> = available.iter().map(|utxo| utxo.amount).collect();
+        let selected = select_utxos(&amounts, cost)
+            .ok_or_else(|| VcxError::from_msg(VcxErrorKind::InsufficientTokenAmount,
+                                              format!("Not enough tokens in wallet to pay: available balance: {}, cost: {}", balance, cost)))?;
+
+        let selected: Vec<&CachedUtxo> = selected.into_iter().map(|index| available[index]).collect();
+        let total = selected.iter().fold(0, |total, utxo| total + utxo.amount);
+        let refund_address = selected.first().map(|utxo| utxo.recipient.clone())
+            .or_else(|| self.addresses.iter().min().cloned())
+            .unwrap_or_default();
+        let inputs: Vec<String> = selected.iter().map(|utxo| utxo.source.clone()).collect();
+
+        self.reserved.extend(inputs.iter().cloned());
+        Ok(UtxoSelection { inputs, remainder: total - cost, refund_address })
+    }
+
+    fn release(&mut self, inputs: &[String]) {
+        for input in inputs {
+            self.reserved.remove(input);
+        }
+    }
+
+    fn spend(&mut self, inputs: &[String], receipts: Vec<CachedUtxo>) {
+        for input in inputs {
+            self.reserved.remove(input);
+            self.utxos.remove(input);
+        }
+        for receipt in receipts {
+            if self.addresses.contains(&receipt.recipient) {
+                self.utxos.insert(receipt.source.clone(), receipt);
+            }
+        }
+    }
+}
+
+/**
+Selects UTXOs covering `cost`. Amounts are expected in descending order. Prefers exact match found by
+branch and bound as it leaves no change output behind; otherwise picks the candidate with smallest change
+out of the smallest single sufficient UTXO and largest-first accumulation.
+
+# Returns
+Indices of selected amounts, None if amounts do not cover cost
+ */
+pub fn select_utxos(amounts: &[u64], cost: u64) -> Option<Vec<usize>> {
+    if cost == 0 {
+        return Some(Vec::new());
+    }
+    let balance: u64 = amounts.iter().sum();
+    if balance < cost {
+        return None;
+    }
+
+    if let Some(exact) = _branch_and_bound(amounts, cost) {
+        return Some(exact);
+    }
+
+    let mut candidates: Vec<Vec<usize>> = Vec::new();
+    if let Some(index) = (0..amounts.len()).filter(|index| amounts[*index] >= cost).min_by_key(|index| amounts[*index]) {
+        candidates.push(vec![index]);
+    }
+    let mut accumulated = 0;
+    let mut largest_first = Vec::new();
+    for (index, amount) in amounts.iter().enumerate() {
+        if accumulated >= cost { break; }
+        accumulated += amount;
+        largest_first.push(index);
+    }
+    candidates.push(largest_first);
+
+    candidates.into_iter()
+        .min_by_key(|selected| (selected.iter().map(|index| amounts[*index]).sum::<u64>() - cost, selected.len()))
+}
+
+fn _branch_and_bound(amounts: &[u64], cost: u64) -> Option<Vec<usize>> {
+    let mut remaining: Vec<u64> = vec![0; amounts.len() + 1];
+    for index in (0..amounts.len()).rev() {
+        remaining[index] = remaining[index + 1] + amounts[index];
+    }
+
+    let mut selected = Vec::new();
+    let mut tries = 0;
+    if _branch_and_bound_step(amounts, &remaining, cost, 0, 0, &mut selected, &mut tries) {
+        Some(selected)
+    } else {
+        None
+    }
+}
+
+fn _branch_and_bound_step(amounts: &[u64], remaining: &[u64], cost: u64, index: usize, total: u64,
+                          selected: &mut Vec<usize>, tries: &mut usize) -> bool {
+    *tries += 1;
+    if total == cost {
+        return true;
+    }
+    if total > cost || total + remaining[index] < cost || index == amounts.len() || *tries > MAX_BRANCH_AND_BOUND_TRIES {
+        return false;
+    }
+
+    selected.push(index);
+    if _branch_and_bound_step(amounts, remaining, cost, index + 1, total + amounts[index], selected, tries) {
+        return true;
+    }
+    selected.pop();
+
+    // skipping an amount equal to the one just tried leads to the same totals
+    let mut next = index + 1;
+    while next < amounts.len() && amounts[next] == amounts[index] {
+        next += 1;
+    }
+    _branch_and_bound_step(amounts, remaining, cost, next, total, selected, tries)
+}
+
+pub fn is_utxo_cache_loaded() -> bool {
+    UTXO_SET.lock().map(|set| set.loaded).unwrap_or(false)
+}
+
+///
+/// Replaces cached UTXOs by those swept from ledger. Reservations of pending payments are kept.
+///
+pub fn load_utxo_cache(addresses: Vec<String>, utxos: Vec<CachedUtxo>) -> VcxResult<()> {
+    UTXO_SET.lock()?.load(addresses, utxos);
+    Ok(())
+}
+
+///
+/// Selects and reserves UTXOs paying `cost`. Reservation must be finished by `spend_utxos` or `release_utxos`.
+///
+pub fn reserve_utxos(cost: u64) -> VcxResult<UtxoSelection> {
+    UTXO_SET.lock()?.reserve(cost)
+}
+
+pub fn spend_utxos(inputs: &[String], receipts: Vec<CachedUtxo>) -> VcxResult<()> {
+    UTXO_SET.lock()?.spend(inputs, receipts);
+    Ok(())
+}
+
+///
+/// Releases reserved UTXOs of failed payment. As it is unknown whether ledger has processed the payment,
+/// cache is invalidated and ledger is swept again before next selection.
+///
+pub fn release_utxos(inputs: &[String]) -> VcxResult<()> {
+    let mut set = UTXO_SET.lock()?;
+    set.release(inputs);
+    set.loaded = false;
+    Ok(())
+}
+
+pub fn clear_utxo_cache() {
+    if let Ok(mut set) = UTXO_SET.lock() {
+        *set = UtxoSet::default();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn _utxo(source: &str, recipient: &str, amount: u64) -> CachedUtxo {
+        CachedUtxo { source: source.to_string(), recipient: recipient.to_string(), amount }
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_select_utxos_prefers_exact_match() {
+        assert_eq!(select_utxos(&[10, 7, 5, 3], 8), Some(vec![2, 3]));
+        assert_eq!(select_utxos(&[10, 7, 5, 3], 15), Some(vec![0, 2]));
+        assert_eq!(select_utxos(&[10, 7, 5, 3], 0), Some(vec![]));
+        assert_eq!(select_utxos(&[10, 7, 5, 3], 26), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_select_utxos_minimises_change() {
+        // no exact match, smallest sufficient utxo leaves less change than largest first
+        assert_eq!(select_utxos(&[100, 10, 4], 9), Some(vec![1]));
+        // no single utxo is sufficient
+        assert_eq!(select_utxos(&[4, 4, 4], 9), Some(vec![0, 1, 2]));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_reserved_utxos_are_not_selected_twice() {
+        let mut set = UtxoSet::default();
+        set.load(vec!["pay:null:1".to_string()], vec![_utxo("txo:1", "pay:null:1", 5), _utxo("txo:2", "pay:null:1", 5)]);
+
+        let first = set.reserve(5).unwrap();
+        let second = set.reserve(5).unwrap();
+        assert_ne!(first.inputs, second.inputs);
+        assert_eq!(set.reserve(1).unwrap_err().kind(), VcxErrorKind::InsufficientTokenAmount);
+
+        set.release(&first.inputs);
+        assert_eq!(set.reserve(5).unwrap().inputs, first.inputs);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_spend_replaces_inputs_by_own_receipts() {
+        let mut set = UtxoSet::default();
+        set.load(vec!["pay:null:1".to_string()], vec![_utxo("txo:1", "pay:null:1", 10)]);
+
+        let selection = set.reserve(4).unwrap();
+        assert_eq!(selection, UtxoSelection { inputs: vec!["txo:1".to_string()], remainder: 6, refund_address: "pay:null:1".to_string() });
+
+        set.spend(&selection.inputs, vec![_utxo("txo:2", "pay:null:1", 6), _utxo("txo:3", "pay:null:other", 4)]);
+        assert!(set.reserved.is_empty());
+        assert_eq!(set.utxos.len(), 1);
+        assert_eq!(set.reserve(6).unwrap().inputs, vec!["txo:2".to_string()]);
+    }
+}
@@ -1,12 +1,24 @@
+use std::sync::Arc;
+
 use indy::{ErrorCode, wallet};
 use indy::{INVALID_WALLET_HANDLE, SearchHandle, WalletHandle};
 use indy::future::Future;
 
+use agency_client::metrics;
+
 use crate::error::prelude::*;
 use crate::init::open_as_main_wallet;
-use crate::libindy::utils::{anoncreds, signus};
+use crate::libindy::utils::{anoncreds, signus, TimedWait, utxo_cache};
 use crate::settings;
 
+lazy_static! {
+    static ref INDY_WALLET_ADD_RECORD: Arc<metrics::Histogram> = metrics::histogram("indy_wallet_add_record");
+    static ref INDY_WALLET_GET_RECORD: Arc<metrics::Histogram> = metrics::histogram("indy_wallet_get_record");
+    static ref INDY_WALLET_DELETE_RECORD: Arc<metrics::Histogram> = metrics::histogram("indy_wallet_delete_record");
+    static ref INDY_WALLET_UPDATE_RECORD_VALUE: Arc<metrics::Histogram> = metrics::histogram("indy_wallet_update_record_value");
+    static ref INDY_WALLET_FETCH_SEARCH_RECORDS: Arc<metrics::Histogram> = metrics::histogram("indy_wallet_fetch_search_records");
+}
+
 #[derive(Clone, Debug, Serialize, Deserialize)]
 pub struct WalletConfig {
     pub wallet_name: String,
@@ -179,6 +191,7 @@ pub fn close_main_wallet() -> VcxResult<()> {
     wallet::close_wallet(get_wallet_handle())
         .wait()?;
 
+    utxo_cache::clear_utxo_cache();
     reset_wallet_handle()?;
     Ok(())
 }
@@ -215,7 +228,7 @@ pub fn add_record(xtype: &str, id: &str, value: &str, tags: Option<&str>) -> Vcx
     if settings::indy_mocks_enabled() { return Ok(()); }
 
     wallet::add_wallet_record(get_wallet_handle(), xtype, id, value, tags)
-        .wait()
+        .timed_wait(&INDY_WALLET_ADD_RECORD)
         .map_err(VcxError::from)
 }
 
@@ -227,7 +240,7 @@ pub fn get_record(xtype: &str, id: &str, options: &str) -> VcxResult<String> {
     }
 
     wallet::get_wallet_record(get_wallet_handle(), xtype, id, options)
-        .wait()
+        .timed_wait(&INDY_WALLET_GET_RECORD)
         .map_err(VcxError::from)
 }
 
@@ -237,7 +250,7 @@ pub fn delete_record(xtype: &str, id: &str) -> VcxResult<()> {
     if settings::indy_mocks_enabled() { return Ok(()); }
 
     wallet::delete_wallet_record(get_wallet_handle(), xtype, id)
-        .wait()
+        .timed_wait(&INDY_WALLET_DELETE_RECORD)
         .map_err(VcxError::from)
 }
 
@@ -248,7 +261,7 @@ pub fn update_record_value(xtype: &str, id: &str, value: &str) -> VcxResult<()>
     if settings::indy_mocks_enabled() { return Ok(()); }
 
     wallet::update_wallet_record_value(get_wallet_handle(), xtype, id, value)
-        .wait()
+        .timed_wait(&INDY_WALLET_UPDATE_RECORD_VALUE)
         .map_err(VcxError::from)
 }
 
@@ -308,7 +321,7 @@ pub fn fetch_next_records(search_handle: SearchHandle, count: usize) -> VcxResul
     }
 
     wallet::fetch_wallet_search_next_records(get_wallet_handle(), search_handle, count)
-        .wait()
+        .timed_wait(&INDY_WALLET_FETCH_SEARCH_RECORDS)
         .map_err(VcxError::from)
 }
 
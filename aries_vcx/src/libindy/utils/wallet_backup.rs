@@ -0,0 +1,930 @@
+use std::collections::HashMap;
+use std::fs::{self, File, OpenOptions};
+use std::io::{self, BufReader, BufWriter, Read, Seek, SeekFrom, Write};
+use std::path::Path;
+use std::sync::mpsc::{Receiver, sync_channel, SyncSender};
+use std::thread::{self, JoinHandle};
+
+use flate2::Compression;
+use flate2::read::DeflateDecoder;
+use flate2::write::DeflateEncoder;
+use indy::INVALID_WALLET_HANDLE;
+use openssl::hash::MessageDigest;
+use openssl::pkcs5::pbkdf2_hmac;
+use openssl::rand::rand_bytes;
+use openssl::sha::{Sha256, sha256};
+use openssl::symm::{Cipher, decrypt_aead, encrypt_aead};
+
+use crate::error::prelude::*;
+use crate::init::open_as_main_wallet;
+use crate::libindy::utils::wallet::{add_record, close_main_wallet, delete_record, export_main_wallet, get_wallet_handle, import,
+                                    RestoreWalletConfigs, update_record_tags, update_record_value, WalletConfig};
+use crate::libindy::utils::wallet_search::{count_records, DEFAULT_SEARCH_PAGE_SIZE, SearchProjection, WalletRecord, WalletSearch};
+use crate::settings;
+
+const ARCHIVE_MAGIC: &[u8] = b"VCXWB\x01";
+const KEY_DERIVATION_ITERATIONS: u32 = 100_000;
+const SALT_LEN: usize = 16;
+const NONCE_LEN: usize = 12;
+const TAG_LEN: usize = 16;
+const MAX_HEADER_LEN: usize = 64 * 1024;
+const MAX_FRAME_LEN: usize = 256 * 1024 * 1024;
+const INDY_EXPORT_CHUNK_LEN: usize = 1024 * 1024;
+const MANIFEST_CHUNK_LEN: usize = 1000;
+const PIPELINE_DEPTH: usize = 4;
+const FRAME_DEFLATED_CHUNK: u8 = 0;
+const FRAME_INDY_EXPORT: u8 = 1;
+
+/*
+Wallet backup archive is a header followed by frames, each frame holding one chunk. Chunks are serialized
+to MessagePack, deflated and sealed with AES-256-GCM under a key derived from the backup key. IndyExport
+chunks are sealed as raw bytes instead, libindy export being encrypted already and so incompressible; the
+first byte of every sealed frame tells which of the two it is. The archive id and frame index are
+authenticated with every frame, so frames cannot be reordered or moved between archives. Frames are only
+appended, so an interrupted export leaves a valid prefix of frames it can be resumed from.
+
+Records hidden from non-secrets API (DIDs, keys, credentials, master secret) are only reachable through
+libindy export, so the archive carries libindy export of the whole wallet first, split into IndyExport
+chunks, followed by Records chunks with non-secret records of the requested types. Incremental archives
+only carry records changed since their base archive, and ids of records deleted since then, found by
+comparing against the manifest of record digests which closes every archive. Increments carry libindy
+export as well, secrets created since the base being reachable no other way, and restore refuses
+archives whose newest one was exported without it.
+ */
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+enum Chunk {
+    IndyExport { data: Vec<u8>, last: bool },
+    Records { record_type: String, records: Vec<BackupRecord> },
+    Deleted { record_type: String, ids: Vec<String> },
+    Manifest { record_type: String, entries: Vec<(String, [u8; 32])> },
+    End { records: u64 },
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+struct BackupRecord {
+    id: String,
+    value: String,
+    tags: HashMap<String, String>,
+}
+
+impl BackupRecord {
+    fn digest(&self) -> [u8; 32] {
+        let mut tags: Vec<(&String, &String)> = self.tags.iter().collect();
+        tags.sort();
+        let mut hasher = Sha256::new();
+        hasher.update(self.value.as_bytes());
+        for (name, value) in tags {
+            hasher.update(&[0]);
+            hasher.update(name.as_bytes());
+            hasher.update(&[0]);
+            hasher.update(value.as_bytes());
+        }
+        hasher.finish()
+    }
+}
+
+impl From<WalletRecord> for BackupRecord {
+    fn from(record: WalletRecord) -> Self {
+        BackupRecord {
+            id: record.id,
+            value: record.value.unwrap_or_default(),
+            tags: record.tags.unwrap_or_default(),
+        }
+    }
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+struct ArchiveHeader {
+    backup_id: String,
+    base_id: Option<String>,
+    salt: String,
+    iterations: u32,
+    key_check: String,
+}
+
+#[derive(Clone)]
+struct ArchiveKey {
+    key: Vec<u8>,
+    backup_id: String,
+}
+
+impl ArchiveKey {
+    fn derive(backup_key: &str, salt: &[u8], iterations: u32, backup_id: &str) -> VcxResult<ArchiveKey> {
+        let mut key = vec![0u8; 32];
+        pbkdf2_hmac(backup_key.as_bytes(), salt, iterations as usize, MessageDigest::sha256(), &mut key)
+            .to_vcx(VcxErrorKind::WalletAccessFailed, "Cannot derive wallet backup key")?;
+        Ok(ArchiveKey { key, backup_id: backup_id.to_string() })
+    }
+
+    fn check_value(&self) -> String {
+        let mut data = b"vcx-wallet-backup-key-check".to_vec();
+        data.extend_from_slice(&self.key);
+        base64::encode(&sha256(&data))
+    }
+
+    fn aad(&self, index: u64) -> Vec<u8> {
+        let mut aad = self.backup_id.as_bytes().to_vec();
+        aad.extend_from_slice(&index.to_be_bytes());
+        aad
+    }
+
+    fn seal(&self, index: u64, chunk: &Chunk) -> VcxResult<Vec<u8>> {
+        let plaintext = _encode_chunk(chunk)?;
+        let mut nonce = [0u8; NONCE_LEN];
+        rand_bytes(&mut nonce)
+            .to_vcx(VcxErrorKind::IOError, "Cannot generate wallet backup nonce")?;
+        let mut tag = [0u8; TAG_LEN];
+        let ciphertext = encrypt_aead(Cipher::aes_256_gcm(), &self.key, Some(&nonce[..]), &self.aad(index), &plaintext, &mut tag)
+            .to_vcx(VcxErrorKind::IOError, "Cannot encrypt wallet backup chunk")?;
+
+        let mut frame = Vec::with_capacity(NONCE_LEN + ciphertext.len() + TAG_LEN);
+        frame.extend_from_slice(&nonce);
+        frame.extend_from_slice(&ciphertext);
+        frame.extend_from_slice(&tag);
+        Ok(frame)
+    }
+
+    fn open(&self, index: u64, frame: &[u8]) -> VcxResult<Chunk> {
+        let (nonce, rest) = frame.split_at(NONCE_LEN);
+        let (ciphertext, tag) = rest.split_at(rest.len() - TAG_LEN);
+        let plaintext = decrypt_aead(Cipher::aes_256_gcm(), &self.key, Some(nonce), &self.aad(index), ciphertext, tag)
+            .map_err(|_| VcxError::from_msg(VcxErrorKind::IOError, format!("Wallet backup chunk {} is corrupted", index)))?;
+        _decode_chunk(&plaintext)
+    }
+}
+
+fn _encode_chunk(chunk: &Chunk) -> VcxResult<Vec<u8>> {
+    if let Chunk::IndyExport { data, last } = chunk {
+        let mut plaintext = Vec::with_capacity(2 + data.len());
+        plaintext.push(FRAME_INDY_EXPORT);
+        plaintext.push(*last as u8);
+        plaintext.extend_from_slice(data);
+        return Ok(plaintext);
+    }
+    let serialized = rmp_serde::to_vec(chunk)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize wallet backup chunk")?;
+    let mut encoder = DeflateEncoder::new(vec![FRAME_DEFLATED_CHUNK], Compression::default());
+    encoder.write_all(&serialized)
+        .to_vcx(VcxErrorKind::IOError, "Cannot compress wallet backup chunk")?;
+    encoder.finish()
+        .to_vcx(VcxErrorKind::IOError, "Cannot compress wallet backup chunk")
+}
+
+fn _decode_chunk(plaintext: &[u8]) -> VcxResult<Chunk> {
+    match plaintext.split_first() {
+        Some((&FRAME_INDY_EXPORT, rest)) if !rest.is_empty() => {
+            Ok(Chunk::IndyExport { data: rest[1..].to_vec(), last: rest[0] != 0 })
+        }
+        Some((&FRAME_DEFLATED_CHUNK, compressed)) => {
+            let mut serialized = Vec::new();
+            DeflateDecoder::new(compressed).read_to_end(&mut serialized)
+                .to_vcx(VcxErrorKind::IOError, "Cannot decompress wallet backup chunk")?;
+            rmp_serde::from_slice(&serialized)
+                .to_vcx(VcxErrorKind::InvalidMessagePack, "Cannot deserialize wallet backup chunk")
+        }
+        _ => Err(VcxError::from_msg(VcxErrorKind::IOError, "Wallet backup chunk has unknown format"))
+    }
+}
+
+fn _new_header(backup_key: &str, base_id: Option<String>) -> VcxResult<(ArchiveHeader, ArchiveKey)> {
+    let mut salt = [0u8; SALT_LEN];
+    rand_bytes(&mut salt)
+        .to_vcx(VcxErrorKind::IOError, "Cannot generate wallet backup salt")?;
+    let backup_id = uuid::Uuid::new_v4().to_string();
+    let key = ArchiveKey::derive(backup_key, &salt, KEY_DERIVATION_ITERATIONS, &backup_id)?;
+    let header = ArchiveHeader {
+        backup_id,
+        base_id,
+        salt: base64::encode(&salt),
+        iterations: KEY_DERIVATION_ITERATIONS,
+        key_check: key.check_value(),
+    };
+    Ok((header, key))
+}
+
+/// Position in the archive right after a frame, from which frames can be appended again.
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Checkpoint {
+    position: u64,
+    next_index: u64,
+}
+
+struct ArchiveReader {
+    reader: BufReader<File>,
+    header: ArchiveHeader,
+    key: ArchiveKey,
+    checkpoint: Checkpoint,
+}
+
+impl ArchiveReader {
+    fn open(path: &str, backup_key: &str) -> VcxResult<ArchiveReader> {
+        let file = File::open(path)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot open wallet backup archive {}", path))?;
+        let mut reader = BufReader::new(file);
+
+        let mut magic = [0u8; 6];
+        reader.read_exact(&mut magic)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot read wallet backup archive {}", path))?;
+        if &magic[..] != ARCHIVE_MAGIC {
+            return Err(VcxError::from_msg(VcxErrorKind::IOError, format!("File {} is not a wallet backup archive", path)));
+        }
+        let header_len = _read_len(&mut reader)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot read wallet backup archive {}", path))?
+            .filter(|len| *len <= MAX_HEADER_LEN)
+            .ok_or(VcxError::from_msg(VcxErrorKind::IOError, format!("Wallet backup archive {} has invalid header", path)))?;
+        let mut header = vec![0u8; header_len];
+        reader.read_exact(&mut header)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot read wallet backup archive {}", path))?;
+        let header: ArchiveHeader = serde_json::from_slice(&header)
+            .to_vcx(VcxErrorKind::InvalidJson, format!("Wallet backup archive {} has invalid header", path))?;
+
+        let salt = base64::decode(&header.salt)
+            .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Wallet backup archive {} has invalid salt: {}", path, err)))?;
+        let key = ArchiveKey::derive(backup_key, &salt, header.iterations, &header.backup_id)?;
+        if key.check_value() != header.key_check {
+            return Err(VcxError::from_msg(VcxErrorKind::WalletAccessFailed, format!("Invalid backup key for wallet backup archive {}", path)));
+        }
+
+        let position = (ARCHIVE_MAGIC.len() + 4 + header_len) as u64;
+        Ok(ArchiveReader { reader, header, key, checkpoint: Checkpoint { position, next_index: 0 } })
+    }
+
+    ///
+    /// Returns following chunk, or `None` at the end of the archive. Frame cut short by an interrupted
+    /// export is reported as an error.
+    ///
+    fn next_chunk(&mut self) -> VcxResult<Option<Chunk>> {
+        let frame_len = match _read_len(&mut self.reader).to_vcx(VcxErrorKind::IOError, "Cannot read wallet backup frame")? {
+            Some(frame_len) => frame_len,
+            None => return Ok(None)
+        };
+        if frame_len < NONCE_LEN + TAG_LEN || frame_len > MAX_FRAME_LEN {
+            return Err(VcxError::from_msg(VcxErrorKind::IOError, format!("Wallet backup frame {} has invalid length {}", self.checkpoint.next_index, frame_len)));
+        }
+        let mut frame = vec![0u8; frame_len];
+        self.reader.read_exact(&mut frame)
+            .to_vcx(VcxErrorKind::IOError, "Cannot read wallet backup frame")?;
+        let chunk = self.key.open(self.checkpoint.next_index, &frame)?;
+        self.checkpoint = Checkpoint {
+            position: self.checkpoint.position + 4 + frame_len as u64,
+            next_index: self.checkpoint.next_index + 1,
+        };
+        Ok(Some(chunk))
+    }
+}
+
+/// Reads big endian length prefix; `None` if the reader is at its end.
+fn _read_len<R: Read>(reader: &mut R) -> io::Result<Option<usize>> {
+    let mut len = [0u8; 4];
+    let mut filled = 0;
+    while filled < len.len() {
+        match reader.read(&mut len[filled..])? {
+            0 if filled == 0 => return Ok(None),
+            0 => return Err(io::Error::new(io::ErrorKind::UnexpectedEof, "length prefix cut short")),
+            read => filled += read
+        }
+    }
+    Ok(Some(u32::from_be_bytes(len) as usize))
+}
+
+struct ArchiveWriter {
+    writer: BufWriter<File>,
+    key: ArchiveKey,
+    next_index: u64,
+}
+
+impl ArchiveWriter {
+    fn create(path: &str, header: &ArchiveHeader, key: ArchiveKey) -> VcxResult<ArchiveWriter> {
+        let header = serde_json::to_vec(header)
+            .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize wallet backup header")?;
+        let file = OpenOptions::new().write(true).create_new(true).open(path)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot create wallet backup archive {}", path))?;
+        let mut writer = BufWriter::new(file);
+        writer.write_all(ARCHIVE_MAGIC)
+            .and_then(|_| writer.write_all(&(header.len() as u32).to_be_bytes()))
+            .and_then(|_| writer.write_all(&header))
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot write wallet backup archive {}", path))?;
+        Ok(ArchiveWriter { writer, key, next_index: 0 })
+    }
+
+    ///
+    /// Opens archive for appending after the checkpoint, dropping whatever follows it.
+    ///
+    fn resume(path: &str, key: ArchiveKey, checkpoint: Checkpoint) -> VcxResult<ArchiveWriter> {
+        let mut file = OpenOptions::new().write(true).open(path)
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot open wallet backup archive {}", path))?;
+        file.set_len(checkpoint.position)
+            .and_then(|_| file.seek(SeekFrom::End(0)))
+            .to_vcx(VcxErrorKind::IOError, format!("Cannot truncate wallet backup archive {}", path))?;
+        Ok(ArchiveWriter { writer: BufWriter::new(file), key, next_index: checkpoint.next_index })
+    }
+
+    fn write_chunk(&mut self, chunk: &Chunk) -> VcxResult<()> {
+        let frame = self.key.seal(self.next_index, chunk)?;
+        self.writer.write_all(&(frame.len() as u32).to_be_bytes())
+            .and_then(|_| self.writer.write_all(&frame))
+            .to_vcx(VcxErrorKind::IOError, "Cannot write wallet backup frame")?;
+        self.next_index += 1;
+        Ok(())
+    }
+
+    fn finish(mut self) -> VcxResult<()> {
+        self.writer.flush()
+            .and_then(|_| self.writer.get_ref().sync_all())
+            .to_vcx(VcxErrorKind::IOError, "Cannot flush wallet backup archive")
+    }
+}
+
+///
+/// Compresses, encrypts and writes chunks on a separate thread, so sealing a chunk overlaps with
+/// fetching the next page of records from the wallet.
+///
+fn _spawn_writer(mut writer: ArchiveWriter) -> VcxResult<(SyncSender<Chunk>, JoinHandle<VcxResult<()>>)> {
+    let (sender, receiver) = sync_channel::<Chunk>(PIPELINE_DEPTH);
+    let handle = thread::Builder::new()
+        .name("vcx-wallet-backup-writer".to_string())
+        .spawn(move || {
+            for chunk in receiver {
+                writer.write_chunk(&chunk)?;
+            }
+            writer.finish()
+        })
+        .to_vcx(VcxErrorKind::IOError, "Cannot spawn wallet backup writer thread")?;
+    Ok((sender, handle))
+}
+
+///
+/// Reads, decrypts and decompresses chunks on a separate thread, ahead of them being applied to the wallet.
+///
+fn _spawn_reader(mut reader: ArchiveReader) -> VcxResult<Receiver<VcxResult<Chunk>>> {
+    let (sender, receiver) = sync_channel::<VcxResult<Chunk>>(PIPELINE_DEPTH);
+    thread::Builder::new()
+        .name("vcx-wallet-backup-reader".to_string())
+        .spawn(move || {
+            loop {
+                let chunk = match reader.next_chunk() {
+                    Ok(Some(chunk)) => Ok(chunk),
+                    Ok(None) => return,
+                    Err(err) => Err(err)
+                };
+                let failed = chunk.is_err();
+                if sender.send(chunk).is_err() || failed {
+                    return;
+                }
+            }
+        })
+        .to_vcx(VcxErrorKind::IOError, "Cannot spawn wallet backup reader thread")?;
+    Ok(receiver)
+}
+
+fn _send(sender: &SyncSender<Chunk>, chunk: Chunk) -> VcxResult<()> {
+    sender.send(chunk)
+        .map_err(|_| VcxError::from_msg(VcxErrorKind::IOError, "Wallet backup writer stopped"))
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Serialize)]
+#[serde(rename_all = "snake_case")]
+pub enum BackupStage {
+    IndyExport,
+    Records,
+    Manifest,
+    Finished,
+}
+
+#[derive(Debug, Clone, PartialEq, Serialize)]
+pub struct BackupProgress {
+    pub stage: BackupStage,
+    pub records_done: u64,
+    pub records_total: u64,
+    /// Bytes of libindy export written or read so far, and its whole size.
+    pub indy_export_done: u64,
+    pub indy_export_total: u64,
+}
+
+#[derive(Clone, Debug, Serialize, Deserialize)]
+pub struct WalletBackupConfig {
+    pub path: String,
+    pub backup_key: String,
+    #[serde(default)]
+    pub record_types: Vec<String>,
+    /// Archive this one is an increment of; only records changed since then are written.
+    #[serde(default)]
+    pub base_path: Option<String>,
+    /// Whether libindy export of the whole wallet is included, true by default. Archive exported
+    /// without it cannot be restored as the newest one.
+    #[serde(default)]
+    pub include_indy_export: Option<bool>,
+    /// Whether export interrupted before is continued if the archive already exists.
+    #[serde(default)]
+    pub resume: bool,
+    #[serde(default)]
+    pub page_size: Option<usize>,
+}
+
+impl WalletBackupConfig {
+    fn include_indy_export(&self) -> bool {
+        self.include_indy_export.unwrap_or(true)
+    }
+}
+
+#[derive(Clone, Debug, Serialize, Deserialize)]
+pub struct WalletRestoreConfig {
+    pub wallet_name: String,
+    pub wallet_key: String,
+    #[serde(default)]
+    pub wallet_key_derivation: Option<String>,
+    pub backup_key: String,
+    /// Full archive followed by its increments, in the order they were exported.
+    pub archive_paths: Vec<String>,
+}
+
+type Manifest = HashMap<String, HashMap<String, [u8; 32]>>;
+
+/// What an interrupted export already wrote, recovered from frames of the archive.
+#[derive(Debug, Default)]
+struct ExportState {
+    indy_done: bool,
+    written: Manifest,
+    records: u64,
+}
+
+fn _read_base(path: &str, backup_key: &str) -> VcxResult<(String, Manifest)> {
+    let mut reader = ArchiveReader::open(path, backup_key)?;
+    let mut manifest = Manifest::new();
+    while let Some(chunk) = reader.next_chunk()? {
+        match chunk {
+            Chunk::Manifest { record_type, entries } => manifest.entry(record_type).or_default().extend(entries),
+            Chunk::End { .. } => return Ok((reader.header.backup_id, manifest)),
+            _ => {}
+        }
+    }
+    Err(VcxError::from_msg(VcxErrorKind::InvalidState, format!("Base wallet backup archive {} is incomplete", path)))
+}
+
+fn _resume_writer(config: &WalletBackupConfig, base_id: Option<String>) -> VcxResult<(ArchiveWriter, ExportState)> {
+    let mut reader = ArchiveReader::open(&config.path, &config.backup_key)?;
+    if reader.header.base_id != base_id {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration,
+                                      format!("Wallet backup archive {} was started from another base archive", config.path)));
+    }
+    let start = reader.checkpoint;
+    let mut state = ExportState::default();
+    let mut indy_started = false;
+    let mut manifest_start = None;
+    loop {
+        let before = reader.checkpoint;
+        match reader.next_chunk() {
+            Ok(Some(Chunk::IndyExport { last, .. })) => {
+                indy_started = true;
+                state.indy_done = last;
+            }
+            Ok(Some(Chunk::Records { record_type, records })) => {
+                state.records += records.len() as u64;
+                state.written.entry(record_type).or_default()
+                    .extend(records.iter().map(|record| (record.id.clone(), record.digest())));
+            }
+            Ok(Some(Chunk::Deleted { .. })) => {}
+            Ok(Some(Chunk::Manifest { .. })) => {
+                manifest_start.get_or_insert(before);
+            }
+            Ok(Some(Chunk::End { .. })) => {
+                return Err(VcxError::from_msg(VcxErrorKind::InvalidState, format!("Wallet backup archive {} is already complete", config.path)));
+            }
+            Ok(None) => break,
+            Err(err) => {
+                warn!("_resume_writer >>> dropping frames of {} following byte {}: {}", config.path, before.position, err);
+                break;
+            }
+        }
+    }
+
+    // libindy export is not reproducible byte for byte and manifest is written again as a whole
+    let checkpoint = if indy_started && !state.indy_done {
+        state = ExportState::default();
+        start
+    } else {
+        manifest_start.unwrap_or(reader.checkpoint)
+    };
+    let writer = ArchiveWriter::resume(&config.path, reader.key.clone(), checkpoint)?;
+    Ok((writer, state))
+}
+
+///
+/// Sends libindy export of the wallet split into chunks, reporting bytes sent after every chunk. Returns size of the export.
+///
+fn _send_indy_export(backup_key: &str, export_path: &str, sender: &SyncSender<Chunk>, report: &dyn Fn(u64, u64)) -> VcxResult<u64> {
+    export_main_wallet(export_path, backup_key)?;
+    let mut file = File::open(export_path)
+        .to_vcx(VcxErrorKind::IOError, "Cannot open libindy wallet export")?;
+    let size = file.metadata()
+        .to_vcx(VcxErrorKind::IOError, "Cannot read libindy wallet export")?
+        .len();
+    let mut sent = 0;
+    loop {
+        let mut data = Vec::with_capacity(INDY_EXPORT_CHUNK_LEN);
+        (&mut file).take(INDY_EXPORT_CHUNK_LEN as u64).read_to_end(&mut data)
+            .to_vcx(VcxErrorKind::IOError, "Cannot read libindy wallet export")?;
+        sent += data.len() as u64;
+        let last = sent >= size;
+        if data.is_empty() && !last {
+            return Err(VcxError::from_msg(VcxErrorKind::IOError, "Libindy wallet export ended unexpectedly"));
+        }
+        _send(sender, Chunk::IndyExport { data, last })?;
+        report(sent, size);
+        if last {
+            return Ok(size);
+        }
+    }
+}
+
+fn _export_chunks(config: &WalletBackupConfig, base: &Manifest, mut state: ExportState, sender: &SyncSender<Chunk>,
+                  progress: &dyn Fn(&BackupProgress)) -> VcxResult<()> {
+    let page_size = config.page_size.unwrap_or(DEFAULT_SEARCH_PAGE_SIZE);
+    let records_total = config.record_types.iter()
+        .map(|record_type| count_records(record_type, "{}"))
+        .sum::<VcxResult<usize>>()? as u64;
+    let mut records_done = 0;
+
+    let indy_export_len = if config.include_indy_export() && !state.indy_done {
+        let report_export = |indy_export_done, indy_export_total| {
+            progress(&BackupProgress { stage: BackupStage::IndyExport, records_done: 0, records_total, indy_export_done, indy_export_total })
+        };
+        report_export(0, 0);
+        let export_path = format!("{}.indy", config.path);
+        let sent = _send_indy_export(&config.backup_key, &export_path, sender, &report_export);
+        fs::remove_file(&export_path).ok();
+        sent?
+    } else {
+        0
+    };
+    let report = |stage, records_done| {
+        progress(&BackupProgress { stage, records_done, records_total, indy_export_done: indy_export_len, indy_export_total: indy_export_len })
+    };
+
+    let mut manifest = Manifest::new();
+    for record_type in &config.record_types {
+        let mut known = base.get(record_type).cloned().unwrap_or_default();
+        known.extend(state.written.remove(record_type).unwrap_or_default());
+        let mut current = HashMap::new();
+
+        let projection = SearchProjection { retrieve_type: false, retrieve_value: true, retrieve_tags: true, tag_names: None };
+        let mut search = WalletSearch::open(record_type, "{}", projection, page_size)?;
+        loop {
+            let page = search.next_page()?;
+            if page.is_empty() {
+                break;
+            }
+            records_done += page.len() as u64;
+            let changed: Vec<BackupRecord> = page.into_iter()
+                .map(BackupRecord::from)
+                .filter(|record| {
+                    let digest = record.digest();
+                    let unchanged = known.get(&record.id) == Some(&digest);
+                    current.insert(record.id.clone(), digest);
+                    !unchanged
+                })
+                .collect();
+            if !changed.is_empty() {
+                state.records += changed.len() as u64;
+                _send(sender, Chunk::Records { record_type: record_type.clone(), records: changed })?;
+            }
+            report(BackupStage::Records, records_done);
+        }
+
+        let deleted: Vec<String> = known.keys().filter(|id| !current.contains_key(*id)).cloned().collect();
+        if !deleted.is_empty() {
+            _send(sender, Chunk::Deleted { record_type: record_type.clone(), ids: deleted })?;
+        }
+        manifest.insert(record_type.clone(), current);
+    }
+
+    report(BackupStage::Manifest, records_done);
+    for (record_type, entries) in manifest {
+        let entries: Vec<(String, [u8; 32])> = entries.into_iter().collect();
+        for entries in entries.chunks(MANIFEST_CHUNK_LEN) {
+            _send(sender, Chunk::Manifest { record_type: record_type.clone(), entries: entries.to_vec() })?;
+        }
+    }
+    _send(sender, Chunk::End { records: state.records })?;
+    report(BackupStage::Finished, records_done);
+    Ok(())
+}
+
+///
+/// Exports opened wallet into compressed and encrypted archive, written chunk by chunk with progress
+/// reported after every chunk. Unlike `export_main_wallet`, export can be resumed and can be incremental.
+///
+pub fn export_wallet_stream(config: &WalletBackupConfig, progress: &dyn Fn(&BackupProgress)) -> VcxResult<()> {
+    trace!("export_wallet_stream >>> path: {}, record_types: {:?}, base_path: {:?}, resume: {}",
+           config.path, config.record_types, config.base_path, config.resume);
+    if config.backup_key.is_empty() || config.page_size == Some(0) || (config.record_types.is_empty() && !config.include_indy_export()) {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration, "Wallet backup needs backup key, positive page size and something to export"));
+    }
+
+    let (base_id, base) = match &config.base_path {
+        Some(base_path) => {
+            let (base_id, base) = _read_base(base_path, &config.backup_key)?;
+            (Some(base_id), base)
+        }
+        None => (None, Manifest::new())
+    };
+
+    let (writer, state) = if Path::new(&config.path).exists() {
+        if !config.resume {
+            return Err(VcxError::from_msg(VcxErrorKind::IOError, format!("Wallet backup archive {} already exists", config.path)));
+        }
+        _resume_writer(config, base_id)?
+    } else {
+        let (header, key) = _new_header(&config.backup_key, base_id)?;
+        (ArchiveWriter::create(&config.path, &header, key)?, ExportState::default())
+    };
+
+    let (sender, handle) = _spawn_writer(writer)?;
+    let exported = _export_chunks(config, &base, state, &sender, progress);
+    drop(sender);
+    let written = handle.join()
+        .map_err(|_| VcxError::from_msg(VcxErrorKind::IOError, "Wallet backup writer panicked"))?;
+    written.and(exported)
+}
+
+struct ArchiveSummary {
+    backup_id: String,
+    base_id: Option<String>,
+    has_indy_export: bool,
+    indy_export_len: u64,
+    records: u64,
+}
+
+fn _verify_archive(path: &str, backup_key: &str) -> VcxResult<ArchiveSummary> {
+    let mut reader = ArchiveReader::open(path, backup_key)?;
+    let mut has_indy_export = false;
+    let mut indy_export_len = 0;
+    while let Some(chunk) = reader.next_chunk()? {
+        match chunk {
+            Chunk::IndyExport { data, last } => {
+                indy_export_len += data.len() as u64;
+                has_indy_export = last;
+            }
+            Chunk::End { records } => {
+                return Ok(ArchiveSummary { backup_id: reader.header.backup_id, base_id: reader.header.base_id, has_indy_export, indy_export_len, records });
+            }
+            _ => {}
+        }
+    }
+    Err(VcxError::from_msg(VcxErrorKind::InvalidState, format!("Wallet backup archive {} is incomplete", path)))
+}
+
+fn _extract_indy_export(path: &str, backup_key: &str, export_path: &str, report: &mut dyn FnMut(u64)) -> VcxResult<()> {
+    let mut reader = ArchiveReader::open(path, backup_key)?;
+    let mut file = File::create(export_path)
+        .to_vcx(VcxErrorKind::IOError, "Cannot create libindy wallet export")?;
+    let mut extracted = 0;
+    while let Some(Chunk::IndyExport { data, last }) = reader.next_chunk()? {
+        file.write_all(&data)
+            .to_vcx(VcxErrorKind::IOError, "Cannot write libindy wallet export")?;
+        extracted += data.len() as u64;
+        report(extracted);
+        if last {
+            return file.sync_all().to_vcx(VcxErrorKind::IOError, "Cannot write libindy wallet export");
+        }
+    }
+    Err(VcxError::from_msg(VcxErrorKind::InvalidState, format!("Libindy export in wallet backup archive {} is incomplete", path)))
+}
+
+fn _upsert_record(record_type: &str, record: &BackupRecord) -> VcxResult<()> {
+    let tags = serde_json::to_string(&record.tags)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize wallet record tags")?;
+    match add_record(record_type, &record.id, &record.value, Some(&tags)) {
+        Err(err) if err.kind() == VcxErrorKind::DuplicationWalletRecord => {
+            update_record_value(record_type, &record.id, &record.value)?;
+            update_record_tags(record_type, &record.id, &tags)
+        }
+        result => result
+    }
+}
+
+fn _apply_archive(path: &str, backup_key: &str, records_done: &mut u64, report: &mut dyn FnMut(BackupStage, u64)) -> VcxResult<()> {
+    for chunk in _spawn_reader(ArchiveReader::open(path, backup_key)?)? {
+        match chunk? {
+            Chunk::Records { record_type, records } => {
+                for record in &records {
+                    _upsert_record(&record_type, record)?;
+                }
+                *records_done += records.len() as u64;
+                report(BackupStage::Records, *records_done);
+            }
+            Chunk::Deleted { record_type, ids } => {
+                for id in ids {
+                    match delete_record(&record_type, &id) {
+                        Err(err) if err.kind() == VcxErrorKind::WalletRecordNotFound => {}
+                        result => result?
+                    }
+                }
+            }
+            _ => {}
+        }
+    }
+    Ok(())
+}
+
+///
+/// Creates a new wallet from a full backup archive and its increments. Libindy export of the newest
+/// archive is imported first, then its records are applied. Fails if the newest archive has no libindy
+/// export, since DIDs, keys and credentials created after the older archives would be lost.
+///
+pub fn import_wallet_stream(config: &WalletRestoreConfig, progress: &dyn Fn(&BackupProgress)) -> VcxResult<()> {
+    trace!("import_wallet_stream >>> wallet_name: {}, archive_paths: {:?}", config.wallet_name, config.archive_paths);
+    if get_wallet_handle() != INVALID_WALLET_HANDLE {
+        return Err(VcxError::from_msg(VcxErrorKind::WalletAlreadyOpen, "Wallet backup cannot be imported while a wallet is opened"));
+    }
+
+    let mut newest = None;
+    let mut previous_id = None;
+    for (index, path) in config.archive_paths.iter().enumerate() {
+        let summary = _verify_archive(path, &config.backup_key)?;
+        if index > 0 && summary.base_id != previous_id {
+            return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration, format!("Wallet backup archive {} is not an increment of the preceding one", path)));
+        }
+        previous_id = Some(summary.backup_id.clone());
+        newest = Some((path, summary));
+    }
+    let (snapshot, newest) = newest
+        .ok_or(VcxError::from_msg(VcxErrorKind::InvalidConfiguration, "No wallet backup archive to import"))?;
+    if !newest.has_indy_export {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration,
+                                      format!("Newest wallet backup archive {} does not contain libindy wallet export", snapshot)));
+    }
+    let records_total = newest.records;
+    let indy_export_total = newest.indy_export_len;
+    let mut report = |stage, records_done| {
+        progress(&BackupProgress { stage, records_done, records_total, indy_export_done: indy_export_total, indy_export_total })
+    };
+    let mut report_export = |indy_export_done| {
+        progress(&BackupProgress { stage: BackupStage::IndyExport, records_done: 0, records_total, indy_export_done, indy_export_total })
+    };
+
+    report_export(0);
+    let export_path = format!("{}.indy", snapshot);
+    let wallet_key_derivation = config.wallet_key_derivation.clone().unwrap_or(settings::WALLET_KDF_DEFAULT.into());
+    let imported = _extract_indy_export(snapshot, &config.backup_key, &export_path, &mut report_export)
+        .and_then(|_| import(&RestoreWalletConfigs {
+            wallet_name: config.wallet_name.clone(),
+            wallet_key: config.wallet_key.clone(),
+            exported_wallet_path: export_path.clone(),
+            backup_key: config.backup_key.clone(),
+            wallet_key_derivation: Some(wallet_key_derivation.clone()),
+        }));
+    fs::remove_file(&export_path).ok();
+    imported?;
+
+    open_as_main_wallet(&WalletConfig {
+        wallet_name: config.wallet_name.clone(),
+        wallet_key: config.wallet_key.clone(),
+        wallet_key_derivation,
+        wallet_type: None,
+        storage_config: None,
+        storage_credentials: None,
+        rekey: None,
+        rekey_derivation_method: None,
+    })?;
+    let mut records_done = 0;
+    let applied = _apply_archive(snapshot, &config.backup_key, &mut records_done, &mut report);
+    let closed = close_main_wallet();
+    applied?;
+    closed?;
+
+    report(BackupStage::Finished, records_done);
+    Ok(())
+}
+
+#[cfg(test)]
+pub mod tests {
+    use crate::utils::devsetup::TempFile;
+
+    use super::*;
+
+    fn _record(id: &str, value: &str) -> BackupRecord {
+        let tags = vec![("tag".to_string(), id.to_string())].into_iter().collect();
+        BackupRecord { id: id.to_string(), value: value.to_string(), tags }
+    }
+
+    fn _write_archive(path: &str, chunks: &[Chunk]) -> ArchiveHeader {
+        let (header, key) = _new_header("backup_key", None).unwrap();
+        let mut writer = ArchiveWriter::create(path, &header, key).unwrap();
+        for chunk in chunks {
+            writer.write_chunk(chunk).unwrap();
+        }
+        writer.finish().unwrap();
+        header
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_archive_chunks_roundtrip() {
+        let archive = TempFile::prepare_path("test_archive_chunks_roundtrip.vcxwb");
+        let chunks = vec![
+            Chunk::IndyExport { data: b"indy export".to_vec(), last: true },
+            Chunk::Records { record_type: "type1".to_string(), records: vec![_record("id1", "value1"), _record("id2", "value2")] },
+            Chunk::Deleted { record_type: "type1".to_string(), ids: vec!["id3".to_string()] },
+            Chunk::Manifest { record_type: "type1".to_string(), entries: vec![("id1".to_string(), _record("id1", "value1").digest())] },
+            Chunk::End { records: 2 },
+        ];
+        let header = _write_archive(&archive.path, &chunks);
+
+        let mut reader = ArchiveReader::open(&archive.path, "backup_key").unwrap();
+        assert_eq!(reader.header, header);
+        for chunk in &chunks {
+            assert_eq!(&reader.next_chunk().unwrap().unwrap(), chunk);
+        }
+        assert_eq!(reader.next_chunk().unwrap(), None);
+
+        assert_eq!(ArchiveReader::open(&archive.path, "other_key").err().unwrap().kind(), VcxErrorKind::WalletAccessFailed);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_indy_export_chunk_is_not_compressed() {
+        let (_, key) = _new_header("backup_key", None).unwrap();
+        let export = Chunk::IndyExport { data: vec![0u8; 4096], last: false };
+        let frame = key.seal(0, &export).unwrap();
+        assert_eq!(frame.len(), NONCE_LEN + 2 + 4096 + TAG_LEN);
+        assert_eq!(key.open(0, &frame).unwrap(), export);
+
+        let records = Chunk::Deleted { record_type: "type1".to_string(), ids: vec!["id1".to_string(); 1000] };
+        let frame = key.seal(1, &records).unwrap();
+        assert!(frame.len() < 1000);
+        assert_eq!(key.open(1, &frame).unwrap(), records);
+        assert_eq!(key.open(2, &frame).unwrap_err().kind(), VcxErrorKind::IOError);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_resume_drops_cut_frame() {
+        let archive = TempFile::prepare_path("test_resume_drops_cut_frame.vcxwb");
+        let header = _write_archive(&archive.path, &vec![
+            Chunk::IndyExport { data: b"indy export".to_vec(), last: true },
+            Chunk::Records { record_type: "type1".to_string(), records: vec![_record("id1", "value1")] },
+        ]);
+        let complete_len = fs::metadata(&archive.path).unwrap().len();
+        OpenOptions::new().append(true).open(&archive.path).unwrap().write_all(&[0, 0, 1, 0, 42]).unwrap();
+
+        let config = WalletBackupConfig {
+            path: archive.path.clone(),
+            backup_key: "backup_key".to_string(),
+            record_types: vec!["type1".to_string()],
+            base_path: None,
+            include_indy_export: None,
+            resume: true,
+            page_size: None,
+        };
+        let (mut writer, state) = _resume_writer(&config, None).unwrap();
+        assert!(state.indy_done);
+        assert_eq!(state.records, 1);
+        assert_eq!(state.written["type1"]["id1"], _record("id1", "value1").digest());
+        assert_eq!(fs::metadata(&archive.path).unwrap().len(), complete_len);
+
+        writer.write_chunk(&Chunk::End { records: 1 }).unwrap();
+        writer.finish().unwrap();
+        let summary = _verify_archive(&archive.path, "backup_key").unwrap();
+        assert_eq!(summary.backup_id, header.backup_id);
+        assert!(summary.has_indy_export);
+        assert_eq!(summary.records, 1);
+        assert_eq!(_resume_writer(&config, None).err().unwrap().kind(), VcxErrorKind::InvalidState);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_import_refuses_newest_archive_without_indy_export() {
+        let base = TempFile::prepare_path("test_import_refuses_newest_archive_without_indy_export_base.vcxwb");
+        let increment = TempFile::prepare_path("test_import_refuses_newest_archive_without_indy_export_increment.vcxwb");
+        let header = _write_archive(&base.path, &vec![
+            Chunk::IndyExport { data: b"indy export".to_vec(), last: true },
+            Chunk::End { records: 0 },
+        ]);
+        let (header, key) = _new_header("backup_key", Some(header.backup_id)).unwrap();
+        let mut writer = ArchiveWriter::create(&increment.path, &header, key).unwrap();
+        writer.write_chunk(&Chunk::Records { record_type: "type1".to_string(), records: vec![_record("id1", "value1")] }).unwrap();
+        writer.write_chunk(&Chunk::End { records: 1 }).unwrap();
+        writer.finish().unwrap();
+
+        let config = WalletRestoreConfig {
+            wallet_name: "test_import_refuses_newest_archive_without_indy_export".to_string(),
+            wallet_key: "wallet_key".to_string(),
+            wallet_key_derivation: None,
+            backup_key: "backup_key".to_string(),
+            archive_paths: vec![base.path.clone(), increment.path.clone()],
+        };
+        assert_eq!(import_wallet_stream(&config, &|_| {}).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_record_digest_covers_tags() {
+        let record = _record("id1", "value1");
+        let mut retagged = record.clone();
+        retagged.tags.insert("other".to_string(), "tag".to_string());
+        assert_ne!(record.digest(), retagged.digest());
+        assert_ne!(record.digest(), _record("id1", "value2").digest());
+        assert_eq!(record.digest(), _record("id1", "value1").digest());
+    }
+}
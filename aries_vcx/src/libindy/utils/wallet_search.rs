@@ -0,0 +1,240 @@
+use std::collections::{HashMap, VecDeque};
+
+use indy::SearchHandle;
+
+use crate::error::prelude::*;
+use crate::libindy::utils::wallet::{close_search, fetch_next_records, open_search};
+
+pub const DEFAULT_SEARCH_PAGE_SIZE: usize = 100;
+
+#[derive(Debug, Clone, PartialEq, Serialize, Deserialize)]
+pub struct WalletRecord {
+    pub id: String,
+    #[serde(rename = "type", skip_serializing_if = "Option::is_none")]
+    pub type_: Option<String>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub value: Option<String>,
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub tags: Option<HashMap<String, String>>,
+}
+
+#[derive(Debug, Deserialize)]
+#[serde(rename_all = "camelCase")]
+struct SearchPage {
+    total_count: Option<usize>,
+    records: Option<Vec<WalletRecord>>,
+}
+
+/**
+Parts of records fetched by a search. By default only record ids are fetched. Libindy can only fetch
+all tags of a record, so unless `retrieve_tags` asks for all of them, `tag_names` are picked out of
+them before records are returned.
+ */
+#[derive(Debug, Clone, Default, PartialEq, Serialize, Deserialize)]
+#[serde(rename_all = "camelCase")]
+pub struct SearchProjection {
+    #[serde(default)]
+    pub retrieve_type: bool,
+    #[serde(default)]
+    pub retrieve_value: bool,
+    #[serde(default)]
+    pub retrieve_tags: bool,
+    #[serde(default)]
+    pub tag_names: Option<Vec<String>>,
+}
+
+impl SearchProjection {
+    pub fn ids_only() -> SearchProjection {
+        SearchProjection::default()
+    }
+
+    fn search_options(&self) -> String {
+        json!({
+            "retrieveRecords": true,
+            "retrieveTotalCount": false,
+            "retrieveType": self.retrieve_type,
+            "retrieveValue": self.retrieve_value,
+            "retrieveTags": self.retrieve_tags || self.tag_names.is_some(),
+        }).to_string()
+    }
+
+    fn project(&self, mut record: WalletRecord) -> WalletRecord {
+        if self.retrieve_tags {
+            return record;
+        }
+        if let (Some(tag_names), Some(tags)) = (&self.tag_names, record.tags.as_mut()) {
+            tags.retain(|name, _| tag_names.contains(name));
+        }
+        record
+    }
+}
+
+/**
+Cursor over wallet records matching a query. Records are fetched from the wallet one page at a time,
+so memory use does not depend on number of matches. Underlying wallet search is closed as soon as the
+last page was fetched, or when the cursor is dropped.
+ */
+#[derive(Debug)]
+pub struct WalletSearch {
+    search_handle: Option<SearchHandle>,
+    projection: SearchProjection,
+    page_size: usize,
+    buffered: VecDeque<WalletRecord>,
+}
+
+impl WalletSearch {
+    pub fn open(xtype: &str, query: &str, projection: SearchProjection, page_size: usize) -> VcxResult<WalletSearch> {
+        trace!("WalletSearch::open >>> xtype: {}, query: {}, projection: {:?}, page_size: {}", secret!(xtype), secret!(query), projection, page_size);
+        if page_size == 0 {
+            return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, "Search page size must be positive"));
+        }
+        let search_handle = open_search(xtype, query, &projection.search_options())?;
+        Ok(WalletSearch { search_handle: Some(search_handle), projection, page_size, buffered: VecDeque::new() })
+    }
+
+    pub fn is_finished(&self) -> bool {
+        self.search_handle.is_none() && self.buffered.is_empty()
+    }
+
+    ///
+    /// Returns up to `page_size` following records, empty page once all records were returned.
+    ///
+    pub fn next_page(&mut self) -> VcxResult<Vec<WalletRecord>> {
+        if self.buffered.is_empty() {
+            self._fetch_page()?;
+        }
+        Ok(self.buffered.drain(..).collect())
+    }
+
+    fn _fetch_page(&mut self) -> VcxResult<()> {
+        let search_handle = match self.search_handle {
+            Some(search_handle) => search_handle,
+            None => return Ok(())
+        };
+        let page = fetch_next_records(search_handle, self.page_size)
+            .and_then(|page| _parse_search_page(&page));
+        let records = match page {
+            Ok(page) => page.records.unwrap_or_default(),
+            Err(err) => {
+                self._close();
+                return Err(err);
+            }
+        };
+        if records.len() < self.page_size {
+            self._close();
+        }
+        let projection = &self.projection;
+        self.buffered.extend(records.into_iter().map(|record| projection.project(record)));
+        Ok(())
+    }
+
+    fn _close(&mut self) {
+        if let Some(search_handle) = self.search_handle.take() {
+            if let Err(err) = close_search(search_handle) {
+                warn!("WalletSearch >>> failed to close wallet search {}: {}", search_handle, err);
+            }
+        }
+    }
+}
+
+impl Iterator for WalletSearch {
+    type Item = VcxResult<WalletRecord>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        if self.buffered.is_empty() {
+            if let Err(err) = self._fetch_page() {
+                return Some(Err(err));
+            }
+        }
+        self.buffered.pop_front().map(Ok)
+    }
+}
+
+impl Drop for WalletSearch {
+    fn drop(&mut self) {
+        self._close();
+    }
+}
+
+///
+/// Counts records matching the query without fetching any of them.
+///
+pub fn count_records(xtype: &str, query: &str) -> VcxResult<usize> {
+    trace!("count_records >>> xtype: {}, query: {}", secret!(xtype), secret!(query));
+    let options = json!({"retrieveRecords": false, "retrieveTotalCount": true}).to_string();
+    let search_handle = open_search(xtype, query, &options)?;
+    let page = fetch_next_records(search_handle, 1)
+        .and_then(|page| _parse_search_page(&page));
+    close_search(search_handle)?;
+    Ok(page?.total_count.unwrap_or(0))
+}
+
+fn _parse_search_page(page: &str) -> VcxResult<SearchPage> {
+    serde_json::from_str(page)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot parse wallet search records: {}", err)))
+}
+
+#[cfg(test)]
+pub mod tests {
+    use crate::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_parse_search_page() {
+        let page = _parse_search_page(r#"{"totalCount":null,"records":[{"id":"id1","value":"value1","tags":{"a":"1","b":"2"}}]}"#).unwrap();
+        assert_eq!(page.total_count, None);
+        assert_eq!(page.records.unwrap().len(), 1);
+
+        let page = _parse_search_page(r#"{"totalCount":3,"records":null}"#).unwrap();
+        assert_eq!(page.total_count, Some(3));
+        assert!(page.records.is_none());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_projection_keeps_selected_tags() {
+        let projection = SearchProjection { retrieve_type: false, retrieve_value: false, retrieve_tags: false, tag_names: Some(vec!["a".to_string()]) };
+        let options: serde_json::Value = serde_json::from_str(&projection.search_options()).unwrap();
+        assert_eq!(options["retrieveValue"], json!(false));
+        assert_eq!(options["retrieveTags"], json!(true));
+
+        let tags: HashMap<String, String> = vec![("a", "1"), ("b", "2")].into_iter().map(|(k, v)| (k.to_string(), v.to_string())).collect();
+        let record = projection.project(WalletRecord { id: "id1".to_string(), type_: None, value: None, tags: Some(tags) });
+        assert_eq!(record.tags.unwrap().keys().collect::<Vec<_>>(), vec!["a"]);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_empty_search_finishes() {
+        let _setup = SetupMocks::init();
+
+        let mut search = WalletSearch::open("type1", "{}", SearchProjection::ids_only(), DEFAULT_SEARCH_PAGE_SIZE).unwrap();
+        assert_eq!(search.next_page().unwrap(), vec![]);
+        assert!(search.is_finished());
+        assert!(search.next().is_none());
+        assert_eq!(count_records("type1", "{}").unwrap(), 0);
+    }
+
+    #[cfg(feature = "pool_tests")]
+    #[test]
+    fn test_search_pages_through_records() {
+        use crate::libindy::utils::wallet::add_record;
+        use crate::utils::devsetup::SetupLibraryWallet;
+
+        let _setup = SetupLibraryWallet::init();
+        for i in 0..5 {
+            add_record("search_type", &format!("id{}", i), "value", Some(&json!({"a": "1", "b": "2"}).to_string())).unwrap();
+        }
+
+        assert_eq!(count_records("search_type", "{}").unwrap(), 5);
+
+        let projection = SearchProjection { retrieve_type: false, retrieve_value: false, retrieve_tags: false, tag_names: Some(vec!["b".to_string()]) };
+        let mut search = WalletSearch::open("search_type", "{}", projection, 2).unwrap();
+        assert_eq!(search.next_page().unwrap().len(), 2);
+        let rest: Vec<WalletRecord> = search.map(|record| record.unwrap()).collect();
+        assert_eq!(rest.len(), 3);
+        assert!(rest.iter().all(|record| record.value.is_none() && record.tags.as_ref().unwrap().len() == 1));
+    }
+}
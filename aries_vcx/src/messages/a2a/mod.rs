@@ -321,15 +321,58 @@ impl A2AMessage {
     const OUT_OF_BAND: &'static str = "out-of-band";
 }
 
+/**
+Kinds of messages which can be picked out of downloaded messages by their `@type`, without
+deserializing the messages of other kinds.
+ */
+#[derive(Debug, Clone, Copy, PartialEq)]
+pub enum A2AMessageKind {
+    CredentialOffer,
+    PresentationRequest,
+}
+
+impl A2AMessageKind {
+    pub fn matches(&self, message_type: &MessageType) -> bool {
+        match self {
+            A2AMessageKind::CredentialOffer => message_type.family == MessageFamilies::CredentialIssuance && message_type.msg_type == A2AMessage::CREDENTIAL_OFFER,
+            A2AMessageKind::PresentationRequest => message_type.family == MessageFamilies::PresentProof && message_type.msg_type == A2AMessage::REQUEST_PRESENTATION,
+        }
+    }
+
+    pub fn matches_message(&self, message: &A2AMessage) -> bool {
+        match (self, message) {
+            (A2AMessageKind::CredentialOffer, A2AMessage::CredentialOffer(_)) => true,
+            (A2AMessageKind::PresentationRequest, A2AMessage::PresentationRequest(_)) => true,
+            _ => false
+        }
+    }
+}
+
+#[derive(Deserialize)]
+struct MessageTypeOnly {
+    #[serde(rename = "@type")]
+    type_: MessageType,
+}
+
+impl A2AMessage {
+    /// Reads just `@type` of serialized message, skipping over other fields.
+    pub fn peek_type(message: &str) -> Option<MessageType> {
+        serde_json::from_str::<MessageTypeOnly>(message)
+            .map(|message| message.type_)
+            .ok()
+    }
+}
+
 #[cfg(test)]
 pub mod test_a2a_serialization {
     use serde_json::Value;
 
-    use crate::messages::a2a::{A2AMessage, MessageId};
+    use crate::messages::a2a::{A2AMessage, A2AMessageKind, MessageId};
     use crate::messages::ack::{Ack, AckStatus};
     use crate::messages::connection::request::Request;
     use crate::utils::devsetup::SetupDefaults;
     use crate::messages::forward::Forward;
+    use crate::messages::issuance::credential_offer::test_utils::_credential_offer;
 
     #[test]
     #[cfg(feature = "general_test")]
@@ -457,6 +500,19 @@ pub mod test_a2a_serialization {
             panic!("The message was expected to be deserialized as Connection Request, but was not.")
         }
     }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_peek_type_of_message() {
+        let offer = serde_json::to_string(&_credential_offer().to_a2a_message()).unwrap();
+        let message_type = A2AMessage::peek_type(&offer).unwrap();
+        assert!(A2AMessageKind::CredentialOffer.matches(&message_type));
+        assert!(!A2AMessageKind::PresentationRequest.matches(&message_type));
+        assert!(A2AMessageKind::CredentialOffer.matches_message(&serde_json::from_str(&offer).unwrap()));
+
+        assert!(A2AMessage::peek_type(r#"{"@type": "unknown", "content": "hello"}"#).is_none());
+        assert!(A2AMessage::peek_type("not json").is_none());
+    }
 }
 
 #[macro_export]
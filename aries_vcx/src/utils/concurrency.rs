@@ -0,0 +1,148 @@
+use std::panic::{self, AssertUnwindSafe};
+use std::sync::{Arc, mpsc, Mutex};
+use std::thread;
+
+use crate::error::prelude::*;
+
+pub const DEFAULT_MAX_WORKERS: usize = 8;
+const POOL_THREADS: usize = 16;
+
+type Job = Box<dyn FnOnce() + Send + 'static>;
+
+lazy_static! {
+    static ref WORKER_POOL: Option<Mutex<mpsc::Sender<Job>>> = _start_pool();
+}
+
+/*
+Long-lived threads shared by all concurrent maps, so a batch does not pay for spawning threads. The pool
+only lends helpers: the thread calling map_concurrently processes items itself as well, so a map called
+from within another one (or while the pool is busy) still completes, just with fewer helpers.
+ */
+fn _start_pool() -> Option<Mutex<mpsc::Sender<Job>>> {
+    let (sender, receiver) = mpsc::channel::<Job>();
+    let receiver = Arc::new(Mutex::new(receiver));
+    let mut started = 0;
+    for i in 0..POOL_THREADS {
+        let receiver = receiver.clone();
+        let spawned = thread::Builder::new()
+            .name(format!("vcx-worker-{}", i))
+            .spawn(move || loop {
+                let job = match receiver.lock() {
+                    Ok(receiver) => receiver.recv(),
+                    Err(_) => return
+                };
+                match job {
+                    Ok(job) => if panic::catch_unwind(AssertUnwindSafe(job)).is_err() {
+                        error!("map_concurrently >>> worker task panicked");
+                    },
+                    Err(_) => return
+                }
+            });
+        match spawned {
+            Ok(_) => started += 1,
+            Err(err) => warn!("map_concurrently >>> cannot spawn worker thread: {}", err)
+        }
+    }
+    if started == 0 {
+        return None;
+    }
+    Some(Mutex::new(sender))
+}
+
+fn _submit(job: Job) -> bool {
+    match WORKER_POOL.as_ref() {
+        Some(pool) => pool.lock().map(|sender| sender.send(job).is_ok()).unwrap_or(false),
+        None => false
+    }
+}
+
+// Processes items of the queue until it is empty
+fn _drain<T, R, F: Fn(T) -> R>(queue: &Mutex<Vec<(usize, T)>>, f: &F, sender: &mpsc::Sender<(usize, R)>) {
+    loop {
+        let next = match queue.lock() {
+            Ok(mut queue) => queue.pop(),
+            Err(_) => None
+        };
+        match next {
+            Some((index, item)) => {
+                if sender.send((index, f(item))).is_err() { return; }
+            }
+            None => return
+        }
+    }
+}
+
+/**
+Applies `f` to every item on up to `max_workers` threads of a shared worker pool, including the calling
+thread. Results are returned in the order of input items. Libindy and agency calls block the calling thread
+until completed, so running independent calls from several threads lets them proceed concurrently.
+ */
+pub fn map_concurrently<T, R, F>(items: Vec<T>, max_workers: usize, f: F) -> VcxResult<Vec<R>>
+    where T: Send + 'static, R: Send + 'static, F: Fn(T) -> R + Send + Sync + 'static {
+    let count = items.len();
+    let workers = max_workers.max(1).min(count);
+    if workers <= 1 {
+        return Ok(items.into_iter().map(f).collect());
+    }
+
+    let queue: Arc<Mutex<Vec<(usize, T)>>> = Arc::new(Mutex::new(items.into_iter().enumerate().rev().collect()));
+    let f = Arc::new(f);
+    let (sender, receiver) = mpsc::channel::<(usize, R)>();
+
+    for _ in 1..workers {
+        let queue = queue.clone();
+        let f = f.clone();
+        let sender = sender.clone();
+        if !_submit(Box::new(move || _drain(&queue, f.as_ref(), &sender))) {
+            break;
+        }
+    }
+    _drain(&queue, f.as_ref(), &sender);
+    drop(sender);
+
+    // helpers still queued in the pool find the queue empty, so results are awaited only until all items are done
+    let mut results: Vec<Option<R>> = (0..count).map(|_| None).collect();
+    let mut received = 0;
+    while received < count {
+        match receiver.recv() {
+            Ok((index, result)) => {
+                results[index] = Some(result);
+                received += 1;
+            }
+            Err(_) => break
+        }
+    }
+
+    results.into_iter()
+        .map(|result| result.ok_or(VcxError::from_msg(VcxErrorKind::InvalidState, "Concurrent task did not produce result")))
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_map_concurrently_preserves_order() {
+        let items: Vec<u32> = (0..100).collect();
+        let results = map_concurrently(items, 4, |item| item * 2).unwrap();
+        assert_eq!(results, (0..100).map(|item| item * 2).collect::<Vec<u32>>());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_map_concurrently_handles_empty_input() {
+        let results = map_concurrently(Vec::<u32>::new(), 4, |item| item).unwrap();
+        assert!(results.is_empty());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_nested_map_concurrently_completes() {
+        let results = map_concurrently((0..POOL_THREADS as u32 * 2).collect(), POOL_THREADS, |item| {
+            map_concurrently((0..10).collect(), 4, move |inner: u32| item * inner).unwrap().into_iter().sum::<u32>()
+        }).unwrap();
+        assert_eq!(results, (0..POOL_THREADS as u32 * 2).map(|item| item * 45).collect::<Vec<u32>>());
+    }
+}
@@ -197,6 +197,8 @@ impl SetupPoolConfig {
             genesis_path,
             pool_name: None,
             pool_config: None,
+            open_in_background: None,
+            refresh_interval_secs: None,
         };
 
         SetupPoolConfig { skip_cleanup: false, pool_config }
@@ -1,3 +1,6 @@
+use std::sync::Arc;
+
+use agency_client::metrics;
 use agency_client::mocking::AgencyMockDecrypted;
 
 use crate::error::prelude::*;
@@ -7,6 +10,10 @@ use crate::messages::connection::did_doc::DidDoc;
 use crate::messages::forward::Forward;
 use crate::settings;
 
+lazy_static! {
+    static ref MESSAGE_DESERIALIZE: Arc<metrics::Histogram> = metrics::histogram("message_deserialize");
+}
+
 #[derive(Debug)]
 pub struct EncryptionEnvelope(pub Vec<u8>);
 
@@ -64,6 +71,36 @@ impl EncryptionEnvelope {
         crypto::pack_message(None, &receiver_keys, message.as_bytes())
     }
 
+    ///
+    /// Decrypts the payload, returns serialized A2A message and verkey of its sender if it was authcrypted.
+    ///
+    pub fn decrypt(payload: Vec<u8>) -> VcxResult<(String, Option<String>)> {
+        Self::_unpack_a2a_message(payload)
+    }
+
+    pub fn authenticate(sender_vk: Option<&str>, expected_vk: &str) -> VcxResult<()> {
+        match sender_vk {
+            Some(sender_vk) => {
+                if sender_vk != expected_vk {
+                    error!("auth_unpack  sender_vk != expected_vk.... sender_vk: {}, expected_vk: {}", sender_vk, expected_vk);
+                    return Err(VcxError::from_msg(VcxErrorKind::InvalidJson,
+                                                  format!("Message did not pass authentication check. Expected sender verkey was {}, but actually was {}", expected_vk, sender_vk))
+                    );
+                }
+                Ok(())
+            }
+            None => {
+                error!("auth_unpack  message was authcrypted");
+                Err(VcxError::from_msg(VcxErrorKind::InvalidJson, "Can't authenticate message because it was anoncrypted."))
+            }
+        }
+    }
+
+    pub fn decode(message: &str) -> VcxResult<A2AMessage> {
+        MESSAGE_DESERIALIZE.time(|| serde_json::from_str(message))
+            .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize A2A message: {}", err)))
+    }
+
     fn _unpack_a2a_message(payload: Vec<u8>) -> VcxResult<(String, Option<String>)> {
         trace!("EncryptionEnvelope::_unpack_a2a_message >>> processing payload of {} bytes", payload.len());
 
@@ -90,9 +127,7 @@ impl EncryptionEnvelope {
             let (a2a_message, _sender_vk) = Self::_unpack_a2a_message(payload)?;
             a2a_message
         };
-        let a2a_message = serde_json::from_str(&message)
-            .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize A2A message: {}", err)))?;
-        Ok(a2a_message)
+        Self::decode(&message)
     }
 
     pub fn auth_unpack(payload: Vec<u8>, expected_vk: &str) -> VcxResult<A2AMessage> {
@@ -105,25 +140,10 @@ impl EncryptionEnvelope {
             let (a2a_message, sender_vk) = Self::_unpack_a2a_message(payload)?;
             trace!("anon_unpack >> a2a_msg: {:?}, sender_vk: {:?}", a2a_message, sender_vk);
 
-            match sender_vk {
-                Some(sender_vk) => {
-                    if sender_vk != expected_vk {
-                        error!("auth_unpack  sender_vk != expected_vk.... sender_vk: {}, expected_vk: {}", sender_vk, expected_vk);
-                        return Err(VcxError::from_msg(VcxErrorKind::InvalidJson,
-                                                      format!("Message did not pass authentication check. Expected sender verkey was {}, but actually was {}", expected_vk, sender_vk))
-                        );
-                    }
-                }
-                None => {
-                    error!("auth_unpack  message was authcrypted");
-                    return Err(VcxError::from_msg(VcxErrorKind::InvalidJson, "Can't authenticate message because it was anoncrypted."));
-                }
-            }
+            Self::authenticate(sender_vk.as_deref(), expected_vk)?;
             a2a_message
         };
-        let a2a_message = serde_json::from_str(&message)
-            .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize A2A message: {}", err)))?;
-        Ok(a2a_message)
+        Self::decode(&message)
     }
 }
 
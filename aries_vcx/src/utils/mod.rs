@@ -58,6 +58,8 @@ pub mod validation;
 pub mod serialization;
 pub mod encryption_envelope;
 pub mod filters;
+pub mod concurrency;
+pub mod refill_pool;
 
 pub fn get_temp_dir_path(filename: &str) -> PathBuf {
     let mut path = env::temp_dir();
@@ -0,0 +1,325 @@
+use std::collections::VecDeque;
+use std::sync::{Arc, Mutex};
+use std::thread;
+
+use indy::{INVALID_WALLET_HANDLE, WalletHandle};
+
+use crate::error::prelude::*;
+use crate::libindy::utils::wallet::get_wallet_handle;
+use crate::settings;
+
+#[derive(Debug, Clone, Copy, Serialize, Deserialize, PartialEq)]
+pub struct RefillPoolConfig {
+    pub capacity: usize,
+    pub low_water_mark: usize,
+}
+
+///
+/// Provisions items kept ready in a `RefillPool`.
+///
+pub trait RefillSource: Send + Sync + 'static {
+    type Item: Send + 'static;
+
+    /// Name of the pool used in logs and for the refill thread.
+    fn name(&self) -> &'static str;
+
+    /// Whether the pool is used at all; items are provisioned on demand otherwise.
+    fn enabled(&self) -> bool {
+        !settings::indy_mocks_enabled()
+    }
+
+    fn provision(&self) -> VcxResult<Self::Item>;
+
+    /// Persists newly provisioned item before it is pooled. Items kept in memory only need not override it.
+    fn store(&self, _item: &Self::Item) -> VcxResult<()> {
+        Ok(())
+    }
+
+    /// Loads items stored for the currently opened wallet.
+    fn load_stored(&self) -> VcxResult<Vec<Self::Item>> {
+        Ok(Vec::new())
+    }
+}
+
+/*
+Items provisioned ahead of time by a background thread. Once the pool drops to the low water mark, a
+refill thread tops it up to capacity; while it runs no other refill is started. Items are bound to the
+wallet they were provisioned with, so they are dropped when the main wallet changes, and stored ones are
+loaded from the newly opened wallet. Changing wallet or disabling the pool bumps the generation: a refill
+started before stops at its next step and items it provisions are discarded, so a pool re-enabled while
+the old refill is still running never has two refills filling it.
+ */
+struct PoolState<T> {
+    config: Option<RefillPoolConfig>,
+    items: VecDeque<T>,
+    wallet_handle: WalletHandle,
+    loaded: bool,
+    refilling: bool,
+    generation: u64,
+}
+
+impl<T> Default for PoolState<T> {
+    fn default() -> PoolState<T> {
+        PoolState {
+            config: None,
+            items: VecDeque::new(),
+            wallet_handle: INVALID_WALLET_HANDLE,
+            loaded: false,
+            refilling: false,
+            generation: 0,
+        }
+    }
+}
+
+impl<T> PoolState<T> {
+    fn sync_wallet(&mut self, wallet_handle: WalletHandle) {
+        if self.wallet_handle != wallet_handle {
+            self.items.clear();
+            self.wallet_handle = wallet_handle;
+            self.loaded = false;
+            self.refilling = false;
+            self.generation += 1;
+        }
+    }
+
+    fn needs_refill(&self) -> bool {
+        match self.config {
+            Some(config) => !self.refilling && (!self.loaded || self.items.len() <= config.low_water_mark),
+            None => false
+        }
+    }
+
+    fn missing(&self) -> usize {
+        self.config.map(|config| config.capacity.saturating_sub(self.items.len())).unwrap_or(0)
+    }
+
+    fn push(&mut self, generation: u64, item: T) -> bool {
+        if self.generation != generation || self.config.is_none() {
+            return false;
+        }
+        self.items.push_back(item);
+        true
+    }
+}
+
+pub struct RefillPool<S: RefillSource> {
+    source: Arc<S>,
+    state: Arc<Mutex<PoolState<S::Item>>>,
+}
+
+impl<S: RefillSource> RefillPool<S> {
+    pub fn new(source: S) -> RefillPool<S> {
+        RefillPool {
+            source: Arc::new(source),
+            state: Arc::new(Mutex::new(PoolState::default())),
+        }
+    }
+
+    ///
+    /// Enables the pool, or changes its configuration, and starts filling it.
+    ///
+    pub fn enable(&self, config: RefillPoolConfig) -> VcxResult<()> {
+        trace!("RefillPool::enable >>> pool: {}, config: {:?}", self.source.name(), config);
+        if config.capacity == 0 || config.low_water_mark >= config.capacity {
+            return Err(VcxError::from_msg(VcxErrorKind::InvalidConfiguration,
+                                          format!("Low water mark of {} pool must be lower than its positive capacity: {:?}", self.source.name(), config)));
+        }
+        let mut state = self.state.lock()?;
+        state.sync_wallet(get_wallet_handle());
+        state.config = Some(config);
+        state.items.truncate(config.capacity);
+        self._refill_if_needed(&mut state);
+        Ok(())
+    }
+
+    ///
+    /// Disables the pool and drops its items. Stored items are loaded again once the pool is re-enabled.
+    ///
+    pub fn disable(&self) {
+        if let Ok(mut state) = self.state.lock() {
+            let generation = state.generation + 1;
+            *state = PoolState { generation, ..PoolState::default() };
+        }
+    }
+
+    ///
+    /// Removes an item from the pool, `None` if the pool is disabled or empty.
+    ///
+    pub fn take(&self) -> VcxResult<Option<S::Item>> {
+        if !self.source.enabled() {
+            return Ok(None);
+        }
+        let mut state = self.state.lock()?;
+        state.sync_wallet(get_wallet_handle());
+        let item = state.items.pop_front();
+        self._refill_if_needed(&mut state);
+        Ok(item)
+    }
+
+    pub fn len(&self) -> usize {
+        self.state.lock().map(|state| state.items.len()).unwrap_or(0)
+    }
+
+    fn _refill_if_needed(&self, state: &mut PoolState<S::Item>) {
+        if !state.needs_refill() || !self.source.enabled() {
+            return;
+        }
+        state.refilling = true;
+        let generation = state.generation;
+        let source = self.source.clone();
+        let pool_state = self.state.clone();
+        let spawned = thread::Builder::new()
+            .name(format!("vcx-{}-pool", self.source.name()))
+            .spawn(move || _refill(source, pool_state, generation));
+        if let Err(err) = spawned {
+            warn!("RefillPool >>> could not spawn refill thread of {} pool: {}", self.source.name(), err);
+            state.refilling = false;
+        }
+    }
+}
+
+fn _refill<S: RefillSource>(source: Arc<S>, state: Arc<Mutex<PoolState<S::Item>>>, generation: u64) {
+    let mut loaded = Vec::new();
+    let already_loaded = state.lock().map(|state| state.loaded).unwrap_or(true);
+    if !already_loaded {
+        loaded = source.load_stored().unwrap_or_else(|err| {
+            warn!("RefillPool >>> failed to load stored items of {} pool: {}", source.name(), err);
+            Vec::new()
+        });
+    }
+    match state.lock() {
+        Ok(mut state) if state.generation == generation => {
+            state.items.extend(loaded);
+            state.loaded = true;
+        }
+        _ => return
+    }
+
+    loop {
+        let missing = match state.lock() {
+            Ok(state) if state.generation == generation => state.missing(),
+            _ => return
+        };
+        if missing == 0 {
+            break;
+        }
+        let item = match source.provision().and_then(|item| source.store(&item).map(|_| item)) {
+            Ok(item) => item,
+            Err(err) => {
+                warn!("RefillPool >>> failed to provision item of {} pool: {}", source.name(), err);
+                break;
+            }
+        };
+        let pushed = state.lock().map(|mut state| state.push(generation, item)).unwrap_or(false);
+        if !pushed {
+            return;
+        }
+    }
+
+    if let Ok(mut state) = state.lock() {
+        if state.generation == generation {
+            state.refilling = false;
+        }
+    }
+}
+
+#[cfg(test)]
+pub mod tests {
+    use std::sync::atomic::{AtomicUsize, Ordering};
+    use std::time::{Duration, Instant};
+
+    use super::*;
+
+    #[derive(Default)]
+    struct GatedSource {
+        gate: Mutex<()>,
+        provisioning: AtomicUsize,
+        provisioned: AtomicUsize,
+    }
+
+    impl RefillSource for GatedSource {
+        type Item = usize;
+
+        fn name(&self) -> &'static str {
+            "test"
+        }
+
+        fn enabled(&self) -> bool {
+            true
+        }
+
+        fn provision(&self) -> VcxResult<usize> {
+            self.provisioning.fetch_add(1, Ordering::SeqCst);
+            let _gate = self.gate.lock().unwrap();
+            Ok(self.provisioned.fetch_add(1, Ordering::SeqCst))
+        }
+    }
+
+    fn _wait_until<F: Fn() -> bool>(condition: F) {
+        let started = Instant::now();
+        while !condition() {
+            assert!(started.elapsed() < Duration::from_secs(10), "timed out waiting for refill");
+            thread::sleep(Duration::from_millis(5));
+        }
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_pool_refills_at_low_water_mark() {
+        let mut state: PoolState<&str> = PoolState::default();
+        assert!(!state.needs_refill());
+        assert!(!state.push(state.generation, "item0"));
+
+        state.config = Some(RefillPoolConfig { capacity: 3, low_water_mark: 1 });
+        assert!(state.needs_refill());
+        state.loaded = true;
+        assert_eq!(state.missing(), 3);
+
+        assert!(state.push(state.generation, "item1"));
+        assert!(state.push(state.generation, "item2"));
+        assert!(!state.needs_refill());
+        state.items.pop_front();
+        assert!(state.needs_refill());
+        state.refilling = true;
+        assert!(!state.needs_refill());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_pool_is_discarded_when_wallet_changes() {
+        let mut state: PoolState<&str> = PoolState::default();
+        state.config = Some(RefillPoolConfig { capacity: 3, low_water_mark: 1 });
+        state.sync_wallet(WalletHandle(1));
+        let generation = state.generation;
+        assert!(state.push(generation, "item1"));
+
+        state.sync_wallet(WalletHandle(1));
+        assert_eq!(state.items.len(), 1);
+
+        state.sync_wallet(WalletHandle(2));
+        assert!(state.items.is_empty());
+        assert!(!state.loaded);
+        assert!(!state.push(generation, "item2"));
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_reenabled_pool_is_filled_by_single_refill() {
+        let pool = RefillPool::new(GatedSource::default());
+        let config = RefillPoolConfig { capacity: 1, low_water_mark: 0 };
+        assert_eq!(pool.enable(RefillPoolConfig { capacity: 1, low_water_mark: 1 }).unwrap_err().kind(), VcxErrorKind::InvalidConfiguration);
+
+        let gate = pool.source.gate.lock().unwrap();
+        pool.enable(config).unwrap();
+        _wait_until(|| pool.source.provisioning.load(Ordering::SeqCst) == 1);
+        pool.enable(config).unwrap();
+        pool.disable();
+        pool.enable(config).unwrap();
+        _wait_until(|| pool.source.provisioning.load(Ordering::SeqCst) == 2);
+        drop(gate);
+
+        _wait_until(|| pool.source.provisioned.load(Ordering::SeqCst) == 2 && !pool.state.lock().unwrap().refilling);
+        assert_eq!(pool.len(), 1);
+        assert!(pool.take().unwrap().is_some());
+    }
+}
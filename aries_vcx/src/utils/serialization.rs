@@ -1,4 +1,10 @@
-use crate::error::{VcxErrorKind, VcxResult, VcxResultExt};
+use std::io::{Read, Write};
+
+use flate2::Compression;
+use flate2::read::DeflateDecoder;
+use flate2::write::DeflateEncoder;
+
+use crate::error::{VcxError, VcxErrorKind, VcxResult, VcxResultExt};
 
 #[derive(Debug, Serialize, Deserialize)]
 pub struct ObjectWithVersion<'a, T> {
@@ -27,4 +33,152 @@ impl<'a, 'de, T> ObjectWithVersion<'a, T> where T: ::serde::Serialize + ::serde:
 pub enum SerializableObjectWithState<T, P> {
     #[serde(rename = "1.0")]
     V1 { data: T, state: P, source_id: String },
-}
\ No newline at end of file
+}
+
+/*
+Binary snapshot layout: 4 bytes magic, 1 byte format version, deflated MessagePack encoding of the JSON
+value of the object. Going through the JSON value keeps enum and map representations identical to the
+JSON snapshot, so both formats can be converted into each other without knowing the object type.
+MessagePack alone saves little over JSON, as snapshots mostly consist of keys and nested JSON strings
+which it keeps as they are; deflate is what shrinks their repeated keys and base58 and decimal strings.
+Version 1 snapshots, MessagePack without deflate, are still read.
+ */
+pub const BINARY_SNAPSHOT_MAGIC: &[u8; 4] = b"VCXB";
+pub const BINARY_SNAPSHOT_VERSION: u8 = 2;
+const BINARY_SNAPSHOT_VERSION_UNCOMPRESSED: u8 = 1;
+const BINARY_SNAPSHOT_HEADER_LEN: usize = 5;
+
+pub fn is_binary_snapshot(data: &[u8]) -> bool {
+    data.len() >= BINARY_SNAPSHOT_HEADER_LEN && &data[..4] == BINARY_SNAPSHOT_MAGIC
+}
+
+pub fn to_binary<T: ::serde::Serialize>(object: &T) -> VcxResult<Vec<u8>> {
+    let value = ::serde_json::to_value(object)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize object")?;
+    _value_to_binary(&value)
+}
+
+pub fn from_binary<T: ::serde::de::DeserializeOwned>(data: &[u8]) -> VcxResult<T> {
+    let value = _binary_to_value(data)?;
+    ::serde_json::from_value(value)
+        .to_vcx(VcxErrorKind::InvalidJson, "Cannot deserialize object")
+}
+
+pub fn json_to_binary(json: &str) -> VcxResult<Vec<u8>> {
+    let value: ::serde_json::Value = ::serde_json::from_str(json)
+        .to_vcx(VcxErrorKind::InvalidJson, "Cannot deserialize object")?;
+    _value_to_binary(&value)
+}
+
+pub fn binary_to_json(data: &[u8]) -> VcxResult<String> {
+    let value = _binary_to_value(data)?;
+    ::serde_json::to_string(&value)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize object")
+}
+
+fn _value_to_binary(value: &::serde_json::Value) -> VcxResult<Vec<u8>> {
+    let body = ::rmp_serde::to_vec(value)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot serialize object to binary format")?;
+    let mut header = Vec::with_capacity(BINARY_SNAPSHOT_HEADER_LEN + body.len() / 2);
+    header.extend_from_slice(BINARY_SNAPSHOT_MAGIC);
+    header.push(BINARY_SNAPSHOT_VERSION);
+    let mut encoder = DeflateEncoder::new(header, Compression::fast());
+    encoder.write_all(&body)
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot compress object in binary format")?;
+    encoder.finish()
+        .to_vcx(VcxErrorKind::SerializationError, "Cannot compress object in binary format")
+}
+
+fn _binary_to_value(data: &[u8]) -> VcxResult<::serde_json::Value> {
+    if !is_binary_snapshot(data) {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidJson, "Cannot deserialize object: data is not in binary format"));
+    }
+    let body = &data[BINARY_SNAPSHOT_HEADER_LEN..];
+    let value = match data[4] {
+        BINARY_SNAPSHOT_VERSION => {
+            let mut decompressed = Vec::with_capacity(body.len() * 3);
+            DeflateDecoder::new(body).read_to_end(&mut decompressed)
+                .to_vcx(VcxErrorKind::InvalidJson, "Cannot decompress object in binary format")?;
+            ::rmp_serde::from_slice(&decompressed)
+        }
+        BINARY_SNAPSHOT_VERSION_UNCOMPRESSED => ::rmp_serde::from_slice(body),
+        version => return Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize object: unsupported binary format version {}", version)))
+    };
+    value.to_vcx(VcxErrorKind::InvalidJson, "Cannot deserialize object from binary format")
+}
+
+#[cfg(test)]
+mod tests {
+    use crate::utils::mockdata::mockdata_credex::CREDENTIAL_SM_FINISHED;
+
+    use super::*;
+
+    #[derive(Debug, Clone, Serialize, Deserialize, PartialEq)]
+    struct Snapshot {
+        source_id: String,
+        thread_id: Option<String>,
+        attempts: u32,
+        offer: String,
+    }
+
+    #[derive(Debug, Serialize, Deserialize, PartialEq)]
+    #[serde(tag = "version")]
+    enum Snapshots {
+        #[serde(rename = "2.0")]
+        V3(Snapshot),
+    }
+
+    fn _snapshot() -> Snapshots {
+        Snapshots::V3(Snapshot {
+            source_id: "alice".to_string(),
+            thread_id: None,
+            attempts: 3,
+            offer: json!({"schema_id": "V4SGRU86Z58d6TV7PBUe6f:2:GVT:1.0", "nonce": "123456789"}).to_string(),
+        })
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_binary_roundtrip() {
+        let snapshot = _snapshot();
+        let data = to_binary(&snapshot).unwrap();
+        assert!(is_binary_snapshot(&data));
+        assert_eq!(from_binary::<Snapshots>(&data).unwrap(), snapshot);
+        assert_eq!(from_binary::<Snapshots>(b"{\"version\":\"2.0\"}").unwrap_err().kind(), VcxErrorKind::InvalidJson);
+
+        let mut unsupported = data.clone();
+        unsupported[4] = BINARY_SNAPSHOT_VERSION + 1;
+        assert_eq!(from_binary::<Snapshots>(&unsupported).unwrap_err().kind(), VcxErrorKind::InvalidJson);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cross_format_conversion() {
+        let snapshot = _snapshot();
+        let json = ::serde_json::to_string(&snapshot).unwrap();
+
+        let data = json_to_binary(&json).unwrap();
+        let converted: ::serde_json::Value = ::serde_json::from_str(&binary_to_json(&data).unwrap()).unwrap();
+        assert_eq!(converted, ::serde_json::to_value(&snapshot).unwrap());
+        assert_eq!(from_binary::<Snapshots>(&data).unwrap(), snapshot);
+
+        let converted: Snapshots = ::serde_json::from_str(&binary_to_json(&to_binary(&snapshot).unwrap()).unwrap()).unwrap();
+        assert_eq!(converted, snapshot);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_binary_snapshot_of_credential_is_compact() {
+        let value: ::serde_json::Value = ::serde_json::from_str(CREDENTIAL_SM_FINISHED).unwrap();
+        let json = ::serde_json::to_string(&value).unwrap();
+
+        let data = json_to_binary(&json).unwrap();
+        assert!(data.len() * 2 < json.len(), "binary snapshot takes {} bytes, json {} bytes", data.len(), json.len());
+        assert_eq!(binary_to_json(&data).unwrap(), json);
+
+        let mut uncompressed = BINARY_SNAPSHOT_MAGIC.to_vec();
+        uncompressed.push(BINARY_SNAPSHOT_VERSION_UNCOMPRESSED);
+        uncompressed.extend_from_slice(&::rmp_serde::to_vec(&value).unwrap());
+        assert_eq!(binary_to_json(&uncompressed).unwrap(), json);
+    }
+}
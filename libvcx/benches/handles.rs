@@ -0,0 +1,214 @@
+use std::collections::HashMap;
+use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicBool, AtomicI32, Ordering};
+use std::thread;
+
+use criterion::{BenchmarkId, black_box, Criterion, criterion_group, criterion_main};
+
+use aries_vcx::utils::constants::{REQUESTED_ATTRS, REQUESTED_PREDICATES};
+use aries_vcx::utils::devsetup::SetupMocks;
+use aries_vcx::utils::mockdata::mockdata_connection::CONNECTION_SM_INVITEE_COMPLETED;
+use aries_vcx::utils::mockdata::mockdata_credex::{CREDENTIAL_ISSUER_SM_FINISHED, CREDENTIAL_SM_FINISHED};
+use aries_vcx::utils::mockdata::mockdata_proof::ARIES_PROOF_REQUEST_PRESENTATION;
+use vcx::api_lib::api_handle::{connection, credential, disclosed_proof, issuer_credential, proof};
+use vcx::api_lib::api_handle::object_cache::ObjectCache;
+use vcx::api_lib::utils::callback_registry::CallbackRegistry;
+use vcx::error::VcxResult;
+
+const CACHED_OBJECTS: u32 = 1000;
+
+/*
+Background threads keep working on other entries of the same structure while the measured thread
+accesses its own one, so the numbers include waiting for shared locks.
+ */
+struct Contention {
+    stop: Arc<AtomicBool>,
+    threads: Vec<thread::JoinHandle<()>>,
+}
+
+impl Contention {
+    fn spawn<F: Fn(usize) + Send + Sync + 'static>(threads: usize, work: F) -> Contention {
+        let stop = Arc::new(AtomicBool::new(false));
+        let work = Arc::new(work);
+        let threads = (0..threads).map(|i| {
+            let stop = stop.clone();
+            let work = work.clone();
+            thread::spawn(move || {
+                let mut n = i;
+                while !stop.load(Ordering::Relaxed) {
+                    work(n);
+                    n += 1;
+                }
+            })
+        }).collect();
+        Contention { stop, threads }
+    }
+
+    fn start(cache: &Arc<ObjectCache<u64>>, handles: &Arc<Vec<u32>>, threads: usize) -> Contention {
+        let cache = cache.clone();
+        let handles = handles.clone();
+        Contention::spawn(threads, move |n| {
+            let handle = handles[n % handles.len()];
+            if n % 4 == 0 {
+                cache.get_mut(handle, |obj| { *obj += 1; Ok(()) }).unwrap();
+            } else {
+                cache.get(handle, |obj| Ok(*obj)).unwrap();
+            }
+        })
+    }
+}
+
+impl Drop for Contention {
+    fn drop(&mut self) {
+        self.stop.store(true, Ordering::Relaxed);
+        for thread in self.threads.drain(..) {
+            thread.join().ok();
+        }
+    }
+}
+
+fn bench_object_cache(c: &mut Criterion) {
+    let cache: Arc<ObjectCache<u64>> = Arc::new(ObjectCache::new("bench-cache"));
+    let handles = Arc::new(cache.add_many((0..CACHED_OBJECTS as u64).collect()).unwrap());
+    let handle = handles[0];
+
+    let mut group = c.benchmark_group("object_cache");
+    for threads in [0, 1, 4, 8].iter() {
+        let _contention = Contention::start(&cache, &handles, *threads);
+        group.bench_with_input(BenchmarkId::new("get", threads), threads, |b, _| {
+            b.iter(|| cache.get(black_box(handle), |obj| Ok(*obj)).unwrap())
+        });
+        group.bench_with_input(BenchmarkId::new("get_mut", threads), threads, |b, _| {
+            b.iter(|| cache.get_mut(black_box(handle), |obj| { *obj += 1; Ok(()) }).unwrap())
+        });
+    }
+    group.finish();
+}
+
+type Callback = Box<dyn FnMut(u32) + Send>;
+
+// Single Mutex<HashMap> keyed by a counter, the way pending callbacks were kept before CallbackRegistry
+#[derive(Default)]
+struct CallbackMap {
+    callbacks: Mutex<HashMap<i32, Callback>>,
+    next_handle: AtomicI32,
+}
+
+fn _registry_round_trip(registry: &CallbackRegistry<Callback>) {
+    let handle = registry.insert(Box::new(|_| {})).unwrap();
+    (registry.take(handle).unwrap())(1);
+}
+
+fn _map_round_trip(map: &CallbackMap) {
+    let handle = map.next_handle.fetch_add(1, Ordering::Relaxed);
+    map.callbacks.lock().unwrap().insert(handle, Box::new(|_| {}));
+    let mut callback = map.callbacks.lock().unwrap().remove(&handle).unwrap();
+    callback(1);
+}
+
+fn bench_callback_dispatch(c: &mut Criterion) {
+    let registry: Arc<CallbackRegistry<Callback>> = Arc::new(CallbackRegistry::new());
+    let map: Arc<CallbackMap> = Default::default();
+
+    let mut group = c.benchmark_group("callback_dispatch");
+    for threads in [0, 1, 4, 8].iter() {
+        {
+            let contended = registry.clone();
+            let _contention = Contention::spawn(*threads, move |_| _registry_round_trip(&contended));
+            group.bench_with_input(BenchmarkId::new("registry", threads), threads, |b, _| {
+                b.iter(|| _registry_round_trip(&registry))
+            });
+        }
+        {
+            let contended = map.clone();
+            let _contention = Contention::spawn(*threads, move |_| _map_round_trip(&contended));
+            group.bench_with_input(BenchmarkId::new("mutex_hashmap", threads), threads, |b, _| {
+                b.iter(|| _map_round_trip(&map))
+            });
+        }
+    }
+    group.finish();
+}
+
+fn _round_trip(to_string: fn(u32) -> VcxResult<String>,
+               from_string: fn(&str) -> VcxResult<u32>,
+               release: fn(u32) -> VcxResult<()>,
+               handle: u32) {
+    let serialized = to_string(handle).unwrap();
+    let handle = from_string(&serialized).unwrap();
+    release(handle).unwrap();
+}
+
+fn _binary_round_trip(to_binary: fn(u32) -> VcxResult<Vec<u8>>,
+                      from_binary: fn(&[u8]) -> VcxResult<u32>,
+                      release: fn(u32) -> VcxResult<()>,
+                      handle: u32) {
+    let serialized = to_binary(handle).unwrap();
+    let handle = from_binary(&serialized).unwrap();
+    release(handle).unwrap();
+}
+
+fn bench_serialization(c: &mut Criterion) {
+    let _setup = SetupMocks::init();
+
+    let connection_handle = connection::from_string(CONNECTION_SM_INVITEE_COMPLETED).unwrap();
+    let issuer_credential_handle = issuer_credential::from_string(CREDENTIAL_ISSUER_SM_FINISHED).unwrap();
+    let credential_handle = credential::from_string(CREDENTIAL_SM_FINISHED).unwrap();
+    let proof_handle = proof::create_proof("bench".to_string(),
+                                           REQUESTED_ATTRS.to_string(),
+                                           REQUESTED_PREDICATES.to_string(),
+                                           r#"{"support_revocation":false}"#.to_string(),
+                                           "name".to_string()).unwrap();
+    let disclosed_proof_handle = disclosed_proof::create_proof("bench", ARIES_PROOF_REQUEST_PRESENTATION).unwrap();
+
+    // sizes go next to the timings, so both sides of the binary format trade-off are recorded
+    let sizes = vec![
+        ("connection", connection::to_string(connection_handle).unwrap().len(), connection::to_binary(connection_handle).unwrap().len()),
+        ("issuer_credential", issuer_credential::to_string(issuer_credential_handle).unwrap().len(), issuer_credential::to_binary(issuer_credential_handle).unwrap().len()),
+        ("credential", credential::to_string(credential_handle).unwrap().len(), credential::to_binary(credential_handle).unwrap().len()),
+        ("proof", proof::to_string(proof_handle).unwrap().len(), proof::to_binary(proof_handle).unwrap().len()),
+        ("disclosed_proof", disclosed_proof::to_string(disclosed_proof_handle).unwrap().len(), disclosed_proof::to_binary(disclosed_proof_handle).unwrap().len()),
+    ];
+    for (name, json_len, binary_len) in sizes {
+        println!("snapshot size of {}: json {} bytes, binary {} bytes", name, json_len, binary_len);
+    }
+
+    let mut group = c.benchmark_group("serialize_deserialize");
+    group.bench_function("connection", |b| {
+        b.iter(|| _round_trip(connection::to_string, connection::from_string, connection::release, connection_handle))
+    });
+    group.bench_function("issuer_credential", |b| {
+        b.iter(|| _round_trip(issuer_credential::to_string, issuer_credential::from_string, issuer_credential::release, issuer_credential_handle))
+    });
+    group.bench_function("credential", |b| {
+        b.iter(|| _round_trip(credential::to_string, credential::from_string, credential::release, credential_handle))
+    });
+    group.bench_function("proof", |b| {
+        b.iter(|| _round_trip(proof::to_string, proof::from_string, proof::release, proof_handle))
+    });
+    group.bench_function("disclosed_proof", |b| {
+        b.iter(|| _round_trip(disclosed_proof::to_string, disclosed_proof::from_string, disclosed_proof::release, disclosed_proof_handle))
+    });
+    group.finish();
+
+    let mut group = c.benchmark_group("serialize_deserialize_binary");
+    group.bench_function("connection", |b| {
+        b.iter(|| _binary_round_trip(connection::to_binary, connection::from_binary, connection::release, connection_handle))
+    });
+    group.bench_function("issuer_credential", |b| {
+        b.iter(|| _binary_round_trip(issuer_credential::to_binary, issuer_credential::from_binary, issuer_credential::release, issuer_credential_handle))
+    });
+    group.bench_function("credential", |b| {
+        b.iter(|| _binary_round_trip(credential::to_binary, credential::from_binary, credential::release, credential_handle))
+    });
+    group.bench_function("proof", |b| {
+        b.iter(|| _binary_round_trip(proof::to_binary, proof::from_binary, proof::release, proof_handle))
+    });
+    group.bench_function("disclosed_proof", |b| {
+        b.iter(|| _binary_round_trip(disclosed_proof::to_binary, disclosed_proof::from_binary, disclosed_proof::release, disclosed_proof_handle))
+    });
+    group.finish();
+}
+
+criterion_group!(benches, bench_object_cache, bench_callback_dispatch, bench_serialization);
+criterion_main!(benches);
@@ -533,6 +533,150 @@ pub extern fn vcx_connection_deserialize(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Takes an array of json strings representing connections and recreates all of them at once.
+/// Objects are parsed in parallel and stored with a single update of the object cache, which makes it
+/// preferable over repeated `vcx_connection_deserialize` calls when restoring many objects.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data: array of json strings, each is an output of `vcx_connection_serialize` function.
+///
+/// count: number of items in data array
+///
+/// cb: Callback that provides array of handles in the order of data items and provides error status.
+///     If any item cannot be deserialized, error is returned and no object is created.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_connection_deserialize_many(command_handle: CommandHandle,
+                                              data: *const *const c_char,
+                                              count: u32,
+                                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handles: *const u32, count: u32)>) -> u32 {
+    info!("vcx_connection_deserialize_many >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str_array!(data, count, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_connection_deserialize_many(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        match connection::from_strings(data) {
+            Ok(handles) => {
+                trace!("vcx_connection_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, error::SUCCESS.message, handles.len());
+                cb(command_handle, error::SUCCESS.code_num, handles.as_ptr(), handles.len() as u32);
+            }
+            Err(x) => {
+                error!("vcx_connection_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, x, 0);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes the connection object and returns its compact binary representation.
+/// Binary representation holds the same data as output of `vcx_connection_serialize`, they can be converted
+/// into each other by `vcx_serialized_json_to_binary` and `vcx_serialized_binary_to_json`.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// connection_handle: Connection handle that identifies pairwise connection
+///
+/// cb: Callback that provides binary representation of the connection object and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_connection_serialize_binary(command_handle: CommandHandle,
+                                              connection_handle: u32,
+                                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, data_raw: *const u8, data_len: u32)>) -> u32 {
+    info!("vcx_connection_serialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    if !connection::is_valid_handle(connection_handle) {
+        return VcxError::from(VcxErrorKind::InvalidConnectionHandle).into();
+    }
+
+    let source_id = connection::get_source_id(connection_handle).unwrap_or_default();
+    trace!("vcx_connection_serialize_binary(command_handle: {}, connection_handle: {}) source_id: {}",
+           command_handle, connection_handle, source_id);
+
+    execute(move || {
+        match connection::to_binary(connection_handle) {
+            Ok(x) => {
+                trace!("vcx_connection_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x.len(), source_id);
+                let (data_raw, data_len) = utils::cstring::vec_to_pointer(&x);
+                cb(command_handle, error::SUCCESS.code_num, data_raw, data_len);
+            }
+            Err(x) => {
+                error!("vcx_connection_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, x, 0, source_id);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes binary representation of a connection object and recreates the object
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data_raw: binary representation of a connection object. Is an output of `vcx_connection_serialize_binary` function.
+///
+/// data_len: length of data buffer
+///
+/// cb: Callback that provides connection handle and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_connection_deserialize_binary(command_handle: CommandHandle,
+                                                data_raw: *const u8,
+                                                data_len: u32,
+                                                cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handle: u32)>) -> u32 {
+    info!("vcx_connection_deserialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(data_raw, data_len, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_connection_deserialize_binary(command_handle: {}, data_len: {})",
+           command_handle, data_len);
+
+    execute(move || {
+        match connection::from_binary(&data_raw) {
+            Ok(x) => {
+                trace!("vcx_connection_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x, connection::get_source_id(x).unwrap_or_default());
+                cb(command_handle, error::SUCCESS.code_num, x);
+            }
+            Err(x) => {
+                error!("vcx_connection_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, x, 0, "");
+                cb(command_handle, x.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Query the agency for the received messages.
 /// Checks for any messages changing state in the connection and updates the state attribute.
 ///
@@ -7,7 +7,8 @@ use aries_vcx::utils::error;
 
 use crate::api_lib::api_handle::connection;
 use crate::api_lib::api_handle::credential;
-use crate::api_lib::utils::cstring::CStringUtils;
+use crate::api_lib::utils::cstring::{CStringUtils, vec_to_pointer};
+use crate::api_lib::api_c::return_batch_results;
 use crate::api_lib::utils::runtime::execute;
 use crate::error::prelude::*;
 
@@ -595,6 +596,50 @@ pub extern fn vcx_credential_send_request(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Approves several credential offers at once and submits credential requests, each to its own connection.
+/// Credential definitions referenced by the offers are fetched once for the whole batch and requests
+/// are created in parallel, which makes it preferable over repeated `vcx_credential_send_request` calls.
+/// Unlike `vcx_credential_send_request`, which only reports success, the callback provides the state every
+/// credential is left in. A credential handle repeated in the batch fails for every occurrence after the first.
+///
+/// #params
+/// command_handle: command handle to map callback to user context
+///
+/// credential_handles: array of credential handles that were provided during creation
+///
+/// connection_handles: array of connection handles, request for i-th credential is sent over i-th connection
+///
+/// count: number of items in both arrays
+///
+/// cb: Callback that provides error status of the batch and arrays of error codes and states of credentials
+///     in the order of input handles. State is 0 for credentials which failed.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credential_send_requests(command_handle: CommandHandle,
+                                           credential_handles: *const u32,
+                                           connection_handles: *const u32,
+                                           count: u32,
+                                           cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, errors: *const u32, states: *const u32, count: u32)>) -> u32 {
+    info!("vcx_credential_send_requests >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(credential_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(connection_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_credential_send_requests(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        let handles = credential_handles.into_iter().zip(connection_handles.into_iter()).collect();
+        return_batch_results("vcx_credential_send_requests_cb", command_handle, credential::send_credential_requests(handles), cb);
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Approves the credential offer and gets the credential request message that can be sent to the specified connection
 ///
 /// #params
@@ -833,6 +878,49 @@ pub extern fn vcx_v2_credential_update_state_with_message(command_handle: Comman
     error::SUCCESS.code_num
 }
 
+/// Updates state of several credentials at once, checking the given connections for messages in parallel.
+/// Received credentials are stored sharing revocation registry definitions fetched once for the whole batch,
+/// which makes it preferable over repeated `vcx_v2_credential_update_state` calls.
+/// A credential handle repeated in the batch fails for every occurrence after the first.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// credential_handles: array of credential handles that were provided during creation
+///
+/// connection_handles: array of connection handles, i-th credential is updated from i-th connection
+///
+/// count: number of items in both arrays
+///
+/// cb: Callback that provides error status of the batch and arrays of error codes and states of credentials
+///     in the order of input handles. State is 0 for credentials which failed.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_v2_credential_update_states(command_handle: CommandHandle,
+                                              credential_handles: *const u32,
+                                              connection_handles: *const u32,
+                                              count: u32,
+                                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, errors: *const u32, states: *const u32, count: u32)>) -> u32 {
+    info!("vcx_v2_credential_update_states >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(credential_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(connection_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_v2_credential_update_states(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        let handles = credential_handles.into_iter().zip(connection_handles.into_iter()).collect();
+        return_batch_results("vcx_v2_credential_update_states_cb", command_handle, credential::update_states(handles), cb);
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Get the current state of the credential object
 ///
 /// #Params
@@ -977,6 +1065,150 @@ pub extern fn vcx_credential_deserialize(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Takes an array of json strings representing credentials and recreates all of them at once.
+/// Objects are parsed in parallel and stored with a single update of the object cache, which makes it
+/// preferable over repeated `vcx_credential_deserialize` calls when restoring many objects.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data: array of json strings, each is an output of `vcx_credential_serialize` function.
+///
+/// count: number of items in data array
+///
+/// cb: Callback that provides array of handles in the order of data items and provides error status.
+///     If any item cannot be deserialized, error is returned and no object is created.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credential_deserialize_many(command_handle: CommandHandle,
+                                              data: *const *const c_char,
+                                              count: u32,
+                                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handles: *const u32, count: u32)>) -> u32 {
+    info!("vcx_credential_deserialize_many >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str_array!(data, count, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_credential_deserialize_many(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        match credential::from_strings(data) {
+            Ok(handles) => {
+                trace!("vcx_credential_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, error::SUCCESS.message, handles.len());
+                cb(command_handle, error::SUCCESS.code_num, handles.as_ptr(), handles.len() as u32);
+            }
+            Err(x) => {
+                error!("vcx_credential_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, x, 0);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes the credential object and returns its compact binary representation.
+/// Binary representation holds the same data as output of `vcx_credential_serialize`, they can be converted
+/// into each other by `vcx_serialized_json_to_binary` and `vcx_serialized_binary_to_json`.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// handle: Credential handle that was provided during creation. Used to identify credential object
+///
+/// cb: Callback that provides binary representation of the credential object and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credential_serialize_binary(command_handle: CommandHandle,
+                                              handle: u32,
+                                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, data_raw: *const u8, data_len: u32)>) -> u32 {
+    info!("vcx_credential_serialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    if !credential::is_valid_handle(handle) {
+        return VcxError::from(VcxErrorKind::InvalidCredentialHandle).into();
+    }
+
+    let source_id = credential::get_source_id(handle).unwrap_or_default();
+    trace!("vcx_credential_serialize_binary(command_handle: {}, handle: {}) source_id: {}",
+           command_handle, handle, source_id);
+
+    execute(move || {
+        match credential::to_binary(handle) {
+            Ok(x) => {
+                trace!("vcx_credential_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x.len(), source_id);
+                let (data_raw, data_len) = vec_to_pointer(&x);
+                cb(command_handle, error::SUCCESS.code_num, data_raw, data_len);
+            }
+            Err(x) => {
+                error!("vcx_credential_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, x, 0, source_id);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes binary representation of a credential object and recreates the object
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data_raw: binary representation of a credential object. Is an output of `vcx_credential_serialize_binary` function.
+///
+/// data_len: length of data buffer
+///
+/// cb: Callback that provides credential handle and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credential_deserialize_binary(command_handle: CommandHandle,
+                                                data_raw: *const u8,
+                                                data_len: u32,
+                                                cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handle: u32)>) -> u32 {
+    info!("vcx_credential_deserialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(data_raw, data_len, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_credential_deserialize_binary(command_handle: {}, data_len: {})",
+           command_handle, data_len);
+
+    execute(move || {
+        match credential::from_binary(&data_raw) {
+            Ok(x) => {
+                trace!("vcx_credential_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x, credential::get_source_id(x).unwrap_or_default());
+                cb(command_handle, error::SUCCESS.code_num, x);
+            }
+            Err(x) => {
+                error!("vcx_credential_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, x, 0, "");
+                cb(command_handle, x.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Releases the credential object by de-allocating memory
 ///
 /// #Params
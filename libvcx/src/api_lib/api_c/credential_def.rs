@@ -2,6 +2,7 @@ use std::ptr;
 
 use libc::c_char;
 
+use aries_vcx::handlers::issuance::issuer::offer_pool::OfferPoolConfig;
 use aries_vcx::indy_sys::CommandHandle;
 use aries_vcx::settings;
 use aries_vcx::utils::error;
@@ -272,6 +273,73 @@ pub extern fn vcx_credentialdef_release(credentialdef_handle: u32) -> u32 {
     }
 }
 
+/// Keeps credential offers for the credential definition created in background, so issuers sending
+/// offers do not wait for them to be created. Each pre-created offer is sent just once.
+///
+/// #Params
+/// credentialdef_handle: handle pointing to created CredentialDef object
+///
+/// config: Pool configuration
+/// {
+///     "capacity" - number of offers kept ready
+///     "low_water_mark" - number of offers left at which pool gets refilled, lower than capacity
+/// }
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credentialdef_enable_offer_pool(credentialdef_handle: u32, config: *const c_char) -> u32 {
+    info!("vcx_credentialdef_enable_offer_pool >>>");
+
+    check_useful_c_str!(config, VcxErrorKind::InvalidOption);
+
+    let source_id = credential_def::get_source_id(credentialdef_handle).unwrap_or_default();
+    trace!("vcx_credentialdef_enable_offer_pool(credentialdef_handle: {}, config: {}) source_id: {}",
+           credentialdef_handle, config, source_id);
+
+    let pool_config = match serde_json::from_str::<OfferPoolConfig>(&config) {
+        Ok(pool_config) => pool_config,
+        Err(err) => {
+            error!("vcx_credentialdef_enable_offer_pool >>> invalid configuration, err: {:?}", err);
+            return error::INVALID_CONFIGURATION.code_num;
+        }
+    };
+
+    match credential_def::enable_offer_pool(credentialdef_handle, pool_config) {
+        Ok(()) => error::SUCCESS.code_num,
+        Err(err) => {
+            error!("vcx_credentialdef_enable_offer_pool(credentialdef_handle: {}, rc: {}), source_id: {}",
+                   credentialdef_handle, err, source_id);
+            err.into()
+        }
+    }
+}
+
+/// Stops keeping credential offers for the credential definition and drops the pre-created ones.
+/// Offers are then created when they are sent, as if the pool was never enabled.
+///
+/// #Params
+/// credentialdef_handle: handle pointing to created CredentialDef object
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_credentialdef_disable_offer_pool(credentialdef_handle: u32) -> u32 {
+    info!("vcx_credentialdef_disable_offer_pool >>>");
+
+    let source_id = credential_def::get_source_id(credentialdef_handle).unwrap_or_default();
+    trace!("vcx_credentialdef_disable_offer_pool(credentialdef_handle: {}) source_id: {}", credentialdef_handle, source_id);
+
+    match credential_def::disable_offer_pool(credentialdef_handle) {
+        Ok(()) => error::SUCCESS.code_num,
+        Err(err) => {
+            error!("vcx_credentialdef_disable_offer_pool(credentialdef_handle: {}, rc: {}), source_id: {}",
+                   credentialdef_handle, err, source_id);
+            err.into()
+        }
+    }
+}
+
 /// Checks if credential definition is published on the Ledger and updates the state if it is.
 ///
 /// #Params
@@ -661,6 +729,32 @@ mod tests {
         cb.receive(TimeoutUtils::some_medium()).unwrap();
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_vcx_credentialdef_enable_offer_pool() {
+        let _setup = SetupMocks::init();
+
+        let cb = return_types_u32::Return_U32_U32::new().unwrap();
+        assert_eq!(vcx_credentialdef_create(cb.command_handle,
+                                            CString::new("Test Source ID").unwrap().into_raw(),
+                                            CString::new("Test Credential Def").unwrap().into_raw(),
+                                            CString::new(SCHEMA_ID).unwrap().into_raw(),
+                                            CString::new("6vkhW3L28AophhA68SSzRS").unwrap().into_raw(),
+                                            CString::new("tag").unwrap().into_raw(),
+                                            CString::new("{}").unwrap().into_raw(),
+                                            0,
+                                            Some(cb.get_callback())), error::SUCCESS.code_num);
+        let handle = cb.receive(TimeoutUtils::some_medium()).unwrap();
+
+        assert_eq!(vcx_credentialdef_enable_offer_pool(handle, CString::new("{}").unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_credentialdef_enable_offer_pool(handle, CString::new(r#"{"capacity": 3, "low_water_mark": 3}"#).unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_credentialdef_enable_offer_pool(handle, CString::new(r#"{"capacity": 5, "low_water_mark": 2}"#).unwrap().into_raw()), error::SUCCESS.code_num);
+        assert_eq!(vcx_credentialdef_enable_offer_pool(0, CString::new(r#"{"capacity": 5, "low_water_mark": 2}"#).unwrap().into_raw()), error::INVALID_CREDENTIAL_DEF_HANDLE.code_num);
+
+        assert_eq!(vcx_credentialdef_disable_offer_pool(handle), error::SUCCESS.code_num);
+        assert_eq!(vcx_credentialdef_disable_offer_pool(0), error::INVALID_CREDENTIAL_DEF_HANDLE.code_num);
+    }
+
     // TODO: Update to not use prepare_credentialdef_for_endorser if possible
     #[test]
     #[cfg(feature = "to_restore")]
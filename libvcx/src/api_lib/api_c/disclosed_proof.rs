@@ -7,7 +7,7 @@ use aries_vcx::utils::error;
 
 use crate::api_lib::api_handle::connection;
 use crate::api_lib::api_handle::disclosed_proof;
-use crate::api_lib::utils::cstring::CStringUtils;
+use crate::api_lib::utils::cstring::{CStringUtils, vec_to_pointer};
 use crate::api_lib::utils::runtime::execute;
 use crate::error::prelude::*;
 
@@ -681,6 +681,150 @@ pub extern fn vcx_disclosed_proof_deserialize(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Takes an array of json strings representing disclosed proofs and recreates all of them at once.
+/// Objects are parsed in parallel and stored with a single update of the object cache, which makes it
+/// preferable over repeated `vcx_disclosed_proof_deserialize` calls when restoring many objects.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data: array of json strings, each is an output of `vcx_disclosed_proof_serialize` function.
+///
+/// count: number of items in data array
+///
+/// cb: Callback that provides array of handles in the order of data items and provides error status.
+///     If any item cannot be deserialized, error is returned and no object is created.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_disclosed_proof_deserialize_many(command_handle: CommandHandle,
+                                                   data: *const *const c_char,
+                                                   count: u32,
+                                                   cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handles: *const u32, count: u32)>) -> u32 {
+    info!("vcx_disclosed_proof_deserialize_many >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str_array!(data, count, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_disclosed_proof_deserialize_many(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        match disclosed_proof::from_strings(data) {
+            Ok(handles) => {
+                trace!("vcx_disclosed_proof_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, error::SUCCESS.message, handles.len());
+                cb(command_handle, error::SUCCESS.code_num, handles.as_ptr(), handles.len() as u32);
+            }
+            Err(x) => {
+                error!("vcx_disclosed_proof_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, x, 0);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes the disclosed proof object and returns its compact binary representation.
+/// Binary representation holds the same data as output of `vcx_disclosed_proof_serialize`, they can be converted
+/// into each other by `vcx_serialized_json_to_binary` and `vcx_serialized_binary_to_json`.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// proof_handle: Proof handle that was provided during creation. Used to identify the disclosed proof object
+///
+/// cb: Callback that provides binary representation of the disclosed proof object and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_disclosed_proof_serialize_binary(command_handle: CommandHandle,
+                                                   proof_handle: u32,
+                                                   cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, data_raw: *const u8, data_len: u32)>) -> u32 {
+    info!("vcx_disclosed_proof_serialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    if !disclosed_proof::is_valid_handle(proof_handle) {
+        return VcxError::from(VcxErrorKind::InvalidDisclosedProofHandle).into();
+    }
+
+    let source_id = disclosed_proof::get_source_id(proof_handle).unwrap_or_default();
+    trace!("vcx_disclosed_proof_serialize_binary(command_handle: {}, proof_handle: {}) source_id: {}",
+           command_handle, proof_handle, source_id);
+
+    execute(move || {
+        match disclosed_proof::to_binary(proof_handle) {
+            Ok(x) => {
+                trace!("vcx_disclosed_proof_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x.len(), source_id);
+                let (data_raw, data_len) = vec_to_pointer(&x);
+                cb(command_handle, error::SUCCESS.code_num, data_raw, data_len);
+            }
+            Err(x) => {
+                error!("vcx_disclosed_proof_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, x, 0, source_id);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes binary representation of a disclosed proof object and recreates the object
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data_raw: binary representation of a disclosed proof object. Is an output of `vcx_disclosed_proof_serialize_binary` function.
+///
+/// data_len: length of data buffer
+///
+/// cb: Callback that provides disclosed proof handle and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_disclosed_proof_deserialize_binary(command_handle: CommandHandle,
+                                                     data_raw: *const u8,
+                                                     data_len: u32,
+                                                     cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handle: u32)>) -> u32 {
+    info!("vcx_disclosed_proof_deserialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(data_raw, data_len, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_disclosed_proof_deserialize_binary(command_handle: {}, data_len: {})",
+           command_handle, data_len);
+
+    execute(move || {
+        match disclosed_proof::from_binary(&data_raw) {
+            Ok(x) => {
+                trace!("vcx_disclosed_proof_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x, disclosed_proof::get_source_id(x).unwrap_or_default());
+                cb(command_handle, error::SUCCESS.code_num, x);
+            }
+            Err(x) => {
+                error!("vcx_disclosed_proof_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, x, 0, "");
+                cb(command_handle, x.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Get credentials from wallet matching to the proof request associated with proof object
 ///
 /// #Params
@@ -3,7 +3,7 @@ use libc::c_char;
 use aries_vcx::utils::error::SUCCESS;
 
 use crate::api_lib::utils::cstring::CStringUtils;
-use crate::api_lib::utils::logger::{CVoid, EnabledCB, FlushCB, LibvcxDefaultLogger, LibvcxLogger, LogCB, LOGGER_STATE};
+use crate::api_lib::utils::logger::{CVoid, EnabledCB, FlushCB, LibvcxBatchLogger, LibvcxDefaultLogger, LibvcxLogger, LogBatchCB, LogCB, LOGGER_STATE};
 use crate::error::prelude::*;
 
 /// Set default logger implementation.
@@ -74,6 +74,47 @@ pub extern fn vcx_set_logger(context: *const CVoid,
     }
 }
 
+/// Set custom logger implementation receiving log records asynchronously in batches.
+///
+/// Records are formatted only if their level passes `max_level`, buffered and passed to `log_batch`
+/// from a dedicated thread, so logging does not block threads running libvcx operations.
+/// When the buffer is full new records are dropped; their count is passed with the next batch.
+///
+/// #Params
+/// context: pointer to some logger context that will be available in logger handlers.
+/// max_level: most verbose level to be logged (1 - error, 2 - warn, 3 - info, 4 - debug, 5 - trace).
+/// log_batch: "log" operation handler - called with array of `count` records and number of records dropped since previous call.
+///     Record pointers are valid only during the handler call.
+/// flush: (optional) "flush" operation handler - called after buffered records were passed to `log_batch` on flush.
+/// buffer_size: maximum number of buffered records, 0 for default (8192).
+///
+/// #Returns
+/// u32 Error Code
+#[no_mangle]
+pub extern fn vcx_set_batch_logger(context: *const CVoid,
+                                   max_level: u32,
+                                   log_batch: Option<LogBatchCB>,
+                                   flush: Option<FlushCB>,
+                                   buffer_size: u32) -> u32 {
+    info!("vcx_set_batch_logger >>>");
+
+    trace!("vcx_set_batch_logger( context: {:?}, max_level: {:?}, log_batch: {:?}, flush: {:?}, buffer_size: {:?}",
+           context, max_level, log_batch, flush, buffer_size);
+    check_useful_c_callback!(log_batch, VcxErrorKind::InvalidOption);
+
+    let res = LibvcxBatchLogger::init(context, max_level, log_batch, flush, buffer_size as usize);
+    match res {
+        Ok(()) => {
+            debug!("Logger Successfully Initialized");
+            SUCCESS.code_num
+        }
+        Err(ec) => {
+            error!("Logger Failed To Initialize: {}", ec);
+            ec.into()
+        }
+    }
+}
+
 /// Get the currently used logger.
 ///
 /// NOTE: if logger is not set dummy implementation would be returned.
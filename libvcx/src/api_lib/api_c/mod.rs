@@ -12,3 +12,36 @@ pub mod wallet;
 pub mod agent;
 pub mod out_of_band;
 mod filters;
+
+use std::ptr;
+
+use aries_vcx::indy_sys::CommandHandle;
+use aries_vcx::utils::error;
+
+use crate::error::prelude::*;
+
+/**
+Reports per-object results of a batch operation: error codes and states in the order of input handles,
+state is 0 for objects which failed.
+ */
+pub fn return_batch_results(name: &str,
+                            command_handle: CommandHandle,
+                            results: VcxResult<Vec<VcxResult<u32>>>,
+                            cb: extern fn(xcommand_handle: CommandHandle, err: u32, errors: *const u32, states: *const u32, count: u32)) {
+    match results {
+        Ok(results) => {
+            let (errors, states): (Vec<u32>, Vec<u32>) = results.into_iter()
+                .map(|result| match result {
+                    Ok(state) => (error::SUCCESS.code_num, state),
+                    Err(err) => (err.into(), 0)
+                })
+                .unzip();
+            trace!("{}(command_handle: {}, rc: {}, count: {})", name, command_handle, error::SUCCESS.message, states.len());
+            cb(command_handle, error::SUCCESS.code_num, errors.as_ptr(), states.as_ptr(), states.len() as u32);
+        }
+        Err(err) => {
+            error!("{}(command_handle: {}, rc: {}, count: {})", name, command_handle, err, 0);
+            cb(command_handle, err.into(), ptr::null(), ptr::null(), 0);
+        }
+    }
+}
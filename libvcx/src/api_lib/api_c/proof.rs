@@ -7,7 +7,8 @@ use aries_vcx::utils::error;
 
 use crate::api_lib::api_handle::connection;
 use crate::api_lib::api_handle::proof;
-use crate::api_lib::utils::cstring::CStringUtils;
+use crate::api_lib::utils::cstring::{CStringUtils, vec_to_pointer};
+use crate::api_lib::api_c::return_batch_results;
 use crate::api_lib::utils::runtime::execute;
 use crate::error::prelude::*;
 
@@ -155,6 +156,137 @@ pub extern fn vcx_proof_create(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Compiles a proof request template. Requested attributes, predicates and revocation interval are
+/// parsed and validated once, proofs are then created from the template by `vcx_proof_create_from_template`
+/// with only a fresh nonce generated, which makes it preferable over `vcx_proof_create` when the same
+/// proof request is sent repeatedly.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// requested_attrs: attributes prover must provide proof for, same as in `vcx_proof_create`
+///
+/// requested_predicates: predicate specifications prover must provide claim for, same as in `vcx_proof_create`
+///
+/// revocation_interval: Optional<<revocation_interval>>, same as in `vcx_proof_create`
+///
+/// name: Name of the proof request - ex. Drivers Licence.
+///
+/// cb: Callback that provides template handle and error status of request.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_proof_template_create(command_handle: CommandHandle,
+                                        requested_attrs: *const c_char,
+                                        requested_predicates: *const c_char,
+                                        revocation_interval: *const c_char,
+                                        name: *const c_char,
+                                        cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, template_handle: u32)>) -> u32 {
+    info!("vcx_proof_template_create >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(requested_attrs, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(requested_predicates, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(name, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(revocation_interval, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_proof_template_create(command_handle: {}, requested_attrs: {}, requested_predicates: {}, revocation_interval: {}, name: {})",
+           command_handle, requested_attrs, requested_predicates, revocation_interval, name);
+
+    execute(move || {
+        let (rc, handle) = match proof::create_proof_template(requested_attrs, requested_predicates, revocation_interval, name) {
+            Ok(x) => {
+                trace!("vcx_proof_template_create_cb(command_handle: {}, rc: {}, handle: {})",
+                       command_handle, error::SUCCESS.message, x);
+                (error::SUCCESS.code_num, x)
+            }
+            Err(x) => {
+                warn!("vcx_proof_template_create_cb(command_handle: {}, rc: {}, handle: {})",
+                      command_handle, x, 0);
+                (x.into(), 0)
+            }
+        };
+        cb(command_handle, rc, handle);
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Create a new Proof object from compiled proof request template.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// source_id: Enterprise's personal identification for the proof, should be unique.
+///
+/// template_handle: Template handle that was provided by `vcx_proof_template_create`
+///
+/// cb: Callback that provides proof handle and error status of request.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_proof_create_from_template(command_handle: CommandHandle,
+                                             source_id: *const c_char,
+                                             template_handle: u32,
+                                             cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, proof_handle: u32)>) -> u32 {
+    info!("vcx_proof_create_from_template >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(source_id, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_proof_create_from_template(command_handle: {}, source_id: {}, template_handle: {})",
+           command_handle, source_id, template_handle);
+
+    execute(move || {
+        let (rc, handle) = match proof::create_proof_from_template(source_id.clone(), template_handle) {
+            Ok(x) => {
+                trace!("vcx_proof_create_from_template_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x, source_id);
+                (error::SUCCESS.code_num, x)
+            }
+            Err(x) => {
+                warn!("vcx_proof_create_from_template_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                      command_handle, x, 0, source_id);
+                (x.into(), 0)
+            }
+        };
+        cb(command_handle, rc, handle);
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Releases the compiled proof request template. Proofs created from it are not affected.
+///
+/// #Params
+/// template_handle: Template handle that was provided by `vcx_proof_template_create`
+///
+/// #Returns
+/// Success
+#[no_mangle]
+pub extern fn vcx_proof_template_release(template_handle: u32) -> u32 {
+    info!("vcx_proof_template_release >>>");
+
+    match proof::release_proof_template(template_handle) {
+        Ok(()) => {
+            trace!("vcx_proof_template_release(template_handle: {}, rc: {})",
+                   template_handle, error::SUCCESS.message);
+            error::SUCCESS.code_num
+        }
+        Err(e) => {
+            warn!("vcx_proof_template_release(template_handle: {}, rc: {})",
+                  template_handle, e);
+            e.into()
+        }
+    }
+}
+
 /// Query the agency for the received messages.
 /// Checks for any messages changing state in the object and updates the state attribute.
 ///
@@ -215,6 +347,48 @@ pub extern fn vcx_v2_proof_update_state(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Updates state of several proofs at once, checking the given connections for messages in parallel.
+/// Received presentations are validated together, sharing ledger data fetched once for the whole batch,
+/// which makes it preferable over repeated `vcx_v2_proof_update_state` calls.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// proof_handles: array of proof handles that were provided during creation, a repeated handle fails
+///
+/// connection_handles: array of connection handles, i-th proof is updated from i-th connection
+///
+/// count: number of items in both arrays
+///
+/// cb: Callback that provides error status of the batch and arrays of error codes and states of proofs
+///     in the order of input handles. State is 0 for proofs which failed.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_v2_proof_update_states(command_handle: CommandHandle,
+                                         proof_handles: *const u32,
+                                         connection_handles: *const u32,
+                                         count: u32,
+                                         cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, errors: *const u32, states: *const u32, count: u32)>) -> u32 {
+    info!("vcx_v2_proof_update_states >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(proof_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(connection_handles, count, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_v2_proof_update_states(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        let handles = proof_handles.into_iter().zip(connection_handles.into_iter()).collect();
+        return_batch_results("vcx_v2_proof_update_states_cb", command_handle, proof::update_states(handles), cb);
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Update the state of the proof based on the given message.
 ///
 /// #Params
@@ -421,6 +595,150 @@ pub extern fn vcx_proof_deserialize(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Takes an array of json strings representing proofs and recreates all of them at once.
+/// Objects are parsed in parallel and stored with a single update of the object cache, which makes it
+/// preferable over repeated `vcx_proof_deserialize` calls when restoring many objects.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data: array of json strings, each is an output of `vcx_proof_serialize` function.
+///
+/// count: number of items in data array
+///
+/// cb: Callback that provides array of handles in the order of data items and provides error status.
+///     If any item cannot be deserialized, error is returned and no object is created.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_proof_deserialize_many(command_handle: CommandHandle,
+                                         data: *const *const c_char,
+                                         count: u32,
+                                         cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handles: *const u32, count: u32)>) -> u32 {
+    info!("vcx_proof_deserialize_many >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str_array!(data, count, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_proof_deserialize_many(command_handle: {}, count: {})", command_handle, count);
+
+    execute(move || {
+        match proof::from_strings(data) {
+            Ok(handles) => {
+                trace!("vcx_proof_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, error::SUCCESS.message, handles.len());
+                cb(command_handle, error::SUCCESS.code_num, handles.as_ptr(), handles.len() as u32);
+            }
+            Err(x) => {
+                error!("vcx_proof_deserialize_many_cb(command_handle: {}, rc: {}, count: {})",
+                       command_handle, x, 0);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes the proof object and returns its compact binary representation.
+/// Binary representation holds the same data as output of `vcx_proof_serialize`, they can be converted
+/// into each other by `vcx_serialized_json_to_binary` and `vcx_serialized_binary_to_json`.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// proof_handle: Proof handle that was provided during creation. Used to access proof object
+///
+/// cb: Callback that provides binary representation of the proof object and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_proof_serialize_binary(command_handle: CommandHandle,
+                                         proof_handle: u32,
+                                         cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, data_raw: *const u8, data_len: u32)>) -> u32 {
+    info!("vcx_proof_serialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    if !proof::is_valid_handle(proof_handle) {
+        return VcxError::from(VcxErrorKind::InvalidProofHandle).into();
+    }
+
+    let source_id = proof::get_source_id(proof_handle).unwrap_or_default();
+    trace!("vcx_proof_serialize_binary(command_handle: {}, proof_handle: {}) source_id: {}",
+           command_handle, proof_handle, source_id);
+
+    execute(move || {
+        match proof::to_binary(proof_handle) {
+            Ok(x) => {
+                trace!("vcx_proof_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x.len(), source_id);
+                let (data_raw, data_len) = vec_to_pointer(&x);
+                cb(command_handle, error::SUCCESS.code_num, data_raw, data_len);
+            }
+            Err(x) => {
+                error!("vcx_proof_serialize_binary_cb(command_handle: {}, rc: {}, data_len: {}) source_id: {}",
+                       command_handle, x, 0, source_id);
+                cb(command_handle, x.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Takes binary representation of a proof object and recreates the object
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// data_raw: binary representation of a proof object. Is an output of `vcx_proof_serialize_binary` function.
+///
+/// data_len: length of data buffer
+///
+/// cb: Callback that provides proof handle and provides error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_proof_deserialize_binary(command_handle: CommandHandle,
+                                           data_raw: *const u8,
+                                           data_len: u32,
+                                           cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, handle: u32)>) -> u32 {
+    info!("vcx_proof_deserialize_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(data_raw, data_len, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_proof_deserialize_binary(command_handle: {}, data_len: {})",
+           command_handle, data_len);
+
+    execute(move || {
+        match proof::from_binary(&data_raw) {
+            Ok(x) => {
+                trace!("vcx_proof_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, error::SUCCESS.message, x, proof::get_source_id(x).unwrap_or_default());
+                cb(command_handle, error::SUCCESS.code_num, x);
+            }
+            Err(x) => {
+                error!("vcx_proof_deserialize_binary_cb(command_handle: {}, rc: {}, handle: {}) source_id: {}",
+                       command_handle, x, 0, "");
+                cb(command_handle, x.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Releases the proof object by de-allocating memory
 ///
 /// #Params
@@ -707,6 +1025,34 @@ mod tests {
                    error::INVALID_OPTION.code_num);
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_vcx_create_proof_from_template() {
+        let _setup = SetupMocks::init();
+
+        let cb = return_types_u32::Return_U32_U32::new().unwrap();
+        assert_eq!(vcx_proof_template_create(cb.command_handle,
+                                             CString::new(REQUESTED_ATTRS).unwrap().into_raw(),
+                                             CString::new(REQUESTED_PREDICATES).unwrap().into_raw(),
+                                             CString::new(r#"{"support_revocation":false}"#).unwrap().into_raw(),
+                                             CString::new("optional").unwrap().into_raw(),
+                                             Some(cb.get_callback())),
+                   error::SUCCESS.code_num);
+        let template_handle = cb.receive(TimeoutUtils::some_medium()).unwrap();
+
+        let cb = return_types_u32::Return_U32_U32::new().unwrap();
+        assert_eq!(vcx_proof_create_from_template(cb.command_handle,
+                                                  CString::new(DEFAULT_PROOF_NAME).unwrap().into_raw(),
+                                                  template_handle,
+                                                  Some(cb.get_callback())),
+                   error::SUCCESS.code_num);
+        let proof_handle = cb.receive(TimeoutUtils::some_medium()).unwrap();
+        assert_eq!(proof::get_state(proof_handle).unwrap(), VerifierState::Initial as u32);
+
+        assert_eq!(vcx_proof_template_release(template_handle), error::SUCCESS.code_num);
+        assert_ne!(vcx_proof_template_release(template_handle), error::SUCCESS.code_num);
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_vcx_proof_get_request_msg() {
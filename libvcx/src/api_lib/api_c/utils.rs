@@ -11,9 +11,10 @@ use aries_vcx::libindy::utils::payments;
 use aries_vcx::utils::constants::*;
 use aries_vcx::utils::error;
 use aries_vcx::utils::provision::AgentProvisionConfig;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::connection;
-use crate::api_lib::utils::cstring::CStringUtils;
+use crate::api_lib::utils::cstring::{CStringUtils, vec_to_pointer};
 use crate::api_lib::utils::runtime::execute;
 use crate::error::prelude::*;
 
@@ -448,6 +449,121 @@ pub extern fn vcx_pool_set_handle(handle: i32) -> i32 {
     handle
 }
 
+/// Drops cached ledger reads (NYM, attributes and services) so the next lookup goes to the ledger.
+///
+/// #params
+///
+/// did: DID whose cached reads should be dropped. If null, whole cache is cleared.
+///
+/// #Returns
+/// Error code as u32
+#[no_mangle]
+pub extern fn vcx_invalidate_ledger_cache(did: *const c_char) -> u32 {
+    info!("vcx_invalidate_ledger_cache >>>");
+
+    check_useful_opt_c_str!(did, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_invalidate_ledger_cache(did: {:?})", did);
+
+    match did {
+        Some(did) => aries_vcx::libindy::utils::ledger_cache::invalidate_ledger_cache(&did),
+        None => aries_vcx::libindy::utils::ledger_cache::clear_ledger_cache()
+    }
+
+    error::SUCCESS.code_num
+}
+
+/// Converts serialized object (output of any `vcx_*_serialize` function) into its binary representation
+///
+/// #params
+///
+/// command_handle: command handle to map callback to user context.
+///
+/// serialized: json string representing serialized object
+///
+/// cb: Callback that provides binary representation of the object
+///
+/// #Returns
+/// Error code as u32
+#[no_mangle]
+pub extern fn vcx_serialized_json_to_binary(command_handle: CommandHandle,
+                                            serialized: *const c_char,
+                                            cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, data_raw: *const u8, data_len: u32)>) -> u32 {
+    info!("vcx_serialized_json_to_binary >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(serialized, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_serialized_json_to_binary(command_handle: {})", command_handle);
+
+    execute(move || {
+        match serialization::json_to_binary(&serialized) {
+            Ok(x) => {
+                trace!("vcx_serialized_json_to_binary_cb(command_handle: {}, rc: {}, data_len: {})",
+                       command_handle, error::SUCCESS.message, x.len());
+                let (data_raw, data_len) = vec_to_pointer(&x);
+                cb(command_handle, error::SUCCESS.code_num, data_raw, data_len);
+            }
+            Err(err) => {
+                error!("vcx_serialized_json_to_binary_cb(command_handle: {}, rc: {}, data_len: {})",
+                       command_handle, err, 0);
+                cb(command_handle, err.into(), ptr::null(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Converts binary representation of an object (output of any `vcx_*_serialize_binary` function) into json
+///
+/// #params
+///
+/// command_handle: command handle to map callback to user context.
+///
+/// data_raw: binary representation of the object
+///
+/// data_len: length of data buffer
+///
+/// cb: Callback that provides json string representing serialized object
+///
+/// #Returns
+/// Error code as u32
+#[no_mangle]
+pub extern fn vcx_serialized_binary_to_json(command_handle: CommandHandle,
+                                            data_raw: *const u8,
+                                            data_len: u32,
+                                            cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, serialized: *const c_char)>) -> u32 {
+    info!("vcx_serialized_binary_to_json >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_byte_array!(data_raw, data_len, VcxErrorKind::InvalidOption, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_serialized_binary_to_json(command_handle: {}, data_len: {})", command_handle, data_len);
+
+    execute(move || {
+        match serialization::binary_to_json(&data_raw) {
+            Ok(x) => {
+                trace!("vcx_serialized_binary_to_json_cb(command_handle: {}, rc: {}, serialized: {})",
+                       command_handle, error::SUCCESS.message, x);
+                let msg = CStringUtils::string_to_cstring(x);
+                cb(command_handle, error::SUCCESS.code_num, msg.as_ptr());
+            }
+            Err(err) => {
+                error!("vcx_serialized_binary_to_json_cb(command_handle: {}, rc: {}, serialized: {})",
+                       command_handle, err, "null");
+                cb(command_handle, err.into(), ptr::null());
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Gets minimal request price for performing an action in case the requester can perform this action.
 ///
 /// # Params
@@ -3,10 +3,14 @@ use std::ffi::CString;
 use libc::c_char;
 
 use aries_vcx::{libindy, utils};
+use aries_vcx::agency_client::metrics;
 use aries_vcx::indy::CommandHandle;
 use aries_vcx::init::{create_agency_client_for_main_wallet, enable_agency_mocks, enable_vcx_mocks, init_issuer_config, open_main_pool, PoolConfig};
+use aries_vcx::handlers::connection::provisioned_pool::{init_pairwise_pool, PairwisePoolConfig, reset_pairwise_pool};
+use aries_vcx::handlers::connection::send_queue::{init_send_queue, reset_send_queue, SendQueueConfig, take_delivery_outcomes};
+use aries_vcx::handlers::issuance::issuer::offer_pool::reset_offer_pools;
 use aries_vcx::libindy::utils::{ledger, pool, wallet};
-use aries_vcx::libindy::utils::pool::is_pool_open;
+use aries_vcx::libindy::utils::pool::{is_pool_open, is_pool_opening};
 use aries_vcx::libindy::utils::wallet::{close_main_wallet, IssuerConfig, WalletConfig};
 use aries_vcx::settings;
 use aries_vcx::utils::error;
@@ -122,6 +126,119 @@ pub extern fn vcx_create_agency_client_for_main_wallet(command_handle: CommandHa
     error::SUCCESS.code_num
 }
 
+/// Enables pool of pairwise DIDs with cloud agent keys provisioned in background, so new connections
+/// do not wait for the agency to create agent keys. Must be called after wallet was opened and
+/// agency client created. Unused provisioned entries are kept in the wallet.
+///
+/// #Params
+///
+/// config: Pool configuration
+/// {
+///     "capacity" - number of entries kept provisioned
+///     "low_water_mark" - number of entries left at which pool gets refilled, lower than capacity
+/// }
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_init_pairwise_pool(config: *const c_char) -> u32 {
+    info!("vcx_init_pairwise_pool >>>");
+
+    check_useful_c_str!(config, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_init_pairwise_pool >>> config: {}", config);
+
+    let pool_config = match serde_json::from_str::<PairwisePoolConfig>(&config) {
+        Ok(pool_config) => pool_config,
+        Err(err) => {
+            error!("vcx_init_pairwise_pool >>> invalid configuration, err: {:?}", err);
+            return error::INVALID_CONFIGURATION.code_num;
+        }
+    };
+
+    match init_pairwise_pool(pool_config) {
+        Ok(()) => error::SUCCESS.code_num,
+        Err(err) => {
+            error!("vcx_init_pairwise_pool >>> error: {}", err);
+            err.into()
+        }
+    }
+}
+
+/// Enables background delivery of messages sent over connections. Messages of a connection are
+/// delivered in the order they were sent, while packing of queued messages runs on worker threads.
+/// Sending returns once the message is queued, delivery outcomes are obtained by vcx_get_delivery_outcomes.
+///
+/// #Params
+///
+/// config: Send queue configuration, all fields optional
+/// {
+///     "workers" - number of threads packing and delivering messages
+///     "max_retries" - number of times failed delivery is retried
+///     "initial_backoff_ms" - delay before first retry, doubled with every next one
+///     "max_backoff_ms" - upper bound of the delay between retries
+/// }
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_init_send_queue(config: *const c_char) -> u32 {
+    info!("vcx_init_send_queue >>>");
+
+    check_useful_c_str!(config, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_init_send_queue >>> config: {}", config);
+
+    let queue_config = match serde_json::from_str::<SendQueueConfig>(&config) {
+        Ok(queue_config) => queue_config,
+        Err(err) => {
+            error!("vcx_init_send_queue >>> invalid configuration, err: {:?}", err);
+            return error::INVALID_CONFIGURATION.code_num;
+        }
+    };
+
+    match init_send_queue(queue_config) {
+        Ok(()) => error::SUCCESS.code_num,
+        Err(err) => {
+            error!("vcx_init_send_queue >>> error: {}", err);
+            err.into()
+        }
+    }
+}
+
+/// Returns outcomes of messages queued for background delivery which were delivered or given up on
+/// since the previous call.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// cb: Callback that provides outcomes
+/// [{ "id": int, "pw_did": string, "message_id": string, "delivered": bool, "attempts": int, "error": string }]
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_get_delivery_outcomes(command_handle: CommandHandle,
+                                        cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, outcomes: *const c_char)>) -> u32 {
+    info!("vcx_get_delivery_outcomes >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_get_delivery_outcomes(command_handle: {})", command_handle);
+
+    execute(move || {
+        let outcomes = json!(take_delivery_outcomes()).to_string();
+        trace!("vcx_get_delivery_outcomes(command_handle: {}, rc: {}, outcomes: {})",
+               command_handle, error::SUCCESS.message, outcomes);
+        let msg = CStringUtils::string_to_cstring(outcomes);
+        cb(command_handle, error::SUCCESS.code_num, msg.as_ptr());
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Stores institution did and verkey in memory.
 ///
 /// #Params
@@ -183,6 +300,11 @@ pub extern fn vcx_init_issuer_config(command_handle: CommandHandle, config: *con
 ///     "pool_name" (optional) - Name of the pool ledger configuration.
 ///     `pool_config` (optional) - Runtime pool configuration json as a string.
 ///                         if NULL, then default config will be used.
+///     "open_in_background" (optional) - if true, callback is called as soon as pool opening is started
+///                         and ledger requests wait until the pool is ready (false by default).
+///     "refresh_interval_secs" (optional) - interval of refreshing pool node list in background.
+///                         Refreshed transactions are persisted by Libindy, so next opening of the pool
+///                         with the same name only catches up with recent transactions.
 /// }
 /// where pool config structure is as follows
 /// {
@@ -207,7 +329,7 @@ pub extern fn vcx_init_issuer_config(command_handle: CommandHandle, config: *con
 pub extern fn vcx_open_main_pool(command_handle: CommandHandle, pool_config: *const c_char, cb: extern fn(xcommand_handle: CommandHandle, err: u32)) -> u32 {
     info!("vcx_open_main_pool >>>");
     check_useful_c_str!(pool_config, VcxErrorKind::InvalidOption);
-    if is_pool_open() {
+    if is_pool_open() || is_pool_opening() {
         error!("vcx_open_main_pool :: Pool connection is already open.");
         return VcxError::from_msg(VcxErrorKind::AlreadyInitialized, "Pool connection is already open.").into();
     }
@@ -260,6 +382,12 @@ pub extern fn vcx_shutdown(delete: bool) -> u32 {
     info!("vcx_shutdown >>>");
     trace!("vcx_shutdown(delete: {})", delete);
 
+    // searches must be closed while their wallet is still open
+    crate::api_lib::api_handle::wallet_search::release_all();
+    reset_pairwise_pool();
+    reset_offer_pools();
+    reset_send_queue();
+
     match wallet::close_main_wallet() {
         Ok(()) => {}
         Err(_) => {}
@@ -513,6 +641,63 @@ pub extern fn vcx_get_current_error(error_json_p: *mut *const c_char) {
     trace!("vcx_get_current_error: <<<");
 }
 
+/// Exports latency histograms and counters of operations performed by libvcx: agency requests,
+/// libindy wallet, crypto and anoncreds calls, ledger submits, object cache lock waits, message
+/// deserialization and state machine transitions.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+///
+/// format: "prometheus" for Prometheus text exposition format, "json" for
+/// {
+///     "operations": { "<operation>": { "count": int, "errors": int, "sum_us": int, "max_us": int, "quantiles_us": { "0.5": int, ... } } },
+///     "events": { "<event>": int }
+/// }
+///
+/// cb: Callback that provides exported metrics
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_get_metrics(command_handle: CommandHandle,
+                              format: *const c_char,
+                              cb: Option<extern fn(xcommand_handle: CommandHandle, err: u32, metrics: *const c_char)>) -> u32 {
+    info!("vcx_get_metrics >>>");
+
+    check_useful_c_str!(format, VcxErrorKind::InvalidOption);
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_get_metrics(command_handle: {}, format: {})", command_handle, format);
+
+    if format != "prometheus" && format != "json" {
+        return VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Unsupported metrics format: {}", format)).into();
+    }
+
+    execute(move || {
+        let snapshot = metrics::snapshot();
+        let exported = if format == "prometheus" { snapshot.to_prometheus() } else { snapshot.to_json() };
+        trace!("vcx_get_metrics(command_handle: {}, rc: {}, metrics: {} bytes)",
+               command_handle, error::SUCCESS.message, exported.len());
+        let msg = CStringUtils::string_to_cstring(exported);
+        cb(command_handle, error::SUCCESS.code_num, msg.as_ptr());
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Zeroes all recorded metrics.
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_reset_metrics() -> u32 {
+    info!("vcx_reset_metrics >>>");
+    metrics::reset();
+    error::SUCCESS.code_num
+}
+
 #[cfg(test)]
 #[allow(unused_imports)]
 mod tests {
@@ -521,6 +706,7 @@ mod tests {
     use aries_vcx::indy::INVALID_WALLET_HANDLE;
     use aries_vcx::init::PoolConfig;
     use aries_vcx::libindy::utils::pool::get_pool_handle;
+    use aries_vcx::libindy::utils::rev_reg_cache;
     use aries_vcx::libindy::utils::wallet::{import, RestoreWalletConfigs, WalletConfig};
     #[cfg(feature = "pool_tests")]
     use aries_vcx::libindy::utils::wallet::get_wallet_handle;
@@ -608,7 +794,7 @@ mod tests {
         let _genesis_transactions = TempFile::create_with_data(utils::constants::GENESIS_PATH, "{}");
         settings::set_config_value(settings::CONFIG_GENESIS_PATH, &_genesis_transactions.path);
 
-        let pool_config = PoolConfig { genesis_path: _genesis_transactions.path.clone(), pool_name: Some(pool_name.clone()), pool_config: None };
+        let pool_config = PoolConfig { genesis_path: _genesis_transactions.path.clone(), pool_name: Some(pool_name.clone()), pool_config: None, open_in_background: None, refresh_interval_secs: None };
         let err = _vcx_open_main_pool_c_closure(&json!(pool_config).to_string()).unwrap_err();
         assert_eq!(err, error::POOL_LEDGER_CONNECT.code_num);
         assert_eq!(get_pool_handle().unwrap_err().kind(), aries_vcx::error::VcxErrorKind::NoPoolOpen);
@@ -622,7 +808,7 @@ mod tests {
         let _setup = SetupDefaults::init();
         let pool_name = format!("invalidpool_{}", uuid::Uuid::new_v4().to_string());
 
-        let pool_config = PoolConfig { genesis_path: "invalid/txn/path".to_string(), pool_name: Some(pool_name.clone()), pool_config: None };
+        let pool_config = PoolConfig { genesis_path: "invalid/txn/path".to_string(), pool_name: Some(pool_name.clone()), pool_config: None, open_in_background: None, refresh_interval_secs: None };
         let err = _vcx_open_main_pool_c_closure(&json!(pool_config).to_string()).unwrap_err();
         assert_eq!(err, error::INVALID_GENESIS_TXN_PATH.code_num);
         assert_eq!(get_pool_handle().unwrap_err().kind(), aries_vcx::error::VcxErrorKind::NoPoolOpen);
@@ -773,8 +959,11 @@ mod tests {
         let schema = schema::create_and_publish_schema("5", "VsKV7grR1BUE29mG2Fm2kX".to_string(), "name".to_string(), "0.1".to_string(), data.to_string()).unwrap();
         let disclosed_proof = disclosed_proof::create_proof("id", utils::mockdata::mockdata_proof::ARIES_PROOF_REQUEST_PRESENTATION).unwrap();
         let credential = credential::credential_create_with_offer("name", utils::mockdata::mockdata_credex::ARIES_CREDENTIAL_OFFER).unwrap();
+        rev_reg_cache::set_rev_reg_snapshot("shutdown_rev_reg_id", 100, 50, "{}");
+        assert!(rev_reg_cache::get_rev_reg_snapshot("shutdown_rev_reg_id", 75).is_some());
 
         vcx_shutdown(true);
+        assert!(rev_reg_cache::get_rev_reg_snapshot("shutdown_rev_reg_id", 75).is_none());
         assert_eq!(connection::release(connection).unwrap_err().kind(), VcxErrorKind::InvalidConnectionHandle);
         assert_eq!(issuer_credential::release(issuer_credential).unwrap_err().kind(), VcxErrorKind::InvalidIssuerCredentialHandle);
         assert_eq!(schema::release(schema).unwrap_err().kind(), VcxErrorKind::InvalidSchemaHandle);
@@ -812,6 +1001,52 @@ mod tests {
         assert!(return_version.len() > 5);
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_vcx_get_metrics() {
+        let _setup = SetupMocks::init();
+
+        aries_vcx::agency_client::metrics::histogram("test_operation").time(|| Ok::<(), ()>(())).unwrap();
+
+        let cb = return_types_u32::Return_U32_STR::new().unwrap();
+        assert_eq!(vcx_get_metrics(cb.command_handle, CString::new("json").unwrap().into_raw(), Some(cb.get_callback())), error::SUCCESS.code_num);
+        let metrics: serde_json::Value = serde_json::from_str(&cb.receive(TimeoutUtils::some_short()).unwrap().unwrap()).unwrap();
+        assert!(metrics["operations"]["test_operation"]["count"].as_u64().unwrap() >= 1);
+
+        let cb = return_types_u32::Return_U32_STR::new().unwrap();
+        assert_eq!(vcx_get_metrics(cb.command_handle, CString::new("prometheus").unwrap().into_raw(), Some(cb.get_callback())), error::SUCCESS.code_num);
+        assert!(cb.receive(TimeoutUtils::some_short()).unwrap().unwrap().contains("vcx_operation_duration_seconds_count{operation=\"test_operation\"}"));
+
+        let cb = return_types_u32::Return_U32_STR::new().unwrap();
+        assert_eq!(vcx_get_metrics(cb.command_handle, CString::new("xml").unwrap().into_raw(), Some(cb.get_callback())), error::INVALID_OPTION.code_num);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_vcx_init_pairwise_pool() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(vcx_init_pairwise_pool(CString::new("{}").unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_init_pairwise_pool(CString::new(r#"{"capacity": 2, "low_water_mark": 2}"#).unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_init_pairwise_pool(CString::new(r#"{"capacity": 10, "low_water_mark": 3}"#).unwrap().into_raw()), error::SUCCESS.code_num);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_vcx_init_send_queue() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(vcx_init_send_queue(CString::new(r#"{"workers": 0}"#).unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_init_send_queue(CString::new(r#"{"workers": "many"}"#).unwrap().into_raw()), error::INVALID_CONFIGURATION.code_num);
+        assert_eq!(vcx_init_send_queue(CString::new(r#"{"workers": 2}"#).unwrap().into_raw()), error::SUCCESS.code_num);
+
+        let cb = return_types_u32::Return_U32_STR::new().unwrap();
+        assert_eq!(vcx_get_delivery_outcomes(cb.command_handle, Some(cb.get_callback())), error::SUCCESS.code_num);
+        assert_eq!(cb.receive(TimeoutUtils::some_short()).unwrap().unwrap(), "[]");
+
+        reset_send_queue();
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_vcx_update_institution_webhook() {
@@ -932,7 +1167,7 @@ mod tests {
         let _setup = SetupEmpty::init();
 
         let genesis_path = create_tmp_genesis_txn_file();
-        let config = PoolConfig { genesis_path, pool_name: None, pool_config: None };
+        let config = PoolConfig { genesis_path, pool_name: None, pool_config: None, open_in_background: None, refresh_interval_secs: None };
         _vcx_open_main_pool_c_closure(&json!(config).to_string()).unwrap();
 
         delete_test_pool();
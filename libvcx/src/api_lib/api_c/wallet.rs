@@ -8,8 +8,10 @@ use aries_vcx::init::open_as_main_wallet;
 use aries_vcx::libindy::utils::payments::{create_address, get_wallet_token_info, pay_a_payee, sign_with_address, verify_with_address};
 use aries_vcx::libindy::utils::wallet;
 use aries_vcx::libindy::utils::wallet::{export_main_wallet, import, RestoreWalletConfigs, WalletConfig};
+use aries_vcx::libindy::utils::wallet_backup::{BackupProgress, export_wallet_stream, import_wallet_stream, WalletBackupConfig, WalletRestoreConfig};
 use aries_vcx::utils::error;
 
+use crate::api_lib::api_handle::wallet_search;
 use crate::api_lib::utils;
 use crate::api_lib::utils::cstring::CStringUtils;
 use crate::api_lib::utils::runtime::execute;
@@ -1027,6 +1029,193 @@ pub extern fn vcx_wallet_close_search(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+/// Opens a cursor paging through wallet records matching a query.
+///
+/// Unlike vcx_wallet_open_search, records are fetched by pages of limited size and only the projected
+/// parts of records are returned, so huge wallets can be traversed in constant memory.
+///
+/// #Params
+///
+/// command_handle: command handle to map callback to user context.
+///
+/// type_: type of record. (e.g. 'data', 'string', 'foobar', 'image')
+///
+/// query_json: MongoDB style query to wallet record tags (see vcx_wallet_open_search)
+///
+/// projection_json: parts of records to fetch, only record ids are fetched by default
+///  {
+///    retrieveType: (optional, false by default) Retrieve record type,
+///    retrieveValue: (optional, false by default) Retrieve record value,
+///    tagNames: (optional) Names of tags to retrieve, no tags are retrieved if omitted,
+///  }
+///
+/// page_size: maximal number of records returned by vcx_wallet_search_cursor_next_page
+///
+/// cb: Callback that provides cursor handle or error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_wallet_search_cursor_open(command_handle: CommandHandle,
+                                            type_: *const c_char,
+                                            query_json: *const c_char,
+                                            projection_json: *const c_char,
+                                            page_size: usize,
+                                            cb: Option<extern fn(command_handle_: CommandHandle, err: u32,
+                                                                 cursor_handle: u32)>) -> u32 {
+    info!("vcx_wallet_search_cursor_open >>>");
+
+    check_useful_c_str!(type_, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(query_json, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(projection_json, VcxErrorKind::InvalidOption);
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_wallet_search_cursor_open(command_handle: {}, type_: {}, query_json: {}, projection_json: {}, page_size: {})",
+           command_handle, secret!(&type_), secret!(&query_json), projection_json, page_size);
+
+    execute(move || {
+        match wallet_search::open_cursor(&type_, &query_json, &projection_json, page_size) {
+            Ok(handle) => {
+                trace!("vcx_wallet_search_cursor_open(command_handle: {}, rc: {}, cursor_handle: {})",
+                       command_handle, error::SUCCESS.message, handle);
+                cb(command_handle, error::SUCCESS.code_num, handle);
+            }
+            Err(e) => {
+                trace!("vcx_wallet_search_cursor_open(command_handle: {}, rc: {}, cursor_handle: {})",
+                       command_handle, e, 0);
+                cb(command_handle, e.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Fetches next page of records of wallet search cursor.
+///
+/// #Params
+/// command_handle: command handle to map callback to user context.
+/// cursor_handle: cursor handle (created by vcx_wallet_search_cursor_open)
+///
+/// #Returns
+/// JSON array of up to page_size records:
+///   [{
+///       id: "Some id",
+///       type: "Some type", // present only if retrieveType set to true
+///       value: "Some value", // present only if retrieveValue set to true
+///       tags: <tags json>, // present only if tagNames were set
+///   }]
+/// Empty array means all records were returned; the cursor is released by then and its handle is no longer valid.
+#[no_mangle]
+pub extern fn vcx_wallet_search_cursor_next_page(command_handle: CommandHandle,
+                                                 cursor_handle: u32,
+                                                 cb: Option<extern fn(command_handle_: CommandHandle, err: u32,
+                                                                      records_json: *const c_char)>) -> u32 {
+    info!("vcx_wallet_search_cursor_next_page >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    if !wallet_search::is_valid_handle(cursor_handle) {
+        return VcxError::from(VcxErrorKind::InvalidHandle).into();
+    }
+
+    trace!("vcx_wallet_search_cursor_next_page(command_handle: {}, cursor_handle: {})",
+           command_handle, cursor_handle);
+
+    execute(move || {
+        match wallet_search::next_page(cursor_handle) {
+            Ok(records) => {
+                trace!("vcx_wallet_search_cursor_next_page(command_handle: {}, rc: {}, records_json: {})",
+                       command_handle, error::SUCCESS.message, secret!(&records));
+                let msg = CStringUtils::string_to_cstring(records);
+                cb(command_handle, error::SUCCESS.code_num, msg.as_ptr());
+            }
+            Err(e) => {
+                trace!("vcx_wallet_search_cursor_next_page(command_handle: {}, rc: {}, records_json: {})",
+                       command_handle, e, "null");
+                cb(command_handle, e.into(), null());
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Releases wallet search cursor before all its pages were fetched.
+///
+/// #Params
+/// cursor_handle: cursor handle (created by vcx_wallet_search_cursor_open)
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_wallet_search_cursor_release(cursor_handle: u32) -> u32 {
+    info!("vcx_wallet_search_cursor_release >>>");
+
+    match wallet_search::release(cursor_handle) {
+        Ok(()) => {
+            trace!("vcx_wallet_search_cursor_release(cursor_handle: {}, rc: {})", cursor_handle, error::SUCCESS.message);
+            error::SUCCESS.code_num
+        }
+        Err(e) => {
+            warn!("vcx_wallet_search_cursor_release(cursor_handle: {}), rc: {})", cursor_handle, e);
+            e.into()
+        }
+    }
+}
+
+/// Counts wallet records matching a query without fetching them.
+///
+/// #Params
+///
+/// command_handle: command handle to map callback to user context.
+///
+/// type_: type of record. (e.g. 'data', 'string', 'foobar', 'image')
+///
+/// query_json: MongoDB style query to wallet record tags (see vcx_wallet_open_search)
+///
+/// cb: Callback that provides number of matching records or error status
+///
+/// #Returns
+/// Error code as a u32
+#[no_mangle]
+pub extern fn vcx_wallet_count_records(command_handle: CommandHandle,
+                                       type_: *const c_char,
+                                       query_json: *const c_char,
+                                       cb: Option<extern fn(command_handle_: CommandHandle, err: u32,
+                                                            count: u32)>) -> u32 {
+    info!("vcx_wallet_count_records >>>");
+
+    check_useful_c_str!(type_, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(query_json, VcxErrorKind::InvalidOption);
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_wallet_count_records(command_handle: {}, type_: {}, query_json: {})",
+           command_handle, secret!(&type_), secret!(&query_json));
+
+    execute(move || {
+        match wallet_search::count(&type_, &query_json) {
+            Ok(count) => {
+                trace!("vcx_wallet_count_records(command_handle: {}, rc: {}, count: {})",
+                       command_handle, error::SUCCESS.message, count);
+                cb(command_handle, error::SUCCESS.code_num, count as u32);
+            }
+            Err(e) => {
+                trace!("vcx_wallet_count_records(command_handle: {}, rc: {}, count: {})",
+                       command_handle, e, 0);
+                cb(command_handle, e.into(), 0);
+            }
+        };
+
+        Ok(())
+    });
+
+    error::SUCCESS.code_num
+}
+
 /// Exports opened wallet
 ///
 /// Note this endpoint is EXPERIMENTAL. Function signature and behaviour may change
@@ -1132,6 +1321,146 @@ pub extern fn vcx_wallet_import(command_handle: CommandHandle,
     error::SUCCESS.code_num
 }
 
+fn _report_progress(command_handle: CommandHandle,
+                    progress_cb: Option<extern fn(xcommand_handle: CommandHandle, progress: *const c_char)>,
+                    progress: &BackupProgress) {
+    if let Some(progress_cb) = progress_cb {
+        let progress = serde_json::to_string(progress).unwrap_or_default();
+        let progress = CStringUtils::string_to_cstring(progress);
+        progress_cb(command_handle, progress.as_ptr());
+    }
+}
+
+/// Exports opened wallet into chunked, compressed and encrypted archive, reporting progress as it goes.
+/// Unlike vcx_wallet_export, an interrupted export can be resumed, and an archive can be an increment
+/// holding only records changed since its base archive.
+///
+/// Records of libindy (DIDs, keys, credentials) are exported as a whole by libindy into every archive,
+/// incremental ones included, only non-secret records of listed types are exported record by record.
+///
+/// Note this endpoint is EXPERIMENTAL. Function signature and behaviour may change
+/// in the future releases.
+///
+/// #Params:
+/// command_handle: Handle for User's Reference only.
+/// config: Export configuration
+/// {
+///     "path" - path of the archive
+///     "backup_key" - key the archive is encrypted with
+///     "record_types" (optional) - types of non-secret records exported record by record
+///     "base_path" (optional) - archive this one is an increment of
+///     "include_indy_export" (optional) - whether libindy export is included, true by default;
+///         archive exported without it cannot be imported as the newest archive
+///     "resume" (optional) - whether export continues into an existing unfinished archive, false by default
+///     "page_size" (optional) - number of records per chunk
+/// }
+/// progress_cb: Optional callback called with progress as json:
+///     {"stage", "records_done", "records_total", "indy_export_done", "indy_export_total"},
+///     libindy export progress is reported in bytes after every chunk of it
+/// cb: Callback that provides the success/failure of the api call.
+/// #Returns
+/// Error code - success indicates that the api call was successfully created and execution
+/// is scheduled to begin in a separate thread.
+#[no_mangle]
+pub extern fn vcx_wallet_export_stream(command_handle: CommandHandle,
+                                       config: *const c_char,
+                                       progress_cb: Option<extern fn(xcommand_handle: CommandHandle, progress: *const c_char)>,
+                                       cb: Option<extern fn(xcommand_handle: CommandHandle,
+                                                            err: u32)>) -> u32 {
+    info!("vcx_wallet_export_stream >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(config, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_wallet_export_stream(command_handle: {}, config: ****)", command_handle);
+
+    let config = match serde_json::from_str::<WalletBackupConfig>(&config) {
+        Ok(config) => config,
+        Err(err) => {
+            error!("vcx_wallet_export_stream >>> invalid export configuration; err: {:?}", err);
+            return error::INVALID_CONFIGURATION.code_num;
+        }
+    };
+
+    thread::spawn(move || {
+        trace!("vcx_wallet_export_stream(command_handle: {}, path: {})", command_handle, config.path);
+        match export_wallet_stream(&config, &|progress| _report_progress(command_handle, progress_cb, progress)) {
+            Ok(()) => {
+                trace!("vcx_wallet_export_stream(command_handle: {}, rc: {})", command_handle, error::SUCCESS.message);
+                cb(command_handle, error::SUCCESS.code_num);
+            }
+            Err(e) => {
+                warn!("vcx_wallet_export_stream(command_handle: {}, rc: {})", command_handle, e);
+                cb(command_handle, e.into());
+            }
+        };
+    });
+
+    error::SUCCESS.code_num
+}
+
+/// Creates a new wallet from archives created by vcx_wallet_export_stream, reporting progress as it goes.
+/// Cannot be used if wallet is already opened. The newest archive must contain libindy export, otherwise
+/// import fails, as DIDs, keys and credentials created since the older archives would be lost.
+///
+/// Note this endpoint is EXPERIMENTAL. Function signature and behaviour may change
+/// in the future releases.
+///
+/// #Params:
+/// command_handle: Handle for User's Reference only.
+/// config: Import configuration
+/// {
+///     "wallet_name" - name of the new wallet
+///     "wallet_key" - key of the new wallet
+///     "wallet_key_derivation" (optional) - method of key derivation used by libindy, ARGON2I_INT by default
+///     "backup_key" - key the archives were encrypted with
+///     "archive_paths" - full archive followed by its increments, in the order they were exported
+/// }
+/// progress_cb: Optional callback called with progress as json:
+///     {"stage", "records_done", "records_total", "indy_export_done", "indy_export_total"},
+///     libindy export progress is reported in bytes after every chunk of it
+/// cb: Callback that provides the success/failure of the api call.
+/// #Returns
+/// Error code - success indicates that the api call was successfully created and execution
+/// is scheduled to begin in a separate thread.
+#[no_mangle]
+pub extern fn vcx_wallet_import_stream(command_handle: CommandHandle,
+                                       config: *const c_char,
+                                       progress_cb: Option<extern fn(xcommand_handle: CommandHandle, progress: *const c_char)>,
+                                       cb: Option<extern fn(xcommand_handle: CommandHandle,
+                                                            err: u32)>) -> u32 {
+    info!("vcx_wallet_import_stream >>>");
+
+    check_useful_c_callback!(cb, VcxErrorKind::InvalidOption);
+    check_useful_c_str!(config, VcxErrorKind::InvalidOption);
+
+    trace!("vcx_wallet_import_stream(command_handle: {}, config: ****)", command_handle);
+
+    let config = match serde_json::from_str::<WalletRestoreConfig>(&config) {
+        Ok(config) => config,
+        Err(err) => {
+            error!("vcx_wallet_import_stream >>> invalid import configuration; err: {:?}", err);
+            return error::INVALID_CONFIGURATION.code_num;
+        }
+    };
+
+    thread::spawn(move || {
+        trace!("vcx_wallet_import_stream(command_handle: {}, config: ****)", command_handle);
+        match import_wallet_stream(&config, &|progress| _report_progress(command_handle, progress_cb, progress)) {
+            Ok(()) => {
+                trace!("vcx_wallet_import_stream(command_handle: {}, rc: {})", command_handle, error::SUCCESS.message);
+                cb(command_handle, error::SUCCESS.code_num);
+            }
+            Err(e) => {
+                warn!("vcx_wallet_import_stream(command_handle: {}, rc: {})", command_handle, e);
+                cb(command_handle, e.into());
+            }
+        };
+    });
+
+    error::SUCCESS.code_num
+}
+
 // Functionality in Libindy for validating an address in NOT there yet
 /// Validates a Payment address
 ///
@@ -1186,8 +1515,11 @@ pub mod tests {
     use std::ffi::CString;
     use std::ptr;
 
+    use aries_vcx::indy::did;
+    use aries_vcx::indy::future::Future;
     #[cfg(feature = "pool_tests")]
     use aries_vcx::libindy::utils::payments::build_test_address;
+    use aries_vcx::libindy::utils::signus::create_and_store_my_did;
     use aries_vcx::libindy::utils::wallet::{close_main_wallet, create_and_open_as_main_wallet, delete_wallet, WalletConfig};
     use aries_vcx::settings;
     use aries_vcx::utils::devsetup::{SetupDefaults, SetupEmpty, SetupLibraryWallet, SetupLibraryWalletPoolZeroFees, SetupMocks, TempFile};
@@ -1617,4 +1949,125 @@ pub mod tests {
 
         delete_wallet(&wallet_config).unwrap();
     }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_wallet_export_import_stream() {
+        let _setup = SetupDefaults::init();
+
+        let wallet_name = "test_wallet_export_import_stream";
+        let full_archive = TempFile::prepare_path(&format!("{}_full", wallet_name));
+        let increment_archive = TempFile::prepare_path(&format!("{}_increment", wallet_name));
+
+        let wallet_config = WalletConfig {
+            wallet_name: wallet_name.into(),
+            wallet_key: settings::DEFAULT_WALLET_KEY.into(),
+            wallet_key_derivation: settings::WALLET_KDF_RAW.into(),
+            wallet_type: None,
+            storage_config: None,
+            storage_credentials: None,
+            rekey: None,
+            rekey_derivation_method: None,
+        };
+        create_and_open_as_main_wallet(&wallet_config).unwrap();
+        wallet::add_record("stream_type", "id1", "value1", None).unwrap();
+        wallet::add_record("stream_type", "id2", "value2", None).unwrap();
+
+        let backup_key = settings::get_config_value(settings::CONFIG_WALLET_BACKUP_KEY).unwrap();
+        let export = |config: serde_json::Value| {
+            let cb = return_types_u32::Return_U32::new().unwrap();
+            assert_eq!(vcx_wallet_export_stream(cb.command_handle,
+                                                CString::new(config.to_string()).unwrap().as_ptr(),
+                                                None,
+                                                Some(cb.get_callback())), error::SUCCESS.code_num);
+            cb.receive(TimeoutUtils::some_long()).unwrap();
+        };
+        export(json!({"path": full_archive.path, "backup_key": backup_key, "record_types": ["stream_type"]}));
+
+        wallet::update_record_value("stream_type", "id1", "value1_updated").unwrap();
+        wallet::delete_record("stream_type", "id2").unwrap();
+        export(json!({"path": increment_archive.path, "backup_key": backup_key, "record_types": ["stream_type"], "base_path": full_archive.path}));
+
+        close_main_wallet().unwrap();
+        delete_wallet(&wallet_config).unwrap();
+
+        let import_config = json!({
+            "wallet_name": wallet_config.wallet_name.clone(),
+            "wallet_key": wallet_config.wallet_key.clone(),
+            "wallet_key_derivation": settings::WALLET_KDF_RAW,
+            "backup_key": backup_key,
+            "archive_paths": [full_archive.path, increment_archive.path],
+        }).to_string();
+        let cb = return_types_u32::Return_U32::new().unwrap();
+        assert_eq!(vcx_wallet_import_stream(cb.command_handle,
+                                            CString::new(import_config).unwrap().as_ptr(),
+                                            None,
+                                            Some(cb.get_callback())), error::SUCCESS.code_num);
+        cb.receive(TimeoutUtils::some_long()).unwrap();
+
+        open_as_main_wallet(&wallet_config).unwrap();
+        let options = json!({"retrieveType": false, "retrieveValue": true, "retrieveTags": false}).to_string();
+        let record: serde_json::Value = serde_json::from_str(&wallet::get_record("stream_type", "id1", &options).unwrap()).unwrap();
+        assert_eq!(record["value"], json!("value1_updated"));
+        assert!(wallet::get_record("stream_type", "id2", &options).is_err());
+        close_main_wallet().unwrap();
+        delete_wallet(&wallet_config).unwrap();
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_wallet_import_stream_restores_did_created_after_base() {
+        let _setup = SetupDefaults::init();
+
+        let wallet_name = "test_wallet_import_stream_restores_did_created_after_base";
+        let full_archive = TempFile::prepare_path(&format!("{}_full", wallet_name));
+        let increment_archive = TempFile::prepare_path(&format!("{}_increment", wallet_name));
+
+        let wallet_config = WalletConfig {
+            wallet_name: wallet_name.into(),
+            wallet_key: settings::DEFAULT_WALLET_KEY.into(),
+            wallet_key_derivation: settings::WALLET_KDF_RAW.into(),
+            wallet_type: None,
+            storage_config: None,
+            storage_credentials: None,
+            rekey: None,
+            rekey_derivation_method: None,
+        };
+        create_and_open_as_main_wallet(&wallet_config).unwrap();
+
+        let backup_key = settings::get_config_value(settings::CONFIG_WALLET_BACKUP_KEY).unwrap();
+        let export = |config: serde_json::Value| {
+            let cb = return_types_u32::Return_U32::new().unwrap();
+            assert_eq!(vcx_wallet_export_stream(cb.command_handle,
+                                                CString::new(config.to_string()).unwrap().as_ptr(),
+                                                None,
+                                                Some(cb.get_callback())), error::SUCCESS.code_num);
+            cb.receive(TimeoutUtils::some_long()).unwrap();
+        };
+        export(json!({"path": full_archive.path, "backup_key": backup_key, "record_types": ["stream_type"]}));
+        let (did, verkey) = create_and_store_my_did(None, None).unwrap();
+        export(json!({"path": increment_archive.path, "backup_key": backup_key, "record_types": ["stream_type"], "base_path": full_archive.path}));
+
+        close_main_wallet().unwrap();
+        delete_wallet(&wallet_config).unwrap();
+
+        let import_config = json!({
+            "wallet_name": wallet_config.wallet_name.clone(),
+            "wallet_key": wallet_config.wallet_key.clone(),
+            "wallet_key_derivation": settings::WALLET_KDF_RAW,
+            "backup_key": backup_key,
+            "archive_paths": [full_archive.path, increment_archive.path],
+        }).to_string();
+        let cb = return_types_u32::Return_U32::new().unwrap();
+        assert_eq!(vcx_wallet_import_stream(cb.command_handle,
+                                            CString::new(import_config).unwrap().as_ptr(),
+                                            None,
+                                            Some(cb.get_callback())), error::SUCCESS.code_num);
+        cb.receive(TimeoutUtils::some_long()).unwrap();
+
+        open_as_main_wallet(&wallet_config).unwrap();
+        assert_eq!(did::key_for_local_did(wallet::get_wallet_handle(), &did).wait().unwrap(), verkey);
+        close_main_wallet().unwrap();
+        delete_wallet(&wallet_config).unwrap();
+    }
 }
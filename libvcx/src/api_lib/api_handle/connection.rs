@@ -1,14 +1,19 @@
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
+use std::sync::RwLock;
 
 use serde_json;
 
 use aries_vcx::agency_client::get_message::MessageByConnection;
 use aries_vcx::agency_client::MessageStatusCode;
+use aries_vcx::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use aries_vcx::utils::error;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::agent::PUBLIC_AGENT_MAP;
 use crate::api_lib::api_handle::object_cache::ObjectCache;
 use crate::aries_vcx::handlers::connection::connection::Connection;
+use crate::aries_vcx::handlers::out_of_band::receiver::connection_index::ConnectionIndex;
+use crate::aries_vcx::handlers::out_of_band::receiver::receiver::OutOfBandReceiver;
 use crate::aries_vcx::messages::a2a::A2AMessage;
 use crate::aries_vcx::messages::connection::invite::Invitation as InvitationV3;
 use crate::aries_vcx::messages::connection::request::Request;
@@ -16,6 +21,7 @@ use crate::error::prelude::*;
 
 lazy_static! {
     pub static ref CONNECTION_MAP: ObjectCache<Connection> = ObjectCache::<Connection>::new("connections-cache");
+    static ref CONNECTION_INDEX: RwLock<ConnectionIndex<u32>> = RwLock::new(ConnectionIndex::new());
 }
 
 pub fn is_valid_handle(handle: u32) -> bool {
@@ -78,8 +84,52 @@ pub fn get_source_id(handle: u32) -> VcxResult<String> {
 }
 
 pub fn store_connection(connection: Connection) -> VcxResult<u32> {
-    CONNECTION_MAP.add(connection)
-        .or(Err(VcxError::from(VcxErrorKind::CreateConnection)))
+    let handle = CONNECTION_MAP.add(connection)
+        .or(Err(VcxError::from(VcxErrorKind::CreateConnection)))?;
+    _index_connections(&[handle]);
+    Ok(handle)
+}
+
+/**
+Keeps connections which can be reused for out-of-band invitations indexed by their bootstrap DID and
+service. Bootstrap DidDoc of a connection is only set on creation, so the index is updated when
+connections are stored and released.
+ */
+fn _index_connections(handles: &[u32]) {
+    let mut index = match CONNECTION_INDEX.write() {
+        Ok(index) => index,
+        Err(err) => {
+            warn!("_index_connections >>> unable to lock connection index: {:?}", err);
+            return;
+        }
+    };
+    for &handle in handles {
+        CONNECTION_MAP.get(handle, |connection| {
+            index.insert(handle, connection);
+            Ok(())
+        }).ok();
+    }
+}
+
+fn _unindex_connection(handle: u32) {
+    if let Ok(mut index) = CONNECTION_INDEX.write() {
+        index.remove(handle);
+    }
+}
+
+///
+/// Returns one of `conn_handles` which can be reused for the out-of-band invitation.
+///
+pub fn find_reusable_connection(oob: &OutOfBandReceiver, conn_handles: &[u32]) -> VcxResult<Option<u32>> {
+    trace!("find_reusable_connection >>> conn_handles: {:?}", conn_handles);
+    if let Some(handle) = conn_handles.iter().find(|&&handle| !is_valid_handle(handle)) {
+        return Err(VcxError::from_msg(VcxErrorKind::InvalidConnectionHandle, format!("Invalid connection handle: {}", handle)));
+    }
+    let candidates: HashSet<&u32> = conn_handles.iter().collect();
+    let index = CONNECTION_INDEX.read()
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::Common(10), format!("Unable to lock connection index: {:?}", err)))?;
+    oob.connection_exists_in_index(&index, |handle| candidates.contains(handle))
+        .map_err(|err| err.into())
 }
 
 pub fn create_connection(source_id: &str) -> VcxResult<u32> {
@@ -176,16 +226,47 @@ pub fn to_string(handle: u32) -> VcxResult<String> {
 pub fn from_string(connection_data: &str) -> VcxResult<u32> {
     let connection = Connection::from_string(connection_data)?;
     let handle = CONNECTION_MAP.add(connection)?;
+    _index_connections(&[handle]);
+    Ok(handle)
+}
+
+/**
+Deserializes connections on several threads and stores them with single cache update.
+Fails if any of connections cannot be deserialized, in which case none is stored.
+ */
+pub fn from_strings(connections_data: Vec<String>) -> VcxResult<Vec<u32>> {
+    let connections = map_concurrently(connections_data, DEFAULT_MAX_WORKERS, |connection_data| Connection::from_string(&connection_data))?
+        .into_iter()
+        .collect::<Result<Vec<Connection>, _>>()?;
+    let handles = CONNECTION_MAP.add_many(connections)?;
+    _index_connections(&handles);
+    Ok(handles)
+}
+
+pub fn to_binary(handle: u32) -> VcxResult<Vec<u8>> {
+    CONNECTION_MAP.get(handle, |connection| {
+        serialization::to_binary(connection).map_err(|err| err.into())
+    })
+}
+
+pub fn from_binary(connection_data: &[u8]) -> VcxResult<u32> {
+    let connection: Connection = serialization::from_binary(connection_data)?;
+    let handle = CONNECTION_MAP.add(connection)?;
+    _index_connections(&[handle]);
     Ok(handle)
 }
 
 pub fn release(handle: u32) -> VcxResult<()> {
+    _unindex_connection(handle);
     CONNECTION_MAP.release(handle)
         .or(Err(VcxError::from(VcxErrorKind::InvalidConnectionHandle)))
 }
 
 pub fn release_all() {
     CONNECTION_MAP.drain().ok();
+    if let Ok(mut index) = CONNECTION_INDEX.write() {
+        index.clear();
+    }
 }
 
 pub fn get_invite_details(handle: u32) -> VcxResult<String> {
@@ -280,7 +361,8 @@ pub mod tests {
     use aries_vcx::agency_client::mocking::AgencyMockDecrypted;
     use aries_vcx::messages::a2a::A2AMessage;
     use aries_vcx::messages::ack::test_utils::_ack;
-    use aries_vcx::messages::connection::invite::test_utils::{_pairwise_invitation_json, _public_invitation_json};
+    use aries_vcx::messages::connection::invite::test_utils::{_pairwise_invitation, _pairwise_invitation_json, _public_invitation_json};
+    use aries_vcx::messages::connection::service::{FullService, ServiceResolvable};
     use aries_vcx::utils::constants;
     use aries_vcx::utils::devsetup::{SetupEmpty, SetupMocks};
     use aries_vcx::utils::mockdata::mockdata_connection::{ARIES_CONNECTION_ACK, ARIES_CONNECTION_INVITATION, ARIES_CONNECTION_REQUEST, CONNECTION_SM_INVITEE_COMPLETED};
@@ -322,6 +404,28 @@ pub mod tests {
         assert_eq!(1, connection::get_state(connection_handle));
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_find_reusable_connection() {
+        let _setup = SetupMocks::init();
+        let inviter_handle = connection::create_connection(_source_id()).unwrap();
+        let invitee_handle = connection::create_connection_with_invite(_source_id(), &_pairwise_invitation_json()).unwrap();
+
+        let invitation = _pairwise_invitation();
+        let service = FullService::create()
+            .set_recipient_keys(invitation.recipient_keys)
+            .set_routing_keys(invitation.routing_keys);
+        let mut oob = OutOfBandReceiver::default();
+        oob.oob.services.push(ServiceResolvable::FullService(service));
+
+        assert_eq!(find_reusable_connection(&oob, &[inviter_handle, invitee_handle]).unwrap(), Some(invitee_handle));
+        assert_eq!(find_reusable_connection(&oob, &[inviter_handle]).unwrap(), None);
+        assert_eq!(find_reusable_connection(&oob, &[0]).unwrap_err().kind(), VcxErrorKind::InvalidConnectionHandle);
+
+        connection::release(invitee_handle).unwrap();
+        assert_eq!(find_reusable_connection(&oob, &[inviter_handle]).unwrap(), None);
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_create_connection_with_public_invite() {
@@ -552,4 +656,21 @@ pub mod tests {
         let err = send_generic_message(handle, "this is the message").unwrap_err();
         assert_eq!(err.kind(), VcxErrorKind::NotReady);
     }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_from_strings() {
+        let _setup = SetupMocks::init();
+
+        let expected_state = get_state(build_test_connection_invitee_completed());
+        let handles = from_strings(vec![CONNECTION_SM_INVITEE_COMPLETED.to_string(); 3]).unwrap();
+        assert_eq!(handles.len(), 3);
+        for handle in handles.iter() {
+            assert_eq!(get_state(*handle), expected_state);
+            assert_eq!(to_string(*handle).unwrap(), to_string(handles[0]).unwrap());
+        }
+
+        let err = from_strings(vec![CONNECTION_SM_INVITEE_COMPLETED.to_string(), "{}".to_string()]).unwrap_err();
+        assert_eq!(err.kind(), VcxErrorKind::InvalidJson);
+    }
 }
@@ -1,15 +1,21 @@
+use std::sync::Arc;
+
 use serde_json;
 
 use aries_vcx::agency_client::mocking::AgencyMockDecrypted;
 use aries_vcx::settings::indy_mocks_enabled;
+use aries_vcx::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use aries_vcx::utils::constants::GET_MESSAGES_DECRYPTED_RESPONSE;
 use aries_vcx::utils::error;
 use aries_vcx::utils::mockdata::mockdata_credex::ARIES_CREDENTIAL_OFFER;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::connection;
-use crate::api_lib::api_handle::object_cache::ObjectCache;
+use crate::api_lib::api_handle::object_cache::{ObjectCache, reject_repeated_handles};
 use crate::aries_vcx::{
     handlers::issuance::holder::holder::Holder,
+    handlers::issuance::holder::ledger_artefacts::HolderLedgerArtefacts,
+    handlers::issuance::messages::CredentialIssuanceMessage,
     messages::a2a::A2AMessage,
     messages::issuance::credential_offer::CredentialOffer,
 };
@@ -194,6 +200,83 @@ pub fn send_credential_request(handle: u32, connection_handle: u32) -> VcxResult
     }).map_err(handle_err)
 }
 
+struct BatchStep {
+    handle: u32,
+    connection_handle: u32,
+    holder: Holder,
+    message: Option<CredentialIssuanceMessage>,
+    uid: Option<String>,
+}
+
+/**
+Sends credential requests of several credentials, given as pairs of (credential handle, connection handle).
+Cred defs referenced by the offers are fetched once for the whole batch and requests are created in parallel.
+Returns states, or errors of credentials which failed, in the order of input pairs. Repeated credential handles fail.
+ */
+pub fn send_credential_requests(handles: Vec<(u32, u32)>) -> VcxResult<Vec<VcxResult<u32>>> {
+    trace!("Credential::send_credential_requests >>> count: {}", handles.len());
+
+    let steps = reject_repeated_handles(handles).into_iter()
+        .map(|handles| -> VcxResult<BatchStep> {
+            let (handle, connection_handle) = handles?;
+            let holder = HANDLE_MAP.get(handle, |credential| Ok(credential.clone())).map_err(handle_err)?;
+            let my_pw_did = connection::get_pw_did(connection_handle)?;
+            Ok(BatchStep { handle, connection_handle, holder, message: Some(CredentialIssuanceMessage::CredentialRequestSend(my_pw_did)), uid: None })
+        })
+        .collect();
+    _step_batch(steps)
+}
+
+/**
+Updates state of several credentials, given as pairs of (credential handle, connection handle). Messages are
+downloaded in parallel, then received credentials are stored sharing revocation registry definitions fetched
+once for the whole batch. Returns states, or errors of credentials which failed, in the order of input pairs.
+Repeated credential handles fail.
+ */
+pub fn update_states(handles: Vec<(u32, u32)>) -> VcxResult<Vec<VcxResult<u32>>> {
+    trace!("Credential::update_states >>> count: {}", handles.len());
+
+    let steps = map_concurrently(reject_repeated_handles(handles), DEFAULT_MAX_WORKERS, |handles| -> VcxResult<BatchStep> {
+        let (handle, connection_handle) = handles?;
+        let holder = HANDLE_MAP.get(handle, |credential| Ok(credential.clone())).map_err(handle_err)?;
+        if holder.is_terminal_state() {
+            return Ok(BatchStep { handle, connection_handle, holder, message: None, uid: None });
+        }
+        let messages = connection::get_messages(connection_handle)?;
+        let (uid, message) = match holder.find_message_to_handle(messages) {
+            Some((uid, message)) => (Some(uid), Some(message.into())),
+            None => (None, None)
+        };
+        Ok(BatchStep { handle, connection_handle, holder, message, uid })
+    })?;
+    _step_batch(steps)
+}
+
+fn _step_batch(steps: Vec<VcxResult<BatchStep>>) -> VcxResult<Vec<VcxResult<u32>>> {
+    let ids = steps.iter()
+        .filter_map(|step| step.as_ref().ok())
+        .filter_map(|step| step.message.as_ref().and_then(|message| step.holder.referenced_ledger_artefacts(message).ok()))
+        .flatten()
+        .collect();
+    let artefacts = Arc::new(HolderLedgerArtefacts::resolve(ids)?);
+
+    // the holder cloned into the step only tells which ledger artefacts to fetch, the credential is stepped in place
+    let results = map_concurrently(steps, DEFAULT_MAX_WORKERS, move |step| -> VcxResult<u32> {
+        let BatchStep { handle, connection_handle, message, uid, .. } = step?;
+        HANDLE_MAP.get_mut(handle, |credential| {
+            if let Some(message) = message {
+                let send_message = connection::send_message_closure(connection_handle)?;
+                credential.step_with_artefacts(message, Some(&send_message), &artefacts)?;
+                if let Some(uid) = uid {
+                    connection::update_message_status(connection_handle, uid)?;
+                }
+            }
+            Ok(credential.get_state().into())
+        }).map_err(handle_err)
+    })?;
+    Ok(results)
+}
+
 fn get_credential_offer_msg(connection_handle: u32, msg_id: &str) -> VcxResult<String> {
     trace!("get_credential_offer_msg >>> connection_handle: {}, msg_id: {}", connection_handle, msg_id);
 
@@ -271,6 +354,36 @@ pub fn from_string(credential_data: &str) -> VcxResult<u32> {
     }
 }
 
+/**
+Deserializes credentials on several threads and stores them with single cache update.
+Fails if any of credentials cannot be deserialized, in which case none is stored.
+ */
+pub fn from_strings(credentials_data: Vec<String>) -> VcxResult<Vec<u32>> {
+    let credentials = map_concurrently(credentials_data, DEFAULT_MAX_WORKERS, |credential_data| {
+        match serde_json::from_str::<Credentials>(&credential_data) {
+            Ok(Credentials::V3(credential)) => Ok(credential),
+            Err(err) => Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize Credential: {:?}", err)))
+        }
+    })?
+        .into_iter()
+        .collect::<VcxResult<Vec<_>>>()?;
+    HANDLE_MAP.add_many(credentials)
+}
+
+pub fn to_binary(handle: u32) -> VcxResult<Vec<u8>> {
+    HANDLE_MAP.get(handle, |credential| {
+        serialization::to_binary(&Credentials::V3(credential.clone())).map_err(|err| err.into())
+    })
+}
+
+pub fn from_binary(credential_data: &[u8]) -> VcxResult<u32> {
+    let credential: Credentials = serialization::from_binary(credential_data)?;
+
+    match credential {
+        Credentials::V3(credential) => HANDLE_MAP.add(credential)
+    }
+}
+
 pub fn is_payment_required(handle: u32) -> VcxResult<bool> {
     HANDLE_MAP.get(handle, |_| {
         Ok(false)
@@ -406,6 +519,31 @@ pub mod tests {
         assert_eq!(offer_attrs, offer_attrs_expected);
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_credential_batch_request_and_store() {
+        let _setup = SetupMocks::init();
+
+        let handle_conn = connection::tests::build_test_connection_inviter_requested();
+        let offer = _get_offer(handle_conn);
+        let handle_cred_1 = credential_create_with_offer("TEST_CREDENTIAL_1", &offer).unwrap();
+        let handle_cred_2 = credential_create_with_offer("TEST_CREDENTIAL_2", &offer).unwrap();
+
+        let results = send_credential_requests(vec![(handle_cred_1, handle_conn), (handle_cred_2, handle_conn), (0, handle_conn), (handle_cred_1, handle_conn)]).unwrap();
+        assert_eq!(results[0].as_ref().unwrap(), &(HolderState::RequestSent as u32));
+        assert_eq!(results[1].as_ref().unwrap(), &(HolderState::RequestSent as u32));
+        assert_eq!(results[2].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidCredentialHandle);
+        assert_eq!(results[3].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidOption);
+        assert_eq!(HolderState::RequestSent as u32, get_state(handle_cred_2).unwrap());
+
+        AgencyMockDecrypted::set_next_decrypted_response(GET_MESSAGES_DECRYPTED_RESPONSE);
+        AgencyMockDecrypted::set_next_decrypted_message(ARIES_CREDENTIAL_RESPONSE);
+
+        let results = update_states(vec![(handle_cred_1, handle_conn)]).unwrap();
+        assert_eq!(results[0].as_ref().unwrap(), &(HolderState::Finished as u32));
+        assert_eq!(HolderState::Finished as u32, get_state(handle_cred_1).unwrap());
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_get_attributes_json_attach() {
@@ -2,6 +2,7 @@ use serde_json;
 
 use aries_vcx::handlers::issuance::credential_def::CredentialDef;
 use aries_vcx::handlers::issuance::credential_def::PublicEntityStateType;
+use aries_vcx::handlers::issuance::issuer::offer_pool::{self, OfferPoolConfig};
 use aries_vcx::libindy::utils::anoncreds;
 use aries_vcx::libindy::utils::cache::update_rev_reg_ids_cache;
 use aries_vcx::libindy::utils::payments::PaymentTxn;
@@ -62,6 +63,22 @@ pub fn get_cred_def_id(handle: u32) -> VcxResult<String> {
     })
 }
 
+pub fn enable_offer_pool(handle: u32, config: OfferPoolConfig) -> VcxResult<()> {
+    if !is_valid_handle(handle) {
+        return Err(VcxError::from(VcxErrorKind::InvalidCredDefHandle));
+    }
+    let cred_def_id = get_cred_def_id(handle)?;
+    offer_pool::enable_offer_pool(&cred_def_id, config).map_err(|err| err.into())
+}
+
+pub fn disable_offer_pool(handle: u32) -> VcxResult<()> {
+    if !is_valid_handle(handle) {
+        return Err(VcxError::from(VcxErrorKind::InvalidCredDefHandle));
+    }
+    let cred_def_id = get_cred_def_id(handle)?;
+    offer_pool::disable_offer_pool(&cred_def_id).map_err(|err| err.into())
+}
+
 pub fn get_rev_reg_id(handle: u32) -> VcxResult<String> {
     CREDENTIALDEF_MAP.get(handle, |c| {
         c.get_rev_reg_id().ok_or(VcxError::from_msg(VcxErrorKind::InvalidState, "No revocation registry found - does this credential definiton support revocation?"))
@@ -2,9 +2,11 @@ use serde_json;
 
 use aries_vcx::agency_client::mocking::AgencyMockDecrypted;
 use aries_vcx::settings::indy_mocks_enabled;
+use aries_vcx::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use aries_vcx::utils::constants::GET_MESSAGES_DECRYPTED_RESPONSE;
 use aries_vcx::utils::error;
 use aries_vcx::utils::mockdata::mockdata_proof::ARIES_PROOF_REQUEST_PRESENTATION;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::connection;
 use crate::api_lib::api_handle::object_cache::ObjectCache;
@@ -113,6 +115,36 @@ pub fn from_string(proof_data: &str) -> VcxResult<u32> {
     }
 }
 
+/**
+Deserializes proofs on several threads and stores them with single cache update.
+Fails if any of proofs cannot be deserialized, in which case none is stored.
+ */
+pub fn from_strings(proofs_data: Vec<String>) -> VcxResult<Vec<u32>> {
+    let proofs = map_concurrently(proofs_data, DEFAULT_MAX_WORKERS, |proof_data| {
+        match serde_json::from_str::<DisclosedProofs>(&proof_data) {
+            Ok(DisclosedProofs::V3(proof)) => Ok(proof),
+            Err(err) => Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("cannot deserialize DisclosedProofs object: {:?}", err)))
+        }
+    })?
+        .into_iter()
+        .collect::<VcxResult<Vec<_>>>()?;
+    HANDLE_MAP.add_many(proofs)
+}
+
+pub fn to_binary(handle: u32) -> VcxResult<Vec<u8>> {
+    HANDLE_MAP.get(handle, |proof| {
+        serialization::to_binary(&DisclosedProofs::V3(proof.clone())).map_err(|err| err.into())
+    })
+}
+
+pub fn from_binary(proof_data: &[u8]) -> VcxResult<u32> {
+    let proof: DisclosedProofs = serialization::from_binary(proof_data)?;
+
+    match proof {
+        DisclosedProofs::V3(proof) => HANDLE_MAP.add(proof)
+    }
+}
+
 pub fn release(handle: u32) -> VcxResult<()> {
     HANDLE_MAP.release(handle).map_err(handle_err)
 }
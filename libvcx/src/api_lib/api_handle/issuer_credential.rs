@@ -1,6 +1,8 @@
 use serde_json;
 
+use aries_vcx::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use aries_vcx::utils::error;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::connection;
 use crate::api_lib::api_handle::credential_def;
@@ -99,6 +101,36 @@ pub fn from_string(credential_data: &str) -> VcxResult<u32> {
     }
 }
 
+/**
+Deserializes credentials on several threads and stores them with single cache update.
+Fails if any of credentials cannot be deserialized, in which case none is stored.
+ */
+pub fn from_strings(credentials_data: Vec<String>) -> VcxResult<Vec<u32>> {
+    let credentials = map_concurrently(credentials_data, DEFAULT_MAX_WORKERS, |credential_data| {
+        match serde_json::from_str::<IssuerCredentials>(&credential_data) {
+            Ok(IssuerCredentials::V3(credential)) => Ok(credential),
+            Err(err) => Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot deserialize IssuerCredential: {:?}", err)))
+        }
+    })?
+        .into_iter()
+        .collect::<VcxResult<Vec<_>>>()?;
+    ISSUER_CREDENTIAL_MAP.add_many(credentials)
+}
+
+pub fn to_binary(handle: u32) -> VcxResult<Vec<u8>> {
+    ISSUER_CREDENTIAL_MAP.get(handle, |credential| {
+        serialization::to_binary(&IssuerCredentials::V3(credential.clone())).map_err(|err| err.into())
+    })
+}
+
+pub fn from_binary(credential_data: &[u8]) -> VcxResult<u32> {
+    let credential: IssuerCredentials = serialization::from_binary(credential_data)?;
+
+    match credential {
+        IssuerCredentials::V3(credential) => ISSUER_CREDENTIAL_MAP.add(credential)
+    }
+}
+
 pub fn generate_credential_offer_msg(handle: u32) -> VcxResult<(String, String)> {
     ISSUER_CREDENTIAL_MAP.get_mut(handle, |_| {
         Err(VcxError::from_msg(VcxErrorKind::ActionNotSupported, "Not implemented yet"))
@@ -8,3 +8,4 @@ pub mod schema;
 pub mod object_cache;
 pub mod agent;
 pub mod out_of_band;
+pub mod wallet_search;
@@ -1,12 +1,19 @@
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::ops::Deref;
 use std::ops::DerefMut;
 use std::sync::{Mutex, RwLock, RwLockReadGuard, RwLockWriteGuard};
+use std::time::Instant;
+use std::sync::Arc;
 
+use aries_vcx::agency_client::metrics;
 use rand::Rng;
 
 use crate::error::prelude::*;
 
+lazy_static! {
+    static ref OBJECT_CACHE_LOCK_WAIT: Arc<metrics::Histogram> = metrics::histogram("object_cache_lock_wait");
+}
+
 pub struct ObjectCache<T> {
     pub cache_name: String,
     pub store: RwLock<HashMap<u32, Mutex<T>>>,
@@ -50,22 +57,34 @@ impl<T> ObjectCache<T> {
 
     pub fn get<F, R>(&self, handle: u32, closure: F) -> VcxResult<R>
         where F: Fn(&T) -> VcxResult<R> {
+        let started = Instant::now();
         let store = self._lock_store_read()?;
         match store.get(&handle) {
             Some(m) => match m.lock() {
-                Ok(obj) => closure(obj.deref()),
+                Ok(obj) => {
+                    OBJECT_CACHE_LOCK_WAIT.record_duration(started.elapsed(), false);
+                    closure(obj.deref())
+                }
                 Err(_) => Err(VcxError::from_msg(VcxErrorKind::Common(10), format!("[ObjectCache: {}] Unable to lock Object Store", self.cache_name))) //TODO better error
             },
             None => Err(VcxError::from_msg(VcxErrorKind::InvalidHandle, format!("[ObjectCache: {}] Object not found for handle: {}", self.cache_name, handle)))
         }
     }
 
+    /**
+    Only the object itself is locked for the time of the closure, so objects of different handles can
+    be updated concurrently.
+     */
     pub fn get_mut<F, R>(&self, handle: u32, closure: F) -> VcxResult<R>
-        where F: Fn(&mut T) -> VcxResult<R> {
-        let mut store = self._lock_store_write()?;
-        match store.get_mut(&handle) {
+        where F: FnOnce(&mut T) -> VcxResult<R> {
+        let started = Instant::now();
+        let store = self._lock_store_read()?;
+        match store.get(&handle) {
             Some(m) => match m.lock() {
-                Ok(mut obj) => closure(obj.deref_mut()),
+                Ok(mut obj) => {
+                    OBJECT_CACHE_LOCK_WAIT.record_duration(started.elapsed(), false);
+                    closure(obj.deref_mut())
+                }
                 Err(_) => Err(VcxError::from_msg(VcxErrorKind::Common(10), format!("[ObjectCache: {}] Unable to lock Object Store", self.cache_name))) //TODO better error
             },
             None => Err(VcxError::from_msg(VcxErrorKind::InvalidHandle, format!("[ObjectCache: {}] Object not found for handle: {}", self.cache_name, handle)))
@@ -89,6 +108,26 @@ impl<T> ObjectCache<T> {
         }
     }
 
+    /**
+    Adds all objects while holding the store lock only once. Handles are returned in the order of objects.
+     */
+    pub fn add_many(&self, objs: Vec<T>) -> VcxResult<Vec<u32>> {
+        let mut store = self._lock_store_write()?;
+        store.reserve(objs.len());
+
+        let mut handles = Vec::with_capacity(objs.len());
+        let mut rng = rand::thread_rng();
+        for obj in objs {
+            let mut new_handle = rng.gen::<u32>();
+            while store.contains_key(&new_handle) {
+                new_handle = rng.gen::<u32>();
+            }
+            store.insert(new_handle, Mutex::new(obj));
+            handles.push(new_handle);
+        }
+        Ok(handles)
+    }
+
     pub fn insert(&self, handle: u32, obj: T) -> VcxResult<()> {
         let mut store = self._lock_store_write()?;
 
@@ -116,9 +155,27 @@ impl<T> ObjectCache<T> {
     }
 }
 
+/**
+Pairs up handles of a batch operation with their results, failing every repeated occurrence of the same
+object handle so that a single object is never stepped twice in one batch.
+ */
+pub fn reject_repeated_handles(handles: Vec<(u32, u32)>) -> Vec<VcxResult<(u32, u32)>> {
+    let mut seen = HashSet::new();
+    handles.into_iter()
+        .map(|(handle, connection_handle)| {
+            if seen.insert(handle) {
+                Ok((handle, connection_handle))
+            } else {
+                Err(VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Handle {} is repeated in the batch", handle)))
+            }
+        })
+        .collect()
+}
+
 #[cfg(test)]
 mod tests {
-    use crate::api_lib::api_handle::object_cache::ObjectCache;
+    use crate::api_lib::api_handle::object_cache::{ObjectCache, reject_repeated_handles};
+    use crate::error::prelude::*;
     use aries_vcx::utils::devsetup::SetupDefaults;
 
     #[test]
@@ -140,6 +197,20 @@ mod tests {
         assert_eq!(2222, rtn.unwrap())
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn add_many_test() {
+        let _setup = SetupDefaults::init();
+
+        let test: ObjectCache<u32> = ObjectCache::new("cache-add-many-u32");
+        let handles = test.add_many(vec![1, 2, 3]).unwrap();
+        assert_eq!(3, handles.len());
+        assert_eq!(3, test.len().unwrap());
+        for (handle, expected) in handles.into_iter().zip(vec![1, 2, 3]) {
+            assert_eq!(expected, test.get(handle, |obj| Ok(obj.clone())).unwrap());
+        }
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn to_string_test() {
@@ -173,4 +244,15 @@ mod tests {
 
         assert_eq!("TEST", string);
     }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn reject_repeated_handles_test() {
+        let _setup = SetupDefaults::init();
+
+        let results = reject_repeated_handles(vec![(1, 10), (2, 10), (1, 11)]);
+        assert_eq!(results[0].as_ref().unwrap(), &(1, 10));
+        assert_eq!(results[1].as_ref().unwrap(), &(2, 10));
+        assert_eq!(results[2].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidOption);
+    }
 }
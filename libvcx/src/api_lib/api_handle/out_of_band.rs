@@ -1,12 +1,10 @@
-use std::collections::HashMap;
-
 use crate::aries_vcx::handlers::out_of_band::GoalCode;
 use crate::aries_vcx::handlers::out_of_band::sender::sender::OutOfBandSender;
 use crate::aries_vcx::handlers::out_of_band::receiver::receiver::OutOfBandReceiver;
 use crate::aries_vcx::messages::connection::service::{ServiceResolvable, FullService};
 use crate::aries_vcx::messages::a2a::A2AMessage;
 use crate::api_lib::api_handle::object_cache::ObjectCache;
-use crate::api_lib::api_handle::connection::CONNECTION_MAP;
+use crate::api_lib::api_handle::connection;
 use crate::error::prelude::*;
 
 lazy_static! {
@@ -102,26 +100,10 @@ pub fn to_a2a_message(handle: u32) -> VcxResult<String> {
 
 pub fn connection_exists(handle: u32, conn_handles: Vec<u32>) -> VcxResult<(u32, bool)> {
     trace!("connection_exists >>> handle: {}, conn_handles: {:?}", handle, conn_handles);
-    let mut conn_map = HashMap::new();
-    for conn_handle in conn_handles {
-        let connection = CONNECTION_MAP.get(conn_handle, |connection| {
-                Ok(connection.clone())
-            },
-        )?;
-        conn_map.insert(conn_handle, connection);
-    };
-    let connections = conn_map.values().collect();
     OUT_OF_BAND_RECEIVER_MAP.get(handle, |oob| {
-        if let Some(connection) = oob.connection_exists(&connections)? {
-            if let Some((&handle, _)) = conn_map
-                .iter()
-                .find(|(_, conn)| *conn == connection) {
-                    Ok((handle, true))
-                } else {
-                    Err(VcxError::from(VcxErrorKind::InvalidState))
-                }
-        } else {
-            Ok((0, false))
+        match connection::find_reusable_connection(oob, &conn_handles)? {
+            Some(conn_handle) => Ok((conn_handle, true)),
+            None => Ok((0, false))
         }
     })
 }
@@ -1,15 +1,24 @@
+use std::cell::RefCell;
+use std::sync::Arc;
+
 use serde_json;
 
+use aries_vcx::utils::concurrency::{DEFAULT_MAX_WORKERS, map_concurrently};
 use aries_vcx::utils::error;
+use aries_vcx::utils::serialization;
 
 use crate::api_lib::api_handle::connection;
-use crate::api_lib::api_handle::object_cache::ObjectCache;
+use crate::api_lib::api_handle::object_cache::{ObjectCache, reject_repeated_handles};
+use crate::aries_vcx::handlers::proof_presentation::verifier::messages::VerifierMessages;
 use crate::aries_vcx::handlers::proof_presentation::verifier::verifier::Verifier;
+use crate::aries_vcx::libindy::proofs::proof_request::ProofRequestTemplate;
+use crate::aries_vcx::libindy::proofs::verifier::verifier::validate_indy_proofs;
 use crate::aries_vcx::messages::a2a::A2AMessage;
 use crate::error::prelude::*;
 
 lazy_static! {
     static ref PROOF_MAP: ObjectCache<Verifier> = ObjectCache::<Verifier>::new("proofs-cache");
+    static ref PROOF_TEMPLATE_MAP: ObjectCache<Arc<ProofRequestTemplate>> = ObjectCache::<Arc<ProofRequestTemplate>>::new("proof-templates-cache");
 }
 
 #[derive(Serialize, Deserialize, Debug)]
@@ -29,6 +38,28 @@ pub fn create_proof(source_id: String,
         .or(Err(VcxError::from(VcxErrorKind::CreateProof)))
 }
 
+pub fn create_proof_template(requested_attrs: String,
+                             requested_predicates: String,
+                             revocation_details: String,
+                             name: String) -> VcxResult<u32> {
+    let template = ProofRequestTemplate::compile(name, requested_attrs, requested_predicates, revocation_details)?;
+    PROOF_TEMPLATE_MAP.add(Arc::new(template))
+}
+
+pub fn create_proof_from_template(source_id: String, template_handle: u32) -> VcxResult<u32> {
+    // template is shared, so nonce is generated without holding the cache lock
+    let template = PROOF_TEMPLATE_MAP.get(template_handle, |template| Ok(template.clone()))
+        .map_err(|_| VcxError::from_msg(VcxErrorKind::InvalidHandle, format!("Proof template not found for handle: {}", template_handle)))?;
+    let verifier = Verifier::create_from_template(source_id, &template)?;
+    PROOF_MAP.add(verifier)
+        .or(Err(VcxError::from(VcxErrorKind::CreateProof)))
+}
+
+pub fn release_proof_template(template_handle: u32) -> VcxResult<()> {
+    PROOF_TEMPLATE_MAP.release(template_handle)
+        .map_err(|_| VcxError::from_msg(VcxErrorKind::InvalidHandle, format!("Proof template not found for handle: {}", template_handle)))
+}
+
 pub fn is_valid_handle(handle: u32) -> bool {
     PROOF_MAP.has_handle(handle)
 }
@@ -56,6 +87,80 @@ pub fn update_state(handle: u32, message: Option<&str>, connection_handle: u32)
     })
 }
 
+struct BatchStep {
+    handle: u32,
+    connection_handle: u32,
+    message: Option<(String, VerifierMessages)>,
+    presentation: Option<(String, String)>,
+}
+
+/**
+Updates state of several proofs, given as pairs of (proof handle, connection handle). Messages are downloaded
+in parallel, then received presentations are validated together, sharing ledger data fetched once for the whole
+batch. Returns states, or errors of proofs which failed, in the order of input pairs. Repeated proof handles fail.
+ */
+pub fn update_states(handles: Vec<(u32, u32)>) -> VcxResult<Vec<VcxResult<u32>>> {
+    trace!("proof::update_states >>> count: {}", handles.len());
+
+    let steps = map_concurrently(reject_repeated_handles(handles), DEFAULT_MAX_WORKERS, |handles| -> VcxResult<BatchStep> {
+        let (handle, connection_handle) = handles?;
+        let proof = PROOF_MAP.get(handle, |proof| Ok(proof.clone()))?;
+        if !proof.has_transitions() {
+            return Ok(BatchStep { handle, connection_handle, message: None, presentation: None });
+        }
+        let messages = connection::get_messages(connection_handle)?;
+        match proof.find_message_to_handle(messages) {
+            Some((uid, message)) => {
+                let message: VerifierMessages = message.into();
+                let presentation = proof.presentation_to_validate(&message)?;
+                Ok(BatchStep { handle, connection_handle, message: Some((uid, message)), presentation })
+            }
+            None => Ok(BatchStep { handle, connection_handle, message: None, presentation: None })
+        }
+    })?;
+
+    let presentations = steps.iter()
+        .filter_map(|step| step.as_ref().ok())
+        .filter_map(|step| step.presentation.clone())
+        .collect();
+    let mut validations = validate_indy_proofs(presentations)?.into_iter();
+    let steps: Vec<(VcxResult<BatchStep>, Option<aries_vcx::error::VcxResult<bool>>)> = steps.into_iter()
+        .map(|step| {
+            let validation = match &step {
+                Ok(BatchStep { presentation: Some(_), .. }) => validations.next(),
+                _ => None
+            };
+            (step, validation)
+        })
+        .collect();
+
+    // only the state machine is stepped under the proof lock, messages it sends are posted once the lock is
+    // released; if posting fails, the error is reported for the proof and the message stays pending at agency
+    let results = map_concurrently(steps, DEFAULT_MAX_WORKERS, |(step, validation)| -> VcxResult<u32> {
+        let BatchStep { handle, connection_handle, message, .. } = step?;
+        let (uid, message) = match message {
+            Some(message) => message,
+            None => return PROOF_MAP.get(handle, |proof| Ok(proof.get_state().into()))
+        };
+        let send_message = connection::send_message_closure(connection_handle)?;
+        let outbox = RefCell::new(Vec::new());
+        let state = PROOF_MAP.get_mut(handle, |proof| {
+            let queue_message = |message: &A2AMessage| -> aries_vcx::error::VcxResult<()> {
+                outbox.borrow_mut().push(message.clone());
+                Ok(())
+            };
+            proof.step_with_validation(message, Some(&queue_message), validation)?;
+            Ok(proof.get_state().into())
+        })?;
+        for message in outbox.into_inner() {
+            send_message(&message)?;
+        }
+        connection::update_message_status(connection_handle, uid)?;
+        Ok(state)
+    })?;
+    Ok(results)
+}
+
 pub fn get_state(handle: u32) -> VcxResult<u32> {
     PROOF_MAP.get(handle, |proof| {
         Ok(proof.get_state().into())
@@ -74,6 +179,7 @@ pub fn release(handle: u32) -> VcxResult<()> {
 
 pub fn release_all() {
     PROOF_MAP.drain().ok();
+    PROOF_TEMPLATE_MAP.drain().ok();
 }
 
 pub fn to_string(handle: u32) -> VcxResult<String> {
@@ -98,6 +204,36 @@ pub fn from_string(proof_data: &str) -> VcxResult<u32> {
     }
 }
 
+/**
+Deserializes proofs on several threads and stores them with single cache update.
+Fails if any of proofs cannot be deserialized, in which case none is stored.
+ */
+pub fn from_strings(proofs_data: Vec<String>) -> VcxResult<Vec<u32>> {
+    let proofs = map_concurrently(proofs_data, DEFAULT_MAX_WORKERS, |proof_data| {
+        match serde_json::from_str::<Proofs>(&proof_data) {
+            Ok(Proofs::V3(proof)) => Ok(proof),
+            Err(err) => Err(VcxError::from_msg(VcxErrorKind::InvalidJson, format!("cannot deserialize Proofs proofect: {:?}", err)))
+        }
+    })?
+        .into_iter()
+        .collect::<VcxResult<Vec<_>>>()?;
+    PROOF_MAP.add_many(proofs)
+}
+
+pub fn to_binary(handle: u32) -> VcxResult<Vec<u8>> {
+    PROOF_MAP.get(handle, |proof| {
+        serialization::to_binary(&Proofs::V3(proof.clone())).map_err(|err| err.into())
+    })
+}
+
+pub fn from_binary(proof_data: &[u8]) -> VcxResult<u32> {
+    let proof: Proofs = serialization::from_binary(proof_data)?;
+
+    match proof {
+        Proofs::V3(proof) => PROOF_MAP.add(proof)
+    }
+}
+
 pub fn generate_proof_request_msg(handle: u32) -> VcxResult<String> {
     PROOF_MAP.get_mut(handle, |proof| {
         proof.generate_presentation_request_msg().map_err(|err| err.into())
@@ -127,8 +263,8 @@ pub fn get_thread_id(handle: u32) -> VcxResult<String> {
 pub mod tests {
     use serde_json::Value;
 
-    use aries_vcx::agency_client::mocking::HttpClientMockResponse;
-    use aries_vcx::utils::constants::{PROOF_REJECT_RESPONSE_STR_V2, REQUESTED_ATTRS, REQUESTED_PREDICATES, V3_OBJECT_SERIALIZE_VERSION};
+    use aries_vcx::agency_client::mocking::{AgencyMockDecrypted, HttpClientMockResponse};
+    use aries_vcx::utils::constants::{GET_MESSAGES_DECRYPTED_RESPONSE, PROOF_REJECT_RESPONSE_STR_V2, REQUESTED_ATTRS, REQUESTED_PREDICATES, V3_OBJECT_SERIALIZE_VERSION};
     use aries_vcx::utils::devsetup::SetupMocks;
     use aries_vcx::utils::mockdata::mock_settings::MockBuilder;
     use aries_vcx::utils::mockdata::mockdata_proof;
@@ -155,6 +291,29 @@ pub mod tests {
         create_default_proof();
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_create_proof_from_template() {
+        let _setup = SetupMocks::init();
+
+        let template_handle = create_proof_template(REQUESTED_ATTRS.to_owned(),
+                                                    REQUESTED_PREDICATES.to_owned(),
+                                                    r#"{"support_revocation":false}"#.to_string(),
+                                                    "Optional".to_owned()).unwrap();
+        let handle_1 = create_proof_from_template("1".to_string(), template_handle).unwrap();
+        let handle_2 = create_proof_from_template("2".to_string(), template_handle).unwrap();
+        assert_eq!(get_state(handle_1).unwrap(), VerifierState::Initial as u32);
+        assert_eq!(get_source_id(handle_2).unwrap(), "2");
+
+        let request_1: Value = serde_json::from_str(&generate_proof_request_msg(handle_1).unwrap()).unwrap();
+        let request_2: Value = serde_json::from_str(&generate_proof_request_msg(handle_2).unwrap()).unwrap();
+        assert_ne!(request_1["request_presentations~attach"], request_2["request_presentations~attach"]);
+
+        release_proof_template(template_handle).unwrap();
+        assert_eq!(create_proof_from_template("3".to_string(), template_handle).unwrap_err().kind(), VcxErrorKind::InvalidHandle);
+        assert_eq!(create_proof_template("invalid".to_owned(), "[]".to_owned(), "{}".to_owned(), "Optional".to_owned()).unwrap_err().kind(), VcxErrorKind::InvalidJson);
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_revocation_details() {
@@ -286,6 +445,29 @@ pub mod tests {
         assert_eq!(get_state(handle_proof).unwrap(), VerifierState::Finished as u32);
     }
 
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_update_states_validates_presentations_in_batch() {
+        let _setup = SetupMocks::init();
+        let _mock_builder = MockBuilder::init().
+            set_mock_result_for_validate_indy_proof(Ok(true));
+
+        let handle_conn = build_test_connection_inviter_requested();
+        let handle_proof = create_default_proof();
+        send_proof_request(handle_proof, handle_conn, _comment()).unwrap();
+
+        let presentation = mockdata_proof::ARIES_PROOF_PRESENTATION
+            .replace("4e62363d-6348-4b59-9d98-a86497f9301b", &get_thread_id(handle_proof).unwrap());
+        AgencyMockDecrypted::set_next_decrypted_response(GET_MESSAGES_DECRYPTED_RESPONSE);
+        AgencyMockDecrypted::set_next_decrypted_message(&presentation);
+
+        let results = update_states(vec![(handle_proof, handle_conn), (handle_proof, handle_conn), (0, handle_conn)]).unwrap();
+        assert_eq!(results[0].as_ref().unwrap(), &(VerifierState::Finished as u32));
+        assert_eq!(results[1].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidOption);
+        assert_eq!(results[2].as_ref().unwrap_err().kind(), VcxErrorKind::InvalidHandle);
+        assert_eq!(get_state(handle_proof).unwrap(), VerifierState::Finished as u32);
+    }
+
     #[test]
     #[cfg(feature = "general_test")]
     fn test_update_state_with_reject_message() {
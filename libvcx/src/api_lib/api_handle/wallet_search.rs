@@ -0,0 +1,77 @@
+use aries_vcx::libindy::utils::wallet_search::{count_records, SearchProjection, WalletSearch};
+
+use crate::api_lib::api_handle::object_cache::ObjectCache;
+use crate::error::prelude::*;
+
+lazy_static! {
+    static ref WALLET_SEARCH_MAP: ObjectCache<WalletSearch> = ObjectCache::<WalletSearch>::new("wallet-search-cache");
+}
+
+pub fn is_valid_handle(handle: u32) -> bool {
+    WALLET_SEARCH_MAP.has_handle(handle)
+}
+
+pub fn open_cursor(xtype: &str, query: &str, projection_json: &str, page_size: usize) -> VcxResult<u32> {
+    trace!("open_cursor >>> xtype: {}, query: {}, projection: {}, page_size: {}", secret!(xtype), secret!(query), projection_json, page_size);
+    let projection: SearchProjection = serde_json::from_str(projection_json)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Cannot deserialize search projection: {}", err)))?;
+    let search = WalletSearch::open(xtype, query, projection, page_size)?;
+    WALLET_SEARCH_MAP.add(search)
+}
+
+///
+/// Returns JSON array with next page of records. Cursor is released once an empty page is returned.
+///
+pub fn next_page(handle: u32) -> VcxResult<String> {
+    trace!("next_page >>> handle: {}", handle);
+    let (records, finished) = WALLET_SEARCH_MAP.get_mut(handle, |search| {
+        let records = search.next_page()?;
+        Ok((records, search.is_finished()))
+    })?;
+    if records.is_empty() && finished {
+        release(handle)?;
+    }
+    serde_json::to_string(&records)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::SerializationError, format!("Cannot serialize wallet records: {}", err)))
+}
+
+pub fn count(xtype: &str, query: &str) -> VcxResult<usize> {
+    count_records(xtype, query).map_err(|err| err.into())
+}
+
+pub fn release(handle: u32) -> VcxResult<()> {
+    WALLET_SEARCH_MAP.release(handle)
+        .or(Err(VcxError::from(VcxErrorKind::InvalidHandle)))
+}
+
+pub fn release_all() {
+    WALLET_SEARCH_MAP.drain().ok();
+}
+
+#[cfg(test)]
+pub mod tests {
+    use aries_vcx::utils::devsetup::SetupMocks;
+
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_cursor_is_released_after_last_page() {
+        let _setup = SetupMocks::init();
+
+        let handle = open_cursor("type1", "{}", "{}", 10).unwrap();
+        assert!(is_valid_handle(handle));
+        assert_eq!(next_page(handle).unwrap(), "[]");
+        assert!(!is_valid_handle(handle));
+        assert_eq!(next_page(handle).unwrap_err().kind(), VcxErrorKind::InvalidHandle);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_open_cursor_fails_for_invalid_projection() {
+        let _setup = SetupMocks::init();
+
+        assert_eq!(open_cursor("type1", "{}", "[]", 10).unwrap_err().kind(), VcxErrorKind::InvalidOption);
+        assert_eq!(open_cursor("type1", "{}", "{}", 0).unwrap_err().kind(), VcxErrorKind::InvalidOption);
+    }
+}
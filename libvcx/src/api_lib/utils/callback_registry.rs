@@ -0,0 +1,183 @@
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::Mutex;
+
+use aries_vcx::indy_sys::CommandHandle;
+
+use crate::api_lib::utils::callback::POISON_MSG;
+
+/*
+Command handle layout (always positive i32):
+  bits 0-15   slot index within shard
+  bits 16-19  shard index
+  bits 20-30  slot generation, never 0
+Generation is bumped whenever slot is released, so late or duplicate callbacks with handle of
+previous occupant of the slot are rejected instead of invoking closure of the new one.
+ */
+const SLOT_BITS: u32 = 16;
+const SHARD_BITS: u32 = 4;
+const GENERATION_BITS: u32 = 11;
+
+const SHARD_COUNT: usize = 1 << SHARD_BITS;
+const MAX_SLOTS_PER_SHARD: usize = 1 << SLOT_BITS;
+const MAX_GENERATION: u32 = (1 << GENERATION_BITS) - 1;
+const PREALLOCATED_SLOTS_PER_SHARD: usize = 64;
+
+struct Slot<T> {
+    generation: u32,
+    value: Option<T>,
+}
+
+struct Shard<T> {
+    slots: Vec<Slot<T>>,
+    free: Vec<usize>,
+}
+
+impl<T> Shard<T> {
+    fn new() -> Shard<T> {
+        Shard {
+            slots: (0..PREALLOCATED_SLOTS_PER_SHARD).map(|_| Slot { generation: 1, value: None }).collect(),
+            free: (0..PREALLOCATED_SLOTS_PER_SHARD).rev().collect(),
+        }
+    }
+
+    fn insert(&mut self, value: T) -> Option<(usize, u32)> {
+        let index = match self.free.pop() {
+            Some(index) => index,
+            None if self.slots.len() < MAX_SLOTS_PER_SHARD => {
+                self.slots.push(Slot { generation: 1, value: None });
+                self.slots.len() - 1
+            }
+            None => return None
+        };
+        let slot = &mut self.slots[index];
+        slot.value = Some(value);
+        Some((index, slot.generation))
+    }
+
+    fn take(&mut self, index: usize, generation: u32) -> Option<T> {
+        let slot = self.slots.get_mut(index)?;
+        if slot.generation != generation {
+            return None;
+        }
+        let value = slot.value.take()?;
+        slot.generation = if slot.generation >= MAX_GENERATION { 1 } else { slot.generation + 1 };
+        self.free.push(index);
+        Some(value)
+    }
+}
+
+/**
+Registry of pending callback closures keyed by command handle. Closures are spread over
+independently locked shards of pre-allocated slots, so concurrent commands rarely wait on
+each other and registering a callback does not allocate map nodes.
+ */
+pub struct CallbackRegistry<T> {
+    shards: Vec<Mutex<Shard<T>>>,
+    next_shard: AtomicUsize,
+}
+
+impl<T> CallbackRegistry<T> {
+    pub fn new() -> CallbackRegistry<T> {
+        CallbackRegistry {
+            shards: (0..SHARD_COUNT).map(|_| Mutex::new(Shard::new())).collect(),
+            next_shard: AtomicUsize::new(0),
+        }
+    }
+
+    pub fn insert(&self, value: T) -> Option<CommandHandle> {
+        let first_shard = self.next_shard.fetch_add(1, Ordering::Relaxed) % SHARD_COUNT;
+        let mut value = Some(value);
+        for offset in 0..SHARD_COUNT {
+            let shard_index = (first_shard + offset) % SHARD_COUNT;
+            let mut shard = self.shards[shard_index].lock().expect(POISON_MSG);
+            if shard.free.is_empty() && shard.slots.len() >= MAX_SLOTS_PER_SHARD {
+                continue;
+            }
+            if let Some((slot_index, generation)) = shard.insert(value.take()?) {
+                return Some(_encode_handle(shard_index, slot_index, generation));
+            }
+        }
+        None
+    }
+
+    pub fn take(&self, command_handle: CommandHandle) -> Option<T> {
+        let (shard_index, slot_index, generation) = _decode_handle(command_handle)?;
+        let value = self.shards[shard_index].lock().expect(POISON_MSG).take(slot_index, generation);
+        if value.is_none() {
+            warn!("Unable to find callback in registry for command handle {}", command_handle);
+        }
+        value
+    }
+}
+
+impl<T> Default for CallbackRegistry<T> {
+    fn default() -> Self {
+        CallbackRegistry::new()
+    }
+}
+
+fn _encode_handle(shard_index: usize, slot_index: usize, generation: u32) -> CommandHandle {
+    ((generation << (SLOT_BITS + SHARD_BITS)) | ((shard_index as u32) << SLOT_BITS) | slot_index as u32) as CommandHandle
+}
+
+fn _decode_handle(command_handle: CommandHandle) -> Option<(usize, usize, u32)> {
+    if command_handle <= 0 {
+        return None;
+    }
+    let handle = command_handle as u32;
+    let slot_index = (handle & ((1 << SLOT_BITS) - 1)) as usize;
+    let shard_index = ((handle >> SLOT_BITS) & ((1 << SHARD_BITS) - 1)) as usize;
+    let generation = handle >> (SLOT_BITS + SHARD_BITS);
+    Some((shard_index, slot_index, generation))
+}
+
+#[cfg(test)]
+#[cfg(feature = "general_test")]
+mod tests {
+    use super::*;
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_insert_and_take() {
+        let registry: CallbackRegistry<u32> = CallbackRegistry::new();
+        let handle_1 = registry.insert(1).unwrap();
+        let handle_2 = registry.insert(2).unwrap();
+        assert!(handle_1 > 0);
+        assert_ne!(handle_1, handle_2);
+
+        assert_eq!(registry.take(handle_2), Some(2));
+        assert_eq!(registry.take(handle_1), Some(1));
+        assert_eq!(registry.take(handle_1), None);
+        assert_eq!(registry.take(0), None);
+        assert_eq!(registry.take(-1), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_stale_handle_is_rejected() {
+        let registry: CallbackRegistry<u32> = CallbackRegistry::new();
+        let stale_handle = registry.insert(1).unwrap();
+        assert_eq!(registry.take(stale_handle), Some(1));
+
+        // occupy every pre-allocated slot so the released one gets reused
+        let handles: Vec<CommandHandle> = (0..SHARD_COUNT * PREALLOCATED_SLOTS_PER_SHARD)
+            .map(|i| registry.insert(i as u32).unwrap())
+            .collect();
+        assert!(!handles.contains(&stale_handle));
+        assert_eq!(registry.take(stale_handle), None);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_generation_wraps_to_positive_handle() {
+        let mut shard: Shard<u32> = Shard::new();
+        shard.slots[0].generation = MAX_GENERATION;
+        shard.free = vec![0];
+        let (slot_index, generation) = shard.insert(1).unwrap();
+        let handle = _encode_handle(SHARD_COUNT - 1, slot_index, generation);
+        assert!(handle > 0);
+        assert_eq!(_decode_handle(handle), Some((SHARD_COUNT - 1, 0, MAX_GENERATION)));
+        assert_eq!(shard.take(slot_index, generation), Some(1));
+        assert_eq!(shard.slots[0].generation, 1);
+    }
+}
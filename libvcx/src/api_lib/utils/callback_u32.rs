@@ -1,42 +1,44 @@
-use std::collections::HashMap;
-use std::ops::Deref;
-use std::sync::Mutex;
-
 use libc::c_char;
 
 use aries_vcx::indy_sys::CommandHandle;
 
-use crate::api_lib::utils::callback::{build_buf, build_string, get_cb};
+use crate::api_lib::utils::callback::{build_buf, build_string};
+use crate::api_lib::utils::callback_registry::CallbackRegistry;
 
+/*
+Closures waiting for the callbacks of vcx C API calls made through return_types_u32, i.e. by
+tests and embedders calling libvcx from Rust. Callbacks of libindy calls made by aries_vcx are
+dispatched by the futures of the indy crate and do not go through these registries.
+ */
 lazy_static! {
-    pub static ref CALLBACKS_U32: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_U32: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, u32) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_I32: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, i32) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_STR: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, Option<String>) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_U32_STR: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, u32, Option<String>) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_STR_STR: Mutex<HashMap <CommandHandle, Box<dyn FnMut(u32, Option<String>, Option<String>) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_BOOL: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, bool) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_BIN: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, Vec<u8>) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_OPTSTR_BIN: Mutex<HashMap<CommandHandle,Box<dyn FnMut(u32, Option<String>, Vec<u8>) + Send>>> = Default::default();
-    pub static ref CALLBACKS_U32_U32_STR_STR_STR: Mutex<HashMap<CommandHandle, Box<dyn FnMut(u32, u32, Option<String>, Option<String>, Option<String>) + Send>>> = Default::default();
+    pub static ref CALLBACKS_U32: CallbackRegistry<Box<dyn FnMut(u32) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_U32: CallbackRegistry<Box<dyn FnMut(u32, u32) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_I32: CallbackRegistry<Box<dyn FnMut(u32, i32) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_STR: CallbackRegistry<Box<dyn FnMut(u32, Option<String>) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_U32_STR: CallbackRegistry<Box<dyn FnMut(u32, u32, Option<String>) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_STR_STR: CallbackRegistry<Box<dyn FnMut(u32, Option<String>, Option<String>) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_BOOL: CallbackRegistry<Box<dyn FnMut(u32, bool) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_BIN: CallbackRegistry<Box<dyn FnMut(u32, Vec<u8>) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_OPTSTR_BIN: CallbackRegistry<Box<dyn FnMut(u32, Option<String>, Vec<u8>) + Send>> = Default::default();
+    pub static ref CALLBACKS_U32_U32_STR_STR_STR: CallbackRegistry<Box<dyn FnMut(u32, u32, Option<String>, Option<String>, Option<String>) + Send>> = Default::default();
 }
 
 pub extern "C" fn call_cb_u32(command_handle: CommandHandle, arg1: u32) {
-    let cb = get_cb(command_handle, CALLBACKS_U32.deref());
+    let cb = CALLBACKS_U32.take(command_handle);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1)
     }
 }
 
 pub extern "C" fn call_cb_u32_u32(command_handle: CommandHandle, arg1: u32, arg2: u32) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_U32.deref());
+    let cb = CALLBACKS_U32_U32.take(command_handle);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, arg2)
     }
 }
 
 pub extern "C" fn call_cb_u32_u32_str(command_handle: CommandHandle, arg1: u32, arg2: u32, arg3: *const c_char) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_U32_STR.deref());
+    let cb = CALLBACKS_U32_U32_STR.take(command_handle);
     let str1 = build_string(arg3);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, arg2, str1)
@@ -44,14 +46,14 @@ pub extern "C" fn call_cb_u32_u32_str(command_handle: CommandHandle, arg1: u32,
 }
 
 pub extern "C" fn call_cb_u32_i32(command_handle: CommandHandle, arg1: u32, arg2: i32) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_I32.deref());
+    let cb = CALLBACKS_U32_I32.take(command_handle);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, arg2)
     }
 }
 
 pub extern "C" fn call_cb_u32_str(command_handle: CommandHandle, arg1: u32, arg2: *const c_char) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_STR.deref());
+    let cb = CALLBACKS_U32_STR.take(command_handle);
     let str1 = build_string(arg2);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, str1)
@@ -59,7 +61,7 @@ pub extern "C" fn call_cb_u32_str(command_handle: CommandHandle, arg1: u32, arg2
 }
 
 pub extern "C" fn call_cb_u32_str_str(command_handle: CommandHandle, arg1: u32, arg2: *const c_char, arg3: *const c_char) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_STR_STR.deref());
+    let cb = CALLBACKS_U32_STR_STR.take(command_handle);
     let str1 = build_string(arg2);
     let str2 = build_string(arg3);
     if let Some(mut cb_fn) = cb {
@@ -68,14 +70,14 @@ pub extern "C" fn call_cb_u32_str_str(command_handle: CommandHandle, arg1: u32,
 }
 
 pub extern "C" fn call_cb_u32_bool(command_handle: CommandHandle, arg1: u32, arg2: bool) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_BOOL.deref());
+    let cb = CALLBACKS_U32_BOOL.take(command_handle);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, arg2)
     }
 }
 
 pub extern "C" fn call_cb_u32_bin(command_handle: CommandHandle, arg1: u32, buf: *const u8, len: u32) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_BIN.deref());
+    let cb = CALLBACKS_U32_BIN.take(command_handle);
     let data = build_buf(buf, len);
     if let Some(mut cb_fn) = cb {
         cb_fn(arg1, data)
@@ -83,7 +85,7 @@ pub extern "C" fn call_cb_u32_bin(command_handle: CommandHandle, arg1: u32, buf:
 }
 
 pub extern "C" fn call_cb_u32_str_bin(command_handle: CommandHandle, arg1: u32, arg2: *const c_char, buf: *const u8, len: u32) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_OPTSTR_BIN.deref());
+    let cb = CALLBACKS_U32_OPTSTR_BIN.take(command_handle);
     let data = build_buf(buf, len);
 
     let str1 = build_string(arg2);
@@ -94,7 +96,7 @@ pub extern "C" fn call_cb_u32_str_bin(command_handle: CommandHandle, arg1: u32,
 }
 
 pub extern "C" fn call_cb_u32_u32_str_str_str(command_handle: CommandHandle, arg1: u32, arg2: u32, arg3: *const c_char, arg4: *const c_char, arg5: *const c_char) {
-    let cb = get_cb(command_handle, CALLBACKS_U32_U32_STR_STR_STR.deref());
+    let cb = CALLBACKS_U32_U32_STR_STR_STR.take(command_handle);
     let str1 = build_string(arg3);
     let str2 = build_string(arg4);
     let str3 = build_string(arg5);
@@ -126,14 +128,14 @@ mod tests {
 
     #[test]
     #[cfg(feature = "general_test")]
-    fn test_get_cb() {
-        let mutex_map: Mutex<HashMap<u32, Box<dyn FnMut(u32) + Send>>> = Default::default();
-        assert!(get_cb(2123, &mutex_map).is_none());
+    fn test_take_cb() {
+        let registry: CallbackRegistry<Box<dyn FnMut(u32) + Send>> = Default::default();
+        assert!(registry.take(2123).is_none());
 
         let closure: Box<dyn FnMut(u32) + Send> = Box::new(move |_| {});
 
-        mutex_map.lock().unwrap().insert(2123, closure);
-        let cb = get_cb(2123, &mutex_map);
+        let command_handle = registry.insert(closure).unwrap();
+        let cb = registry.take(command_handle);
         assert!(cb.is_some());
     }
 }
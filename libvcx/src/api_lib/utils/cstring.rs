@@ -59,6 +59,21 @@ macro_rules! check_useful_opt_c_str {
     }
 }
 
+macro_rules! check_useful_c_str_array {
+    ($ptr:ident, $len:expr, $e:expr) => {
+        if $ptr.is_null() || $len == 0 {
+            return VcxError::from_msg($e, "Invalid pointer or empty array has been passed").into()
+        }
+
+        let $ptr = match unsafe { std::slice::from_raw_parts($ptr, $len as usize) }.iter()
+            .map(|item| CStringUtils::c_str_to_string(*item).ok().and_then(|val| val))
+            .collect::<Option<Vec<String>>>() {
+            Some(val) => val,
+            None => return VcxError::from_msg($e, "Invalid pointer has been passed in array").into()
+        };
+    }
+}
+
 /// Vector helpers
 macro_rules! check_useful_c_byte_array {
     ($ptr:ident, $len:expr, $err1:expr, $err2:expr) => {
@@ -4,10 +4,16 @@ extern crate env_logger;
 extern crate libc;
 extern crate log;
 
+use std::borrow::Cow;
 use std::env;
 use std::ffi::CString;
 use std::io::Write;
 use std::ptr;
+use std::sync::Arc;
+use std::sync::atomic::{AtomicU32, Ordering};
+use std::sync::mpsc::{self, Receiver, SyncSender, TrySendError};
+use std::thread;
+use std::time::Duration;
 
 pub use aries_vcx::indy_sys::{CVoid, logger::{EnabledCB, FlushCB, LogCB}};
 use aries_vcx::libindy;
@@ -28,16 +34,27 @@ static mut ENABLED_CB: Option<EnabledCB> = None;
 static mut LOG_CB: Option<LogCB> = None;
 static mut FLUSH_CB: Option<FlushCB> = None;
 
+const DEFAULT_LOG_BUFFER_SIZE: usize = 8192;
+const LOG_BATCH_SIZE: usize = 128;
+const LOG_FLUSH_TIMEOUT: Duration = Duration::from_secs(5);
+
+pub type LogBatchCB = extern fn(context: *const CVoid,
+                                records: *const LogRecord,
+                                count: u32,
+                                dropped: u32);
+
 #[derive(Debug, PartialEq)]
 pub enum LoggerState {
     Default,
     Custom,
+    Batch,
 }
 
 impl LoggerState {
     pub fn get(&self) -> (*const CVoid, Option<EnabledCB>, Option<LogCB>, Option<FlushCB>) {
         match self {
-            LoggerState::Default => (ptr::null(), Some(LibvcxDefaultLogger::enabled), Some(LibvcxDefaultLogger::log), Some(LibvcxDefaultLogger::flush)),
+            // these handlers go through log::logger(), which is the batch logger once it is installed
+            LoggerState::Default | LoggerState::Batch => (ptr::null(), Some(LibvcxDefaultLogger::enabled), Some(LibvcxDefaultLogger::log), Some(LibvcxDefaultLogger::flush)),
             LoggerState::Custom => unsafe { (CONTEXT, ENABLED_CB, LOG_CB, FLUSH_CB) },
         }
     }
@@ -121,6 +138,184 @@ impl log::Log for LibvcxLogger {
     }
 }
 
+/// Log record passed to the batch log handler. Pointers are valid only during the handler call.
+#[repr(C)]
+pub struct LogRecord {
+    pub level: u32,
+    pub target: *const c_char,
+    pub message: *const c_char,
+    pub module_path: *const c_char,
+    pub file: *const c_char,
+    pub line: u32,
+}
+
+struct BufferedRecord {
+    level: Level,
+    target: String,
+    message: String,
+    module_path: Option<Cow<'static, str>>,
+    file: Option<Cow<'static, str>>,
+    line: u32,
+}
+
+enum BufferedEntry {
+    Record(BufferedRecord),
+    Flush(SyncSender<()>),
+}
+
+struct BatchHandlers {
+    context: *const CVoid,
+    log_batch: LogBatchCB,
+    flush: Option<FlushCB>,
+    dropped: Arc<AtomicU32>,
+}
+
+unsafe impl Send for BatchHandlers {}
+
+/**
+Logger which only formats enabled records on the emitting thread and passes them through a bounded
+buffer to a dedicated thread, which hands them over to the host in batches. Records are dropped
+rather than blocking the emitting thread when the buffer is full; the number of dropped records is
+reported with the next batch. Buffered records are handed over and the host flush handler is called
+when the logger is flushed or dropped.
+ */
+pub struct LibvcxBatchLogger {
+    max_level: Level,
+    sender: SyncSender<BufferedEntry>,
+    dropped: Arc<AtomicU32>,
+}
+
+impl LibvcxBatchLogger {
+    fn new(context: *const CVoid, max_level: u32, log_batch: LogBatchCB, flush: Option<FlushCB>, buffer_size: usize) -> VcxResult<LibvcxBatchLogger> {
+        let max_level = match max_level {
+            1..=5 => get_level(max_level),
+            _ => return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Invalid log level: {}", max_level)))
+        };
+        let buffer_size = if buffer_size == 0 { DEFAULT_LOG_BUFFER_SIZE } else { buffer_size };
+        let (sender, receiver) = mpsc::sync_channel(buffer_size);
+        let dropped = Arc::new(AtomicU32::new(0));
+
+        let handlers = BatchHandlers { context, log_batch, flush, dropped: dropped.clone() };
+        thread::Builder::new()
+            .name("vcx-logger".to_string())
+            .spawn(move || _drain_log_buffer(receiver, handlers))
+            .map_err(|err| VcxError::from_msg(VcxErrorKind::LoggingError, format!("Cannot start logging thread: {}", err)))?;
+
+        Ok(LibvcxBatchLogger { max_level, sender, dropped })
+    }
+
+    pub fn init(context: *const CVoid, max_level: u32, log_batch: LogBatchCB, flush: Option<FlushCB>, buffer_size: usize) -> VcxResult<()> {
+        trace!("LibvcxBatchLogger::init >>>");
+        let logger = LibvcxBatchLogger::new(context, max_level, log_batch, flush, buffer_size)?;
+        let max_level = logger.max_level;
+        log::set_boxed_logger(Box::new(logger))
+            .map_err(|err| VcxError::from_msg(VcxErrorKind::LoggingError, format!("Setting logger failed with: {}", err)))?;
+        log::set_max_level(max_level.to_level_filter());
+
+        libindy::utils::logger::set_logger(log::logger())
+            .map_err(|err| err.map(aries_vcx::error::VcxErrorKind::LoggingError, "Setting logger failed"))?;
+
+        unsafe {
+            LOGGER_STATE = LoggerState::Batch;
+        }
+
+        Ok(())
+    }
+}
+
+impl log::Log for LibvcxBatchLogger {
+    fn enabled(&self, metadata: &Metadata) -> bool {
+        metadata.level() <= self.max_level
+    }
+
+    fn log(&self, record: &Record) {
+        if !self.enabled(record.metadata()) {
+            return;
+        }
+        let record = BufferedRecord {
+            level: record.level(),
+            target: record.target().to_string(),
+            message: record.args().to_string(),
+            module_path: record.module_path_static().map(Cow::Borrowed).or_else(|| record.module_path().map(|a| Cow::Owned(a.to_string()))),
+            file: record.file_static().map(Cow::Borrowed).or_else(|| record.file().map(|a| Cow::Owned(a.to_string()))),
+            line: record.line().unwrap_or(0),
+        };
+        match self.sender.try_send(BufferedEntry::Record(record)) {
+            Ok(()) => {}
+            Err(TrySendError::Full(_)) | Err(TrySendError::Disconnected(_)) => {
+                self.dropped.fetch_add(1, Ordering::Relaxed);
+            }
+        }
+    }
+
+    fn flush(&self) {
+        let (ack_sender, ack_receiver) = mpsc::sync_channel(1);
+        if self.sender.send(BufferedEntry::Flush(ack_sender)).is_ok() {
+            ack_receiver.recv_timeout(LOG_FLUSH_TIMEOUT).ok();
+        }
+    }
+}
+
+impl Drop for LibvcxBatchLogger {
+    fn drop(&mut self) {
+        log::Log::flush(self)
+    }
+}
+
+fn _drain_log_buffer(receiver: Receiver<BufferedEntry>, handlers: BatchHandlers) {
+    let mut batch: Vec<BufferedRecord> = Vec::with_capacity(LOG_BATCH_SIZE);
+    while let Ok(entry) = receiver.recv() {
+        let mut flush_ack = None;
+        match entry {
+            BufferedEntry::Record(record) => batch.push(record),
+            BufferedEntry::Flush(ack) => flush_ack = Some(ack)
+        }
+        while flush_ack.is_none() && batch.len() < LOG_BATCH_SIZE {
+            match receiver.try_recv() {
+                Ok(BufferedEntry::Record(record)) => batch.push(record),
+                Ok(BufferedEntry::Flush(ack)) => flush_ack = Some(ack),
+                Err(_) => break
+            }
+        }
+        _emit_log_batch(&handlers, &batch);
+        batch.clear();
+        if let Some(ack) = flush_ack {
+            if let Some(flush_cb) = handlers.flush {
+                flush_cb(handlers.context)
+            }
+            ack.send(()).ok();
+        }
+    }
+}
+
+fn _emit_log_batch(handlers: &BatchHandlers, batch: &[BufferedRecord]) {
+    let dropped = handlers.dropped.swap(0, Ordering::Relaxed);
+    if batch.is_empty() && dropped == 0 {
+        return;
+    }
+    let to_cstring = |value: &str| CString::new(value).unwrap_or_default();
+    let strings: Vec<(CString, CString, Option<CString>, Option<CString>)> = batch.iter()
+        .map(|record| (
+            to_cstring(&record.target),
+            to_cstring(&record.message),
+            record.module_path.as_ref().map(|a| to_cstring(a)),
+            record.file.as_ref().map(|a| to_cstring(a))
+        ))
+        .collect();
+    let records: Vec<LogRecord> = batch.iter().zip(strings.iter())
+        .map(|(record, (target, message, module_path, file))| LogRecord {
+            level: record.level as u32,
+            target: target.as_ptr(),
+            message: message.as_ptr(),
+            module_path: module_path.as_ref().map(|p| p.as_ptr()).unwrap_or(ptr::null()),
+            file: file.as_ref().map(|p| p.as_ptr()).unwrap_or(ptr::null()),
+            line: record.line,
+        })
+        .collect();
+
+    (handlers.log_batch)(handlers.context, records.as_ptr(), records.len() as u32, dropped)
+}
+
 // From: https://www.tutorialspoint.com/log4j/log4j_logging_levels.htm
 //
 //DEBUG	Designates fine-grained informational events that are most useful to debug an application.
@@ -234,6 +429,9 @@ fn get_level(level: u32) -> Level {
 
 #[cfg(test)]
 mod tests {
+    use std::slice;
+    use std::sync::Mutex;
+
     use super::*;
 
     fn get_custom_context() -> *const CVoid {
@@ -256,6 +454,128 @@ mod tests {
         unsafe { COUNT = COUNT + 1 }
     }
 
+    #[derive(Default)]
+    struct CollectedLogs {
+        batches: Vec<Vec<(u32, String)>>,
+        dropped: u32,
+        flushes: u32,
+    }
+
+    // passed to the batch handlers as context, so tests do not share any state
+    #[derive(Default)]
+    struct LogCollector {
+        gate: Mutex<()>,
+        logs: Mutex<CollectedLogs>,
+    }
+
+    impl LogCollector {
+        fn context(&self) -> *const CVoid {
+            self as *const LogCollector as *const CVoid
+        }
+
+        fn messages(&self) -> Vec<(u32, String)> {
+            self.logs.lock().unwrap().batches.concat()
+        }
+    }
+
+    extern fn collect_log_batch(context: *const CVoid, records: *const LogRecord, count: u32, dropped: u32) {
+        let collector = unsafe { &*(context as *const LogCollector) };
+        let _gate = collector.gate.lock().unwrap();
+        let records = unsafe { slice::from_raw_parts(records, count as usize) };
+        let batch = records.iter()
+            .map(|record| (record.level, CStringUtils::c_str_to_string(record.message).unwrap().unwrap()))
+            .collect();
+        let mut logs = collector.logs.lock().unwrap();
+        logs.batches.push(batch);
+        logs.dropped += dropped;
+    }
+
+    extern fn collect_flush(context: *const CVoid) {
+        let collector = unsafe { &*(context as *const LogCollector) };
+        collector.logs.lock().unwrap().flushes += 1;
+    }
+
+    fn _log(logger: &LibvcxBatchLogger, level: Level, message: &str) {
+        log::Log::log(logger, &Record::builder()
+            .args(format_args!("{}", message))
+            .level(level)
+            .target("test")
+            .build());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_batch_logger_filters_by_level() {
+        let collector = LogCollector::default();
+        let logger = LibvcxBatchLogger::new(collector.context(), 3, collect_log_batch, Some(collect_flush), 0).unwrap();
+
+        _log(&logger, Level::Error, "error");
+        _log(&logger, Level::Debug, "debug");
+        _log(&logger, Level::Info, "info");
+        _log(&logger, Level::Trace, "trace");
+        log::Log::flush(&logger);
+
+        assert_eq!(collector.messages(), vec![(Level::Error as u32, "error".to_string()), (Level::Info as u32, "info".to_string())]);
+        assert_eq!(collector.logs.lock().unwrap().flushes, 1);
+        assert!(LibvcxBatchLogger::new(collector.context(), 6, collect_log_batch, None, 0).is_err());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_batch_logger_splits_buffered_records_into_batches() {
+        let collector = LogCollector::default();
+        let logger = LibvcxBatchLogger::new(collector.context(), 5, collect_log_batch, Some(collect_flush), 0).unwrap();
+        let count = 2 * LOG_BATCH_SIZE + 1;
+
+        // hold the handler so the records pile up in the buffer
+        let gate = collector.gate.lock().unwrap();
+        for i in 0..count {
+            _log(&logger, Level::Info, &format!("message {}", i));
+        }
+        drop(gate);
+        log::Log::flush(&logger);
+
+        let logs = collector.logs.lock().unwrap();
+        assert!(logs.batches.len() >= 3);
+        assert!(logs.batches.iter().all(|batch| batch.len() <= LOG_BATCH_SIZE));
+        assert_eq!(logs.dropped, 0);
+        let messages: Vec<String> = logs.batches.concat().into_iter().map(|(_, message)| message).collect();
+        assert_eq!(messages, (0..count).map(|i| format!("message {}", i)).collect::<Vec<String>>());
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_batch_logger_reports_dropped_records() {
+        let collector = LogCollector::default();
+        let logger = LibvcxBatchLogger::new(collector.context(), 5, collect_log_batch, None, 2).unwrap();
+
+        let gate = collector.gate.lock().unwrap();
+        for i in 0..10 {
+            _log(&logger, Level::Info, &format!("message {}", i));
+        }
+        drop(gate);
+        log::Log::flush(&logger);
+
+        let logs = collector.logs.lock().unwrap();
+        let delivered: usize = logs.batches.iter().map(Vec::len).sum();
+        assert!(logs.dropped > 0);
+        assert_eq!(delivered + logs.dropped as usize, 10);
+    }
+
+    #[test]
+    #[cfg(feature = "general_test")]
+    fn test_batch_logger_flushes_on_drop() {
+        let collector = LogCollector::default();
+        let logger = LibvcxBatchLogger::new(collector.context(), 5, collect_log_batch, Some(collect_flush), 0).unwrap();
+
+        _log(&logger, Level::Warn, "first");
+        _log(&logger, Level::Warn, "second");
+        drop(logger);
+
+        assert_eq!(collector.messages(), vec![(Level::Warn as u32, "first".to_string()), (Level::Warn as u32, "second".to_string())]);
+        assert_eq!(collector.logs.lock().unwrap().flushes, 1);
+    }
+
     // #[ignore]
     // #[test]
     // #[cfg(feature = "general_test")]
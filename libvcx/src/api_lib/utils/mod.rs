@@ -8,5 +8,6 @@ pub mod timeout;
 pub mod return_types_u32;
 pub mod callback;
 pub mod callback_u32;
+pub mod callback_registry;
 pub mod logger;
 pub mod error;
@@ -1,20 +1,16 @@
-use std::collections::HashMap;
 use std::fmt::Display;
-use std::ops::Deref;
 use std::sync::mpsc::channel;
 use std::sync::mpsc::Receiver;
 use std::sync::mpsc::RecvTimeoutError;
-use std::sync::Mutex;
 use std::time::Duration;
 
 use libc::c_char;
 
 use aries_vcx::indy_sys::CommandHandle;
 use aries_vcx::libindy::utils::error_codes::map_indy_error;
-use aries_vcx::libindy::utils::next_command_handle;
 use aries_vcx::utils::error;
 
-use crate::api_lib::utils::callback::POISON_MSG;
+use crate::api_lib::utils::callback_registry::CallbackRegistry;
 use crate::api_lib::utils::callback_u32 as callback;
 use crate::api_lib::utils::timeout::TimeoutUtils;
 
@@ -22,13 +18,11 @@ fn log_error<T: Display>(e: T) {
     warn!("Unable to send through libindy callback in vcx: {}", e);
 }
 
-fn insert_closure<T>(closure: T, map: &Mutex<HashMap<CommandHandle, T>>) -> CommandHandle {
-    let command_handle = next_command_handle();
-    {
-        let mut callbacks = map.lock().expect(POISON_MSG);
-        callbacks.insert(command_handle, closure);
-    }
-    command_handle
+fn insert_closure<T>(closure: T, registry: &CallbackRegistry<T>) -> Result<CommandHandle, u32> {
+    registry.insert(closure).ok_or_else(|| {
+        warn!("Callback registry is full");
+        error::UNKNOWN_LIBINDY_ERROR.code_num
+    })
 }
 
 pub fn receive<T>(receiver: &Receiver<T>, timeout: Option<Duration>) -> Result<T, u32> {
@@ -62,7 +56,7 @@ impl Return_U32 {
             sender.send(err).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32)?;
 
         Ok(Return_U32 {
             command_handle,
@@ -93,7 +87,7 @@ impl Return_U32_U32 {
             sender.send((err, arg1)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_U32.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_U32)?;
 
         Ok(Return_U32_U32 {
             command_handle,
@@ -125,7 +119,7 @@ impl Return_U32_I32 {
             sender.send((err, arg1)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_I32.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_I32)?;
 
         Ok(Return_U32_I32 {
             command_handle,
@@ -157,7 +151,7 @@ impl Return_U32_STR {
             sender.send((err, str)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_STR.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_STR)?;
 
         Ok(Return_U32_STR {
             command_handle,
@@ -189,7 +183,7 @@ impl Return_U32_U32_STR {
             sender.send((err, arg1, arg2)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_U32_STR.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_U32_STR)?;
 
         Ok(Return_U32_U32_STR {
             command_handle,
@@ -221,7 +215,7 @@ impl Return_U32_STR_STR {
             sender.send((err, str1, str2)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_STR_STR.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_STR_STR)?;
 
         Ok(Return_U32_STR_STR {
             command_handle,
@@ -258,7 +252,7 @@ impl Return_U32_BOOL {
             sender.send((err, arg1)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_BOOL.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_BOOL)?;
 
         Ok(Return_U32_BOOL {
             command_handle,
@@ -291,7 +285,7 @@ impl Return_U32_BIN {
             sender.send((err, arg1)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_BIN.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_BIN)?;
 
         Ok(Return_U32_BIN {
             command_handle,
@@ -323,7 +317,7 @@ impl Return_U32_OPTSTR_BIN {
             sender.send((err, arg1, arg2)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_OPTSTR_BIN.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_OPTSTR_BIN)?;
 
         Ok(Return_U32_OPTSTR_BIN {
             command_handle,
@@ -356,7 +350,7 @@ impl Return_U32_U32_STR_STR_STR {
             sender.send((err, arg1, arg2, arg3, arg4)).unwrap_or_else(log_error);
         });
 
-        let command_handle = insert_closure(closure, callback::CALLBACKS_U32_U32_STR_STR_STR.deref());
+        let command_handle = insert_closure(closure, &callback::CALLBACKS_U32_U32_STR_STR_STR)?;
 
         Ok(Return_U32_U32_STR_STR_STR {
             command_handle,
@@ -0,0 +1,445 @@
+#[macro_use]
+extern crate serde_json;
+extern crate vcx;
+
+use std::collections::BTreeMap;
+use std::env;
+use std::process;
+use std::sync::{Arc, Mutex};
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::thread;
+use std::time::{Duration, Instant, SystemTime, UNIX_EPOCH};
+
+use serde_json::Value;
+
+use aries_vcx::agency_client::mock_agency::{DEFAULT_MOCK_AGENCY_ADDRESS, DEFAULT_MOCK_AGENCY_WORKERS, MockAgency, MockAgencyConfig};
+use aries_vcx::handlers::issuance::holder::holder::HolderState;
+use aries_vcx::handlers::issuance::issuer::issuer::IssuerState;
+use aries_vcx::handlers::proof_presentation::verifier::verifier::VerifierState;
+use aries_vcx::init::{create_agency_client_for_main_wallet, init_issuer_config, open_main_pool, PoolConfig};
+use aries_vcx::libindy::utils::anoncreds::libindy_prover_create_master_secret;
+use aries_vcx::libindy::utils::wallet::{close_main_wallet, configure_issuer_wallet, create_and_open_as_main_wallet, delete_wallet, WalletConfig};
+use aries_vcx::settings;
+use aries_vcx::utils::plugins::init_plugin;
+use aries_vcx::utils::provision::{AgentProvisionConfig, provision_cloud_agent};
+use vcx::api_lib::api_handle::{connection, credential, credential_def, disclosed_proof, issuer_credential, proof, schema};
+use vcx::api_lib::utils::logger::LibvcxDefaultLogger;
+use vcx::api_lib::VcxStateType;
+use vcx::error::prelude::*;
+
+const USAGE: &str = "Drives simulated inviter/invitee pairs through connection, issuance and proof flows.
+
+USAGE:
+    vcx-load-test [OPTIONS]
+
+OPTIONS:
+    --pairs <n>               number of inviter/invitee pairs [default: 10]
+    --concurrency <n>         number of pairs running at the same time [default: 4]
+    --flows <list>            comma separated flows: connection,issuance,proof [default: connection]
+    --genesis-path <path>     ledger genesis file, required by issuance and proof flows
+    --issuer-seed <seed>      seed of the issuer DID, it must be allowed to write to the ledger
+    --agency-endpoint <url>   use this agency instead of starting the local mock agency
+    --agency-did <did>        DID of the agency given by --agency-endpoint
+    --agency-verkey <verkey>  verkey of the agency given by --agency-endpoint
+    --agency-address <addr>   address the local mock agency listens on [default: 127.0.0.1:0]
+    --agency-seed <seed>      seed of the local mock agency DID
+    --agency-workers <n>      number of local mock agency worker threads [default: 16]
+    --poll-interval-ms <ms>   delay between polls for the counterparty messages [default: 50]
+    --timeout-secs <secs>     time limit of a single flow [default: 60]";
+
+const DEFAULT_ISSUER_SEED: &str = "000000000000000000000000Trustee1";
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+enum Flow {
+    Connection,
+    Issuance,
+    Proof,
+}
+
+impl Flow {
+    fn parse(name: &str) -> VcxResult<Flow> {
+        match name.trim() {
+            "connection" => Ok(Flow::Connection),
+            "issuance" => Ok(Flow::Issuance),
+            "proof" => Ok(Flow::Proof),
+            other => Err(VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Unknown flow {}", other)))
+        }
+    }
+
+    fn name(&self) -> &'static str {
+        match self {
+            Flow::Connection => "connection",
+            Flow::Issuance => "issuance",
+            Flow::Proof => "proof",
+        }
+    }
+}
+
+#[derive(Debug, Clone)]
+struct Options {
+    pairs: usize,
+    concurrency: usize,
+    flows: Vec<Flow>,
+    genesis_path: Option<String>,
+    issuer_seed: String,
+    agency: Option<AgentProvisionConfig>,
+    mock_agency: MockAgencyConfig,
+    poll_interval: Duration,
+    timeout: Duration,
+}
+
+impl Options {
+    fn parse(args: Vec<String>) -> VcxResult<Options> {
+        let mut values = BTreeMap::new();
+        let mut args = args.into_iter();
+        while let Some(arg) = args.next() {
+            if arg == "--help" || arg == "-h" {
+                println!("{}", USAGE);
+                process::exit(0);
+            }
+            if !arg.starts_with("--") {
+                return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Unexpected argument {}", arg)));
+            }
+            let value = args.next()
+                .ok_or(VcxError::from_msg(VcxErrorKind::InvalidOption, format!("Missing value of {}", arg)))?;
+            values.insert(arg[2..].to_string(), value);
+        }
+
+        let number = |name: &str, default: usize| -> VcxResult<usize> {
+            values.get(name)
+                .map(|value| value.parse::<usize>()
+                    .map_err(|_| VcxError::from_msg(VcxErrorKind::InvalidOption, format!("--{} must be a number", name))))
+                .unwrap_or(Ok(default))
+        };
+
+        let flows = values.get("flows").map(String::as_str).unwrap_or("connection")
+            .split(',')
+            .map(Flow::parse)
+            .collect::<VcxResult<Vec<Flow>>>()?;
+        let genesis_path = values.get("genesis-path").cloned();
+        if genesis_path.is_none() && flows.iter().any(|flow| *flow != Flow::Connection) {
+            return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, "Issuance and proof flows need a ledger, pass --genesis-path"));
+        }
+        if flows.contains(&Flow::Proof) && !flows.contains(&Flow::Issuance) {
+            return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, "Proof flow presents the issued credential, it needs the issuance flow"));
+        }
+
+        let agency = match (values.get("agency-endpoint"), values.get("agency-did"), values.get("agency-verkey")) {
+            (Some(endpoint), Some(did), Some(verkey)) => Some(AgentProvisionConfig {
+                agency_did: did.to_string(),
+                agency_verkey: verkey.to_string(),
+                agency_endpoint: endpoint.to_string(),
+                agent_seed: None,
+            }),
+            (None, None, None) => None,
+            _ => return Err(VcxError::from_msg(VcxErrorKind::InvalidOption, "--agency-endpoint, --agency-did and --agency-verkey must be passed together"))
+        };
+
+        Ok(Options {
+            pairs: number("pairs", 10)?,
+            concurrency: number("concurrency", 4)?.max(1),
+            flows,
+            genesis_path,
+            issuer_seed: values.get("issuer-seed").cloned().unwrap_or(DEFAULT_ISSUER_SEED.to_string()),
+            agency,
+            mock_agency: MockAgencyConfig {
+                address: values.get("agency-address").cloned().unwrap_or(DEFAULT_MOCK_AGENCY_ADDRESS.to_string()),
+                seed: values.get("agency-seed").cloned(),
+                workers: number("agency-workers", DEFAULT_MOCK_AGENCY_WORKERS)?,
+            },
+            poll_interval: Duration::from_millis(number("poll-interval-ms", 50)? as u64),
+            timeout: Duration::from_secs(number("timeout-secs", 60)? as u64),
+        })
+    }
+}
+
+struct Ledger {
+    issuer_did: String,
+    cred_def_handle: u32,
+    cred_def_id: String,
+}
+
+#[derive(Default)]
+struct FlowStats {
+    latencies: Vec<Duration>,
+    errors: usize,
+}
+
+/*
+Every pair is a pair of connections of the same agent, so one libvcx context plays both roles and the
+numbers cover the whole round trip through the agency: packing, forwarding, polling and the state
+machines of both sides.
+ */
+struct Pair<'a> {
+    index: usize,
+    options: &'a Options,
+    ledger: Option<&'a Ledger>,
+    inviter: u32,
+    invitee: u32,
+}
+
+impl<'a> Pair<'a> {
+    fn poll<F: FnMut() -> VcxResult<bool>>(&self, what: &str, mut done: F) -> VcxResult<()> {
+        let started = Instant::now();
+        while !done()? {
+            if started.elapsed() > self.options.timeout {
+                return Err(VcxError::from_msg(VcxErrorKind::NotReady, format!("Pair {} timed out waiting for {}", self.index, what)));
+            }
+            thread::sleep(self.options.poll_interval);
+        }
+        Ok(())
+    }
+
+    fn ledger(&self) -> VcxResult<&Ledger> {
+        self.ledger.ok_or(VcxError::from_msg(VcxErrorKind::InvalidState, "Ledger is not initialized"))
+    }
+
+    fn connect(&mut self) -> VcxResult<()> {
+        self.inviter = connection::create_connection(&format!("inviter-{}", self.index))?;
+        let invite = connection::connect(self.inviter)?
+            .ok_or(VcxError::from_msg(VcxErrorKind::InvalidState, "Inviter did not create invitation"))?;
+        self.invitee = connection::create_connection_with_invite(&format!("invitee-{}", self.index), &invite)?;
+        connection::connect(self.invitee)?;
+
+        let (inviter, invitee) = (self.inviter, self.invitee);
+        let completed = VcxStateType::VcxStateAccepted as u32;
+        self.poll("connection", || {
+            let inviter_state = connection::update_state(inviter)?;
+            let invitee_state = connection::update_state(invitee)?;
+            Ok(inviter_state == completed && invitee_state == completed)
+        })
+    }
+
+    fn issue(&self) -> VcxResult<()> {
+        let ledger = self.ledger()?;
+        let credential_data = json!({"name": format!("holder-{}", self.index), "age": "25"}).to_string();
+        let issuer = issuer_credential::issuer_credential_create(ledger.cred_def_handle, format!("issuer-{}", self.index),
+                                                                 ledger.issuer_did.clone(), "credential".to_string(), credential_data, 0)?;
+        issuer_credential::send_credential_offer(issuer, self.inviter, None)?;
+
+        let offer = self.wait_for_message("credential offer", || credential::get_credential_offer_messages_with_conn_handle(self.invitee))?;
+        let holder = credential::credential_create_with_offer(&format!("holder-{}", self.index), &offer)?;
+        credential::send_credential_request(holder, self.invitee)?;
+
+        let request_received = u32::from(IssuerState::RequestReceived);
+        self.poll("credential request", || Ok(issuer_credential::update_state(issuer, None, self.inviter)? == request_received))?;
+        issuer_credential::send_credential(issuer, self.inviter)?;
+
+        let finished = u32::from(HolderState::Finished);
+        self.poll("credential", || Ok(credential::update_state(holder, None, self.invitee)? == finished))?;
+
+        issuer_credential::release(issuer)?;
+        credential::release(holder)?;
+        Ok(())
+    }
+
+    fn prove(&self) -> VcxResult<()> {
+        let ledger = self.ledger()?;
+        let requested_attrs = json!([{"name": "name", "restrictions": [{"cred_def_id": ledger.cred_def_id}]}]).to_string();
+        let verifier = proof::create_proof(format!("verifier-{}", self.index), requested_attrs, json!([]).to_string(),
+                                           json!({}).to_string(), "proof".to_string())?;
+        proof::send_proof_request(verifier, self.inviter, None)?;
+
+        let request = self.wait_for_message("presentation request", || disclosed_proof::get_proof_request_messages(self.invitee))?;
+        let prover = disclosed_proof::create_proof(&format!("prover-{}", self.index), &request)?;
+        let credentials = _select_first_credentials(&disclosed_proof::retrieve_credentials(prover)?)?;
+        disclosed_proof::generate_proof(prover, credentials, json!({}).to_string())?;
+        disclosed_proof::send_proof(prover, self.invitee)?;
+
+        let finished = u32::from(VerifierState::Finished);
+        self.poll("presentation", || Ok(proof::update_state(verifier, None, self.inviter)? == finished))?;
+
+        proof::release(verifier)?;
+        disclosed_proof::release(prover)?;
+        Ok(())
+    }
+
+    fn wait_for_message<F: Fn() -> VcxResult<String>>(&self, what: &str, download: F) -> VcxResult<String> {
+        let mut message = None;
+        self.poll(what, || {
+            let messages: Vec<Value> = serde_json::from_str(&download()?)
+                .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot parse {} messages: {}", what, err)))?;
+            message = messages.into_iter().next();
+            Ok(message.is_some())
+        })?;
+        Ok(message.map(|message| message.to_string()).unwrap_or_default())
+    }
+
+    fn release(&self) {
+        connection::release(self.inviter).ok();
+        connection::release(self.invitee).ok();
+    }
+}
+
+fn _select_first_credentials(retrieved: &str) -> VcxResult<String> {
+    let retrieved: Value = serde_json::from_str(retrieved)
+        .map_err(|err| VcxError::from_msg(VcxErrorKind::InvalidJson, format!("Cannot parse retrieved credentials: {}", err)))?;
+    let mut selected = json!({"attrs": {}});
+    if let Some(attrs) = retrieved["attrs"].as_object() {
+        for (referent, credentials) in attrs {
+            let credential = credentials.get(0)
+                .ok_or(VcxError::from_msg(VcxErrorKind::InvalidState, format!("No credential for {}", referent)))?;
+            selected["attrs"][referent] = json!({"credential": credential});
+        }
+    }
+    Ok(selected.to_string())
+}
+
+fn _run_pair(index: usize, options: &Options, ledger: Option<&Ledger>, stats: &Mutex<BTreeMap<Flow, FlowStats>>) {
+    let mut pair = Pair { index, options, ledger, inviter: 0, invitee: 0 };
+    for flow in options.flows.iter() {
+        let started = Instant::now();
+        let result = match flow {
+            Flow::Connection => pair.connect(),
+            Flow::Issuance => pair.issue(),
+            Flow::Proof => pair.prove(),
+        };
+        let elapsed = started.elapsed();
+        let mut stats = stats.lock().unwrap();
+        let flow_stats = stats.entry(*flow).or_default();
+        match result {
+            Ok(()) => flow_stats.latencies.push(elapsed),
+            Err(err) => {
+                flow_stats.errors += 1;
+                eprintln!("pair {} failed {} flow: {}", index, flow.name(), err);
+                break;
+            }
+        }
+    }
+    pair.release();
+}
+
+fn _percentile(sorted: &[Duration], percentile: f64) -> Duration {
+    if sorted.is_empty() {
+        return Duration::default();
+    }
+    let index = ((sorted.len() - 1) as f64 * percentile).round() as usize;
+    sorted[index.min(sorted.len() - 1)]
+}
+
+fn _millis(duration: Duration) -> f64 {
+    duration.as_secs_f64() * 1000.0
+}
+
+fn _report(options: &Options, stats: BTreeMap<Flow, FlowStats>, elapsed: Duration) {
+    println!("pairs: {}, concurrency: {}, elapsed: {:.2}s", options.pairs, options.concurrency, elapsed.as_secs_f64());
+    println!("{:<12} {:>8} {:>8} {:>10} {:>10} {:>10} {:>10} {:>10}", "flow", "ok", "errors", "flows/s", "p50 ms", "p90 ms", "p99 ms", "max ms");
+    for (flow, mut flow_stats) in stats {
+        flow_stats.latencies.sort();
+        let latencies = &flow_stats.latencies;
+        println!("{:<12} {:>8} {:>8} {:>10.2} {:>10.1} {:>10.1} {:>10.1} {:>10.1}",
+                 flow.name(),
+                 latencies.len(),
+                 flow_stats.errors,
+                 latencies.len() as f64 / elapsed.as_secs_f64(),
+                 _millis(_percentile(latencies, 0.5)),
+                 _millis(_percentile(latencies, 0.9)),
+                 _millis(_percentile(latencies, 0.99)),
+                 _millis(latencies.last().cloned().unwrap_or_default()));
+    }
+}
+
+fn _init_ledger(options: &Options, genesis_path: &str) -> VcxResult<Ledger> {
+    init_plugin(settings::DEFAULT_PAYMENT_PLUGIN, settings::DEFAULT_PAYMENT_INIT_FUNCTION);
+    open_main_pool(&PoolConfig {
+        genesis_path: genesis_path.to_string(),
+        pool_name: None,
+        pool_config: None,
+        open_in_background: None,
+        refresh_interval_secs: None,
+    })?;
+    let issuer_config = configure_issuer_wallet(&options.issuer_seed)?;
+    init_issuer_config(&issuer_config)?;
+
+    let version = format!("1.{}", SystemTime::now().duration_since(UNIX_EPOCH).map(|time| time.as_secs()).unwrap_or_default());
+    let schema_handle = schema::create_and_publish_schema("load-test-schema", issuer_config.institution_did.clone(),
+                                                          "load_test".to_string(), version, json!(["name", "age"]).to_string())?;
+    let schema_id = schema::get_schema_id(schema_handle)?;
+    let cred_def_handle = credential_def::create_and_publish_credentialdef("load-test-cred-def".to_string(), "load_test".to_string(),
+                                                                           issuer_config.institution_did.clone(), schema_id,
+                                                                           "tag".to_string(), json!({"support_revocation": false}).to_string())?;
+    let cred_def_id = credential_def::get_cred_def_id(cred_def_handle)?;
+    Ok(Ledger { issuer_did: issuer_config.institution_did, cred_def_handle, cred_def_id })
+}
+
+fn _run(options: Options) -> VcxResult<()> {
+    let mock_agency = match options.agency {
+        Some(_) => None,
+        None => Some(MockAgency::start(&options.mock_agency)?)
+    };
+    let provision_config = options.agency.clone().unwrap_or_else(|| {
+        let agency = mock_agency.as_ref().unwrap();
+        AgentProvisionConfig {
+            agency_did: agency.did().to_string(),
+            agency_verkey: agency.verkey().to_string(),
+            agency_endpoint: agency.endpoint().to_string(),
+            agent_seed: None,
+        }
+    });
+
+    let wallet_config = WalletConfig {
+        wallet_name: format!("vcx_load_test_{}", process::id()),
+        wallet_key: settings::DEFAULT_WALLET_KEY.to_string(),
+        wallet_key_derivation: settings::WALLET_KDF_RAW.to_string(),
+        wallet_type: None,
+        storage_config: None,
+        storage_credentials: None,
+        rekey: None,
+        rekey_derivation_method: None,
+    };
+    create_and_open_as_main_wallet(&wallet_config)?;
+    libindy_prover_create_master_secret(settings::DEFAULT_LINK_SECRET_ALIAS)?;
+
+    let result = (|| -> VcxResult<()> {
+        let agency_client_config = provision_cloud_agent(&provision_config)?;
+        create_agency_client_for_main_wallet(&agency_client_config)?;
+        let ledger = match options.genesis_path {
+            Some(ref genesis_path) => Some(_init_ledger(&options, genesis_path)?),
+            None => None
+        };
+
+        let next_pair = AtomicUsize::new(0);
+        let stats = Mutex::new(BTreeMap::new());
+        let started = Instant::now();
+        let (options, ledger, next_pair, stats) = (Arc::new(options.clone()), Arc::new(ledger), Arc::new(next_pair), Arc::new(stats));
+        let workers: Vec<_> = (0..options.concurrency).map(|_| {
+            let (options, ledger, next_pair, stats) = (options.clone(), ledger.clone(), next_pair.clone(), stats.clone());
+            thread::spawn(move || loop {
+                let index = next_pair.fetch_add(1, Ordering::SeqCst);
+                if index >= options.pairs {
+                    break;
+                }
+                _run_pair(index, &options, Option::as_ref(&ledger), &stats);
+            })
+        }).collect();
+        for worker in workers {
+            worker.join().ok();
+        }
+        let elapsed = started.elapsed();
+        let stats = Arc::try_unwrap(stats).ok().and_then(|stats| stats.into_inner().ok()).unwrap_or_default();
+        _report(&options, stats, elapsed);
+        Ok(())
+    })();
+
+    close_main_wallet().ok();
+    delete_wallet(&wallet_config).ok();
+    if let Some(mock_agency) = mock_agency {
+        mock_agency.stop();
+    }
+    result
+}
+
+fn main() {
+    LibvcxDefaultLogger::init(None).ok();
+    let options = match Options::parse(env::args().skip(1).collect()) {
+        Ok(options) => options,
+        Err(err) => {
+            eprintln!("{}\n\n{}", err, USAGE);
+            process::exit(2);
+        }
+    };
+    if let Err(err) = _run(options) {
+        eprintln!("load test failed: {}", err);
+        process::exit(1);
+    }
+}
@@ -67,6 +67,9 @@ vcx_error_t vcx_update_webhook_url(vcx_command_handle_t handle, const char *noti
 
 vcx_error_t vcx_create_agent(vcx_command_handle_t handle, const char *config, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, const char *xconfig));
 vcx_error_t vcx_create_agency_client_for_main_wallet(vcx_command_handle_t handle, const char *config, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err));
+vcx_error_t vcx_init_pairwise_pool(const char *config);
+vcx_error_t vcx_init_send_queue(const char *config);
+vcx_error_t vcx_get_delivery_outcomes(vcx_command_handle_t command_handle, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, const char *outcomes));
 vcx_error_t vcx_provision_cloud_agent(vcx_command_handle_t handle, const char *config, void (*cb)(vcx_command_handle_t xhandle, const char *xconfig, vcx_error_t err));
 vcx_error_t vcx_update_agent_info(vcx_command_handle_t handle, const char *info, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err));
 
@@ -75,6 +78,10 @@ const char *vcx_version();
 
 vcx_error_t vcx_get_current_error(const char ** error_json_p);
 
+/** Exports latency histograms and counters, format is "prometheus" or "json" */
+vcx_error_t vcx_get_metrics(vcx_command_handle_t command_handle, const char *format, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, const char *metrics));
+vcx_error_t vcx_reset_metrics();
+
 /**
  * Schema object
  *
@@ -118,6 +125,12 @@ vcx_error_t vcx_credentialdef_get_sequence_no(vcx_credentialdef_handle_t credent
 /** Populates data with the contents of the credentialdef handle. */
 vcx_error_t vcx_credentialdef_get(vcx_credentialdef_handle_t credentialdef_handle, char *data);
 
+/** Keeps credential offers for the credentialdef pre-created in background. */
+vcx_error_t vcx_credentialdef_enable_offer_pool(vcx_credentialdef_handle_t credentialdef_handle, const char *config);
+
+/** Stops keeping credential offers for the credentialdef and drops the pre-created ones. */
+vcx_error_t vcx_credentialdef_disable_offer_pool(vcx_credentialdef_handle_t credentialdef_handle);
+
 /**
  * connection object
  *
@@ -137,6 +150,15 @@ vcx_error_t vcx_connection_serialize(vcx_command_handle_t command_handle, vcx_co
 /** Re-creates a connection object from the specified serialization. */
 vcx_error_t vcx_connection_deserialize(vcx_command_handle_t command_handle, const char *serialized_credential, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_connection_handle_t connection_handle));
 
+/** Returns the binary representation of the connection object. */
+vcx_error_t vcx_connection_serialize_binary(vcx_command_handle_t command_handle, vcx_connection_handle_t handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Re-creates a connection object from its binary representation. */
+vcx_error_t vcx_connection_deserialize_binary(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_connection_handle_t handle));
+
+/** Re-creates connection objects from an array of serializations. Handles are returned in the order of serializations. */
+vcx_error_t vcx_connection_deserialize_many(vcx_command_handle_t command_handle, const char *const *serialized, vcx_u32_t count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_connection_handle_t *handles, vcx_u32_t count));
+
 /** Request a state update from the agent for the given connection. */
 vcx_error_t vcx_connection_update_state(vcx_command_handle_t command_handle, vcx_connection_handle_t connection_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_state_t state));
 
@@ -222,6 +244,15 @@ vcx_error_t vcx_connection_verify_signature(vcx_command_handle_t command_handle,
 /** Re-creates a credential object from the specified serialization. */
 //vcx_error_t vcx_issuer_credential_deserialize(vcx_command_handle_t, const char *serialized_credential, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_credential_handle_t credential_handle));
 
+/** Returns the binary representation of the issuer credential object. */
+vcx_error_t vcx_issuer_credential_serialize_binary(vcx_command_handle_t command_handle, vcx_credential_handle_t handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Re-creates a issuer credential object from its binary representation. */
+vcx_error_t vcx_issuer_credential_deserialize_binary(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_credential_handle_t handle));
+
+/** Re-creates issuer credential objects from an array of serializations. Handles are returned in the order of serializations. */
+vcx_error_t vcx_issuer_credential_deserialize_many(vcx_command_handle_t command_handle, const char *const *serialized, vcx_u32_t count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_credential_handle_t *handles, vcx_u32_t count));
+
 /** Terminates a credential for the specified reason. */
 //vcx_error_t vcx_issuer_terminate_credential(vcx_command_handle_t command_handle, vcx_credential_handle_t credential_handle, vcx_state_t state_type, const char *msg);
 
@@ -243,6 +274,11 @@ vcx_error_t vcx_issuer_accept_credential(vcx_credential_handle_t credential_hand
 /** Creates a proof object.  Populates a handle to the new proof. */
 vcx_error_t vcx_proof_create(vcx_command_handle_t command_handle, const char *source_id, const char *requested_attrs, const char *requested_predicates, const char *name, void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err, vcx_proof_handle_t proof_handle));
 
+/** Compiles proof request once, proofs are then created from it with only a fresh nonce */
+vcx_error_t vcx_proof_template_create(vcx_command_handle_t command_handle, const char *requested_attrs, const char *requested_predicates, const char *revocation_interval, const char *name, void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err, unsigned int template_handle));
+vcx_error_t vcx_proof_create_from_template(vcx_command_handle_t command_handle, const char *source_id, unsigned int template_handle, void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err, vcx_proof_handle_t proof_handle));
+vcx_error_t vcx_proof_template_release(unsigned int template_handle);
+
 /** Asynchronously send a proof request to the connection. */
 vcx_error_t vcx_proof_send_request(vcx_command_handle_t command_handle, vcx_proof_handle_t proof_handle, vcx_connection_handle_t connection_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err));
 
@@ -252,6 +288,9 @@ vcx_error_t vcx_get_proof(vcx_command_handle_t command_handle, vcx_proof_handle_
 /** Set proof offer as accepted. */
 vcx_error_t vcx_proof_accepted(vcx_proof_handle_t proof_handle);
 
+/** Updates states of several proofs, validating received presentations together. */
+vcx_error_t vcx_v2_proof_update_states(vcx_command_handle_t command_handle, const vcx_proof_handle_t *proof_handles, const vcx_connection_handle_t *connection_handles, unsigned int count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_error_t *errors, const unsigned int *states, unsigned int count));
+
 /** Retrieves the state of the proof. */
 vcx_error_t vcx_proof_get_state(vcx_command_handle_t command_handle, vcx_proof_handle_t proof_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_state_t state));
 
@@ -261,6 +300,15 @@ vcx_error_t vcx_proof_serialize(vcx_command_handle_t command_handle, vcx_proof_h
 /** Re-creates a proof object from the specified serialization. */
 vcx_error_t vcx_proof_deserialize(vcx_command_handle_t command_handle, const char *serialized_proof, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_proof_handle_t proof_handle));
 
+/** Returns the binary representation of the proof object. */
+vcx_error_t vcx_proof_serialize_binary(vcx_command_handle_t command_handle, vcx_proof_handle_t handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Re-creates a proof object from its binary representation. */
+vcx_error_t vcx_proof_deserialize_binary(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_proof_handle_t handle));
+
+/** Re-creates proof objects from an array of serializations. Handles are returned in the order of serializations. */
+vcx_error_t vcx_proof_deserialize_many(vcx_command_handle_t command_handle, const char *const *serialized, vcx_u32_t count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_proof_handle_t *handles, vcx_u32_t count));
+
 /** Releases the proof from memory. */
 vcx_error_t vcx_proof_release(vcx_proof_handle_t proof_handle);
 
@@ -311,6 +359,15 @@ vcx_error_t vcx_disclosed_proof_serialize(vcx_command_handle_t command_handle, v
 /** Re-creates a disclosed_proof object from the specified serialization. */
 vcx_error_t vcx_disclosed_proof_deserialize(vcx_command_handle_t command_handle, const char *serialized_proof, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_proof_handle_t proof_handle));
 
+/** Returns the binary representation of the disclosed proof object. */
+vcx_error_t vcx_disclosed_proof_serialize_binary(vcx_command_handle_t command_handle, vcx_proof_handle_t handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Re-creates a disclosed proof object from its binary representation. */
+vcx_error_t vcx_disclosed_proof_deserialize_binary(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_proof_handle_t handle));
+
+/** Re-creates disclosed proof objects from an array of serializations. Handles are returned in the order of serializations. */
+vcx_error_t vcx_disclosed_proof_deserialize_many(vcx_command_handle_t command_handle, const char *const *serialized, vcx_u32_t count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_proof_handle_t *handles, vcx_u32_t count));
+
 /** Takes the disclosed proof object and returns a json string of all credentials matching associated proof request from wallet */
 vcx_error_t vcx_disclosed_proof_retrieve_credentials(vcx_command_handle_t command_handle, vcx_proof_handle_t proof_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const char *matching_credentials));
 
@@ -337,6 +394,7 @@ vcx_error_t vcx_credential_create_with_msgid(vcx_command_handle_t command_handle
 
 /** Asynchronously sends the credential request to the connection. */
 vcx_error_t vcx_credential_send_request(vcx_command_handle_t command_handle, vcx_credential_handle_t credential_handle, vcx_connection_handle_t connection_handle, vcx_payment_handle_t payment_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err));
+vcx_error_t vcx_credential_send_requests(vcx_command_handle_t command_handle, const vcx_credential_handle_t *credential_handles, const vcx_connection_handle_t *connection_handles, unsigned int count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_error_t *errors, const unsigned int *states, unsigned int count));
 
 /** Check for any credential offers from the connection. */
 vcx_error_t vcx_credential_get_offers(vcx_command_handle_t command_handle, vcx_connection_handle_t connection_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const char *offers));
@@ -355,6 +413,7 @@ vcx_error_t vcx_credential_get_rev_reg_id(vcx_command_handle_t handle, vcx_crede
 vcx_error_t vcx_credential_is_revokable(vcx_command_handle_t handle, vcx_credential_handle_t credential_handle, void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err, vcx_bool_t revokable));
 
 vcx_error_t vcx_v2_credential_update_state(vcx_command_handle_t command_handle, vcx_credential_handle_t credential_handle, vcx_connection_handle_t connection_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_state_t state));
+vcx_error_t vcx_v2_credential_update_states(vcx_command_handle_t command_handle, const vcx_credential_handle_t *credential_handles, const vcx_connection_handle_t *connection_handles, unsigned int count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_error_t *errors, const unsigned int *states, unsigned int count));
 
 /** Retrieves the state of the credential - including storing the credential if it has been sent. */
 vcx_error_t vcx_credential_get_state(vcx_command_handle_t command_handle, vcx_credential_handle_t credential_handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_state_t state));
@@ -365,6 +424,15 @@ vcx_error_t vcx_credential_serialize(vcx_command_handle_t command_handle, vcx_cr
 /** Re-creates a credential from the specified serialization. */
 vcx_error_t vcx_credential_deserialize(vcx_command_handle_t, const char *serialized_credential, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_credential_handle_t credential_handle));
 
+/** Returns the binary representation of the credential object. */
+vcx_error_t vcx_credential_serialize_binary(vcx_command_handle_t command_handle, vcx_credential_handle_t handle, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Re-creates a credential object from its binary representation. */
+vcx_error_t vcx_credential_deserialize_binary(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_credential_handle_t handle));
+
+/** Re-creates credential objects from an array of serializations. Handles are returned in the order of serializations. */
+vcx_error_t vcx_credential_deserialize_many(vcx_command_handle_t command_handle, const char *const *serialized, vcx_u32_t count, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const vcx_credential_handle_t *handles, vcx_u32_t count));
+
 /** Releases the credential from memory. */
 vcx_error_t vcx_credential_release(vcx_credential_handle_t credential_handle);
 
@@ -383,6 +451,12 @@ vcx_error_t vcx_wallet_export(vcx_command_handle_t handle, const char *path, con
 /** Import an encrypted file back into the wallet */
 vcx_error_t vcx_wallet_import(vcx_command_handle_t handle, const char *config, void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err));
 
+/** Export the wallet as a chunked, compressed and encrypted archive, reporting progress */
+vcx_error_t vcx_wallet_export_stream(vcx_command_handle_t handle, const char *config, void (*progress_cb)(vcx_command_handle_t command_handle, const char *progress), void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err));
+
+/** Import archives created by vcx_wallet_export_stream into a new wallet, reporting progress */
+vcx_error_t vcx_wallet_import_stream(vcx_command_handle_t handle, const char *config, void (*progress_cb)(vcx_command_handle_t command_handle, const char *progress), void (*cb)(vcx_command_handle_t command_handle, vcx_error_t err));
+
 /** Add a record inside a wallet */
 vcx_error_t vcx_wallet_add_record(vcx_command_handle_t handle, const char * type_, const char *record_id, const char *record_value, const char *tags_json, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err));
 
@@ -413,6 +487,18 @@ vcx_error_t vcx_wallet_search_next_records(vcx_command_handle_t command_handle,
 /** Close a search */
 vcx_error_t vcx_wallet_close_search(vcx_command_handle_t commond_handle, vcx_search_handle_t search_handle, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err));
 
+/** Opens a cursor paging through projected wallet records */
+vcx_error_t vcx_wallet_search_cursor_open(vcx_command_handle_t command_handle, const char *type_, const char *query_json, const char *projection_json, size_t page_size, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, vcx_u32_t cursor_handle));
+
+/** Fetches next page of wallet search cursor, empty page means the cursor is exhausted and released */
+vcx_error_t vcx_wallet_search_cursor_next_page(vcx_command_handle_t command_handle, vcx_u32_t cursor_handle, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, const char *records_json));
+
+/** Releases wallet search cursor */
+vcx_error_t vcx_wallet_search_cursor_release(vcx_u32_t cursor_handle);
+
+/** Counts wallet records matching a query */
+vcx_error_t vcx_wallet_count_records(vcx_command_handle_t command_handle, const char *type_, const char *query_json, void (*cb)(vcx_command_handle_t xhandle, vcx_error_t err, vcx_u32_t count));
+
 /**
  * token object
  */
@@ -442,6 +528,15 @@ vcx_error_t vcx_messages_update_status( vcx_command_handle_t command_handle, con
  */
 vcx_error_t vcx_ledger_get_fees(vcx_command_handle_t command_handle, void(*cb)(vcx_command_handle_t xhandle, vcx_error_t error, const char *fees));
 
+/** Drops cached ledger reads of the DID, or the whole cache if did is null. */
+vcx_error_t vcx_invalidate_ledger_cache(const char *did);
+
+/** Converts output of any vcx_*_serialize function into its binary representation. */
+vcx_error_t vcx_serialized_json_to_binary(vcx_command_handle_t command_handle, const char *serialized, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, vcx_data_t *data, vcx_u32_t data_len));
+
+/** Converts binary representation of an object back into the json accepted by vcx_*_deserialize functions. */
+vcx_error_t vcx_serialized_binary_to_json(vcx_command_handle_t command_handle, vcx_data_t *data, vcx_u32_t data_len, void (*cb)(vcx_command_handle_t xcommand_handle, vcx_error_t err, const char *serialized));
+
 /**
  * logging
  **/
@@ -460,6 +555,26 @@ vcx_error_t vcx_set_logger( const void* context,
                                           vcx_u32_t line),
                             void (*flushFn)(const void*  context));
 
+/** Log record passed to logBatchFn of vcx_set_batch_logger. Pointers are valid only during the call. */
+typedef struct
+{
+    vcx_u32_t level;
+    const char *target;
+    const char *message;
+    const char *module_path;
+    const char *file;
+    vcx_u32_t line;
+} vcx_log_record_t;
+
+vcx_error_t vcx_set_batch_logger( const void* context,
+                                  vcx_u32_t max_level,
+                                  void (*logBatchFn)(const void*  context,
+                                                     const vcx_log_record_t *records,
+                                                     vcx_u32_t count,
+                                                     vcx_u32_t dropped),
+                                  void (*flushFn)(const void*  context),
+                                  vcx_u32_t buffer_size);
+
 /// Retrieve author agreement set on the Ledger
 ///
 /// #params
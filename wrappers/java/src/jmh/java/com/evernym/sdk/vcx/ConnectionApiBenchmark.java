@@ -0,0 +1,80 @@
+package com.evernym.sdk.vcx;
+
+import com.evernym.sdk.vcx.connection.ConnectionApi;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+
+import java.nio.ByteBuffer;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Latency of hot connection calls, comparing String and byte array marshaling with direct buffers.
+ * libvcx runs with mocks enabled, so the numbers are dominated by the wrapper and JNA overhead.
+ */
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+public class ConnectionApiBenchmark {
+
+    private static final int DATA_SIZE = 4096;
+
+    private int connectionHandle;
+    private String serializedJson;
+    private ByteBuffer serializedBinary;
+    private byte[] data;
+    private ByteBuffer directData;
+
+    @Setup(Level.Trial)
+    public void setup() throws Exception {
+        LibVcx.init();
+        LibVcx.api.vcx_enable_mocks();
+        connectionHandle = ConnectionApi.vcxConnectionCreate("benchmark").get();
+        serializedJson = ConnectionApi.connectionSerialize(connectionHandle).get();
+        serializedBinary = ConnectionApi.connectionSerializeBinary(connectionHandle).get();
+
+        data = new byte[DATA_SIZE];
+        directData = ByteBuffer.allocateDirect(DATA_SIZE);
+        directData.put(data).flip();
+    }
+
+    @Benchmark
+    public String serializeJson() throws Exception {
+        return ConnectionApi.connectionSerialize(connectionHandle).get();
+    }
+
+    @Benchmark
+    public ByteBuffer serializeBinary() throws Exception {
+        return ConnectionApi.connectionSerializeBinary(connectionHandle).get();
+    }
+
+    @Benchmark
+    public int deserializeJson() throws Exception {
+        int handle = ConnectionApi.connectionDeserialize(serializedJson).get();
+        ConnectionApi.connectionRelease(handle);
+        return handle;
+    }
+
+    @Benchmark
+    public int deserializeBinary() throws Exception {
+        int handle = ConnectionApi.connectionDeserializeBinary(serializedBinary.duplicate()).get();
+        ConnectionApi.connectionRelease(handle);
+        return handle;
+    }
+
+    @Benchmark
+    public byte[] signDataByteArray() throws Exception {
+        return ConnectionApi.connectionSignData(connectionHandle, data, data.length).get();
+    }
+
+    @Benchmark
+    public ByteBuffer signDataDirectBuffer() throws Exception {
+        return ConnectionApi.connectionSignData(connectionHandle, directData.duplicate()).get();
+    }
+}
@@ -5,6 +5,7 @@ import com.sun.jna.ptr.PointerByReference;
 import static com.sun.jna.Native.detach;
 
 import java.io.File;
+import java.nio.ByteBuffer;
 
 public abstract class LibVcx {
     private static final String LIBRARY_NAME = "vcx";
@@ -30,6 +31,7 @@ public abstract class LibVcx {
         public String vcx_version();
         public int vcx_shutdown(boolean delete);
         public int vcx_reset();
+        public int vcx_enable_mocks();
 
     /**
      * Helper API for testing purposes.
@@ -128,6 +130,16 @@ public abstract class LibVcx {
          */
         public int vcx_connection_deserialize(int command_handle, String serialized_claim, Callback cb);
 
+        /**
+         * Returns the contents of the connection handle in compact binary form.
+         */
+        public int vcx_connection_serialize_binary(int command_handle, int connection_handle, Callback cb);
+
+        /**
+         * Re-creates a connection object from the specified binary serialization.
+         */
+        public int vcx_connection_deserialize_binary(int command_handle, ByteBuffer data_raw, int data_len, Callback cb);
+
         /**
          * Request a State update from the agent for the given connection.
          */
@@ -234,6 +246,9 @@ public abstract class LibVcx {
          */
         public int vcx_connection_sign_data(int command_handle, int connection_handle, byte[] data_raw, int data_len, Callback cb);
 
+        /** Same as above, data are read directly from the direct buffer without copying. */
+        public int vcx_connection_sign_data(int command_handle, int connection_handle, ByteBuffer data_raw, int data_len, Callback cb);
+
         /** Verify the signature is valid for the specified data
          ///
          /// #params
@@ -257,6 +272,9 @@ public abstract class LibVcx {
          */
         public int vcx_connection_verify_signature(int command_handle, int connection_handle, byte[] data_raw, int data_len, byte[] signature_raw, int signature_len, Callback cb);
 
+        /** Same as above, data are read directly from the direct buffers without copying. */
+        public int vcx_connection_verify_signature(int command_handle, int connection_handle, ByteBuffer data_raw, int data_len, ByteBuffer signature_raw, int signature_len, Callback cb);
+
         /**
          * credential issuer object
          *
@@ -421,6 +439,16 @@ public abstract class LibVcx {
          */
         public int vcx_disclosed_proof_deserialize(int command_handle, String serialized_proof, Callback cb);
 
+        /**
+         * Populates status with the current State of this disclosed_proof in compact binary form.
+         */
+        public int vcx_disclosed_proof_serialize_binary(int command_handle, int proof_handle, Callback cb);
+
+        /**
+         * Re-creates a disclosed_proof object from the specified binary serialization.
+         */
+        public int vcx_disclosed_proof_deserialize_binary(int command_handle, ByteBuffer data_raw, int data_len, Callback cb);
+
         /**
          * Releases the disclosed_proof from memory.
          */
@@ -510,6 +538,12 @@ public abstract class LibVcx {
         /** Re-creates a credential from the specified serialization. */
         public int vcx_credential_deserialize(int command_handle, String serialized_credential, Callback cb);
 
+        /** Populates status with the current State of this credential in compact binary form. */
+        public int vcx_credential_serialize_binary(int command_handle, int credential_handle, Callback cb);
+
+        /** Re-creates a credential from the specified binary serialization. */
+        public int vcx_credential_deserialize_binary(int command_handle, ByteBuffer data_raw, int data_len, Callback cb);
+
         /** Releases the credential from memory. */
         public int vcx_credential_release(int credential_handle);
 
@@ -574,9 +608,11 @@ public abstract class LibVcx {
 
         /** Sign with payment address **/
         public int vcx_wallet_sign_with_address(int command_handle, String address, byte[] message_raw, int message_len, Callback cb);
+        public int vcx_wallet_sign_with_address(int command_handle, String address, ByteBuffer message_raw, int message_len, Callback cb);
 
         /** Verify with payment address **/
         public int vcx_wallet_verify_with_address(int command_handle, String address, byte[] message_raw, int message_len, byte[] signature_raw, int signature_len, Callback cb);
+        public int vcx_wallet_verify_with_address(int command_handle, String address, ByteBuffer message_raw, int message_len, ByteBuffer signature_raw, int signature_len, Callback cb);
 
         /**
          * token object
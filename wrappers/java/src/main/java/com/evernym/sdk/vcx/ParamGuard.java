@@ -1,5 +1,7 @@
 package com.evernym.sdk.vcx;
 
+import java.nio.ByteBuffer;
+
 public class ParamGuard {
 
 	public static void notNull(Object param, String paramName) {
@@ -11,4 +13,10 @@ public class ParamGuard {
 		if(StringUtils.isNullOrWhiteSpace(param))
 			throw new IllegalArgumentException("A non-empty string must be provided for the '" + paramName + "' parameter.");
 	}
+
+	public static void directBuffer(ByteBuffer param, String paramName) {
+		notNull(param, paramName);
+		if(!param.isDirect())
+			throw new IllegalArgumentException("A direct buffer must be provided for the '" + paramName + "' parameter.");
+	}
 }
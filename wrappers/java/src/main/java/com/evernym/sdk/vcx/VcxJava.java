@@ -5,9 +5,12 @@ import org.apache.commons.lang3.builder.EqualsBuilder;
 import org.apache.commons.lang3.builder.HashCodeBuilder;
 import org.apache.commons.lang3.builder.ToStringBuilder;
 import org.apache.commons.lang3.builder.ToStringStyle;
+import com.sun.jna.Callback;
+import com.sun.jna.Pointer;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.nio.ByteBuffer;
 import java.util.HashMap;
 import java.util.Iterator;
 import java.util.Map;
@@ -78,6 +81,43 @@ public class VcxJava {
 			return future;
 		}
 
+		/*
+		 * DIRECT BUFFERS
+		 */
+
+		/**
+		 * Callback completing the future with a copy of returned native data in a new direct buffer.
+		 * Native data are released by the SDK once the callback returns, so they must be copied, but
+		 * no intermediate byte array is allocated on the heap.
+		 */
+		protected static final Callback directBufferCB = new Callback() {
+			@SuppressWarnings({"unused", "unchecked"})
+			public void callback(int commandHandle, int err, Pointer data_raw, int data_len) {
+				logger.debug("directBufferCB() called with: commandHandle = [{}], err = [{}], data_len = [{}]", commandHandle, err, data_len);
+				CompletableFuture<ByteBuffer> future = (CompletableFuture<ByteBuffer>) removeFuture(commandHandle);
+				if (! checkCallback(future, err)) return;
+
+				ByteBuffer buffer = ByteBuffer.allocateDirect(data_len);
+				if (data_len > 0) {
+					buffer.put(data_raw.getByteBuffer(0, data_len));
+				}
+				buffer.flip();
+				future.complete(buffer);
+			}
+		};
+
+		/**
+		 * Returns buffer whose content starts at the current position of the provided buffer, as native
+		 * calls receive the address of the buffer start.
+		 *
+		 * @param buffer The direct buffer.
+		 * @return Buffer to be passed to native call.
+		 */
+		protected static ByteBuffer remainingOf(ByteBuffer buffer) {
+
+			return buffer.position() == 0 ? buffer : buffer.slice();
+		}
+
 		/*
 		 * ERROR CHECKING
 		 */
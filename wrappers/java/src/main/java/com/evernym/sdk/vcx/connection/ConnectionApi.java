@@ -15,6 +15,7 @@ import com.sun.jna.Pointer;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.CompletableFuture;
 
 /**
@@ -225,7 +226,8 @@ public class ConnectionApi extends VcxJava.API {
 	private static Callback vcxConnectionSerializeCB = new Callback() {
 		@SuppressWarnings({"unused", "unchecked"})
 		public void callback(int commandHandle, int err, String serializedData) {
-			logger.debug("callback() called with: commandHandle = [" + commandHandle + "], err = [" + err + "], serializedData = [" + serializedData + "]");
+			// serialized data are not logged, building the message would copy them on every call
+			logger.debug("callback() called with: commandHandle = [{}], err = [{}], serializedData = [****]", commandHandle, err);
 			CompletableFuture<String> future = (CompletableFuture<String>) removeFuture(commandHandle);
 			if (! checkCallback(future, err)) return;
 			// TODO complete with exception if we find error
@@ -284,6 +286,50 @@ public class ConnectionApi extends VcxJava.API {
 		return future;
 	}
 
+	/**
+	 * Serializes connection into compact binary form.
+	 *
+	 * @param connectionHandle The connection handle.
+	 * @return A future that resolves to a direct buffer with serialized connection.
+	 * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+	 */
+	public static CompletableFuture<ByteBuffer> connectionSerializeBinary(int connectionHandle) throws VcxException {
+		logger.debug("connectionSerializeBinary() called with: connectionHandle = [{}]", connectionHandle);
+		CompletableFuture<ByteBuffer> future = new CompletableFuture<>();
+		int commandHandle = addFuture(future);
+
+		int result = LibVcx.api.vcx_connection_serialize_binary(
+				commandHandle,
+				connectionHandle,
+				directBufferCB
+		);
+		checkResult(result);
+		return future;
+	}
+
+	/**
+	 * Re-creates connection from data produced by connectionSerializeBinary.
+	 *
+	 * @param connectionData Direct buffer with serialized connection, remaining bytes are read.
+	 * @return A future that resolves to the connection handle.
+	 * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+	 */
+	public static CompletableFuture<Integer> connectionDeserializeBinary(ByteBuffer connectionData) throws VcxException {
+		ParamGuard.directBuffer(connectionData, "connectionData");
+		logger.debug("connectionDeserializeBinary() called with: connectionData = [****]");
+		CompletableFuture<Integer> future = new CompletableFuture<>();
+		int commandHandle = addFuture(future);
+
+		int result = LibVcx.api.vcx_connection_deserialize_binary(
+				commandHandle,
+				remainingOf(connectionData),
+				connectionData.remaining(),
+				vcxConnectionDeserializeCB
+		);
+		checkResult(result);
+		return future;
+	}
+
 
 	private static Callback vcxConnectionDeleteCB = new Callback() {
 		@SuppressWarnings({"unused", "unchecked"})
@@ -441,6 +487,26 @@ public class ConnectionApi extends VcxJava.API {
         return future;
     }
 
+    /**
+     * Signs remaining bytes of the direct buffer, which are passed to the SDK without copying.
+     *
+     * @param connectionHandle The connection handle.
+     * @param data Direct buffer with data to sign.
+     * @return A future that resolves to a direct buffer with the signature.
+     * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+     */
+    public static CompletableFuture<ByteBuffer> connectionSignData(int connectionHandle, ByteBuffer data) throws VcxException {
+
+        ParamGuard.directBuffer(data, "data");
+
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<ByteBuffer>();
+        int commandHandle = addFuture(future);
+        int result = LibVcx.api.vcx_connection_sign_data(commandHandle, connectionHandle, remainingOf(data), data.remaining(), directBufferCB);
+        checkResult(future, result);
+
+        return future;
+    }
+
     private static Callback vcxConnectionVerifySignatureCB = new Callback() {
 
         @SuppressWarnings({"unused", "unchecked"})
@@ -467,6 +533,28 @@ public class ConnectionApi extends VcxJava.API {
         return future;
     }
 
+    /**
+     * Verifies signature of remaining bytes of the direct buffer, buffers are passed to the SDK without copying.
+     *
+     * @param connectionHandle The connection handle.
+     * @param data Direct buffer with signed data.
+     * @param signature Direct buffer with the signature.
+     * @return A future that resolves to true if signature is valid, otherwise false.
+     * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+     */
+    public static CompletableFuture<Boolean> connectionVerifySignature(int connectionHandle, ByteBuffer data, ByteBuffer signature) throws VcxException {
+
+        ParamGuard.directBuffer(data, "data");
+        ParamGuard.directBuffer(signature, "signature");
+
+        CompletableFuture<Boolean> future = new CompletableFuture<Boolean>();
+        int commandHandle = addFuture(future);
+        int result = LibVcx.api.vcx_connection_verify_signature(commandHandle, connectionHandle, remainingOf(data), data.remaining(), remainingOf(signature), signature.remaining(), vcxConnectionVerifySignatureCB);
+        checkResult(future, result);
+
+        return future;
+    }
+
     private static Callback vcxConnectionGetPwDidCB = new Callback() {
 
         @SuppressWarnings({"unused", "unchecked"})
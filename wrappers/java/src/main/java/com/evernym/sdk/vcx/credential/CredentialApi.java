@@ -9,6 +9,7 @@ import com.sun.jna.Callback;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.CompletableFuture;
 
 public class CredentialApi extends VcxJava.API {
@@ -160,6 +161,40 @@ public class CredentialApi extends VcxJava.API {
 
     }
 
+    public static CompletableFuture<ByteBuffer> credentialSerializeBinary(
+            int credentialHandle
+    ) throws VcxException {
+        logger.debug("credentialSerializeBinary() called with: credentialHandle = [{}]", credentialHandle);
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<ByteBuffer>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_credential_serialize_binary(commandHandle,
+                credentialHandle,
+                directBufferCB);
+        checkResult(result);
+
+        return future;
+
+    }
+
+    public static CompletableFuture<Integer> credentialDeserializeBinary(
+            ByteBuffer serializedCredential
+    ) throws VcxException {
+        ParamGuard.directBuffer(serializedCredential, "serializedCredential");
+        logger.debug("credentialDeserializeBinary() called with: serializedCredential = [****]");
+        CompletableFuture<Integer> future = new CompletableFuture<Integer>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_credential_deserialize_binary(commandHandle,
+                remainingOf(serializedCredential),
+                serializedCredential.remaining(),
+                vcxCredentialDeserializeCB);
+        checkResult(result);
+
+        return future;
+
+    }
+
     private static Callback vcxGetCredentialCB = new Callback() {
         @SuppressWarnings({"unused", "unchecked"})
         public void callback(int command_handle, int err, String credential) {
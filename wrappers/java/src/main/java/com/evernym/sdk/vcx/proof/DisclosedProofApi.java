@@ -9,6 +9,7 @@ import com.sun.jna.Callback;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.CompletableFuture;
 
 public class DisclosedProofApi extends VcxJava.API {
@@ -404,6 +405,33 @@ public class DisclosedProofApi extends VcxJava.API {
         return future;
     }
 
+    public static CompletableFuture<ByteBuffer> proofSerializeBinary(
+            int proofHandle
+    ) throws VcxException {
+        logger.debug("proofSerializeBinary() called with: proofHandle = [{}]", proofHandle);
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<ByteBuffer>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_disclosed_proof_serialize_binary(commandHandle, proofHandle, directBufferCB);
+        checkResult(result);
+
+        return future;
+    }
+
+    public static CompletableFuture<Integer> proofDeserializeBinary(
+            ByteBuffer serializedProof
+    ) throws VcxException {
+        ParamGuard.directBuffer(serializedProof, "serializedProof");
+        logger.debug("proofDeserializeBinary() called with: serializedProof = [****]");
+        CompletableFuture<Integer> future = new CompletableFuture<Integer>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_disclosed_proof_deserialize_binary(commandHandle, remainingOf(serializedProof), serializedProof.remaining(), vcxProofDeserializeCB);
+        checkResult(result);
+
+        return future;
+    }
+
 	private static Callback vcxDeclinePresentationRequestCB = new Callback() {
 		public void callback(int command_handle, int err) {
 			logger.debug("callback() called with: command_handle = [" + command_handle + "], err = [" + err + "]");
@@ -10,6 +10,7 @@ import com.sun.jna.Callback;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.CompletableFuture;
 
 public class WalletApi extends VcxJava.API {
@@ -196,6 +197,37 @@ public class WalletApi extends VcxJava.API {
         return future;
     }
 
+    /**
+     * Signs remaining bytes of the direct buffer with a payment address, without copying the message.
+     *
+     * @param address:  Payment address of message signer.
+     * @param message   Direct buffer with the message to be signed
+     *
+     * @return A future that resolves to a direct buffer with the signature.
+     * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+     */
+    public static CompletableFuture<ByteBuffer> signWithAddress(
+            String address,
+            ByteBuffer message) throws VcxException {
+
+        ParamGuard.notNullOrWhiteSpace(address, "address");
+        ParamGuard.directBuffer(message, "message");
+
+        CompletableFuture<ByteBuffer> future = new CompletableFuture<ByteBuffer>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_wallet_sign_with_address(
+                commandHandle,
+                address,
+                remainingOf(message),
+                message.remaining(),
+                directBufferCB);
+
+        checkResult(result);
+
+        return future;
+    }
+
     /**
      * Callback used when boolCb completes.
      */
@@ -247,6 +279,41 @@ public class WalletApi extends VcxJava.API {
         return future;
     }
 
+    /**
+     * Verify a signature with a payment address, buffers are passed to the SDK without copying.
+     *
+     * @param address   Payment address of the message signer
+     * @param message   Direct buffer with message that has been signed
+     * @param signature Direct buffer with a signature to be verified
+     * @return A future that resolves to true if signature is valid, otherwise false.
+     * @throws VcxException Thrown if an error occurs when calling the underlying SDK.
+     */
+    public static CompletableFuture<Boolean> verifyWithAddress(
+            String address,
+            ByteBuffer message,
+            ByteBuffer signature) throws VcxException {
+
+        ParamGuard.notNullOrWhiteSpace(address, "address");
+        ParamGuard.directBuffer(message, "message");
+        ParamGuard.directBuffer(signature, "signature");
+
+        CompletableFuture<Boolean> future = new CompletableFuture<Boolean>();
+        int commandHandle = addFuture(future);
+
+        int result = LibVcx.api.vcx_wallet_verify_with_address(
+                commandHandle,
+                address,
+                remainingOf(message),
+                message.remaining(),
+                remainingOf(signature),
+                signature.remaining(),
+                verifyWithAddressCb);
+
+        checkResult(result);
+
+        return future;
+    }
+
     private static Callback vcxAddRecordWalletCB = new Callback() {
         @SuppressWarnings({"unused", "unchecked"})
         public void callback(int commandHandle, int err) {
@@ -6,6 +6,7 @@ import com.evernym.sdk.vcx.connection.InvalidConnectionHandleException;
 import com.evernym.sdk.vcx.vcx.VcxApi;
 import com.evernym.sdk.vcx.utils.UtilsApi;
 
+import java.nio.ByteBuffer;
 import java.util.concurrent.CompletableFuture;
 
 import org.awaitility.Awaitility;
@@ -90,6 +91,19 @@ class ConnectionApiTest {
 		assert (serializedJson.contains("data"));
 	}
 
+	@Test
+	@DisplayName("serialize and deserialize a connection in binary form")
+	void serializeConnectionBinary() throws VcxException, ExecutionException, InterruptedException {
+		Integer connectionHandle = _createConnection();
+		String serializedJson = TestHelper.getResultFromFuture(ConnectionApi.connectionSerialize(connectionHandle));
+		ByteBuffer serializedBinary = TestHelper.getResultFromFuture(ConnectionApi.connectionSerializeBinary(connectionHandle));
+		assert (serializedBinary.isDirect());
+		assert (serializedBinary.remaining() > 0);
+
+		Integer deserializedHandle = TestHelper.getResultFromFuture(ConnectionApi.connectionDeserializeBinary(serializedBinary));
+		Assertions.assertEquals(serializedJson, TestHelper.getResultFromFuture(ConnectionApi.connectionSerialize(deserializedHandle)));
+	}
+
 	@Test
 	@DisplayName("throw invalid connection handle exception for serializing invalid connection ")
 	void serializeConnectionWithBadHandle() {
@@ -359,6 +359,27 @@ export class Connection extends VCXBaseWithState<IConnectionData, ConnectionStat
     return connection;
   }
 
+  /**
+   * Create the object from data produced by serializeBinary.
+   * Example:
+   * data = await connection1.serializeBinary()
+   * connection2 = await Connection.deserializeBinary(connection1.sourceId, data)
+   */
+  public static async deserializeBinary(sourceId: string, data: Buffer): Promise<Connection> {
+    return await super._deserializeBinary(Connection, sourceId, data);
+  }
+
+  /**
+   * Create objects from previously serialized objects by a single call into LibVCX.
+   * Example:
+   * connections = await Connection.deserializeMany([data1, data2])
+   */
+  public static async deserializeMany(
+    connectionsData: ISerializedData<IConnectionData>[],
+  ): Promise<Connection[]> {
+    return await super._deserializeMany(Connection, connectionsData);
+  }
+
   protected _releaseFn = rustAPI().vcx_connection_release;
   protected _updateStFn = rustAPI().vcx_connection_update_state;
   protected _updateStFnV2 = (
@@ -372,6 +393,9 @@ export class Connection extends VCXBaseWithState<IConnectionData, ConnectionStat
   protected _getStFn = rustAPI().vcx_connection_get_state;
   protected _serializeFn = rustAPI().vcx_connection_serialize;
   protected _deserializeFn = rustAPI().vcx_connection_deserialize;
+  protected _serializeBinaryFn = rustAPI().vcx_connection_serialize_binary;
+  protected _deserializeBinaryFn = rustAPI().vcx_connection_deserialize_binary;
+  protected _deserializeManyFn = rustAPI().vcx_connection_deserialize_many;
   protected _inviteDetailFn = rustAPI().vcx_connection_invite_details;
   protected _infoFn = rustAPI().vcx_connection_info;
 
@@ -222,6 +222,31 @@ export class Credential extends VCXBaseWithState<ICredentialStructData, HolderSt
     return credential;
   }
 
+  /**
+   * Create an object from binary data produced by the objects serializeBinary method
+   *
+   * ```
+   * data = await credential.serializeBinary()
+   * credential2 = await Credential.deserializeBinary(credential.sourceId, data)
+   * ```
+   */
+  public static async deserializeBinary(sourceId: string, data: Buffer): Promise<Credential> {
+    return await super._deserializeBinary<Credential>(Credential, sourceId, data);
+  }
+
+  /**
+   * Create objects from JSON Structured data produced by serialize method, by a single call into LibVCX
+   *
+   * ```
+   * credentials = await Credential.deserializeMany([data1, data2])
+   * ```
+   */
+  public static async deserializeMany(
+    credentialsData: ISerializedData<ICredentialStructData>[],
+  ): Promise<Credential[]> {
+    return await super._deserializeMany<Credential>(Credential, credentialsData);
+  }
+
   /**
    * Retrieves all pending credential offers.
    *
@@ -266,6 +291,9 @@ export class Credential extends VCXBaseWithState<ICredentialStructData, HolderSt
   protected _getStFn = rustAPI().vcx_credential_get_state;
   protected _serializeFn = rustAPI().vcx_credential_serialize;
   protected _deserializeFn = rustAPI().vcx_credential_deserialize;
+  protected _serializeBinaryFn = rustAPI().vcx_credential_serialize_binary;
+  protected _deserializeBinaryFn = rustAPI().vcx_credential_deserialize_binary;
+  protected _deserializeManyFn = rustAPI().vcx_credential_deserialize_many;
   protected _credOffer = '';
 
   /**
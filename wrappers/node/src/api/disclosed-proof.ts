@@ -252,6 +252,33 @@ export class DisclosedProof extends VCXBaseWithState<IDisclosedProofData, Prover
     }
   }
 
+  /**
+   * Builds a proof object from binary data produced by the serializeBinary function.
+   *
+   * Example:
+   * ```
+   * data = await disclosedProof.serializeBinary()
+   * disclosedProof2 = await DisclosedProof.deserializeBinary(disclosedProof.sourceId, data)
+   * ```
+   */
+  public static async deserializeBinary(sourceId: string, data: Buffer): Promise<DisclosedProof> {
+    return await super._deserializeBinary<DisclosedProof>(DisclosedProof, sourceId, data);
+  }
+
+  /**
+   * Builds proof objects from data produced by the serialize function, by a single call into LibVCX.
+   *
+   * Example:
+   * ```
+   * disclosedProofs = await DisclosedProof.deserializeMany([data1, data2])
+   * ```
+   */
+  public static async deserializeMany(
+    data: ISerializedData<IDisclosedProofData>[],
+  ): Promise<DisclosedProof[]> {
+    return await super._deserializeMany<DisclosedProof>(DisclosedProof, data);
+  }
+
   /**
    * Queries agency for all pending proof requests from the given connection.
    *
@@ -294,6 +321,9 @@ export class DisclosedProof extends VCXBaseWithState<IDisclosedProofData, Prover
   protected _getStFn = rustAPI().vcx_disclosed_proof_get_state;
   protected _serializeFn = rustAPI().vcx_disclosed_proof_serialize;
   protected _deserializeFn = rustAPI().vcx_disclosed_proof_deserialize;
+  protected _serializeBinaryFn = rustAPI().vcx_disclosed_proof_serialize_binary;
+  protected _deserializeBinaryFn = rustAPI().vcx_disclosed_proof_deserialize_binary;
+  protected _deserializeManyFn = rustAPI().vcx_disclosed_proof_deserialize_many;
   private _proofReq = '';
 
   /**
@@ -1,11 +1,80 @@
 import * as ffi from 'ffi-napi';
+import * as ref from 'ref-napi';
 import { VCXInternalError } from '../errors';
-import { createFFICallbackPromise, ICbRef } from '../utils/ffi-helpers';
+import { createFFICallbackPromise, FFICallbackDispatcher, ICbRef } from '../utils/ffi-helpers';
 import { GCWatcher } from '../utils/memory-management-helpers';
 import { ISerializedData } from './common';
 
 export type IVCXBaseCreateFn = (cb: ICbRef) => number;
 
+type IVCXBaseSerializeBinaryFn = (commandHandle: number, handle: number, cb: ICbRef) => number;
+type IVCXBaseDeserializeBinaryFn = (
+  commandHandle: number,
+  data: Buffer,
+  dataLength: number,
+  cb: ICbRef,
+) => number;
+type IVCXBaseDeserializeManyFn = (
+  commandHandle: number,
+  data: Buffer,
+  count: number,
+  cb: ICbRef,
+) => number;
+
+const handleDispatcher = new FFICallbackDispatcher<number>(
+  ['uint32', 'uint32'],
+  (resolve, reject, err: number, handle: number) => {
+    if (err) {
+      reject(err);
+      return;
+    }
+    resolve(handle);
+  },
+);
+
+const serializeDispatcher = new FFICallbackDispatcher<string>(
+  ['uint32', 'string'],
+  (resolve, reject, err: number, serializedData?: string) => {
+    if (err) {
+      reject(err);
+      return;
+    }
+    if (!serializedData) {
+      reject('no data to serialize');
+      return;
+    }
+    resolve(serializedData);
+  },
+);
+
+const serializeBinaryDispatcher = new FFICallbackDispatcher<Buffer>(
+  ['uint32', 'pointer', 'uint32'],
+  (resolve, reject, err: number, dataPtr: Buffer, length: number) => {
+    if (err) {
+      reject(err);
+      return;
+    }
+    if (!dataPtr || !length) {
+      reject('no data to serialize');
+      return;
+    }
+    // LibVCX frees the data once the callback returns
+    resolve(Buffer.from(ref.reinterpret(dataPtr, length, 0)));
+  },
+);
+
+const deserializeManyDispatcher = new FFICallbackDispatcher<number[]>(
+  ['uint32', 'pointer', 'uint32'],
+  (resolve, reject, err: number, handlesPtr: Buffer, count: number) => {
+    if (err) {
+      reject(err);
+      return;
+    }
+    const handles = ref.reinterpret(handlesPtr, count * ref.sizeof.uint32, 0);
+    resolve(Array.from({ length: count }, (_, i) => ref.types.uint32.get(handles, i * ref.sizeof.uint32)));
+  },
+);
+
 export abstract class VCXBase<SerializedData> extends GCWatcher {
   protected static async _deserialize<T extends VCXBase<unknown>, P = unknown>(
     // eslint-disable-next-line @typescript-eslint/no-explicit-any
@@ -22,8 +91,63 @@ export abstract class VCXBase<SerializedData> extends GCWatcher {
     }
   }
 
+  protected static async _deserializeBinary<T extends VCXBase<unknown>, P = unknown>(
+    // eslint-disable-next-line @typescript-eslint/no-explicit-any
+    VCXClass: new (sourceId: string, args?: any) => T,
+    sourceId: string,
+    data: Buffer,
+    constructorParams?: P,
+  ): Promise<T> {
+    try {
+      const obj = new VCXClass(sourceId, constructorParams);
+      const deserializeBinaryFn = obj._getBinaryFn(obj._deserializeBinaryFn);
+      const handle = await handleDispatcher.call((commandHandle, cb) =>
+        deserializeBinaryFn(commandHandle, data, data.length, cb),
+      );
+      obj._setHandle(handle);
+      return obj;
+    } catch (err) {
+      throw new VCXInternalError(err);
+    }
+  }
+
+  /**
+   * Deserializes all objects by a single call into LibVCX, which parses them concurrently.
+   */
+  protected static async _deserializeMany<T extends VCXBase<unknown>, P = unknown>(
+    // eslint-disable-next-line @typescript-eslint/no-explicit-any
+    VCXClass: new (sourceId: string, args?: any) => T,
+    objsData: ISerializedData<{ source_id: string }>[],
+    constructorParams: P[] = [],
+  ): Promise<T[]> {
+    try {
+      const objs = objsData.map(
+        (objData, i) => new VCXClass(objData.source_id || objData.data.source_id, constructorParams[i]),
+      );
+      if (!objs.length) {
+        return objs;
+      }
+      const deserializeManyFn = objs[0]._getBinaryFn(objs[0]._deserializeManyFn);
+      const cStrings = objsData.map((objData) => ref.allocCString(JSON.stringify(objData)));
+      const cStringArray = Buffer.alloc(cStrings.length * ref.sizeof.pointer);
+      cStrings.forEach((cString, i) => ref.writePointer(cStringArray, i * ref.sizeof.pointer, cString));
+      const handles = await deserializeManyDispatcher.call(
+        (commandHandle, cb) => deserializeManyFn(commandHandle, cStringArray, cStrings.length, cb),
+        cStrings,
+      );
+      objs.forEach((obj, i) => obj._setHandle(handles[i]));
+      return objs;
+    } catch (err) {
+      throw new VCXInternalError(err);
+    }
+  }
+
   protected abstract _serializeFn: (commandHandle: number, handle: number, cb: ICbRef) => number;
   protected abstract _deserializeFn: (commandHandle: number, handle: string, cb: ICbRef) => number;
+  // binary and batched serialization is supported only by some objects
+  protected _serializeBinaryFn?: IVCXBaseSerializeBinaryFn;
+  protected _deserializeBinaryFn?: IVCXBaseDeserializeBinaryFn;
+  protected _deserializeManyFn?: IVCXBaseDeserializeManyFn;
   protected _sourceId: string;
 
   constructor(sourceId: string) {
@@ -45,30 +169,8 @@ export abstract class VCXBase<SerializedData> extends GCWatcher {
    */
   public async serialize(): Promise<ISerializedData<SerializedData>> {
     try {
-      const dataStr = await createFFICallbackPromise<string>(
-        (resolve, reject, cb) => {
-          const rc = this._serializeFn(0, this.handle, cb);
-          if (rc) {
-            reject(rc);
-            return;
-          }
-        },
-        (resolve, reject) =>
-          ffi.Callback(
-            'void',
-            ['uint32', 'uint32', 'string'],
-            (handle: string, err: number, serializedData?: string) => {
-              if (err) {
-                reject(err);
-                return;
-              }
-              if (!serializedData) {
-                reject('no data to serialize');
-                return;
-              }
-              resolve(serializedData);
-            },
-          ),
+      const dataStr = await serializeDispatcher.call((commandHandle, cb) =>
+        this._serializeFn(commandHandle, this.handle, cb),
       );
       const data: ISerializedData<SerializedData> = JSON.parse(dataStr);
       return data;
@@ -76,6 +178,29 @@ export abstract class VCXBase<SerializedData> extends GCWatcher {
       throw new VCXInternalError(err);
     }
   }
+
+  /**
+   *
+   * Serializes object into compact binary form, which can be passed to the deserializeBinary function.
+   * Data is not converted into a JS string, so it is cheaper than serialize for large objects.
+   *
+   * Example:
+   *
+   * ```
+   *  data = await object.serializeBinary()
+   * ```
+   */
+  public async serializeBinary(): Promise<Buffer> {
+    try {
+      const serializeBinaryFn = this._getBinaryFn(this._serializeBinaryFn);
+      return await serializeBinaryDispatcher.call((commandHandle, cb) =>
+        serializeBinaryFn(commandHandle, this.handle, cb),
+      );
+    } catch (err) {
+      throw new VCXInternalError(err);
+    }
+  }
+
   /** The source Id assigned by the user for this object */
   get sourceId(): string {
     return this._sourceId;
@@ -105,26 +230,16 @@ export abstract class VCXBase<SerializedData> extends GCWatcher {
     this._setHandle(handleRes);
   }
 
+  private _getBinaryFn<F>(fn?: F): F {
+    if (!fn) {
+      throw new Error(`${this.constructor.name} does not support binary serialization`);
+    }
+    return fn;
+  }
+
   private async _initFromData(objData: ISerializedData<{ source_id: string }>): Promise<void> {
-    const commandHandle = 0;
-    const objHandle = await createFFICallbackPromise<number>(
-      (resolve, reject, cb) => {
-        const rc = this._deserializeFn(commandHandle, JSON.stringify(objData), cb);
-        if (rc) {
-          reject(rc);
-        }
-      },
-      (resolve, reject) =>
-        ffi.Callback(
-          'void',
-          ['uint32', 'uint32', 'uint32'],
-          (xHandle: number, err: number, handle: number) => {
-            if (err) {
-              reject(err);
-            }
-            resolve(handle);
-          },
-        ),
+    const objHandle = await handleDispatcher.call((commandHandle, cb) =>
+      this._deserializeFn(commandHandle, JSON.stringify(objData), cb),
     );
     this._setHandle(objHandle);
   }
@@ -225,6 +225,14 @@ export interface IFFIEntryPoint {
   vcx_connection_deserialize: (commandId: number, data: string, cb: ICbRef) => number;
   vcx_connection_release: (handle: number) => number;
   vcx_connection_serialize: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_connection_serialize_binary: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_connection_deserialize_binary: (
+    commandId: number,
+    data: Buffer,
+    dataLength: number,
+    cb: ICbRef,
+  ) => number;
+  vcx_connection_deserialize_many: (commandId: number, data: Buffer, count: number, cb: ICbRef) => number;
   vcx_connection_update_state: (commandId: number, handle: number, cb: ICbRef) => number;
   vcx_connection_update_state_with_message: (
     commandId: number,
@@ -298,6 +306,14 @@ export interface IFFIEntryPoint {
   vcx_issuer_credential_release: (handle: number) => number;
   vcx_issuer_credential_deserialize: (commandId: number, data: string, cb: ICbRef) => number;
   vcx_issuer_credential_serialize: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_issuer_credential_serialize_binary: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_issuer_credential_deserialize_binary: (
+    commandId: number,
+    data: Buffer,
+    dataLength: number,
+    cb: ICbRef,
+  ) => number;
+  vcx_issuer_credential_deserialize_many: (commandId: number, data: Buffer, count: number, cb: ICbRef) => number;
   vcx_issuer_credential_get_thread_id: (commandId: number, handle: number, cb: ICbRef) => number;
   vcx_v2_issuer_credential_update_state: (
     commandId: number,
@@ -373,6 +389,14 @@ export interface IFFIEntryPoint {
   ) => number;
   vcx_proof_get_request_msg: (commandId: number, proofHandle: number, cb: ICbRef) => number;
   vcx_proof_serialize: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_proof_serialize_binary: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_proof_deserialize_binary: (
+    commandId: number,
+    data: Buffer,
+    dataLength: number,
+    cb: ICbRef,
+  ) => number;
+  vcx_proof_deserialize_many: (commandId: number, data: Buffer, count: number, cb: ICbRef) => number;
   vcx_v2_proof_update_state: (
     commandId: number,
     handle: number,
@@ -412,6 +436,14 @@ export interface IFFIEntryPoint {
   vcx_disclosed_proof_get_proof_msg: (commandId: number, handle: number, cb: ICbRef) => number;
   vcx_disclosed_proof_get_reject_msg: (commandId: number, handle: number, cb: ICbRef) => number;
   vcx_disclosed_proof_serialize: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_disclosed_proof_serialize_binary: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_disclosed_proof_deserialize_binary: (
+    commandId: number,
+    data: Buffer,
+    dataLength: number,
+    cb: ICbRef,
+  ) => number;
+  vcx_disclosed_proof_deserialize_many: (commandId: number, data: Buffer, count: number, cb: ICbRef) => number;
   vcx_disclosed_proof_deserialize: (commandId: number, data: string, cb: ICbRef) => number;
   vcx_v2_disclosed_proof_update_state: (
     commandId: number,
@@ -483,6 +515,14 @@ export interface IFFIEntryPoint {
     cb: ICbRef,
   ) => number;
   vcx_credential_serialize: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_credential_serialize_binary: (commandId: number, handle: number, cb: ICbRef) => number;
+  vcx_credential_deserialize_binary: (
+    commandId: number,
+    data: Buffer,
+    dataLength: number,
+    cb: ICbRef,
+  ) => number;
+  vcx_credential_deserialize_many: (commandId: number, data: Buffer, count: number, cb: ICbRef) => number;
   vcx_credential_deserialize: (commandId: number, data: string, cb: ICbRef) => number;
   vcx_v2_credential_update_state: (
     commandId: number,
@@ -737,6 +777,18 @@ export const FFIConfiguration: { [Key in keyof IFFIEntryPoint]: any } = {
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_CONNECTION_HANDLE, FFI_CALLBACK_PTR],
   ],
+  vcx_connection_serialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_CONNECTION_HANDLE, FFI_CALLBACK_PTR],
+  ],
+  vcx_connection_deserialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
+  vcx_connection_deserialize_many: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
   vcx_connection_update_state: [
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_CONNECTION_HANDLE, FFI_CALLBACK_PTR],
@@ -822,6 +874,18 @@ export const FFIConfiguration: { [Key in keyof IFFIEntryPoint]: any } = {
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_CREDENTIAL_HANDLE, FFI_CALLBACK_PTR],
   ],
+  vcx_issuer_credential_serialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_CREDENTIAL_HANDLE, FFI_CALLBACK_PTR],
+  ],
+  vcx_issuer_credential_deserialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
+  vcx_issuer_credential_deserialize_many: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
   vcx_v2_issuer_credential_update_state: [
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_CREDENTIAL_HANDLE, FFI_CONNECTION_HANDLE, FFI_CALLBACK_PTR],
@@ -909,6 +973,18 @@ export const FFIConfiguration: { [Key in keyof IFFIEntryPoint]: any } = {
     [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CALLBACK_PTR],
   ],
   vcx_proof_serialize: [FFI_ERROR_CODE, [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CALLBACK_PTR]],
+  vcx_proof_serialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CALLBACK_PTR],
+  ],
+  vcx_proof_deserialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
+  vcx_proof_deserialize_many: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
   vcx_v2_proof_update_state: [
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CONNECTION_HANDLE, FFI_CALLBACK_PTR],
@@ -949,6 +1025,18 @@ export const FFIConfiguration: { [Key in keyof IFFIEntryPoint]: any } = {
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CALLBACK_PTR],
   ],
+  vcx_disclosed_proof_serialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_PROOF_HANDLE, FFI_CALLBACK_PTR],
+  ],
+  vcx_disclosed_proof_deserialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
+  vcx_disclosed_proof_deserialize_many: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
   vcx_disclosed_proof_deserialize: [
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_STRING_DATA, FFI_CALLBACK_PTR],
@@ -1028,6 +1116,18 @@ export const FFIConfiguration: { [Key in keyof IFFIEntryPoint]: any } = {
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_CREDENTIAL_HANDLE, FFI_CALLBACK_PTR],
   ],
+  vcx_credential_serialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_CREDENTIAL_HANDLE, FFI_CALLBACK_PTR],
+  ],
+  vcx_credential_deserialize_binary: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
+  vcx_credential_deserialize_many: [
+    FFI_ERROR_CODE,
+    [FFI_COMMAND_HANDLE, FFI_POINTER, FFI_UNSIGNED_INT, FFI_CALLBACK_PTR],
+  ],
   vcx_credential_deserialize: [
     FFI_ERROR_CODE,
     [FFI_COMMAND_HANDLE, FFI_STRING_DATA, FFI_CALLBACK_PTR],
@@ -1,3 +1,5 @@
+import * as ffi from 'ffi-napi';
+
 const maxTimeout = 2147483647;
 
 export type ICbRef = Buffer;
@@ -34,3 +36,78 @@ export const createFFICallbackPromise = <T>(
       throw err;
     });
 };
+
+type IFFICallbackHandler<T> = (
+  resolve: (value?: T) => void,
+  reject: (reason?: number | string | Error) => void,
+  // eslint-disable-next-line @typescript-eslint/no-explicit-any
+  ...args: any[]
+) => void;
+
+interface IPendingCall<T> {
+  resolve: (value?: T) => void;
+  reject: (reason?: number | string | Error) => void;
+  // native memory which must outlive the call, e.g. C strings referenced by a pointer array
+  keepAlive?: unknown;
+}
+
+const maxCommandHandle = 2147483647;
+let nextCommandHandle = 1;
+
+const allocCommandHandle = (): number => {
+  const commandHandle = nextCommandHandle;
+  nextCommandHandle = nextCommandHandle >= maxCommandHandle ? 1 : nextCommandHandle + 1;
+  return commandHandle;
+};
+
+// Dispatches results of LibVCX calls sharing one callback signature through a single, long-lived
+// FFI callback. LibVCX passes the command handle back as the first callback argument, which is used
+// to find the promise of the call. Creating an ffi.Callback per call compiles a new native trampoline,
+// which dominates the cost of short calls.
+export class FFICallbackDispatcher<T> {
+  private readonly _pending = new Map<number, IPendingCall<T>>();
+  private readonly _cbRef: ICbRef;
+
+  constructor(argTypes: string[], handler: IFFICallbackHandler<T>) {
+    this._cbRef = ffi.Callback(
+      'void',
+      ['uint32', ...argTypes],
+      // eslint-disable-next-line @typescript-eslint/no-explicit-any
+      (commandHandle: number, ...args: any[]) => {
+        const pending = this._pending.get(commandHandle);
+        if (!pending) {
+          return;
+        }
+        this._pending.delete(commandHandle);
+        handler(pending.resolve, pending.reject, ...args);
+      },
+    );
+  }
+
+  public call(fn: (commandHandle: number, cb: ICbRef) => number, keepAlive?: unknown): Promise<T> {
+    const commandHandle = allocCommandHandle();
+    const processKeepAliveTimer = setTimeout(() => undefined, maxTimeout);
+    return new Promise<T>((resolve, reject) => {
+      this._pending.set(commandHandle, { resolve, reject, keepAlive });
+      let rc;
+      try {
+        rc = fn(commandHandle, this._cbRef);
+      } catch (err) {
+        this._pending.delete(commandHandle);
+        throw err;
+      }
+      if (rc) {
+        this._pending.delete(commandHandle);
+        reject(rc);
+      }
+    })
+      .then((res) => {
+        clearTimeout(processKeepAliveTimer);
+        return res;
+      })
+      .catch((err) => {
+        clearTimeout(processKeepAliveTimer);
+        throw err;
+      });
+  }
+}
@@ -129,6 +129,28 @@ describe('Connection:', () => {
     });
   });
 
+  describe('deserializeBinary:', () => {
+    it('success', async () => {
+      const connection1 = await connectionCreateInviterNull();
+      const data1 = await connection1.serializeBinary();
+      assert.instanceOf(data1, Buffer);
+      const connection2 = await Connection.deserializeBinary(connection1.sourceId, data1);
+      assert.deepEqual(await connection2.serialize(), await connection1.serialize());
+    });
+  });
+
+  describe('deserializeMany:', () => {
+    it('success', async () => {
+      const connection1 = await connectionCreateInviterNull();
+      const connection2 = await connectionCreateInviterNull();
+      const data = [await connection1.serialize(), await connection2.serialize()];
+      const connections = await Connection.deserializeMany(data);
+      assert.equal(connections.length, 2);
+      assert.deepEqual(await connections[0].serialize(), data[0]);
+      assert.deepEqual(await connections[1].serialize(), data[1]);
+    });
+  });
+
   describe('updateState:', () => {
     it('throws error when not initialized', async () => {
       let caught_error;
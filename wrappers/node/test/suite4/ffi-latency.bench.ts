@@ -0,0 +1,92 @@
+import '../module-resolver-helper';
+
+import { assert } from 'chai';
+import * as ffi from 'ffi-napi';
+import { connectionCreateInviterNull } from 'helpers/entities';
+import { initVcxTestMode } from 'helpers/utils';
+import { Connection, rustAPI } from 'src';
+import { createFFICallbackPromise } from '../../src/utils/ffi-helpers';
+
+// Per-call latency of the FFI binding. These are not assertions about speed, results are printed
+// so that changes of the binding can be compared, run with `npm run bench:ffi`.
+
+const ITERATIONS = 2000;
+const BATCH_SIZE = 100;
+
+const measure = async (label: string, iterations: number, fn: () => Promise<unknown>): Promise<number> => {
+  // warm up JIT and native allocations
+  for (let i = 0; i < 50; i++) {
+    await fn();
+  }
+  const start = process.hrtime();
+  for (let i = 0; i < iterations; i++) {
+    await fn();
+  }
+  const [seconds, nanoseconds] = process.hrtime(start);
+  const perCallUs = (seconds * 1e9 + nanoseconds) / iterations / 1000;
+  console.log(`${label}: ${perCallUs.toFixed(1)} us/call`);
+  return perCallUs;
+};
+
+const serializeWithCallbackPerCall = (connection: Connection): Promise<string> =>
+  createFFICallbackPromise<string>(
+    (resolve, reject, cb) => {
+      const rc = rustAPI().vcx_connection_serialize(0, connection.handle, cb);
+      if (rc) {
+        reject(rc);
+      }
+    },
+    (resolve, reject) =>
+      ffi.Callback(
+        'void',
+        ['uint32', 'uint32', 'string'],
+        (xHandle: number, err: number, data: string) => {
+          if (err) {
+            reject(err);
+            return;
+          }
+          resolve(data);
+        },
+      ),
+  );
+
+describe('FFI latency:', () => {
+  before(() => initVcxTestMode());
+
+  it('serialize: callback per call vs shared callback', async () => {
+    const connection = await connectionCreateInviterNull();
+    const perCall = await measure('serialize, ffi.Callback per call', ITERATIONS, () =>
+      serializeWithCallbackPerCall(connection),
+    );
+    const shared = await measure('serialize, shared callback', ITERATIONS, () => connection.serialize());
+    console.log(`shared callback speedup: ${(perCall / shared).toFixed(2)}x`);
+  });
+
+  it('serialize: json vs binary', async () => {
+    const connection = await connectionCreateInviterNull();
+    await measure('serialize to json', ITERATIONS, () => connection.serialize());
+    await measure('serializeBinary to Buffer', ITERATIONS, () => connection.serializeBinary());
+
+    const json = await connection.serialize();
+    await measure('deserialize from json', ITERATIONS, () => Connection.deserialize(json));
+    const binary = await connection.serializeBinary();
+    await measure('deserializeBinary from Buffer', ITERATIONS, () =>
+      Connection.deserializeBinary(connection.sourceId, binary),
+    );
+  });
+
+  it(`deserialize: one by one vs batch of ${BATCH_SIZE}`, async () => {
+    const connection = await connectionCreateInviterNull();
+    const data = await connection.serialize();
+    const batch = new Array(BATCH_SIZE).fill(data);
+
+    const oneByOne = await measure(`deserialize x${BATCH_SIZE}, one call each`, ITERATIONS / BATCH_SIZE, () =>
+      Promise.all(batch.map((item) => Connection.deserialize(item))),
+    );
+    const batched = await measure(`deserializeMany x${BATCH_SIZE}`, ITERATIONS / BATCH_SIZE, async () => {
+      const connections = await Connection.deserializeMany(batch);
+      assert.equal(connections.length, BATCH_SIZE);
+    });
+    console.log(`batch speedup: ${(oneByOne / batched).toFixed(2)}x`);
+  });
+});